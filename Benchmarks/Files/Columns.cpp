@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <Stuff/Files/Columns.hpp>
+
+using namespace Stf::FFormat;
+
+/// The header from `asd()`
+static constexpr auto record_format = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc")
+                                                    << name_field(primitive_field<Primitive::U16BE>(), "length")
+                                                    << name_field(primitive_field<Primitive::U16BE>(), "id")
+                                                    << name_field(primitive_field<Primitive::U32BE>(), "order");
+
+using record_type = decltype(record_format)::representation_type;
+
+static constexpr size_t record_count = 4uz * 1024 * 1024;
+
+static std::vector<uint8_t> const& records() {
+    static const auto ret = [] {
+        std::mt19937 engine { 1234 };
+        std::vector<uint8_t> data(record_count * record_format.encoded_size);
+        for (auto& byte : data)
+            byte = static_cast<uint8_t>(engine());
+        return data;
+    }();
+
+    return ret;
+}
+
+static void set_record_counters(benchmark::State& state) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * records().size()));
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations() * record_count), benchmark::Counter::kIsRate);
+}
+
+/// A tuple per record, the outputs are reused across iterations in all of the benchmarks
+static void benchmark_columns_records(benchmark::State& state) {
+    const auto& data = records();
+
+    std::vector<record_type> out(record_count);
+
+    for (auto _ : state) {
+        const auto* it = data.data();
+        for (auto& record : out)
+            it = *record_format.decode(it, data.data() + data.size(), record);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_columns_records)->Unit(benchmark::kMillisecond);
+
+/// All of the columns on the calling thread
+static void benchmark_columns_serial(benchmark::State& state) {
+    Stf::ThreadPool pool { 0 };
+    columns_t<decltype(record_format)> columns {};
+
+    for (auto _ : state) {
+        std::ignore = decode_columns_into(record_format, records(), columns, pool);
+        benchmark::DoNotOptimize(std::get<0>(columns).data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_columns_serial)->Unit(benchmark::kMillisecond);
+
+static void benchmark_columns_parallel(benchmark::State& state) {
+    columns_t<decltype(record_format)> columns {};
+
+    for (auto _ : state) {
+        std::ignore = decode_columns_into(record_format, records(), columns);
+        benchmark::DoNotOptimize(std::get<0>(columns).data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_columns_parallel)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Only "order"
+static void benchmark_columns_projected(benchmark::State& state) {
+    columns_t<decltype(record_format), 3> columns {};
+
+    for (auto _ : state) {
+        std::ignore = decode_columns_into<3>(record_format, records(), columns);
+        benchmark::DoNotOptimize(std::get<0>(columns).data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_columns_projected)->Unit(benchmark::kMillisecond)->UseRealTime();
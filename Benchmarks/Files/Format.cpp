@@ -0,0 +1,205 @@
+#include <benchmark/benchmark.h>
+
+#include <deque>
+#include <random>
+
+#include <Stuff/Files/Format.hpp>
+
+using namespace Stf::FFormat;
+
+/// A telemetry record: a header like the one in `asd()` followed by a block of big endian samples
+static constexpr auto record_format = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc")
+                                                    << name_field(primitive_field<Primitive::U16BE>(), "length")
+                                                    << name_field(primitive_field<Primitive::U16BE>(), "id")
+                                                    << name_field(primitive_field<Primitive::U32BE>(), "order")
+                                                    << name_field(make_array_field<64>(primitive_field<Primitive::F32BE>()), "samples");
+
+using record_type = decltype(record_format)::representation_type;
+
+static constexpr size_t record_count = 4096;
+
+static std::vector<uint8_t> const& records() {
+    static const auto ret = [] {
+        std::mt19937 engine { 1234 };
+        std::vector<uint8_t> data(record_count * record_format.encoded_size);
+        for (auto& byte : data)
+            byte = static_cast<uint8_t>(engine());
+        return data;
+    }();
+
+    return ret;
+}
+
+static void set_record_counters(benchmark::State& state) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * records().size()));
+    state.counters["records/s"] = benchmark::Counter(static_cast<double>(state.iterations() * record_count), benchmark::Counter::kIsRate);
+}
+
+template<typename Iter> static void decode_all(benchmark::State& state, Iter begin, Iter end) {
+    std::vector<record_type> out(record_count);
+
+    for (auto _ : state) {
+        auto it = begin;
+        for (auto& record : out)
+            it = *record_format.decode(it, end, record);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_record_counters(state);
+}
+
+/// Single bounds check per record, memcpy and in-register byte swaps
+static void benchmark_fformat_decode_contiguous(benchmark::State& state) {
+    const auto& data = records();
+    decode_all(state, data.data(), data.data() + data.size());
+}
+BENCHMARK(benchmark_fformat_decode_contiguous);
+
+/// Byte by byte through the input iterator path
+static void benchmark_fformat_decode_iterator(benchmark::State& state) {
+    const std::deque<uint8_t> data(records().begin(), records().end());
+    decode_all(state, data.begin(), data.end());
+}
+BENCHMARK(benchmark_fformat_decode_iterator);
+
+static std::vector<record_type> const& decoded_records() {
+    static const auto ret = [] {
+        std::vector<record_type> out(record_count);
+        auto it = records().data();
+        for (auto& record : out)
+            it = *record_format.decode(it, records().data() + records().size(), record);
+        return out;
+    }();
+
+    return ret;
+}
+
+/// Straight-line stores at the members' offsets
+static void benchmark_fformat_encode_contiguous(benchmark::State& state) {
+    std::vector<uint8_t> out(records().size());
+
+    for (auto _ : state) {
+        auto* it = out.data();
+        for (auto const& record : decoded_records())
+            it = record_format.encode(it, record);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_fformat_encode_contiguous);
+
+/// Byte by byte through the output iterator path
+static void benchmark_fformat_encode_iterator(benchmark::State& state) {
+    std::deque<uint8_t> out(records().size());
+
+    for (auto _ : state) {
+        auto it = out.begin();
+        for (auto const& record : decoded_records())
+            it = record_format.encode(it, record);
+        benchmark::DoNotOptimize(&*out.begin());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_fformat_encode_iterator);
+
+/// Decode a record and write it back out, as a filter over a log would
+static void benchmark_fformat_round_trip(benchmark::State& state) {
+    const auto& in = records();
+    std::vector<uint8_t> out(in.size());
+
+    for (auto _ : state) {
+        const auto* src = in.data();
+        auto* dst = out.data();
+        for (auto i = 0uz; i < record_count; i++) {
+            record_type record;
+            src = *record_format.decode(src, in.data() + in.size(), record);
+            dst = record_format.encode(dst, record);
+        }
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_record_counters(state);
+}
+BENCHMARK(benchmark_fformat_round_trip);
+
+/// A log of variable-length messages: a fixed header, a payload of a few kilobytes and a counted block of samples
+static constexpr auto message_format = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc")
+                                                     << name_field(primitive_field<Primitive::U64BE>(), "time")
+                                                     << name_field(blob_field<Primitive::U32BE>(), "payload")
+                                                     << name_field(counted_array_field<Primitive::U16BE>(primitive_field<Primitive::F32BE>()), "samples");
+
+using message_type = decltype(message_format)::representation_type;
+
+static constexpr size_t message_count = 1024;
+
+static std::vector<uint8_t> const& messages() {
+    static const auto ret = [] {
+        std::mt19937 engine { 1234 };
+        const auto payload_size = [&] { return 2048 + engine() % 4096; };
+
+        std::vector<uint8_t> data {};
+        for (auto i = 0uz; i < message_count; i++) {
+            std::vector<uint8_t> payload(payload_size());
+            std::vector<float> samples(engine() % 64);
+
+            auto out = back_inserter(data);
+            out = primitive_field<Primitive::U32BE>().encode(out, static_cast<uint32_t>(engine()));
+            out = primitive_field<Primitive::U64BE>().encode(out, i);
+            out = blob_field<Primitive::U32BE>().encode(out, payload);
+            counted_array_field<Primitive::U16BE>(primitive_field<Primitive::F32BE>()).encode(out, samples);
+        }
+        return data;
+    }();
+
+    return ret;
+}
+
+static void set_message_counters(benchmark::State& state) {
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * messages().size()));
+    state.counters["messages/s"] = benchmark::Counter(static_cast<double>(state.iterations() * message_count), benchmark::Counter::kIsRate);
+}
+
+/// Payloads and samples come out as views into the log, walking it only reads the headers and the prefixes
+static void benchmark_fformat_decode_views(benchmark::State& state) {
+    const auto& data = messages();
+
+    for (auto _ : state) {
+        const auto* it = data.data();
+        uint64_t time_sum = 0;
+        for (auto i = 0uz; i < message_count; i++) {
+            message_type message;
+            it = *message_format.decode(it, data.data() + data.size(), message);
+            time_sum += std::get<1>(message);
+        }
+        benchmark::DoNotOptimize(time_sum);
+    }
+
+    set_message_counters(state);
+}
+BENCHMARK(benchmark_fformat_decode_views);
+
+/// The same walk with owning containers, what decoding into copies would cost
+static void benchmark_fformat_decode_copies(benchmark::State& state) {
+    const auto& data = messages();
+
+    for (auto _ : state) {
+        const auto* it = data.data();
+        uint64_t time_sum = 0;
+        for (auto i = 0uz; i < message_count; i++) {
+            message_type message;
+            it = *message_format.decode(it, data.data() + data.size(), message);
+
+            const std::vector<uint8_t> payload(std::get<2>(message).begin(), std::get<2>(message).end());
+            const std::vector<float> samples(std::get<3>(message).begin(), std::get<3>(message).end());
+            benchmark::DoNotOptimize(payload.data());
+            benchmark::DoNotOptimize(samples.data());
+            time_sum += std::get<1>(message);
+        }
+        benchmark::DoNotOptimize(time_sum);
+    }
+
+    set_message_counters(state);
+}
+BENCHMARK(benchmark_fformat_decode_copies);
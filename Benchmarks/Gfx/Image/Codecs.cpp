@@ -0,0 +1,166 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <fstream>
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/PNM.hpp>
+#include <Stuff/Graphics/Image/TGA.hpp>
+
+#define DO_ASSERT(expr)                        \
+    {                                          \
+        for (bool _res = bool(expr); !_res;) { \
+            std::abort();                      \
+        }                                      \
+    }
+
+using namespace Stf::Gfx;
+
+using Frame = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+
+/// dice.qoi tiled 2x2 (1600x1200), photographic content with flat areas for the run-length encoders
+static Frame const& frame() {
+    static const auto ret = [] {
+        std::ifstream ifs("Tests/Graphics/Images/dice.qoi", std::ios::binary);
+        DO_ASSERT(ifs);
+        const std::vector<uint8_t> qoi_data(std::istreambuf_iterator<char> { ifs }, std::istreambuf_iterator<char>());
+
+        const auto tile = Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+        DO_ASSERT(tile);
+
+        const auto [w, h] = tile->dimensions();
+        Frame image {};
+        image.create({ w * 2, h * 2 });
+        for (auto y = 0uz; y < h * 2; y++)
+            for (auto x = 0uz; x < w * 2; x++)
+                image[{ x, y }] = tile->get_pixel(x % w, y % h);
+
+        return image;
+    }();
+
+    return ret;
+}
+
+static void set_pixel_counters(benchmark::State& state) {
+    const auto pixels = frame().pixel_count();
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * pixels * 4));
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * pixels) / 1e6, benchmark::Counter::kIsRate);
+}
+
+template<typename Fn> static std::vector<uint8_t> encoded(Fn&& encode) {
+    std::vector<uint8_t> ret {};
+    encode(back_inserter(ret));
+    return ret;
+}
+
+static NewImage<ColorFormat::RGB8u, ColorSpace::SRGB> const& rgb_frame() {
+    static const auto ret = [] {
+        NewImage<ColorFormat::RGB8u, ColorSpace::SRGB> image {};
+        image.create(frame().dimensions());
+        for (auto i = 0uz; i < image.pixel_count(); i++)
+            image[i] = { frame()[i][0], frame()[i][1], frame()[i][2] };
+        return image;
+    }();
+
+    return ret;
+}
+
+/// Args: RLE, 24 bit (BGR) or 32 bit (BGRA) file
+static void benchmark_codecs_tga_decode(benchmark::State& state) {
+    const auto rle = state.range(0) != 0;
+    const auto data = state.range(1) == 24 ? encoded([rle](auto out) { DO_ASSERT(Formats::TGA::encode(out, rgb_frame(), rle)); })
+                                           : encoded([rle](auto out) { DO_ASSERT(Formats::TGA::encode(out, frame(), rle)); });
+
+    for (auto _ : state) {
+        auto image = Formats::TGA::decode<ColorFormat::RGBA8u, ColorSpace::SRGB>(data);
+        benchmark::DoNotOptimize(image->data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_tga_decode)->Args({ 0, 24 })->Args({ 0, 32 })->Args({ 1, 24 })->Args({ 1, 32 })->Unit(benchmark::kMillisecond);
+
+/// The uncompressed 24 bit decoder pixel by pixel, what the row shuffles replace
+static void benchmark_codecs_tga_decode_per_pixel(benchmark::State& state) {
+    const auto data = encoded([](auto out) { DO_ASSERT(Formats::TGA::encode(out, rgb_frame())); });
+
+    for (auto _ : state) {
+        const auto header = Formats::TGA::Header::from_bytes(data);
+        Frame image {};
+        image.create(header->dims);
+
+        const auto* src = data.data() + header->data_offset();
+        for (auto& pixel : image.pixels()) {
+            pixel = { src[2], src[1], src[0], 255 };
+            src += 3;
+        }
+        benchmark::DoNotOptimize(image.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_tga_decode_per_pixel)->Unit(benchmark::kMillisecond);
+
+/// Arg: RLE
+static void benchmark_codecs_tga_encode(benchmark::State& state) {
+    std::vector<uint8_t> data(frame().size() * 2);
+
+    for (auto _ : state) {
+        auto res = Formats::TGA::encode(data.data(), frame(), state.range(0) != 0);
+        benchmark::DoNotOptimize(*res);
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_tga_encode)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
+
+/// PPM (RGB) and PAM (RGBA) into RGBA
+static void benchmark_codecs_ppm_decode(benchmark::State& state) {
+    const auto data = encoded([](auto out) { Formats::PNM::encode(out, rgb_frame()); });
+
+    for (auto _ : state) {
+        auto image = Formats::PNM::decode<ColorFormat::RGBA8u, ColorSpace::SRGB>(data);
+        benchmark::DoNotOptimize(image->data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_ppm_decode)->Unit(benchmark::kMillisecond);
+
+static void benchmark_codecs_pam_decode(benchmark::State& state) {
+    const auto data = encoded([](auto out) { Formats::PNM::encode(out, frame()); });
+
+    for (auto _ : state) {
+        auto image = Formats::PNM::decode<ColorFormat::BGRA8u, ColorSpace::SRGB>(data);
+        benchmark::DoNotOptimize(image->data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_pam_decode)->Unit(benchmark::kMillisecond);
+
+static void benchmark_codecs_pam_encode(benchmark::State& state) {
+    std::vector<uint8_t> data(frame().size() + 128);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(Formats::PNM::encode(data.data(), frame()));
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_pam_encode)->Unit(benchmark::kMillisecond);
+
+/// The same frame through QoI, for reference
+static void benchmark_codecs_qoi_decode(benchmark::State& state) {
+    Image<> legacy(frame().dimensions()[0], frame().dimensions()[1]);
+    std::memcpy(legacy.data(), frame().data(), frame().size());
+
+    const auto data = encoded([&](auto out) { DO_ASSERT(Formats::QoI::encode(out, legacy)); });
+
+    for (auto _ : state) {
+        auto image = Formats::QoI::decode(data.begin(), data.end());
+        benchmark::DoNotOptimize(image->data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_codecs_qoi_decode)->Unit(benchmark::kMillisecond);
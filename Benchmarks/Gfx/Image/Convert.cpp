@@ -0,0 +1,117 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+
+#include <Stuff/Graphics/Convert.hpp>
+
+using namespace Stf::Gfx;
+
+using Capture = NewImage<ColorFormat::BGRA8u, ColorSpace::SRGB>;
+using Working = NewImage<ColorFormat::RGBA32f, ColorSpace::Linear>;
+
+static constexpr Stf::Vector<size_t, 2> frame_dimensions { 1920, 1080 };
+
+static void set_pixel_counters(benchmark::State& state) {
+    const auto pixels = frame_dimensions[0] * frame_dimensions[1];
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * pixels) / 1e6, benchmark::Counter::kIsRate);
+}
+
+static Capture const& capture_frame() {
+    static const auto image = [] {
+        std::mt19937 engine { 1234 };
+
+        Capture ret {};
+        ret.create(frame_dimensions);
+        for (auto& pixel : ret.pixels())
+            pixel = std::bit_cast<Capture::color_type>(static_cast<uint32_t>(engine()));
+
+        return ret;
+    }();
+
+    return image;
+}
+
+/// Per pixel, per channel std::pow for reference
+static void benchmark_convert_bgra8_to_rgba32f_naive(benchmark::State& state) {
+    const auto& src = capture_frame();
+    Working dst {};
+    dst.create(src.dimensions());
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < src.pixel_count(); i++) {
+            const auto [b, g, r, a] = src[i];
+            dst[i] = {
+                SRGB::to_linear(static_cast<float>(r) / 255.f),
+                SRGB::to_linear(static_cast<float>(g) / 255.f),
+                SRGB::to_linear(static_cast<float>(b) / 255.f),
+                static_cast<float>(a) / 255.f,
+            };
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_convert_bgra8_to_rgba32f_naive)->UseRealTime();
+
+/// Arg: thread count, including the calling thread
+static void benchmark_convert_bgra8_to_rgba32f(benchmark::State& state) {
+    const auto& src = capture_frame();
+    Stf::ThreadPool pool(state.range(0) - 1);
+    Working dst {};
+    dst.create(src.dimensions());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convert(src, dst, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_convert_bgra8_to_rgba32f)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+static void benchmark_convert_rgba32f_to_bgra8(benchmark::State& state) {
+    Stf::ThreadPool pool(state.range(0) - 1);
+    const auto src = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(capture_frame(), pool);
+    Capture dst {};
+    dst.create(src.dimensions());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convert(src, dst, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_convert_rgba32f_to_bgra8)->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+
+static void benchmark_convert_bgra8_to_rgba8(benchmark::State& state) {
+    const auto& src = capture_frame();
+    Stf::ThreadPool pool(0);
+    NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB> dst {};
+    dst.create(src.dimensions());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convert(src, dst, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_convert_bgra8_to_rgba8)->UseRealTime();
+
+static void benchmark_convert_bgra8_to_rgb16(benchmark::State& state) {
+    const auto& src = capture_frame();
+    Stf::ThreadPool pool(0);
+    NewImage<ColorFormat::RGB16u, ColorSpace::SRGB> dst {};
+    dst.create(src.dimensions());
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convert(src, dst, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_convert_bgra8_to_rgb16)->UseRealTime();
@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <random>
+
+#include <Stuff/Graphics/Expression.hpp>
+
+using namespace Stf::Gfx;
+
+using Frame = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+using LinearFrame = NewImage<ColorFormat::RGBA32f, ColorSpace::Linear>;
+
+/// Arg: the height of a 16:9 frame, 1080p, 4K or 8K
+static Stf::Vector<size_t, 2> frame_dimensions(benchmark::State const& state) {
+    const auto height = static_cast<size_t>(state.range(0));
+    return { height * 16 / 9, height };
+}
+
+static Frame const& frame(Stf::Vector<size_t, 2> dimensions, uint32_t seed) {
+    static std::map<std::pair<size_t, uint32_t>, Frame> frames {};
+
+    auto& ret = frames[{ dimensions[1], seed }];
+    if (ret.pixel_count() == 0) {
+        std::mt19937 engine { seed };
+        ret.create(dimensions);
+        for (auto& pixel : ret.pixels())
+            pixel = std::bit_cast<Frame::color_type>(static_cast<uint32_t>(engine()));
+    }
+
+    return ret;
+}
+
+/// Megapixels of output per second
+static void set_pixel_counters(benchmark::State& state, Stf::Vector<size_t, 2> dimensions) {
+    const auto pixels = dimensions[0] * dimensions[1];
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * pixels) / 1e6, benchmark::Counter::kIsRate);
+}
+
+/// convert -> premultiply -> blend -> convert, one pass over whole images per step
+static void benchmark_expression_composite_passes(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& fg = frame(dimensions, 1);
+    const auto& bg = frame(dimensions, 2);
+    Stf::ThreadPool pool(0);
+
+    LinearFrame fg_linear {};
+    LinearFrame bg_linear {};
+    fg_linear.create(dimensions);
+    bg_linear.create(dimensions);
+    Frame dst {};
+    dst.create(dimensions);
+
+    for (auto _ : state) {
+        std::ignore = convert(fg, fg_linear, pool);
+        std::ignore = convert(bg, bg_linear, pool);
+
+        for (auto& pixel : fg_linear.pixels())
+            for (auto c = 0uz; c < 3; c++)
+                pixel[c] *= pixel[3];
+
+        for (auto i = 0uz; i < fg_linear.pixel_count(); i++)
+            for (auto c = 0uz; c < 4; c++)
+                bg_linear[i][c] = fg_linear[i][c] + bg_linear[i][c] * (1.f - fg_linear[i][3]);
+
+        std::ignore = convert(bg_linear, dst, pool);
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_expression_composite_passes)->Arg(1080)->Arg(2160)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_expression_composite_fused(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& fg = frame(dimensions, 1);
+    const auto& bg = frame(dimensions, 2);
+    Stf::ThreadPool pool(0);
+
+    Frame dst {};
+    dst.create(dimensions);
+
+    const auto e = to_srgb(over(premultiply(to_linear(expression(fg))), to_linear(expression(bg))));
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(assign(dst, e, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_expression_composite_fused)->Arg(1080)->Arg(2160)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// A linear float chain with no transfer functions, bound by memory when done in passes
+static void benchmark_expression_arithmetic_passes(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto a = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(frame(dimensions, 1));
+    const auto b = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(frame(dimensions, 2));
+
+    LinearFrame tmp {};
+    LinearFrame dst {};
+    tmp.create(dimensions);
+    dst.create(dimensions);
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < a.pixel_count(); i++)
+            for (auto c = 0uz; c < 4; c++)
+                tmp[i][c] = a[i][c] * 0.75f;
+        for (auto i = 0uz; i < a.pixel_count(); i++)
+            for (auto c = 0uz; c < 4; c++)
+                tmp[i][c] += b[i][c] * 0.25f;
+        for (auto i = 0uz; i < a.pixel_count(); i++)
+            for (auto c = 0uz; c < 4; c++)
+                dst[i][c] = tmp[i][c] * tmp[i][c];
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_expression_arithmetic_passes)->Arg(1080)->Arg(2160)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_expression_arithmetic_fused(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto a = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(frame(dimensions, 1));
+    const auto b = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(frame(dimensions, 2));
+    Stf::ThreadPool pool(0);
+
+    LinearFrame dst {};
+    dst.create(dimensions);
+
+    const auto blend = expression(a) * 0.75f + expression(b) * 0.25f;
+    const auto e = blend * blend;
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(assign(dst, e, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_expression_arithmetic_fused)->Arg(1080)->Arg(2160)->Unit(benchmark::kMillisecond)->UseRealTime();
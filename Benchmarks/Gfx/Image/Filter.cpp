@@ -0,0 +1,146 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <map>
+#include <random>
+
+#include <Stuff/Graphics/Filter.hpp>
+
+using namespace Stf::Gfx;
+
+using Frame = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+
+/// Arg: the height of a 16:9 frame, 1080p, 4K or 8K
+static Stf::Vector<size_t, 2> frame_dimensions(benchmark::State const& state) {
+    const auto height = static_cast<size_t>(state.range(0));
+    return { height * 16 / 9, height };
+}
+
+static Frame const& frame(Stf::Vector<size_t, 2> dimensions) {
+    static std::map<size_t, Frame> frames {};
+
+    auto& ret = frames[dimensions[1]];
+    if (ret.pixel_count() == 0) {
+        std::mt19937 engine { 1234 };
+        ret.create(dimensions);
+        for (auto& pixel : ret.pixels())
+            pixel = std::bit_cast<Frame::color_type>(static_cast<uint32_t>(engine()));
+    }
+
+    return ret;
+}
+
+/// Megapixels of the source per second
+static void set_pixel_counters(benchmark::State& state, Stf::Vector<size_t, 2> dimensions) {
+    const auto pixels = dimensions[0] * dimensions[1];
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * pixels) / 1e6, benchmark::Counter::kIsRate);
+}
+
+/// A 2D Gaussian evaluated per pixel for reference
+static void benchmark_filter_gaussian_naive(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& src = frame(dimensions);
+    Frame dst {};
+    dst.create(dimensions);
+
+    constexpr auto sigma = 2.f;
+    constexpr auto radius = 6;
+
+    std::array<float, 2 * radius + 1> weights {};
+    for (auto i = -radius; i <= radius; i++)
+        weights[i + radius] = std::exp(-static_cast<float>(i * i) / (2.f * sigma * sigma));
+
+    const auto [width, height] = dimensions;
+    const auto clamp = [](ptrdiff_t v, size_t size) { return static_cast<size_t>(std::clamp<ptrdiff_t>(v, 0, static_cast<ptrdiff_t>(size) - 1)); };
+
+    for (auto _ : state) {
+        for (auto y = 0uz; y < height; y++) {
+            for (auto x = 0uz; x < width; x++) {
+                std::array<float, 4> sum {};
+                float total = 0;
+                for (auto dy = -radius; dy <= radius; dy++)
+                    for (auto dx = -radius; dx <= radius; dx++) {
+                        const auto w = weights[dy + radius] * weights[dx + radius];
+                        const auto pixel = src[{ clamp(static_cast<ptrdiff_t>(x) + dx, width), clamp(static_cast<ptrdiff_t>(y) + dy, height) }];
+                        for (auto c = 0uz; c < 4; c++)
+                            sum[c] += w * static_cast<float>(pixel[c]);
+                        total += w;
+                    }
+
+                Frame::color_type out;
+                for (auto c = 0uz; c < 4; c++)
+                    out[c] = static_cast<uint8_t>(sum[c] / total + 0.5f);
+                dst[{ x, y }] = out;
+            }
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_filter_gaussian_naive)->Arg(1080)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_filter_gaussian(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& src = frame(dimensions);
+    Stf::ThreadPool pool(0);
+    Frame dst {};
+    dst.create(dimensions);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(convolve(src, dst, Filters::Gaussian { 2. }, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_filter_gaussian)->Arg(1080)->Arg(2160)->Arg(4320)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+template<typename Filter> static void benchmark_filter_half(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& src = frame(dimensions);
+    Stf::ThreadPool pool(0);
+    Frame dst {};
+    dst.create({ dimensions[0] / 2, dimensions[1] / 2 });
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(resample(src, dst, Filter {}, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK_TEMPLATE(benchmark_filter_half, Filters::Area)->Arg(1080)->Arg(2160)->Arg(4320)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_filter_half, Filters::Triangle)->Arg(1080)->Arg(2160)->Arg(4320)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK_TEMPLATE(benchmark_filter_half, Filters::Lanczos)->Arg(1080)->Arg(2160)->Arg(4320)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Args: the height and the thread count, including the calling thread
+static void benchmark_filter_upscale_lanczos(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& src = frame(dimensions);
+    Stf::ThreadPool pool(state.range(1) - 1);
+    Frame dst {};
+    dst.create({ dimensions[0] * 2, dimensions[1] * 2 });
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(resample(src, dst, Filters::Lanczos {}, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_filter_upscale_lanczos)->Args({ 1080, 1 })->Args({ 1080, 2 })->Args({ 1080, 4 })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_filter_mipmaps(benchmark::State& state) {
+    const auto dimensions = frame_dimensions(state);
+    const auto& src = frame(dimensions);
+    Stf::ThreadPool pool(0);
+
+    for (auto _ : state) {
+        auto levels = mipmaps(src, Filters::Area {}, pool);
+        benchmark::DoNotOptimize(levels.data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_filter_mipmaps)->Arg(1080)->Arg(2160)->Arg(4320)->Unit(benchmark::kMillisecond)->UseRealTime();
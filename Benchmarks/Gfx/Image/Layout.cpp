@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <Stuff/Graphics/Tiles.hpp>
+
+using namespace Stf::Gfx;
+
+using BenchTraits = ColorTraits<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+
+template<typename Layout>
+using BenchImage = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB, BenchTraits, std::allocator<BenchTraits::color_type>, Layout>;
+
+/// 16 MiB per image, well over the last level cache
+static constexpr Stf::Vector<size_t, 2> image_dimensions { 2048, 2048 };
+
+/// The same traversal block for every layout so that only the addressing differs
+static constexpr Stf::Vector<size_t, 2> block_dimensions { 64, 64 };
+
+static void set_pixel_counters(benchmark::State& state) {
+    const auto pixels = image_dimensions[0] * image_dimensions[1];
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * pixels) / 1e6, benchmark::Counter::kIsRate);
+}
+
+template<typename Layout> static BenchImage<Layout> random_image() {
+    std::mt19937 engine { 1234 };
+
+    BenchImage<Layout> ret {};
+    ret.create(image_dimensions);
+    for (auto& pixel : ret.pixels())
+        pixel = std::bit_cast<BenchTraits::color_type>(static_cast<uint32_t>(engine()));
+
+    return ret;
+}
+
+/// Row by row, every write of the destination is a column walk
+static void benchmark_layout_transpose_rows(benchmark::State& state) {
+    const auto src = random_image<Layouts::Linear>();
+    BenchImage<Layouts::Linear> dst {};
+    dst.create(image_dimensions);
+
+    for (auto _ : state) {
+        for (auto y = 0uz; y < image_dimensions[1]; y++)
+            for (auto x = 0uz; x < image_dimensions[0]; x++)
+                dst[{ y, x }] = src[{ x, y }];
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK(benchmark_layout_transpose_rows);
+
+template<typename Layout> static void benchmark_layout_transpose(benchmark::State& state) {
+    const auto src = random_image<Layout>();
+    BenchImage<Layout> dst {};
+    dst.create(image_dimensions);
+
+    for (auto _ : state) {
+        for (const auto tile : src.tiles(block_dimensions)) {
+            const auto [x0, y0] = tile.origin;
+            for (auto y = y0; y < y0 + tile.extent[1]; y++)
+                for (auto x = x0; x < x0 + tile.extent[0]; x++)
+                    dst[{ y, x }] = src[{ x, y }];
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK_TEMPLATE(benchmark_layout_transpose, Layouts::Linear);
+BENCHMARK_TEMPLATE(benchmark_layout_transpose, Layouts::Tiled<8>);
+BENCHMARK_TEMPLATE(benchmark_layout_transpose, Layouts::Tiled<64>);
+BENCHMARK_TEMPLATE(benchmark_layout_transpose, Layouts::Morton);
+
+/// 3x3 box filter of the interior
+template<typename Layout> static void benchmark_layout_box3x3(benchmark::State& state) {
+    const auto src = random_image<Layout>();
+    BenchImage<Layout> dst {};
+    dst.create(image_dimensions);
+
+    for (auto _ : state) {
+        for (const auto tile : src.tiles(block_dimensions)) {
+            const auto [x0, y0] = tile.origin;
+            for (auto y = std::max<size_t>(y0, 1); y < std::min(y0 + tile.extent[1], image_dimensions[1] - 1); y++) {
+                for (auto x = std::max<size_t>(x0, 1); x < std::min(x0 + tile.extent[0], image_dimensions[0] - 1); x++) {
+                    std::array<uint32_t, 4> sum {};
+                    for (auto dy = 0uz; dy < 3; dy++)
+                        for (auto dx = 0uz; dx < 3; dx++) {
+                            const auto pixel = src[{ x + dx - 1, y + dy - 1 }];
+                            for (auto c = 0uz; c < 4; c++)
+                                sum[c] += pixel[c];
+                        }
+
+                    BenchTraits::color_type out;
+                    for (auto c = 0uz; c < 4; c++)
+                        out[c] = static_cast<uint8_t>(sum[c] / 9);
+                    dst[{ x, y }] = out;
+                }
+            }
+        }
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK_TEMPLATE(benchmark_layout_box3x3, Layouts::Linear);
+BENCHMARK_TEMPLATE(benchmark_layout_box3x3, Layouts::Tiled<8>);
+BENCHMARK_TEMPLATE(benchmark_layout_box3x3, Layouts::Tiled<64>);
+BENCHMARK_TEMPLATE(benchmark_layout_box3x3, Layouts::Morton);
+
+template<typename DstLayout> static void benchmark_layout_relayout(benchmark::State& state) {
+    const auto src = random_image<Layouts::Linear>();
+    Stf::ThreadPool pool(0);
+    BenchImage<DstLayout> dst {};
+    dst.create(image_dimensions);
+
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(relayout(src, dst, pool));
+        benchmark::DoNotOptimize(dst.data());
+    }
+
+    set_pixel_counters(state);
+}
+BENCHMARK_TEMPLATE(benchmark_layout_relayout, Layouts::Tiled<8>);
+BENCHMARK_TEMPLATE(benchmark_layout_relayout, Layouts::Tiled<64>);
+BENCHMARK_TEMPLATE(benchmark_layout_relayout, Layouts::Morton);
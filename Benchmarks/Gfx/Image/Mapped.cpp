@@ -0,0 +1,124 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/Mapped.hpp>
+
+#define DO_ASSERT(expr)                        \
+    {                                          \
+        for (bool _res = bool(expr); !_res;) { \
+            std::abort();                      \
+        }                                      \
+    }
+
+using raw_image_type = Stf::Gfx::NewImage<Stf::Gfx::ColorFormat::RGBA8u, Stf::Gfx::ColorSpace::SRGB>;
+
+static constexpr const char* qoi_file = "Tests/Graphics/Images/dice.qoi";
+
+static void set_pixel_counters(benchmark::State& state, Stf::Vector<size_t, 2> dimensions) {
+    state.SetBytesProcessed(state.iterations() * dimensions[0] * dimensions[1] * 4);
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * dimensions[0] * dimensions[1]) / 1e6, benchmark::Counter::kIsRate);
+}
+
+/// dice.qoi tiled 4x4 (3200x2400) in a raw file in the temporary directory, written once
+static std::string const& raw_file() {
+    static const auto filename = [] {
+        std::ifstream ifs(qoi_file, std::ios::binary);
+        DO_ASSERT(ifs);
+        const std::vector<uint8_t> qoi_data(std::istreambuf_iterator<char> { ifs }, std::istreambuf_iterator<char>());
+
+        const auto tile = Stf::Gfx::Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+        DO_ASSERT(tile);
+
+        const auto [w, h] = tile->dimensions();
+        raw_image_type image {};
+        image.create({ w * 4, h * 4 });
+        for (size_t y = 0; y < h * 4; y++)
+            for (size_t x = 0; x < w * 4; x++)
+                image[{ x, y }] = tile->get_pixel(x % w, y % h);
+
+        auto ret = (std::filesystem::temp_directory_path() / "libstuff_benchmark_large.raw").string();
+        std::ofstream ofs(ret, std::ios::binary);
+        DO_ASSERT(ofs);
+        Stf::Gfx::Formats::Raw::encode(std::ostreambuf_iterator<char>(ofs), image);
+
+        return ret;
+    }();
+
+    return filename;
+}
+
+/// Sums a byte of every cache line, reading the image is part of loading it when the pixels are paged in lazily
+static size_t touch(raw_image_type const& image) {
+    size_t sum = 0;
+    for (size_t i = 0; i < image.size(); i += 64)
+        sum += image.data()[i];
+
+    return sum;
+}
+
+/// Reads the whole file through a stream and decodes the copy
+static void benchmark_qoi_load_ifstream(benchmark::State& state) {
+    Stf::Vector<size_t, 2> dimensions {};
+
+    for (auto _ : state) {
+        std::ifstream ifs(qoi_file, std::ios::binary);
+        const std::vector<uint8_t> qoi_data(std::istreambuf_iterator<char> { ifs }, std::istreambuf_iterator<char>());
+
+        const auto res = Stf::Gfx::Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+        DO_ASSERT(res);
+        dimensions = res->dimensions();
+        benchmark::DoNotOptimize(res->data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_qoi_load_ifstream);
+
+static void benchmark_qoi_load_mapped(benchmark::State& state) {
+    Stf::Vector<size_t, 2> dimensions {};
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::QoI::load(qoi_file);
+        DO_ASSERT(res);
+        dimensions = res->dimensions();
+        benchmark::DoNotOptimize(res->data());
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_qoi_load_mapped);
+
+static void benchmark_raw_load_copy(benchmark::State& state) {
+    const auto& filename = raw_file();
+    Stf::Vector<size_t, 2> dimensions {};
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::Raw::load<Stf::Gfx::ColorFormat::RGBA8u, Stf::Gfx::ColorSpace::SRGB>(filename);
+        DO_ASSERT(res);
+        dimensions = res->dimensions();
+        benchmark::DoNotOptimize(touch(*res));
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_raw_load_copy);
+
+static void benchmark_raw_mapped(benchmark::State& state) {
+    const auto& filename = raw_file();
+    Stf::Vector<size_t, 2> dimensions {};
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::MappedImage<Stf::Gfx::ColorFormat::RGBA8u, Stf::Gfx::ColorSpace::SRGB>::open(filename);
+        DO_ASSERT(res);
+        dimensions = (*res)->dimensions();
+        benchmark::DoNotOptimize(touch(**res));
+    }
+
+    set_pixel_counters(state, dimensions);
+}
+BENCHMARK(benchmark_raw_mapped);
@@ -0,0 +1,42 @@
+#include <benchmark/benchmark.h>
+
+#include <Stuff/Graphics/BufferPool.hpp>
+#include <Stuff/Graphics/Image.hpp>
+
+using namespace Stf::Gfx;
+
+/// A frame is created, filled and handed on, as in a decode -> process -> encode pipeline
+template<typename Allocator> static void benchmark_pool_frames(benchmark::State& state) {
+    for (auto _ : state) {
+        Image<Allocator> frame(1920, 1080);
+        frame.fill(Colors::black);
+        benchmark::DoNotOptimize(frame.data());
+    }
+
+    state.counters["frames/s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(benchmark_pool_frames, std::allocator<uint8_t>)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(benchmark_pool_frames, PooledAllocator<uint8_t>)->Unit(benchmark::kMicrosecond);
+
+/// Several stages keeping a reference to the same frame, only the last one modifies it
+static void benchmark_pool_fanout_copy(benchmark::State& state) {
+    const Image<> frame(1920, 1080, Colors::black);
+
+    for (auto _ : state) {
+        std::array<Image<>, 4> stages { frame, frame, frame, frame };
+        stages.back().set_pixel(0, { 1, 2, 3, 4 });
+        benchmark::DoNotOptimize(stages.back().data());
+    }
+}
+BENCHMARK(benchmark_pool_fanout_copy)->Unit(benchmark::kMicrosecond);
+
+static void benchmark_pool_fanout_shared(benchmark::State& state) {
+    const SharedImage<PooledAllocator<uint8_t>> frame { Image<PooledAllocator<uint8_t>>(1920, 1080, Colors::black) };
+
+    for (auto _ : state) {
+        std::array<SharedImage<PooledAllocator<uint8_t>>, 4> stages { frame, frame, frame, frame };
+        stages.back().write().set_pixel(0, { 1, 2, 3, 4 });
+        benchmark::DoNotOptimize(stages.back()->data());
+    }
+}
+BENCHMARK(benchmark_pool_fanout_shared)->Unit(benchmark::kMicrosecond);
@@ -2,10 +2,12 @@
 
 #include <fstream>
 #include <random>
+#include <sstream>
 
 #include <fmt/format.h>
 
 #include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/QoIStriped.hpp>
 
 #define DO_ASSERT(expr)                        \
     {                                          \
@@ -14,11 +16,21 @@
         }                                      \
     }
 
-static void benchmark_decode_generic(benchmark::State& state, size_t width, size_t height, const char* file) {
+static std::vector<uint8_t> read_file(const char* file) {
     std::ifstream image_ifs(file, std::ios::binary | std::ios::in);
     DO_ASSERT(image_ifs);
 
-    std::vector<uint8_t> qoi_data(std::istreambuf_iterator<char> { image_ifs }, std::istreambuf_iterator<char>());
+    return std::vector<uint8_t>(std::istreambuf_iterator<char> { image_ifs }, std::istreambuf_iterator<char>());
+}
+
+static void set_pixel_counters(benchmark::State& state, size_t width, size_t height) {
+    state.SetBytesProcessed(state.iterations() * width * height * 4);
+    state.counters["MP/s"] = benchmark::Counter(static_cast<double>(state.iterations() * width * height) / 1e6, benchmark::Counter::kIsRate);
+}
+
+/// Contiguous input, goes through the unchecked fast path
+static void benchmark_decode_generic(benchmark::State& state, size_t width, size_t height, const char* file) {
+    const auto qoi_data = read_file(file);
     Stf::Gfx::Image image(width, height);
 
     for (auto _ : state) {
@@ -26,13 +38,168 @@ static void benchmark_decode_generic(benchmark::State& state, size_t width, size
 #ifndef NDEBUG
         DO_ASSERT(res)
 #endif
+        benchmark::DoNotOptimize(image.data());
     }
+
+    set_pixel_counters(state, width, height);
+}
+
+/// Input iterators, everything goes through the checked path
+static void benchmark_decode_stream_generic(benchmark::State& state, size_t width, size_t height, const char* file) {
+    const auto qoi_data = read_file(file);
+    const std::string qoi_string(qoi_data.begin(), qoi_data.end());
+    Stf::Gfx::Image image(width, height);
+
+    for (auto _ : state) {
+        std::istringstream iss(qoi_string);
+        const auto res = Stf::Gfx::Formats::QoI::decode(std::istreambuf_iterator<char>(iss), std::istreambuf_iterator<char>(), image);
+#ifndef NDEBUG
+        DO_ASSERT(res)
+#endif
+        benchmark::DoNotOptimize(image.data());
+    }
+
+    set_pixel_counters(state, width, height);
 }
 
 static void benchmark_qoi_dice(benchmark::State& state) { benchmark_decode_generic(state, 800, 600, "Tests/Graphics/Images/dice.qoi"); }
 BENCHMARK(benchmark_qoi_dice);
+static void benchmark_qoi_dice_stream(benchmark::State& state) { benchmark_decode_stream_generic(state, 800, 600, "Tests/Graphics/Images/dice.qoi"); }
+BENCHMARK(benchmark_qoi_dice_stream);
 static void benchmark_qoi_testcard(benchmark::State& state) { benchmark_decode_generic(state, 256, 256, "Tests/Graphics/Images/testcard.qoi"); }
 BENCHMARK(benchmark_qoi_testcard);
+static void benchmark_qoi_testcard_rgba(benchmark::State& state) { benchmark_decode_generic(state, 256, 256, "Tests/Graphics/Images/testcard_rgba.qoi"); }
+BENCHMARK(benchmark_qoi_testcard_rgba);
+
+/// 64 KiB input chunks, one row of output at a time
+static void benchmark_qoi_stream_decode(benchmark::State& state) {
+    const auto qoi_data = read_file("Tests/Graphics/Images/dice.qoi");
+    std::vector<uint8_t> row(800 * 4);
+
+    for (auto _ : state) {
+        Stf::Gfx::Formats::QoI::StreamDecoder decoder {};
+
+        for (size_t in_pos = 0; !decoder.finished();) {
+            const auto progress = decoder.decode(std::span(qoi_data).subspan(in_pos, std::min<size_t>(65536, qoi_data.size() - in_pos)), row);
+            DO_ASSERT(progress);
+            in_pos += progress->consumed;
+            benchmark::DoNotOptimize(row.data());
+        }
+    }
+
+    set_pixel_counters(state, 800, 600);
+}
+BENCHMARK(benchmark_qoi_stream_decode);
+
+/// One row of input at a time, 64 KiB output chunks
+static void benchmark_qoi_stream_encode(benchmark::State& state) {
+    const auto qoi_data = read_file("Tests/Graphics/Images/dice.qoi");
+    const auto image = Stf::Gfx::Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+    DO_ASSERT(image);
+
+    const auto header = Stf::Gfx::Detail::Image::QoI::Header::from_image(*image);
+    const std::span<const uint8_t> pixels(image->data(), image->size());
+    std::vector<uint8_t> out(65536);
+
+    for (auto _ : state) {
+        Stf::Gfx::Formats::QoI::StreamEncoder encoder { *header };
+
+        for (size_t in_pos = 0; !encoder.finished();) {
+            const auto progress = encoder.encode(pixels.subspan(in_pos, std::min<size_t>(800 * 4, pixels.size() - in_pos)), out);
+            in_pos += progress.consumed;
+            benchmark::DoNotOptimize(out.data());
+        }
+    }
+
+    set_pixel_counters(state, 800, 600);
+}
+BENCHMARK(benchmark_qoi_stream_encode);
+
+static void benchmark_qoi_encode_dice(benchmark::State& state) {
+    const auto qoi_data = read_file("Tests/Graphics/Images/dice.qoi");
+    const auto image = Stf::Gfx::Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+    DO_ASSERT(image);
+
+    std::vector<uint8_t> out(qoi_data.size() * 2);
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::QoI::encode(out.data(), *image);
+        DO_ASSERT(res);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_pixel_counters(state, 800, 600);
+}
+BENCHMARK(benchmark_qoi_encode_dice);
+
+/// dice.qoi tiled 4x4, 3200x2400
+static Stf::Gfx::Image<> const& large_image() {
+    static const auto image = [] {
+        const auto qoi_data = read_file("Tests/Graphics/Images/dice.qoi");
+        const auto tile = Stf::Gfx::Formats::QoI::decode(qoi_data.begin(), qoi_data.end());
+        DO_ASSERT(tile);
+
+        const auto [w, h] = tile->dimensions();
+        Stf::Gfx::Image<> ret(w * 4, h * 4);
+        for (size_t y = 0; y < h * 4; y++)
+            for (size_t x = 0; x < w * 4; x++)
+                ret.set_pixel(x, y, tile->get_pixel(x % w, y % h));
+
+        return ret;
+    }();
+
+    return image;
+}
+
+/// Arg: thread count, including the calling thread
+static void benchmark_qoi_striped_encode(benchmark::State& state) {
+    const auto& image = large_image();
+    Stf::ThreadPool pool(state.range(0) - 1);
+    std::vector<uint8_t> out(14 + 4 + image.pixel_count() * 5 + 8);
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::QoI::encode_striped(out.begin(), image, Stf::Gfx::Formats::QoI::default_stripe_height, pool);
+        DO_ASSERT(res);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_pixel_counters(state, image.dimensions()[0], image.dimensions()[1]);
+}
+BENCHMARK(benchmark_qoi_striped_encode)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+static void benchmark_qoi_striped_decode(benchmark::State& state) {
+    const auto& source = large_image();
+    Stf::ThreadPool pool(state.range(0) - 1);
+
+    std::vector<uint8_t> striped {};
+    DO_ASSERT(Stf::Gfx::Formats::QoI::encode_striped(back_inserter(striped), source, Stf::Gfx::Formats::QoI::default_stripe_height, pool));
+
+    Stf::Gfx::Image<> image(source.dimensions()[0], source.dimensions()[1]);
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::QoI::decode_striped(striped, image, pool);
+        DO_ASSERT(res);
+        benchmark::DoNotOptimize(image.data());
+    }
+
+    set_pixel_counters(state, source.dimensions()[0], source.dimensions()[1]);
+}
+BENCHMARK(benchmark_qoi_striped_decode)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+/// Plain QoI on the same image for reference
+static void benchmark_qoi_plain_encode(benchmark::State& state) {
+    const auto& image = large_image();
+    std::vector<uint8_t> out(14 + image.pixel_count() * 5 + 8);
+
+    for (auto _ : state) {
+        const auto res = Stf::Gfx::Formats::QoI::encode(out.begin(), image);
+        DO_ASSERT(res);
+        benchmark::DoNotOptimize(out.data());
+    }
+
+    set_pixel_counters(state, image.dimensions()[0], image.dimensions()[1]);
+}
+BENCHMARK(benchmark_qoi_plain_encode)->UseRealTime();
 
 static uint8_t default_alpha_decider(uint8_t) { return 255; }
 
@@ -61,6 +228,8 @@ static void benchmark_encode_generic(benchmark::State& state, size_t width, size
             DO_ASSERT(res);
         }
     }
+
+    set_pixel_counters(state, width, height * random_images.size());
 }
 
 static void benchmark_encode_random(benchmark::State& state) {
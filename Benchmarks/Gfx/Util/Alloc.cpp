@@ -1,10 +1,18 @@
 #include <benchmark/benchmark.h>
 
 #include <array>
+#include <condition_variable>
+#include <list>
+#include <memory_resource>
+#include <mutex>
 #include <random>
+#include <thread>
 #include <unordered_map>
 
 #include <Stuff/Util/Alloc.hpp>
+#include <Stuff/Util/Arena.hpp>
+#include <Stuff/Util/Resource.hpp>
+#include <Stuff/Util/Slab.hpp>
 
 static std::array<std::byte, 1024 * 1024 * 512> s_bump_allocator_container;
 
@@ -41,6 +49,32 @@ static void benchmark_bump_single_size(benchmark::State& state) {
 }
 BENCHMARK(benchmark_bump_single_size);
 
+static void benchmark_arena_single_size(benchmark::State& state) {
+    Stf::Arena arena {};
+    Stf::ArenaAllocator<int> alloc { arena };
+    for (auto _ : state) {
+        arena.reset();
+        allocate_single_size(alloc);
+    }
+}
+BENCHMARK(benchmark_arena_single_size);
+
+static void benchmark_shared_arena_single_size(benchmark::State& state) {
+    Stf::SharedArena arena {};
+    Stf::ArenaAllocator<int, Stf::SharedArena> alloc { arena };
+    for (auto _ : state) {
+        arena.reset();
+        allocate_single_size(alloc);
+    }
+}
+BENCHMARK(benchmark_shared_arena_single_size);
+
+static void benchmark_slab_single_size(benchmark::State& state) {
+    for (auto _ : state)
+        allocate_single_size<Stf::SlabAllocator<int>>();
+}
+BENCHMARK(benchmark_slab_single_size);
+
 static void benchmark_std_single_size(benchmark::State& state) {
     std::allocator<int> alloc {};
 
@@ -85,6 +119,22 @@ static void benchmark_bump_mixed_size(benchmark::State& state) {
 }
 BENCHMARK(benchmark_bump_mixed_size);
 
+static void benchmark_arena_mixed_size(benchmark::State& state) {
+    Stf::Arena arena {};
+    Stf::ArenaAllocator<int> alloc { arena };
+    for (auto _ : state) {
+        arena.reset();
+        allocate_mixed_sizes(alloc);
+    }
+}
+BENCHMARK(benchmark_arena_mixed_size);
+
+static void benchmark_slab_mixed_size(benchmark::State& state) {
+    for (auto _ : state)
+        allocate_mixed_sizes<Stf::SlabAllocator<int>>();
+}
+BENCHMARK(benchmark_slab_mixed_size);
+
 static void benchmark_std_mixed_size(benchmark::State& state) {
     std::allocator<int> alloc {};
 
@@ -92,4 +142,197 @@ static void benchmark_std_mixed_size(benchmark::State& state) {
         allocate_mixed_sizes(alloc);
     }
 }
-BENCHMARK(benchmark_std_mixed_size);
\ No newline at end of file
+BENCHMARK(benchmark_std_mixed_size);
+
+/// The allocations made while serving a request: a few dozen small objects, all freed when the request is done
+template<typename Fn> static void serve_request(Fn&& allocate) {
+    std::array<void*, 48> objects;
+    for (auto i = 0uz; i < objects.size(); i++)
+        objects[i] = allocate(16 + (i * 37) % 240);
+
+    benchmark::DoNotOptimize(objects);
+}
+
+static void benchmark_std_requests(benchmark::State& state) {
+    for (auto _ : state) {
+        std::array<std::pair<void*, size_t>, 48> objects;
+        auto i = 0uz;
+        serve_request([&](size_t size) { return (objects[i++] = { ::operator new(size), size }).first; });
+
+        for (auto const& [p, size] : objects)
+            ::operator delete(p, size);
+    }
+}
+BENCHMARK(benchmark_std_requests);
+
+static void benchmark_arena_requests(benchmark::State& state) {
+    auto& arena = Stf::Arena::local();
+
+    for (auto _ : state) {
+        Stf::ArenaScope scope(arena);
+        serve_request([&](size_t size) { return arena.allocate(size); });
+    }
+}
+BENCHMARK(benchmark_arena_requests);
+
+/// A working set of objects of 16 to 512 bytes where a random one is replaced at every step
+template<typename Allocator> static void churn_mixed_sizes(benchmark::State& state) {
+    Allocator alloc {};
+
+    std::mt19937 engine { 1234 };
+    std::array<std::pair<std::byte*, size_t>, 4096> live {};
+    for (auto& [p, size] : live)
+        p = alloc.allocate(size = 16 + engine() % 497);
+
+    for (auto _ : state) {
+        for (auto i = 0; i < 1024; i++) {
+            auto& [p, size] = live[engine() % live.size()];
+            alloc.deallocate(p, size);
+            p = alloc.allocate(size = 16 + engine() % 497);
+        }
+        benchmark::DoNotOptimize(live);
+    }
+
+    for (auto const& [p, size] : live)
+        alloc.deallocate(p, size);
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1024));
+}
+
+static void benchmark_std_churn(benchmark::State& state) { churn_mixed_sizes<std::allocator<std::byte>>(state); }
+BENCHMARK(benchmark_std_churn);
+
+static void benchmark_slab_churn(benchmark::State& state) { churn_mixed_sizes<Stf::SlabAllocator<std::byte>>(state); }
+BENCHMARK(benchmark_slab_churn);
+
+/// Objects allocated on the benchmark thread and freed on another, as with a queue between a producer and a consumer
+template<typename Allocator> static void free_on_other_thread(benchmark::State& state) {
+    using pointer_type = typename Allocator::value_type*;
+    static constexpr size_t batch_size = 4096;
+
+    Allocator alloc {};
+    std::array<pointer_type, batch_size> batch {};
+
+    std::mutex mutex {};
+    std::condition_variable cv {};
+    bool batch_ready = false;
+    bool stopping = false;
+
+    std::thread consumer([&] {
+        for (;;) {
+            std::unique_lock lock { mutex };
+            cv.wait(lock, [&] { return batch_ready || stopping; });
+            if (!batch_ready)
+                return;
+
+            for (auto* p : batch)
+                alloc.deallocate(p, 1);
+
+            batch_ready = false;
+            cv.notify_one();
+        }
+    });
+
+    for (auto _ : state) {
+        std::unique_lock lock { mutex };
+        cv.wait(lock, [&] { return !batch_ready; });
+
+        for (auto& p : batch)
+            p = alloc.allocate(1);
+
+        batch_ready = true;
+        cv.notify_one();
+    }
+
+    {
+        std::unique_lock lock { mutex };
+        cv.wait(lock, [&] { return !batch_ready; });
+        stopping = true;
+        cv.notify_one();
+    }
+    consumer.join();
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * batch_size));
+}
+
+using node_type = std::array<std::byte, 48>;
+
+static void benchmark_std_cross_thread(benchmark::State& state) { free_on_other_thread<std::allocator<node_type>>(state); }
+BENCHMARK(benchmark_std_cross_thread)->UseRealTime();
+
+static void benchmark_slab_cross_thread(benchmark::State& state) { free_on_other_thread<Stf::SlabAllocator<node_type>>(state); }
+BENCHMARK(benchmark_slab_cross_thread)->UseRealTime();
+
+template<typename Allocator> static void list_nodes(benchmark::State& state) {
+    std::list<int, Allocator> list {};
+
+    for (auto _ : state) {
+        for (auto i = 0; i < 1024; i++)
+            list.push_back(i);
+        benchmark::DoNotOptimize(list.back());
+        list.clear();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1024));
+}
+
+static void benchmark_std_list_nodes(benchmark::State& state) { list_nodes<std::allocator<int>>(state); }
+BENCHMARK(benchmark_std_list_nodes);
+
+static void benchmark_slab_list_nodes(benchmark::State& state) { list_nodes<Stf::SlabAllocator<int>>(state); }
+BENCHMARK(benchmark_slab_list_nodes);
+
+/// The same list through a memory resource, `reset` is called on it after every round if it has one
+template<typename Resource> static void pmr_list_nodes(benchmark::State& state, Resource& resource, std::pmr::memory_resource* memory) {
+    std::pmr::list<int> list(memory);
+
+    for (auto _ : state) {
+        for (auto i = 0; i < 1024; i++)
+            list.push_back(i);
+        benchmark::DoNotOptimize(list.back());
+        list.clear();
+
+        if constexpr (requires { resource.reset(); })
+            resource.reset();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 1024));
+}
+
+static void benchmark_pmr_new_delete_list_nodes(benchmark::State& state) {
+    auto* const resource = std::pmr::new_delete_resource();
+    pmr_list_nodes(state, *resource, resource);
+}
+BENCHMARK(benchmark_pmr_new_delete_list_nodes);
+
+static void benchmark_pmr_pool_list_nodes(benchmark::State& state) {
+    std::pmr::unsynchronized_pool_resource resource {};
+    pmr_list_nodes(state, resource, &resource);
+}
+BENCHMARK(benchmark_pmr_pool_list_nodes);
+
+static void benchmark_pmr_arena_list_nodes(benchmark::State& state) {
+    Stf::ArenaResource resource {};
+    pmr_list_nodes(state, resource, &resource);
+}
+BENCHMARK(benchmark_pmr_arena_list_nodes);
+
+static void benchmark_pmr_slab_list_nodes(benchmark::State& state) {
+    Stf::SlabResource resource {};
+    pmr_list_nodes(state, resource, &resource);
+}
+BENCHMARK(benchmark_pmr_slab_list_nodes);
+
+static void benchmark_pmr_slab_stats_list_nodes(benchmark::State& state) {
+    Stf::SlabResource slab {};
+    Stf::StatsResource resource(&slab);
+    pmr_list_nodes(state, slab, resource.resource());
+}
+BENCHMARK(benchmark_pmr_slab_stats_list_nodes);
+
+static void benchmark_pmr_slab_stats_disabled_list_nodes(benchmark::State& state) {
+    Stf::SlabResource slab {};
+    Stf::StatsResource<false> resource(&slab);
+    pmr_list_nodes(state, slab, resource.resource());
+}
+BENCHMARK(benchmark_pmr_slab_stats_disabled_list_nodes);
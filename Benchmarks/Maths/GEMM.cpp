@@ -0,0 +1,97 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <Stuff/Maths/BLAS/Dynamic.hpp>
+
+template<typename T> static Stf::DynMatrix<T> random_matrix(size_t rows, size_t cols) {
+    std::mt19937_64 gen(rows * 31 + cols);
+    std::uniform_real_distribution<T> dist(-1, 1);
+
+    Stf::DynMatrix<T> ret(rows, cols);
+    for (auto i = 0uz; i < rows; i++)
+        for (auto j = 0uz; j < cols; j++)
+            ret.at(i, j) = dist(gen);
+
+    return ret;
+}
+
+template<typename T> static void gemm_generic(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+
+    const auto a = random_matrix<T>(n, n);
+    const auto b = random_matrix<T>(n, n);
+    Stf::DynMatrix<T> c(n, n);
+
+    for (auto _ : state) {
+        Stf::gemm(T { 1 }, a, b, T {}, c);
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["GFLOP"] = benchmark::Counter(2. * n * n * n * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template<typename T> static void gemm_naive_generic(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+
+    const auto a = random_matrix<T>(n, n);
+    const auto b = random_matrix<T>(n, n);
+    Stf::DynMatrix<T> c(n, n);
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < n; i++)
+            for (auto j = 0uz; j < n; j++) {
+                T sum = 0;
+                for (auto k = 0uz; k < n; k++)
+                    sum += a.at(i, k) * b.at(k, j);
+                c.at(i, j) = sum;
+            }
+        benchmark::DoNotOptimize(c.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["GFLOP"] = benchmark::Counter(2. * n * n * n * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template<typename T> static void gemv_generic(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+
+    const auto a = random_matrix<T>(n, n);
+    const auto x_mat = random_matrix<T>(n, 1);
+    const Stf::DynVector<T> x(std::span<const T>(x_mat.data(), n));
+    Stf::DynVector<T> y(n);
+
+    for (auto _ : state) {
+        Stf::gemv(T { 1 }, a, x, T {}, y);
+        benchmark::DoNotOptimize(y.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["GFLOP"] = benchmark::Counter(2. * n * n * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+template<typename T> static void lu_generic(benchmark::State& state) {
+    const auto n = static_cast<size_t>(state.range(0));
+    const auto a = random_matrix<T>(n, n);
+
+    for (auto _ : state) {
+        auto lu = Stf::lu_decompose(a);
+        benchmark::DoNotOptimize(lu);
+    }
+
+    state.counters["GFLOP"] = benchmark::Counter(2. / 3. * n * n * n * 1e-9, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+static void gemm_f32(benchmark::State& state) { return gemm_generic<float>(state); }
+BENCHMARK(gemm_f32)->RangeMultiplier(2)->Range(64, 2048)->UseRealTime();
+static void gemm_f64(benchmark::State& state) { return gemm_generic<double>(state); }
+BENCHMARK(gemm_f64)->RangeMultiplier(2)->Range(64, 2048)->UseRealTime();
+static void gemm_naive_f32(benchmark::State& state) { return gemm_naive_generic<float>(state); }
+BENCHMARK(gemm_naive_f32)->RangeMultiplier(2)->Range(64, 512)->UseRealTime();
+
+static void gemv_f32(benchmark::State& state) { return gemv_generic<float>(state); }
+BENCHMARK(gemv_f32)->RangeMultiplier(4)->Range(64, 8192)->UseRealTime();
+
+static void lu_f64(benchmark::State& state) { return lu_generic<double>(state); }
+BENCHMARK(lu_f64)->RangeMultiplier(2)->Range(64, 1024)->UseRealTime();
@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <Stuff/Graphics/SRGB.hpp>
+#include <Stuff/IO/NTC.hpp>
+
+static std::vector<float> random_floats(size_t n, float lo, float hi) {
+    std::mt19937_64 gen(n);
+    std::uniform_real_distribution<float> dist(lo, hi);
+
+    std::vector<float> ret(n);
+    for (auto& v : ret)
+        v = dist(gen);
+
+    return ret;
+}
+
+template<auto Fn> static void direct_generic(benchmark::State& state, float lo, float hi) {
+    const auto in = random_floats(state.range(0), lo, hi);
+    std::vector<float> out(in.size());
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < in.size(); i++)
+            out[i] = Fn(in[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<auto& Table> static void lut_generic(benchmark::State& state, float lo, float hi) {
+    const auto in = random_floats(state.range(0), lo, hi);
+    std::vector<float> out(in.size());
+
+    for (auto _ : state) {
+        Table(in, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void srgb_to_linear_direct(benchmark::State& state) {
+    direct_generic<[](float v) { return Stf::Gfx::SRGB::to_linear(v); }>(state, 0.f, 1.f);
+}
+BENCHMARK(srgb_to_linear_direct)->Range(1 << 10, 1 << 16);
+static void srgb_to_linear_lut(benchmark::State& state) { lut_generic<Stf::Gfx::SRGB::to_linear_lut<>>(state, 0.f, 1.f); }
+BENCHMARK(srgb_to_linear_lut)->Range(1 << 10, 1 << 16);
+
+static void srgb_from_linear_direct(benchmark::State& state) {
+    direct_generic<[](float v) { return Stf::Gfx::SRGB::from_linear(v); }>(state, 0.f, 1.f);
+}
+BENCHMARK(srgb_from_linear_direct)->Range(1 << 10, 1 << 16);
+static void srgb_from_linear_lut(benchmark::State& state) { lut_generic<Stf::Gfx::SRGB::from_linear_lut<>>(state, 0.f, 1.f); }
+BENCHMARK(srgb_from_linear_lut)->Range(1 << 10, 1 << 16);
+
+static constexpr auto ntc_lut = Stf::NTC::divider_lut(Stf::NTC::Nominal::R10K, 10'000.f);
+
+static void ntc_direct(benchmark::State& state) {
+    direct_generic<[](float ratio) {
+        return Stf::NTC::calculate_ntc(Stf::NTC::Nominal::R10K, Stf::NTC::solve_voltage_divider(10'000.f, 1.f, ratio).second);
+    }>(state, 0.02f, 0.98f);
+}
+BENCHMARK(ntc_direct)->Range(1 << 10, 1 << 16);
+static void ntc_lut_span(benchmark::State& state) { lut_generic<ntc_lut>(state, 0.02f, 0.98f); }
+BENCHMARK(ntc_lut_span)->Range(1 << 10, 1 << 16);
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <Stuff/Maths/BLAS/QuatBatch.hpp>
+
+struct QuatBenchData {
+    explicit QuatBenchData(size_t n) {
+        std::mt19937_64 gen(n);
+        std::normal_distribution<float> dist {};
+        std::uniform_real_distribution<float> dist_t(0.f, 1.f);
+
+        for (auto* arr : { &a, &b, &out })
+            for (auto& v : *arr)
+                v.resize(n);
+        for (auto* arr : { &vec, &vec_out })
+            for (auto& v : *arr)
+                v.resize(n);
+        t.resize(n);
+
+        for (auto i = 0uz; i < n; i++) {
+            const auto q_a = Stf::Quaternion<float> { dist(gen), dist(gen), dist(gen), dist(gen) }.normalized();
+            const auto q_b = Stf::Quaternion<float> { dist(gen), dist(gen), dist(gen), dist(gen) }.normalized();
+            a[0][i] = q_a.x, a[1][i] = q_a.y, a[2][i] = q_a.z, a[3][i] = q_a.w;
+            b[0][i] = q_b.x, b[1][i] = q_b.y, b[2][i] = q_b.z, b[3][i] = q_b.w;
+            vec[0][i] = dist(gen), vec[1][i] = dist(gen), vec[2][i] = dist(gen);
+            t[i] = dist_t(gen);
+
+            aos_a.push_back(q_a);
+            aos_b.push_back(q_b);
+            aos_vec.push_back(Stf::vector(vec[0][i], vec[1][i], vec[2][i]));
+        }
+
+        aos_out.resize(n);
+        aos_vec_out.resize(n);
+    }
+
+    std::array<std::vector<float>, 4> a, b, out;
+    std::array<std::vector<float>, 3> vec, vec_out;
+    std::vector<float> t;
+
+    std::vector<Stf::Quaternion<float>> aos_a, aos_b, aos_out;
+    std::vector<Stf::Vector<float, 3>> aos_vec, aos_vec_out;
+
+    Stf::QuaternionSoA<float> soa_a() { return { a[0], a[1], a[2], a[3] }; }
+    Stf::QuaternionSoA<float> soa_b() { return { b[0], b[1], b[2], b[3] }; }
+    Stf::QuaternionSoA<float> soa_out() { return { out[0], out[1], out[2], out[3] }; }
+    Stf::Vector3SoA<float> soa_vec() { return { vec[0], vec[1], vec[2] }; }
+    Stf::Vector3SoA<float> soa_vec_out() { return { vec_out[0], vec_out[1], vec_out[2] }; }
+};
+
+static void quat_rotate_aos(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < data.aos_vec.size(); i++)
+            data.aos_vec_out[i] = data.aos_a[i].rotate(data.aos_vec[i]);
+        benchmark::DoNotOptimize(data.aos_vec_out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_rotate_aos)->Range(1 << 10, 1 << 20);
+
+static void quat_rotate_soa(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        Stf::rotate(data.soa_a(), data.soa_vec(), data.soa_vec_out());
+        benchmark::DoNotOptimize(data.vec_out[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_rotate_soa)->Range(1 << 10, 1 << 20);
+
+static void quat_multiply_aos(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < data.aos_a.size(); i++)
+            data.aos_out[i] = data.aos_a[i] * data.aos_b[i];
+        benchmark::DoNotOptimize(data.aos_out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_multiply_aos)->Range(1 << 10, 1 << 20);
+
+static void quat_multiply_soa(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        Stf::multiply(data.soa_a(), data.soa_b(), data.soa_out());
+        benchmark::DoNotOptimize(data.out[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_multiply_soa)->Range(1 << 10, 1 << 20);
+
+static void quat_slerp_aos(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < data.aos_a.size(); i++)
+            data.aos_out[i] = Stf::slerp(data.aos_a[i], data.aos_b[i], data.t[i]);
+        benchmark::DoNotOptimize(data.aos_out.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_slerp_aos)->Range(1 << 10, 1 << 20);
+
+static void quat_slerp_soa(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        Stf::slerp(data.soa_a(), data.soa_b(), data.t, data.soa_out());
+        benchmark::DoNotOptimize(data.out[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_slerp_soa)->Range(1 << 10, 1 << 20);
+
+static void quat_nlerp_soa(benchmark::State& state) {
+    QuatBenchData data(state.range(0));
+
+    for (auto _ : state) {
+        Stf::nlerp(data.soa_a(), data.soa_b(), data.t, data.soa_out());
+        benchmark::DoNotOptimize(data.out[0].data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(quat_nlerp_soa)->Range(1 << 10, 1 << 20);
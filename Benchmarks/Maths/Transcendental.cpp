@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <Stuff/Maths/Transcendental.hpp>
+
+static std::vector<float> random_floats(size_t n, float lo, float hi) {
+    std::mt19937_64 gen(n);
+    std::uniform_real_distribution<float> dist(lo, hi);
+
+    std::vector<float> ret(n);
+    for (auto& v : ret)
+        v = dist(gen);
+
+    return ret;
+}
+
+template<auto Fn> static void std_generic(benchmark::State& state, float lo, float hi) {
+    const auto in = random_floats(state.range(0), lo, hi);
+    std::vector<float> out(in.size());
+
+    for (auto _ : state) {
+        for (auto i = 0uz; i < in.size(); i++)
+            out[i] = Fn(in[i]);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<auto Fn> static void stf_generic(benchmark::State& state, float lo, float hi) {
+    const auto in = random_floats(state.range(0), lo, hi);
+    std::vector<float> out(in.size());
+
+    for (auto _ : state) {
+        Fn(in, out);
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void sin_std(benchmark::State& state) { std_generic<static_cast<float (*)(float)>(std::sin)>(state, -100.f, 100.f); }
+BENCHMARK(sin_std)->Range(1 << 10, 1 << 16);
+static void sin_stf(benchmark::State& state) { stf_generic<[](std::span<const float> in, std::span<float> out) { Stf::sin(in, out); }>(state, -100.f, 100.f); }
+BENCHMARK(sin_stf)->Range(1 << 10, 1 << 16);
+
+static void exp_std(benchmark::State& state) { std_generic<static_cast<float (*)(float)>(std::exp)>(state, -80.f, 80.f); }
+BENCHMARK(exp_std)->Range(1 << 10, 1 << 16);
+static void exp_stf(benchmark::State& state) { stf_generic<[](std::span<const float> in, std::span<float> out) { Stf::exp(in, out); }>(state, -80.f, 80.f); }
+BENCHMARK(exp_stf)->Range(1 << 10, 1 << 16);
+
+static void log_std(benchmark::State& state) { std_generic<static_cast<float (*)(float)>(std::log)>(state, 1e-3f, 1e3f); }
+BENCHMARK(log_std)->Range(1 << 10, 1 << 16);
+static void log_stf(benchmark::State& state) { stf_generic<[](std::span<const float> in, std::span<float> out) { Stf::log(in, out); }>(state, 1e-3f, 1e3f); }
+BENCHMARK(log_stf)->Range(1 << 10, 1 << 16);
+
+static void pow_std(benchmark::State& state) {
+    std_generic<[](float x) { return std::pow(x, 2.2f); }>(state, 0.f, 1.f);
+}
+BENCHMARK(pow_std)->Range(1 << 10, 1 << 16);
+static void pow_stf(benchmark::State& state) {
+    stf_generic<[](std::span<const float> in, std::span<float> out) { Stf::pow(in, 2.2f, out); }>(state, 0.f, 1.f);
+}
+BENCHMARK(pow_stf)->Range(1 << 10, 1 << 16);
@@ -0,0 +1,185 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <Stuff/Util/AsyncIO.hpp>
+#include <Stuff/Util/MMap.hpp>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#define DO_ASSERT(expr)                        \
+    {                                          \
+        for (bool _res = bool(expr); !_res;) { \
+            std::abort();                      \
+        }                                      \
+    }
+
+static constexpr size_t file_size = 256uz * 1024 * 1024;
+static constexpr size_t block_size = 4096;
+static constexpr size_t read_count = 16384;
+
+/// An asset or log segment sized file in the temporary directory
+static std::string const& data_file() {
+    static const auto filename = [] {
+        auto ret = (std::filesystem::temp_directory_path() / "libstuff_benchmark_async_io.bin").string();
+
+        std::mt19937_64 engine { 1234 };
+        std::vector<uint64_t> block(1024 * 1024 / sizeof(uint64_t));
+        std::ofstream ofs(ret, std::ios::binary);
+        DO_ASSERT(ofs);
+        for (auto written = 0uz; written < file_size; written += block.size() * sizeof(uint64_t)) {
+            for (auto& word : block)
+                word = engine();
+            ofs.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(uint64_t)));
+        }
+
+        return ret;
+    }();
+
+    return filename;
+}
+
+/// Offsets of the blocks that are read, the same ones for every benchmark
+static std::vector<size_t> const& read_offsets() {
+    static const auto offsets = [] {
+        std::mt19937_64 engine { 1234 };
+        std::vector<size_t> ret(read_count);
+        for (auto& offset : ret)
+            offset = engine() % (file_size / block_size) * block_size;
+        return ret;
+    }();
+
+    return offsets;
+}
+
+/// The file, dropped from the page cache before every iteration if the first argument is 1
+struct BenchmarkFile {
+    explicit BenchmarkFile(benchmark::State& state)
+        : m_state(state)
+        , m_fildes(open(data_file().c_str(), O_RDONLY)) {
+        DO_ASSERT(m_fildes >= 0);
+    }
+
+    ~BenchmarkFile() {
+        close(m_fildes);
+        m_state.SetItemsProcessed(static_cast<int64_t>(m_state.iterations() * read_count));
+        m_state.counters["IOPS"] = benchmark::Counter(static_cast<double>(m_state.iterations() * read_count), benchmark::Counter::kIsRate);
+    }
+
+    int fildes() const { return m_fildes; }
+
+    void evict() {
+        if (m_state.range(0) == 0)
+            return;
+
+        m_state.PauseTiming();
+        posix_fadvise(m_fildes, 0, 0, POSIX_FADV_DONTNEED);
+        m_state.ResumeTiming();
+    }
+
+private:
+    benchmark::State& m_state;
+    int m_fildes;
+};
+
+/// Arg: cold page cache. One page fault at a time
+static void benchmark_async_io_mmap(benchmark::State& state) {
+    BenchmarkFile file(state);
+
+    std::array<char, block_size> buffer;
+    for (auto _ : state) {
+        // mapped after the eviction, pages that are mapped are not dropped
+        file.evict();
+        const Stf::MMapStringView view(data_file(), true, { .access = Stf::MMapAccess::Random });
+        DO_ASSERT(view.data() != nullptr);
+
+        for (const auto offset : read_offsets()) {
+            std::memcpy(buffer.data(), view.data() + offset, block_size);
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+}
+BENCHMARK(benchmark_async_io_mmap)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_async_io_pread(benchmark::State& state) {
+    BenchmarkFile file(state);
+
+    std::array<char, block_size> buffer;
+    for (auto _ : state) {
+        file.evict();
+        for (const auto offset : read_offsets()) {
+            DO_ASSERT(pread(file.fildes(), buffer.data(), block_size, static_cast<off_t>(offset)) == block_size);
+            benchmark::DoNotOptimize(buffer.data());
+        }
+    }
+}
+BENCHMARK(benchmark_async_io_pread)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Keeps `io.queue_depth()` reads in flight, each completion issues the next read into the buffer it is done with
+static void read_all(Stf::AsyncIO& io, int fildes, std::vector<std::vector<char>>& buffers, bool fixed) {
+    const auto& offsets = read_offsets();
+    auto next = 0uz;
+
+    std::function<void(size_t)> issue = [&](size_t buffer) {
+        if (next == offsets.size())
+            return;
+
+        const auto offset = offsets[next++];
+        const auto callback = [&, buffer](int64_t result) {
+            DO_ASSERT(result == block_size);
+            issue(buffer);
+        };
+
+        if (fixed)
+            io.read_fixed(fildes, buffer, block_size, offset, callback);
+        else
+            io.read(fildes, buffers[buffer], offset, callback);
+    };
+
+    for (auto i = 0uz; i < buffers.size(); i++)
+        issue(i);
+
+    io.drain();
+}
+
+/// Args: cold page cache, queue depth
+static void benchmark_async_io_uring(benchmark::State& state) {
+    BenchmarkFile file(state);
+    Stf::AsyncIO io(static_cast<size_t>(state.range(1)));
+    if (io.backend() != Stf::AsyncIOBackend::IOUring) {
+        state.SkipWithError("io_uring is not available");
+        return;
+    }
+
+    std::vector<std::vector<char>> buffers(io.queue_depth(), std::vector<char>(block_size));
+    std::vector<std::span<char>> spans(buffers.begin(), buffers.end());
+    DO_ASSERT(io.register_buffers(spans));
+
+    for (auto _ : state) {
+        file.evict();
+        read_all(io, file.fildes(), buffers, true);
+    }
+}
+BENCHMARK(benchmark_async_io_uring)->ArgsProduct({ { 0, 1 }, { 1, 16, 64 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Args: cold page cache, queue depth, with as many threads
+static void benchmark_async_io_thread_pool(benchmark::State& state) {
+    BenchmarkFile file(state);
+    Stf::ThreadPool pool { static_cast<size_t>(state.range(1)) };
+    Stf::AsyncIO io(static_cast<size_t>(state.range(1)), false, pool);
+
+    std::vector<std::vector<char>> buffers(io.queue_depth(), std::vector<char>(block_size));
+
+    for (auto _ : state) {
+        file.evict();
+        read_all(io, file.fildes(), buffers, false);
+    }
+}
+BENCHMARK(benchmark_async_io_thread_pool)->ArgsProduct({ { 0, 1 }, { 16, 64 } })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,185 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <Stuff/Util/MMap.hpp>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+#define DO_ASSERT(expr)                        \
+    {                                          \
+        for (bool _res = bool(expr); !_res;) { \
+            std::abort();                      \
+        }                                      \
+    }
+
+static constexpr size_t file_size = 256uz * 1024 * 1024;
+
+/// A log sized file in the temporary directory, written once and then in the page cache
+static std::string const& log_file() {
+    static const auto filename = [] {
+        auto ret = (std::filesystem::temp_directory_path() / "libstuff_benchmark_log.bin").string();
+
+        std::mt19937_64 engine { 1234 };
+        std::vector<uint64_t> block(1024 * 1024 / sizeof(uint64_t));
+        std::ofstream ofs(ret, std::ios::binary);
+        DO_ASSERT(ofs);
+        for (auto written = 0uz; written < file_size; written += block.size() * sizeof(uint64_t)) {
+            for (auto& word : block)
+                word = engine();
+            ofs.write(reinterpret_cast<const char*>(block.data()), static_cast<std::streamsize>(block.size() * sizeof(uint64_t)));
+        }
+
+        return ret;
+    }();
+
+    return filename;
+}
+
+/// What a scan over a log does with every byte at the least
+static uint64_t scan(std::span<const char> bytes) {
+    uint64_t sum = 0;
+    for (auto i = 0uz; i + sizeof(uint64_t) <= bytes.size(); i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        sum += word;
+    }
+    return sum;
+}
+
+static void set_scan_counters(benchmark::State& state) { state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * file_size)); }
+
+/// With an argument of 1, drops the file from the page cache so that the scan reads it from the disk
+static void evict(benchmark::State& state, std::string const& filename) {
+    if (state.range(0) == 0)
+        return;
+
+    state.PauseTiming();
+    const auto fildes = open(filename.c_str(), O_RDONLY);
+    DO_ASSERT(fildes >= 0);
+    fdatasync(fildes);
+    posix_fadvise(fildes, 0, 0, POSIX_FADV_DONTNEED);
+    close(fildes);
+    state.ResumeTiming();
+}
+
+/// Maps the whole file and scans it, the mapping is part of what is measured
+static void scan_mapped(benchmark::State& state, Stf::MMapOptions const& options) {
+    const auto& filename = log_file();
+
+    for (auto _ : state) {
+        evict(state, filename);
+        const Stf::MMapStringView file(filename, true, options);
+        DO_ASSERT(file.data() != nullptr);
+        benchmark::DoNotOptimize(scan(file));
+    }
+
+    set_scan_counters(state);
+}
+
+/// Arg: cold page cache. Every page is faulted in as it is read
+static void benchmark_mmap_scan_default(benchmark::State& state) { scan_mapped(state, {}); }
+BENCHMARK(benchmark_mmap_scan_default)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_mmap_scan_sequential(benchmark::State& state) { scan_mapped(state, { .access = Stf::MMapAccess::Sequential, .will_need = true }); }
+BENCHMARK(benchmark_mmap_scan_sequential)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_mmap_scan_populate(benchmark::State& state) { scan_mapped(state, { .populate = true }); }
+BENCHMARK(benchmark_mmap_scan_populate)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void benchmark_mmap_scan_huge_pages(benchmark::State& state) { scan_mapped(state, { .populate = true, .huge_pages = true }); }
+BENCHMARK(benchmark_mmap_scan_huge_pages)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Args: cold page cache, window size in MiB, the next window is populated in the background while one is scanned
+static void benchmark_mmap_scan_windows(benchmark::State& state) {
+    const auto& filename = log_file();
+
+    for (auto _ : state) {
+        evict(state, filename);
+        Stf::MMapWindowedFile file(filename, static_cast<size_t>(state.range(1)) * 1024 * 1024);
+        DO_ASSERT(file.is_open());
+
+        uint64_t sum = 0;
+        for (auto i = 0uz; i < file.window_count(); i++)
+            sum += scan(file.window(i));
+        benchmark::DoNotOptimize(sum);
+    }
+
+    set_scan_counters(state);
+}
+BENCHMARK(benchmark_mmap_scan_windows)->ArgsProduct({ { 0, 1 }, { 4, 16, 64 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static constexpr size_t output_size = 64uz * 1024 * 1024;
+
+/// Records of a few sizes around that of a log line
+static std::vector<std::vector<char>> const& output_records() {
+    static const auto records = [] {
+        std::mt19937 engine { 1234 };
+        std::vector<std::vector<char>> ret(256);
+        for (auto& record : ret) {
+            record.resize(32 + engine() % 96);
+            for (auto& c : record)
+                c = static_cast<char>('a' + engine() % 26);
+        }
+        return ret;
+    }();
+
+    return records;
+}
+
+/// Writes the records into `write` over and over until `output_size` bytes are written into a fresh file
+template<typename Fn> static void write_records(benchmark::State& state, std::string const& filename, Fn&& write) {
+    const auto& records = output_records();
+
+    auto written = 0uz;
+    for (auto i = 0uz; written < output_size; i++) {
+        const auto& record = records[i % records.size()];
+        write(std::span<const char>(record));
+        written += record.size();
+    }
+
+    state.PauseTiming();
+    std::filesystem::remove(filename);
+    state.ResumeTiming();
+}
+
+static void set_output_counters(benchmark::State& state) { state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * output_size)); }
+
+static std::string output_file() { return (std::filesystem::temp_directory_path() / "libstuff_benchmark_output.bin").string(); }
+
+static void benchmark_mmap_write_ofstream(benchmark::State& state) {
+    const auto filename = output_file();
+    std::filesystem::remove(filename);
+
+    for (auto _ : state) {
+        std::ofstream ofs(filename, std::ios::binary);
+        write_records(state, filename, [&](std::span<const char> record) { ofs.write(record.data(), static_cast<std::streamsize>(record.size())); });
+    }
+
+    set_output_counters(state);
+}
+BENCHMARK(benchmark_mmap_write_ofstream)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+/// Args: initial capacity in MiB, whether the records are committed (synced to the disk) at the end
+static void benchmark_mmap_write_append(benchmark::State& state) {
+    const auto filename = output_file();
+    std::filesystem::remove(filename);
+
+    for (auto _ : state) {
+        auto file = Stf::MMapAppendFile::open(filename, static_cast<size_t>(state.range(0)) * 1024 * 1024);
+        DO_ASSERT(file);
+
+        write_records(state, filename, [&](std::span<const char> record) { std::ignore = file->append(record); });
+        if (state.range(1) != 0)
+            DO_ASSERT(file->commit());
+    }
+
+    set_output_counters(state);
+}
+BENCHMARK(benchmark_mmap_write_append)->ArgsProduct({ { 1, 64 }, { 0, 1 } })->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,52 @@
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <Stuff/Util/Memo.hpp>
+
+static constexpr size_t s_memo_capacity = 4096;
+
+/// A cheap stand-in for the geometry functions that are memoized, to have the cost be that of the cache
+template<template<typename, typename...> typename Base> struct Distance : Base<float, int, int, int> {
+    Distance()
+        : Base<float, int, int, int>(s_memo_capacity) { }
+
+protected:
+    float impl(int x, int y, int z) override { return std::sqrt(static_cast<float>(x * x + y * y + z * z)); }
+};
+
+/// Points drawn from `working_set` distinct ones, with the lower ones more likely
+static std::vector<std::array<int, 3>> make_points(size_t working_set) {
+    std::mt19937 engine { 1234 };
+    std::geometric_distribution<size_t> dist { 4. / static_cast<double>(working_set) };
+
+    std::vector<std::array<int, 3>> ret(16384);
+    for (auto& point : ret) {
+        const auto i = static_cast<int>(dist(engine) % working_set);
+        point = { i % 32, i / 32 % 32, i / 1024 };
+    }
+
+    return ret;
+}
+
+template<typename Memoizer> static void memoized_calls(benchmark::State& state) {
+    Memoizer memoizer {};
+    const auto points = make_points(static_cast<size_t>(state.range(0)));
+
+    for (auto _ : state) {
+        for (auto const& [x, y, z] : points)
+            benchmark::DoNotOptimize(memoizer(x, y, z));
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+    state.counters["hit_rate"] = static_cast<double>(memoizer.memo_calls()) / static_cast<double>(memoizer.all_calls());
+}
+
+static void benchmark_memo_list(benchmark::State& state) { memoized_calls<Distance<Stf::Comp::MemoizerBase>>(state); }
+BENCHMARK(benchmark_memo_list)->Arg(1024)->Arg(16384);
+
+static void benchmark_memo_flat(benchmark::State& state) { memoized_calls<Distance<Stf::Comp::FlatMemoizerBase>>(state); }
+BENCHMARK(benchmark_memo_flat)->Arg(1024)->Arg(16384);
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <Stuff/Files/Format.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/MMap.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/// Bulk decoding of fixed-size records described by an FFormat group into a column (a vector) per member.\n
+/// `decode_columns<Is...>(group, data)` decodes the members `Is` of every record in `data` (all of the members if `Is`
+/// is empty), the other members are not read. Records are split into ranges of about `chunk_bytes` that are decoded in
+/// parallel, each range column after column. Columns of primitives are filled from registers of whole records with a
+/// byte shuffle (that also swaps the bytes where needed) per register, the other columns go through `decode_unchecked`
+/// one record at a time.
+namespace Stf::FFormat {
+
+namespace Detail::Columns {
+
+/// Bytes of records decoded per parallel range
+inline constexpr size_t chunk_bytes = 64uz * 1024;
+
+template<typename E> struct Unnamed {
+    using type = E;
+    static constexpr E const& get(E const& expression) { return expression; }
+};
+
+template<typename E> struct Unnamed<NamedField<E>> {
+    using type = typename Unnamed<E>::type;
+    static constexpr type const& get(NamedField<E> const& expression) { return Unnamed<E>::get(expression.inner()); }
+};
+
+template<typename E> using unnamed_t = typename Unnamed<E>::type;
+
+template<typename Group, size_t... Is>
+auto columns_type_of(std::index_sequence<Is...>) -> std::tuple<std::vector<std::tuple_element_t<Is, typename Group::representation_type>>...>;
+
+template<typename Group, size_t... Is>
+using Projection = std::conditional_t<
+  sizeof...(Is) == 0, std::make_index_sequence<std::tuple_size_v<typename Group::representation_type>>, std::index_sequence<Is...>>;
+
+/// Byte indices, into `Width` bytes of records starting at a record, of the `Size` byte fields at `Offset` in as many
+/// of the records as fit, written one after the other and byte reversed if `Reverse`
+template<size_t Width, size_t Size, size_t Stride, size_t Offset, bool Reverse> inline constexpr auto column_shuffle = [] {
+    std::array<int, Width> ret {};
+    for (size_t i = 0; i < Width; i++) {
+        const auto record = i / Size;
+        const auto byte = Reverse ? Size - 1 - i % Size : i % Size;
+        ret[i] = static_cast<int>(std::min(record * Stride + Offset + byte, Width - 1));
+    }
+    return ret;
+}();
+
+/// Decodes the `Type` at `Offset` in each of the `count` records of `Stride` bytes at `records` into `out`. A register
+/// of records is loaded at a time and a single byte shuffle pulls the fields of all of the records it holds out of it.
+template<Primitive Type, size_t Stride, size_t Offset> void shuffle_column(const uint8_t* records, size_t count, primitive_respresentation_t<Type>* out) {
+    using T = primitive_respresentation_t<Type>;
+    constexpr size_t width = SIMD::native_width;
+    constexpr size_t size = sizeof(T);
+
+    // how many records a register holds the field of
+    constexpr size_t per_register = Offset + size <= width ? (width - Offset - size) / Stride + 1 : 0;
+
+    size_t i = 0;
+    if constexpr (per_register > 1) {
+        constexpr auto& index = column_shuffle<width, size, Stride, Offset, primitive_respresentation<Type>::reverse_bytes>;
+
+        // the loads stay in the records and the stores in the column
+        constexpr size_t reach = std::max(width / size, (width + Stride - 1) / Stride);
+        for (; i + reach <= count; i += per_register) {
+            const auto v = SIMD::load<width>(records + i * Stride);
+            const auto fields = [&]<size_t... Is>(std::index_sequence<Is...>) {
+                return __builtin_shufflevector(v, v, index[Is]...);
+            }(std::make_index_sequence<width> {});
+            SIMD::store(reinterpret_cast<uint8_t*>(out + i), fields);
+        }
+    }
+
+    for (; i < count; i++)
+        PrimitiveField<Type> {}.decode_unchecked(records + i * Stride + Offset, out[i]);
+}
+
+template<size_t Stride, size_t Offset, typename E>
+void decode_column(E const& expression, const uint8_t* records, size_t count, typename E::representation_type* out) {
+    if constexpr (!std::is_same_v<unnamed_t<E>, E>) {
+        decode_column<Stride, Offset>(Unnamed<E>::get(expression), records, count, out);
+    } else if constexpr (is_primitive_field<E>::value) {
+        shuffle_column<E::primitive, Stride, Offset>(records, count, out);
+    } else {
+        for (size_t i = 0; i < count; i++)
+            expression.decode_unchecked(records + i * Stride + Offset, out[i]);
+    }
+}
+
+}
+
+/// The columns of the members `Is` of `Group`, or of all of its members if `Is` is empty
+template<typename Group, size_t... Is>
+using columns_t = decltype(Detail::Columns::columns_type_of<Detail::Columns::unnamed_t<Group>>(Detail::Columns::Projection<Detail::Columns::unnamed_t<Group>, Is...> {}));
+
+/// Decodes the members `Is` (all of them if `Is` is empty) of the records laid out back to back in `data` into
+/// `columns`, which are resized to the record count and keep their storage if they are large enough. `group` is a
+/// fixed-size group, possibly named.
+template<size_t... Is, Concepts::FieldExpression Group>
+tl::expected<void, std::string_view> decode_columns_into(Group const& group, std::span<const uint8_t> data, columns_t<Group, Is...>& columns, ThreadPool& pool = ThreadPool::global()) {
+    using G = Detail::Columns::unnamed_t<Group>;
+    constexpr size_t stride = G::encoded_size;
+    static_assert(stride != dynamic_size && stride != 0, "Columns are decoded from non-empty, fixed-size records");
+
+    if (data.size() % stride != 0)
+        return tl::unexpected { "Data is not a whole number of records" };
+
+    const auto& expressions = Detail::Columns::Unnamed<Group>::get(group).expressions;
+    const auto count = data.size() / stride;
+
+    [&]<size_t... Cs, size_t... Ms>(std::index_sequence<Cs...>, std::index_sequence<Ms...>) {
+        (std::get<Cs>(columns).resize(count), ...);
+
+        // the ranges a pool hands out are split further, so that each column pass reads the records from the cache
+        constexpr auto block = std::max<size_t>(SIMD::native_width, Detail::Columns::chunk_bytes / stride);
+        pool.parallel_for(0, count, block, [&](size_t first, size_t last) {
+            for (auto begin = first; begin < last; begin += block) {
+                const auto end = std::min(last, begin + block);
+                const auto* records = data.data() + begin * stride;
+                (Detail::Columns::decode_column<stride, G::offsets[Ms]>(std::get<Ms>(expressions), records, end - begin, std::get<Cs>(columns).data() + begin), ...);
+            }
+        });
+    }(std::make_index_sequence<std::tuple_size_v<columns_t<Group, Is...>>> {}, Detail::Columns::Projection<G, Is...> {});
+
+    return {};
+}
+
+template<size_t... Is, Concepts::FieldExpression Group>
+tl::expected<columns_t<Group, Is...>, std::string_view> decode_columns(Group const& group, std::span<const uint8_t> data, ThreadPool& pool = ThreadPool::global()) {
+    columns_t<Group, Is...> ret {};
+    TRYX(decode_columns_into<Is...>(group, data, ret, pool));
+    return ret;
+}
+
+/// Decodes the records of a mapped file
+template<size_t... Is, Concepts::FieldExpression Group>
+tl::expected<columns_t<Group, Is...>, std::string_view> decode_columns(Group const& group, MMapStringView const& file, ThreadPool& pool = ThreadPool::global()) {
+    return decode_columns<Is...>(group, std::span(reinterpret_cast<const uint8_t*>(file.data()), file.size()), pool);
+}
+
+}
@@ -3,12 +3,23 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <optional>
+#include <ranges>
+#include <span>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <Stuff/Maths/Bit.hpp>
+#include <Stuff/Maths/SIMD.hpp>
 
 namespace Stf::FFormat {
 
@@ -65,15 +76,15 @@ PRIMITIVE_REPRESENTATION_FACTORY(U16BE, uint16_t, big);
 PRIMITIVE_REPRESENTATION_FACTORY(U32BE, uint32_t, big);
 PRIMITIVE_REPRESENTATION_FACTORY(U64BE, uint64_t, big);
 PRIMITIVE_REPRESENTATION_FACTORY(U128BE, __uint128_t, big);
-PRIMITIVE_REPRESENTATION_FACTORY(I16BE, uint16_t, big);
-PRIMITIVE_REPRESENTATION_FACTORY(I32BE, uint32_t, big);
-PRIMITIVE_REPRESENTATION_FACTORY(I64BE, uint64_t, big);
-PRIMITIVE_REPRESENTATION_FACTORY(I128BE, __uint128_t, big);
-
-PRIMITIVE_REPRESENTATION_FACTORY(U16LE, int16_t, little);
-PRIMITIVE_REPRESENTATION_FACTORY(U32LE, int32_t, little);
-PRIMITIVE_REPRESENTATION_FACTORY(U64LE, int64_t, little);
-PRIMITIVE_REPRESENTATION_FACTORY(U128LE, __int128_t, little);
+PRIMITIVE_REPRESENTATION_FACTORY(I16BE, int16_t, big);
+PRIMITIVE_REPRESENTATION_FACTORY(I32BE, int32_t, big);
+PRIMITIVE_REPRESENTATION_FACTORY(I64BE, int64_t, big);
+PRIMITIVE_REPRESENTATION_FACTORY(I128BE, __int128_t, big);
+
+PRIMITIVE_REPRESENTATION_FACTORY(U16LE, uint16_t, little);
+PRIMITIVE_REPRESENTATION_FACTORY(U32LE, uint32_t, little);
+PRIMITIVE_REPRESENTATION_FACTORY(U64LE, uint64_t, little);
+PRIMITIVE_REPRESENTATION_FACTORY(U128LE, __uint128_t, little);
 PRIMITIVE_REPRESENTATION_FACTORY(I16LE, int16_t, little);
 PRIMITIVE_REPRESENTATION_FACTORY(I32LE, int32_t, little);
 PRIMITIVE_REPRESENTATION_FACTORY(I64LE, int64_t, little);
@@ -95,10 +106,60 @@ PRIMITIVE_REPRESENTATION_FACTORY(F64LE, double, little);
 
 template<Primitive P> using primitive_respresentation_t = typename primitive_respresentation<P>::type;
 
+/// The `encoded_size` of expressions whose size depends on the data: length prefixed blobs, counted arrays, tagged unions
+/// and anything containing one of them. Only fixed-size expressions have `decode_unchecked` and `encode_unchecked`.
+inline constexpr size_t dynamic_size = std::numeric_limits<size_t>::max();
+
 namespace Detail {
 
+/// Iterators over bytes laid out contiguously in memory. Expressions decode from them with a single bounds check for the
+/// whole expression and then read the bytes in place (see `decode_unchecked`) instead of stepping the iterator per byte.
+template<typename IIter>
+concept ByteContiguous = std::contiguous_iterator<IIter> && sizeof(std::iter_value_t<IIter>) == 1;
+
+/// Writable ByteContiguous iterators, expressions encode into them with stores at fixed offsets (see `encode_unchecked`)
+template<typename OIter>
+concept MutableByteContiguous = ByteContiguous<OIter> && !std::is_const_v<std::remove_reference_t<std::iter_reference_t<OIter>>>;
+
+template<ByteContiguous IIter> inline const uint8_t* byte_address(IIter it) { return reinterpret_cast<const uint8_t*>(std::to_address(it)); }
+
+template<MutableByteContiguous OIter> inline uint8_t* mutable_byte_address(OIter it) { return reinterpret_cast<uint8_t*>(std::to_address(it)); }
+
+/// Reverses the bytes of each `Size` byte element in the vector `v`
+template<size_t Size, typename V> inline V reverse_lanes(V v) {
+    static_assert(sizeof(V) % Size == 0);
+    using B = SIMD::Vec<uint8_t, sizeof(V)>;
+
+    return [&]<size_t... Is>(std::index_sequence<Is...>) {
+        const auto bytes = reinterpret_cast<B>(v);
+        return reinterpret_cast<V>(__builtin_shufflevector(bytes, bytes, (Is / Size * Size + Size - 1 - Is % Size)...));
+    }(std::make_index_sequence<sizeof(V)> {});
+}
+
+/// Reverses the bytes of each of the `count` elements of `Size` bytes at `data`, one byte shuffle per register
+template<size_t Size> inline void reverse_each(uint8_t* data, size_t count) {
+    constexpr size_t width = SIMD::native_width;
+
+    const auto bytes = count * Size;
+
+    size_t i = 0;
+    for (; i + width <= bytes; i += width)
+        SIMD::store(data + i, reverse_lanes<Size>(SIMD::load<width>(data + i)));
+
+    for (; i < bytes; i += Size)
+        std::reverse(data + i, data + i + Size);
+}
+
 template<typename E> struct FieldExpression { using field_expression_tag = void; };
 
+/// How many bytes `value` takes once encoded, `E::encoded_size` unless that is `dynamic_size`
+template<typename E> constexpr size_t encoded_size_of(E const& expression, typename E::representation_type const& value) {
+    if constexpr (E::encoded_size != dynamic_size)
+        return E::encoded_size;
+    else
+        return expression.encoded_size_of(value);
+}
+
 template<typename E> struct NamedField : public FieldExpression<NamedField<E>> {
     using field_expression_tag = void;
     using representation_type = typename E::representation_type;
@@ -115,27 +176,45 @@ template<typename E> struct NamedField : public FieldExpression<NamedField<E>> {
     template<std::input_iterator IIter> constexpr auto decode(IIter begin, IIter end, representation_type& out) const {
         return field_expression.decode(begin, end, out);
     }
+
+    void decode_unchecked(const uint8_t* data, representation_type& out) const { field_expression.decode_unchecked(data, out); }
+
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter encode(OIter out, representation_type const& value) const {
+        return field_expression.encode(out, value);
+    }
+
+    void encode_unchecked(uint8_t* data, representation_type const& value) const { field_expression.encode_unchecked(data, value); }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const { return Detail::encoded_size_of(field_expression, value); }
 };
 
 template<Primitive Type> struct PrimitiveField : public FieldExpression<PrimitiveField<Type>> {
     using field_expression_tag = void;
     using representation_type = primitive_respresentation_t<Type>;
     inline static constexpr size_t encoded_size = sizeof(representation_type);
+    inline static constexpr Primitive primitive = Type;
 
     template<std::input_iterator IIter> constexpr std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
         using U = primitive_respresentation<Type>;
 
-        if (begin == end)
-            return std::nullopt;
+        if constexpr (ByteContiguous<IIter>) {
+            if (!std::is_constant_evaluated()) {
+                if (end - begin < static_cast<ptrdiff_t>(encoded_size))
+                    return std::nullopt;
+
+                decode_unchecked(byte_address(begin), out);
+                return begin + encoded_size;
+            }
+        }
 
         std::array<char, encoded_size> arr;
 
         auto it = begin;
         for (size_t i = 0; i < encoded_size; i++) {
-            arr[i] = *it++;
-
             if (it == end)
                 return std::nullopt;
+
+            arr[i] = *it++;
         }
 
         if (U::reverse_bytes)
@@ -144,16 +223,63 @@ template<Primitive Type> struct PrimitiveField : public FieldExpression<Primitiv
         out = std::bit_cast<representation_type>(arr);
         return it;
     }
+
+    /// Decodes from `encoded_size` bytes at `data`
+    void decode_unchecked(const uint8_t* data, representation_type& out) const {
+        std::memcpy(&out, data, encoded_size);
+        if constexpr (primitive_respresentation<Type>::reverse_bytes)
+            out = Stf::reverse_bytes(out);
+    }
+
+    /// Writes `encoded_size` bytes to `out`, there is no end to check against: fixed-size expressions always take
+    /// `encoded_size` bytes
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter encode(OIter out, representation_type const& value) const {
+        if constexpr (MutableByteContiguous<OIter>) {
+            if (!std::is_constant_evaluated()) {
+                encode_unchecked(mutable_byte_address(out), value);
+                return out + encoded_size;
+            }
+        }
+
+        auto arr = std::bit_cast<std::array<uint8_t, encoded_size>>(value);
+        if (primitive_respresentation<Type>::reverse_bytes)
+            std::reverse(arr.begin(), arr.end());
+
+        return std::copy(arr.begin(), arr.end(), out);
+    }
+
+    /// Encodes into `encoded_size` bytes at `data`
+    void encode_unchecked(uint8_t* data, representation_type const& value) const {
+        if constexpr (primitive_respresentation<Type>::reverse_bytes) {
+            const auto reversed = Stf::reverse_bytes(value);
+            std::memcpy(data, &reversed, encoded_size);
+        } else {
+            std::memcpy(data, &value, encoded_size);
+        }
+    }
 };
 
+template<typename E> struct is_primitive_field : std::false_type { };
+template<Primitive Type> struct is_primitive_field<PrimitiveField<Type>> : std::true_type { };
+
 template<Concepts::FieldExpression E, size_t Len> struct FieldArrayField : public FieldExpression<FieldArrayField<E, Len>> {
     using field_expression_tag = void;
     using representation_type = std::array<typename E::representation_type, Len>;
-    inline static constexpr size_t encoded_size = E::encoded_size * Len;
+    inline static constexpr size_t encoded_size = E::encoded_size == dynamic_size ? dynamic_size : E::encoded_size * Len;
 
     E expression;
 
     template<std::input_iterator IIter> constexpr std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
+        if constexpr (ByteContiguous<IIter> && encoded_size != dynamic_size) {
+            if (!std::is_constant_evaluated()) {
+                if (end - begin < static_cast<ptrdiff_t>(encoded_size))
+                    return std::nullopt;
+
+                decode_unchecked(byte_address(begin), out);
+                return begin + encoded_size;
+            }
+        }
+
         auto it = begin;
         for (size_t i = 0; i < Len; i++)
             if (auto res = expression.decode(it, end, out[i]); !res)
@@ -163,33 +289,342 @@ template<Concepts::FieldExpression E, size_t Len> struct FieldArrayField : publi
 
         return it;
     }
+
+    /// Arrays of primitives are copied whole and byte swapped in registers
+    void decode_unchecked(const uint8_t* data, representation_type& out) const {
+        if constexpr (is_primitive_field<E>::value) {
+            std::memcpy(out.data(), data, encoded_size);
+            if constexpr (primitive_respresentation<E::primitive>::reverse_bytes)
+                reverse_each<E::encoded_size>(reinterpret_cast<uint8_t*>(out.data()), Len);
+        } else {
+            for (size_t i = 0; i < Len; i++)
+                expression.decode_unchecked(data + i * E::encoded_size, out[i]);
+        }
+    }
+
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter encode(OIter out, representation_type const& value) const {
+        if constexpr (MutableByteContiguous<OIter> && encoded_size != dynamic_size) {
+            if (!std::is_constant_evaluated()) {
+                encode_unchecked(mutable_byte_address(out), value);
+                return out + encoded_size;
+            }
+        }
+
+        for (size_t i = 0; i < Len; i++)
+            out = expression.encode(out, value[i]);
+
+        return out;
+    }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const {
+        size_t ret = 0;
+        for (auto const& element : value)
+            ret += Detail::encoded_size_of(expression, element);
+        return ret;
+    }
+
+    /// Arrays of primitives are copied whole and byte swapped in place
+    void encode_unchecked(uint8_t* data, representation_type const& value) const {
+        if constexpr (is_primitive_field<E>::value) {
+            std::memcpy(data, value.data(), encoded_size);
+            if constexpr (primitive_respresentation<E::primitive>::reverse_bytes)
+                reverse_each<E::encoded_size>(data, Len);
+        } else {
+            for (size_t i = 0; i < Len; i++)
+                expression.encode_unchecked(data + i * E::encoded_size, value[i]);
+        }
+    }
 };
 
 template<typename... Es> struct GroupExpression : public FieldExpression<GroupExpression<Es...>> {
     using field_expression_tag = void;
     using representation_type = std::tuple<typename Es::representation_type...>;
-    inline static constexpr size_t encoded_size = ((1 + Es::encoded_size), ...);
+    /// Groups with a member of `dynamic_size` are decoded and encoded member by member, others take a single bounds check
+    /// and go through the members at their offsets
+    inline static constexpr size_t encoded_size = ((Es::encoded_size == dynamic_size) || ...) ? dynamic_size : (0 + ... + Es::encoded_size);
+
+    /// Where each member starts in the encoded group, meaningful for fixed-size groups only
+    inline static constexpr std::array<size_t, sizeof...(Es)> offsets = [] {
+        std::array<size_t, sizeof...(Es)> ret {};
+        size_t offset = 0;
+        size_t i = 0;
+        ((ret[i++] = offset, offset += Es::encoded_size), ...);
+        return ret;
+    }();
 
     std::tuple<Es...> expressions;
 
     template<std::input_iterator IIter> constexpr std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
+        if constexpr (ByteContiguous<IIter> && encoded_size != dynamic_size) {
+            if (!std::is_constant_evaluated()) {
+                if (end - begin < static_cast<ptrdiff_t>(encoded_size))
+                    return std::nullopt;
+
+                decode_unchecked(byte_address(begin), out);
+                return begin + encoded_size;
+            }
+        }
+
         return decode_impl(begin, end, out);
     }
 
+    void decode_unchecked(const uint8_t* data, representation_type& out) const {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::get<Is>(expressions).decode_unchecked(data + offsets[Is], std::get<Is>(out)), ...);
+        }(std::index_sequence_for<Es...> {});
+    }
+
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter encode(OIter out, representation_type const& value) const {
+        if constexpr (MutableByteContiguous<OIter> && encoded_size != dynamic_size) {
+            if (!std::is_constant_evaluated()) {
+                encode_unchecked(mutable_byte_address(out), value);
+                return out + encoded_size;
+            }
+        }
+
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((out = std::get<Is>(expressions).encode(out, std::get<Is>(value))), ...);
+        }(std::index_sequence_for<Es...> {});
+
+        return out;
+    }
+
+    /// One store per member at its offset in the group, the members' offsets and sizes are all known at compile time
+    void encode_unchecked(uint8_t* data, representation_type const& value) const {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (std::get<Is>(expressions).encode_unchecked(data + offsets[Is], std::get<Is>(value)), ...);
+        }(std::index_sequence_for<Es...> {});
+    }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const {
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            return (0 + ... + Detail::encoded_size_of(std::get<Is>(expressions), std::get<Is>(value)));
+        }(std::index_sequence_for<Es...> {});
+    }
+
 private:
     template<std::input_iterator IIter, size_t N = 0> constexpr std::optional<IIter> decode_impl(IIter it, IIter end, representation_type& out) const {
-        auto const& cur_expr = std::get<N>(expressions);
-        auto& cur_out = std::get<N>(out);
+        if constexpr (sizeof...(Es) == 0) {
+            return it;
+        } else {
+            auto const& cur_expr = std::get<N>(expressions);
+            auto& cur_out = std::get<N>(out);
+
+            auto res = cur_expr.decode(it, end, cur_out);
+
+            if (!res)
+                return std::nullopt;
 
-        auto res = cur_expr.decode(it, end, cur_out);
+            if constexpr (N + 1 < std::tuple_size_v<decltype(expressions)>)
+                return decode_impl<IIter, N + 1>(*res, end, out);
+            else
+                return *res;
+        }
+    }
+};
 
+/// Length or count prefixes, `Type` has to be an unsigned integer
+template<Primitive Type>
+concept SizePrimitive = std::is_integral_v<primitive_respresentation_t<Type>> && std::is_unsigned_v<primitive_respresentation_t<Type>>;
+
+/// A blob of bytes preceded by its length. Decodes to a view of the blob in the source buffer, skipping over a payload
+/// costs as much as reading its length.
+template<Primitive LengthType> struct BlobField : public FieldExpression<BlobField<LengthType>> {
+    static_assert(SizePrimitive<LengthType>);
+
+    using field_expression_tag = void;
+    using representation_type = std::span<const uint8_t>;
+    using length_type = primitive_respresentation_t<LengthType>;
+    inline static constexpr size_t encoded_size = dynamic_size;
+
+    PrimitiveField<LengthType> length_field;
+
+    /// The view points into [begin, end), which has to outlive it
+    template<ByteContiguous IIter> std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
+        length_type length = 0;
+        const auto res = length_field.decode(begin, end, length);
         if (!res)
             return std::nullopt;
 
-        if constexpr (N + 1 < std::tuple_size_v<decltype(expressions)>)
-            return decode_impl<IIter, N + 1>(*res, end, out);
-        else
-            return *res;
+        if (static_cast<size_t>(end - *res) < length)
+            return std::nullopt;
+
+        out = { byte_address(*res), static_cast<size_t>(length) };
+        return *res + static_cast<ptrdiff_t>(length);
+    }
+
+    /// The size of `value` has to fit in `length_type`
+    template<std::output_iterator<uint8_t> OIter> OIter encode(OIter out, representation_type const& value) const {
+        assert(value.size() <= std::numeric_limits<length_type>::max());
+        out = length_field.encode(out, static_cast<length_type>(value.size()));
+
+        if constexpr (MutableByteContiguous<OIter>) {
+            std::memcpy(mutable_byte_address(out), value.data(), value.size());
+            return out + static_cast<ptrdiff_t>(value.size());
+        } else {
+            return std::copy(value.begin(), value.end(), out);
+        }
+    }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const { return length_field.encoded_size + value.size(); }
+};
+
+/// Encoded elements of a counted array, each one is decoded when it is accessed
+template<typename E> struct ArrayView {
+    using value_type = typename E::representation_type;
+
+    struct iterator {
+        using value_type = ArrayView::value_type;
+        using difference_type = ptrdiff_t;
+
+        E expression;
+        const uint8_t* data = nullptr;
+
+        value_type operator*() const {
+            value_type ret;
+            expression.decode_unchecked(data, ret);
+            return ret;
+        }
+
+        iterator& operator++() {
+            data += E::encoded_size;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            auto ret = *this;
+            ++*this;
+            return ret;
+        }
+
+        friend bool operator==(iterator const& lhs, iterator const& rhs) { return lhs.data == rhs.data; }
+    };
+
+    E expression;
+    std::span<const uint8_t> bytes;
+
+    constexpr size_t size() const { return bytes.size() / E::encoded_size; }
+    constexpr bool empty() const { return bytes.empty(); }
+
+    value_type operator[](size_t i) const { return *iterator { expression, bytes.data() + i * E::encoded_size }; }
+
+    iterator begin() const { return { expression, bytes.data() }; }
+    iterator end() const { return { expression, bytes.data() + bytes.size() }; }
+
+    /// The elements as they are encoded
+    constexpr std::span<const uint8_t> encoded() const { return bytes; }
+};
+
+/// An array of fixed-size elements preceded by the element count. Decodes to an `ArrayView` into the source buffer
+/// after checking that all of the elements are there.
+template<Primitive CountType, Concepts::FieldExpression E> struct CountedArrayField : public FieldExpression<CountedArrayField<CountType, E>> {
+    static_assert(SizePrimitive<CountType>);
+    static_assert(E::encoded_size != dynamic_size && E::encoded_size != 0, "Counted arrays hold non-empty, fixed-size elements");
+
+    using field_expression_tag = void;
+    using representation_type = ArrayView<E>;
+    using count_type = primitive_respresentation_t<CountType>;
+    inline static constexpr size_t encoded_size = dynamic_size;
+
+    PrimitiveField<CountType> count_field;
+    E expression;
+
+    template<ByteContiguous IIter> std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
+        count_type count = 0;
+        const auto res = count_field.decode(begin, end, count);
+        if (!res)
+            return std::nullopt;
+
+        if (static_cast<size_t>(end - *res) / E::encoded_size < count)
+            return std::nullopt;
+
+        const auto size = static_cast<size_t>(count) * E::encoded_size;
+        out = { expression, { byte_address(*res), size } };
+        return *res + static_cast<ptrdiff_t>(size);
+    }
+
+    /// Encodes an `ArrayView` (as a copy of its bytes) or any sized range of elements, whose size has to fit in
+    /// `count_type`
+    template<std::output_iterator<uint8_t> OIter, std::ranges::sized_range R>
+        requires std::convertible_to<std::ranges::range_value_t<R>, typename E::representation_type>
+    OIter encode(OIter out, R const& values) const {
+        assert(static_cast<size_t>(std::ranges::size(values)) <= std::numeric_limits<count_type>::max());
+        out = count_field.encode(out, static_cast<count_type>(std::ranges::size(values)));
+
+        if constexpr (std::is_same_v<R, representation_type>) {
+            if constexpr (MutableByteContiguous<OIter>) {
+                std::memcpy(mutable_byte_address(out), values.bytes.data(), values.bytes.size());
+                return out + static_cast<ptrdiff_t>(values.bytes.size());
+            } else {
+                return std::copy(values.bytes.begin(), values.bytes.end(), out);
+            }
+        } else {
+            for (auto const& value : values)
+                out = expression.encode(out, value);
+
+            return out;
+        }
+    }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const { return count_field.encoded_size + value.bytes.size(); }
+};
+
+template<auto Tag, Concepts::FieldExpression E> struct UnionCase {
+    inline static constexpr auto tag = Tag;
+    E expression;
+};
+
+/// A tag followed by the alternative that the tag selects. Decodes to a variant with an alternative per case, unknown
+/// tags fail to decode.
+template<Primitive TagType, typename... Cases> struct TaggedUnionField : public FieldExpression<TaggedUnionField<TagType, Cases...>> {
+    static_assert(sizeof...(Cases) != 0);
+
+    using field_expression_tag = void;
+    using representation_type = std::variant<typename decltype(Cases::expression)::representation_type...>;
+    using tag_type = primitive_respresentation_t<TagType>;
+    inline static constexpr size_t encoded_size = dynamic_size;
+
+    PrimitiveField<TagType> tag_field;
+    std::tuple<Cases...> cases;
+
+    template<std::input_iterator IIter> constexpr std::optional<IIter> decode(IIter begin, IIter end, representation_type& out) const {
+        tag_type tag {};
+        const auto res = tag_field.decode(begin, end, tag);
+        if (!res)
+            return std::nullopt;
+
+        std::optional<IIter> ret = std::nullopt;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            const auto decode_case = [&]<size_t I>(std::integral_constant<size_t, I>) {
+                ret = std::get<I>(cases).expression.decode(*res, end, out.template emplace<I>());
+                return true;
+            };
+            std::ignore = ((tag == static_cast<tag_type>(Cases::tag) && decode_case(std::integral_constant<size_t, Is> {})) || ...);
+        }(std::index_sequence_for<Cases...> {});
+
+        return ret;
+    }
+
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter encode(OIter out, representation_type const& value) const {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            const auto encode_case = [&]<size_t I>(std::integral_constant<size_t, I>) {
+                out = tag_field.encode(out, static_cast<tag_type>(std::tuple_element_t<I, std::tuple<Cases...>>::tag));
+                out = std::get<I>(cases).expression.encode(out, std::get<I>(value));
+                return true;
+            };
+            std::ignore = ((value.index() == Is && encode_case(std::integral_constant<size_t, Is> {})) || ...);
+        }(std::index_sequence_for<Cases...> {});
+
+        return out;
+    }
+
+    constexpr size_t encoded_size_of(representation_type const& value) const {
+        size_t ret = tag_field.encoded_size;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((ret += value.index() == Is ? Detail::encoded_size_of(std::get<Is>(cases).expression, std::get<Is>(value)) : 0), ...);
+        }(std::index_sequence_for<Cases...> {});
+
+        return ret;
     }
 };
 
@@ -199,10 +634,26 @@ template<Primitive Type> constexpr auto primitive_field() { return Detail::Primi
 
 template<size_t N, Concepts::FieldExpression E> constexpr auto make_array_field(E expr) { return Detail::FieldArrayField<E, N> { {}, expr }; }
 
-template<typename E> constexpr auto name_field(E&& expr, const char* name) { return Detail::NamedField<E> { {}, expr, name }; }
+template<typename E> constexpr auto name_field(E&& expr, const char* name) {
+    return Detail::NamedField<std::remove_cvref_t<E>> { {}, std::forward<E>(expr), name };
+}
+
+template<Primitive LengthType> constexpr auto blob_field() { return Detail::BlobField<LengthType> {}; }
+
+template<Primitive CountType, Concepts::FieldExpression E> constexpr auto counted_array_field(E expr) {
+    return Detail::CountedArrayField<CountType, E> { {}, {}, expr };
+}
+
+template<auto Tag, Concepts::FieldExpression E> constexpr auto union_case(E expr) { return Detail::UnionCase<Tag, E> { expr }; }
+
+template<Primitive TagType, typename... Cases> constexpr auto tagged_union_field(Cases... cases) {
+    return Detail::TaggedUnionField<TagType, Cases...> { {}, {}, std::tuple(cases...) };
+}
 
 constexpr auto group_field() { return Detail::GroupExpression<> {}; }
 
+using Detail::encoded_size_of;
+
 template<Concepts::FieldExpression E1, Concepts::FieldExpression... Es> constexpr auto operator<<(Detail::GroupExpression<Es...> e_0, E1 e_1) {
     return Detail::GroupExpression<Es..., E1> { {}, std::tuple_cat(std::move(e_0.expressions), std::tuple(e_1)) };
 }
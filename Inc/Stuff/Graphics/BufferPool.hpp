@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace Stf::Gfx {
+
+/// A cache of freed image buffers, bucketed by size class, so that pipelines that keep creating images of the same
+/// sizes stop going to the system allocator after their first frames.\n
+/// Sizes are rounded up to one of four classes per power of two (at most 25% larger than requested) and buffers are
+/// aligned to `alignment` bytes. Freed buffers are kept until `max_cached_bytes` is reached, past which they are
+/// freed. All members are thread safe.
+struct BufferPool {
+    static constexpr size_t alignment = 64;
+
+    struct Stats {
+        /// Allocations served from the cache
+        size_t hits = 0;
+        /// Allocations that went to the system allocator
+        size_t misses = 0;
+        /// Deallocations that went back to the cache
+        size_t recycled = 0;
+        /// Deallocations that were freed because the cache was full
+        size_t evicted = 0;
+
+        size_t cached_buffers = 0;
+        size_t cached_bytes = 0;
+
+        constexpr double hit_rate() const {
+            const auto total = hits + misses;
+            return total == 0 ? 0. : static_cast<double>(hits) / static_cast<double>(total);
+        }
+    };
+
+    explicit BufferPool(size_t max_cached_bytes = size_t(256) << 20);
+
+    BufferPool(BufferPool const&) = delete;
+    BufferPool(BufferPool&&) = delete;
+
+    /// Frees the cached buffers, buffers still in use must not be deallocated afterwards
+    ~BufferPool() noexcept;
+
+    /// The process-wide pool
+    static BufferPool& global();
+
+    /// The number of bytes actually reserved for a request of `bytes` bytes
+    static size_t size_class(size_t bytes);
+
+    [[nodiscard]] void* allocate(size_t bytes);
+
+    /// `bytes` has to be the size that was passed to allocate
+    void deallocate(void* p, size_t bytes) noexcept;
+
+    Stats stats() const;
+
+    /// Zeroes the counters but not the cache sizes
+    void reset_stats();
+
+    /// Frees every cached buffer
+    void trim();
+
+private:
+    mutable std::mutex m_mutex {};
+    std::unordered_map<size_t, std::vector<void*>> m_free {};
+
+    size_t m_max_cached_bytes;
+    Stats m_stats {};
+
+    static void free_buffer(void* p, size_t size_class) noexcept;
+};
+
+/// An allocator backed by a BufferPool, the global one by default
+template<typename T> struct PooledAllocator {
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    template<typename U> struct rebind { using other = PooledAllocator<U>; };
+
+    PooledAllocator() noexcept
+        : m_pool(&BufferPool::global()) { }
+
+    explicit PooledAllocator(BufferPool& pool) noexcept
+        : m_pool(&pool) { }
+
+    template<typename U>
+    PooledAllocator(PooledAllocator<U> const& other) noexcept
+        : m_pool(&other.pool()) { }
+
+    [[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(m_pool->allocate(n * sizeof(T))); }
+
+    void deallocate(T* p, size_t n) noexcept { m_pool->deallocate(p, n * sizeof(T)); }
+
+    BufferPool& pool() const noexcept { return *m_pool; }
+
+    template<typename U> bool operator==(PooledAllocator<U> const& other) const noexcept { return m_pool == &other.pool(); }
+
+private:
+    BufferPool* m_pool;
+};
+
+}
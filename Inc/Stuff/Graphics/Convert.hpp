@@ -0,0 +1,534 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/SRGB.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <span>
+
+/// Bulk conversion between any two NewImage formats and color spaces.\n
+/// Integer channels are treated as normalised to their full range (0 -> 0.f, max -> 1.f) when converting to or from
+/// floats and rescaled exactly when converting between integer widths. Missing alpha channels read as opaque. Float
+/// values are clamped to [0, 1] when they are stored into integer channels and when they go through an sRGB transfer
+/// function, which only applies to the color channels.\n
+/// Conversions take the cheapest of four paths:
+/// - channel swizzles for formats with the same channel type and color space (e.g. BGRA8u <-> RGBA8u)
+/// - exact integer rescaling between integer formats in the same color space (e.g. RGBA8u -> RGB16u)
+/// - a table of all 256 results for everything else from 8 bit channels (e.g. BGRA8u sRGB -> RGBA32f linear)
+/// - a float pipeline for everything else, which unpacks blocks of pixels into planes, applies the transfer function
+///   with the tables from <Stuff/Graphics/SRGB.hpp> (exact vectorised functions for wide linear -> sRGB outputs,
+///   exactly rounding quantizers for 8 bit outputs) and packs the planes into the destination
+namespace Stf::Gfx::Detail::Convert {
+
+/// Storage index of the red, green, blue and alpha channels, -1 for channels the format lacks
+constexpr std::array<int, 4> layout_of(ColorFormat format) {
+    switch (format) {
+    case ColorFormat::RGB8u:
+    case ColorFormat::RGB16u:
+    case ColorFormat::RGB32u:
+    case ColorFormat::RGB32f: return { 0, 1, 2, -1 };
+    case ColorFormat::BGRA8u: return { 2, 1, 0, 3 };
+    default: return { 0, 1, 2, 3 };
+    }
+}
+
+/// Logical channel (0 = red ... 3 = alpha) held at every storage index
+template<ColorFormat Format, size_t ChannelCount> constexpr std::array<int, ChannelCount> storage_channels() {
+    constexpr auto layout = layout_of(Format);
+
+    std::array<int, ChannelCount> ret {};
+    for (auto c = 0uz; c < 4; c++)
+        if (layout[c] >= 0)
+            ret[layout[c]] = static_cast<int>(c);
+
+    return ret;
+}
+
+template<typename T> inline constexpr T channel_max = std::is_floating_point_v<T> ? T(1) : std::numeric_limits<T>::max();
+
+/// Pixels per block of the float pipeline, the four planes of a block stay in L1
+inline constexpr size_t block_size = 256;
+
+/// Minimum number of pixels per parallel task
+inline constexpr size_t parallel_grain = 1uz << 16;
+
+template<typename SrcTraits, ColorFormat SrcFormat, typename DstTraits, ColorFormat DstFormat>
+void swizzle(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    using T = typename DstTraits::channel_type;
+    constexpr auto src_layout = layout_of(SrcFormat);
+    constexpr auto dst_channels = storage_channels<DstFormat, DstTraits::channel_count>();
+
+    for (auto i = 0uz; i < count; i++) {
+        typename DstTraits::color_type out;
+        for (auto c = 0uz; c < DstTraits::channel_count; c++) {
+            const auto from = src_layout[dst_channels[c]];
+            out[c] = from >= 0 ? src[i][from] : channel_max<T>;
+        }
+        dst[i] = out;
+    }
+}
+
+/// 4 channel 8 bit permutations, 16 pixels per byte shuffle
+template<typename SrcTraits, ColorFormat SrcFormat, typename DstTraits, ColorFormat DstFormat>
+void swizzle_u8x4(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    static constexpr auto src_layout = layout_of(SrcFormat);
+    static constexpr auto dst_channels = storage_channels<DstFormat, 4>();
+
+    constexpr size_t pixels = 16;
+    using V = SIMD::Vec<uint8_t, pixels * 4>;
+
+    // V is wider than the target may be, it is kept inside the lambda so that it never crosses a call (see -Wpsabi)
+    const auto shuffle = []<size_t... Is>(const uint8_t* in, uint8_t* out, std::index_sequence<Is...>) {
+        V v;
+        std::memcpy(&v, in, sizeof(v));
+        const V shuffled = __builtin_shufflevector(v, v, (Is / 4 * 4 + src_layout[dst_channels[Is % 4]])...);
+        std::memcpy(out, &shuffled, sizeof(shuffled));
+    };
+
+    const auto* const src_bytes = reinterpret_cast<const uint8_t*>(src);
+    auto* const dst_bytes = reinterpret_cast<uint8_t*>(dst);
+
+    size_t i = 0;
+    for (; i + pixels <= count; i += pixels)
+        shuffle(src_bytes + i * 4, dst_bytes + i * 4, std::make_index_sequence<pixels * 4> {});
+
+    swizzle<SrcTraits, SrcFormat, DstTraits, DstFormat>(src + i, dst + i, count - i);
+}
+
+template<typename SrcTraits, ColorFormat SrcFormat, typename DstTraits, ColorFormat DstFormat>
+void rescale(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    using S = typename SrcTraits::channel_type;
+    using T = typename DstTraits::channel_type;
+    constexpr auto src_layout = layout_of(SrcFormat);
+    constexpr auto dst_channels = storage_channels<DstFormat, DstTraits::channel_count>();
+
+    constexpr uint64_t src_max = channel_max<S>;
+    constexpr uint64_t dst_max = channel_max<T>;
+
+    for (auto i = 0uz; i < count; i++) {
+        typename DstTraits::color_type out;
+        for (auto c = 0uz; c < DstTraits::channel_count; c++) {
+            const auto from = src_layout[dst_channels[c]];
+            if (from < 0) {
+                out[c] = channel_max<T>;
+            } else if constexpr (dst_max % src_max == 0) {
+                // widening is a multiplication by 0x0101, 0x01010101 or 0x00010001
+                out[c] = static_cast<T>(src[i][from] * (dst_max / src_max));
+            } else {
+                out[c] = static_cast<T>((src[i][from] * dst_max + src_max / 2) / src_max);
+            }
+        }
+        dst[i] = out;
+    }
+}
+
+/// `v` in [0, 1]
+template<typename T> constexpr T from_unit(double v) {
+    if constexpr (std::is_floating_point_v<T>)
+        return static_cast<T>(v);
+    else
+        return static_cast<T>(v * static_cast<double>(channel_max<T>) + 0.5);
+}
+
+/// The destination value of every 8 bit code, for color channels (transfer function included) at [0, 256) and for
+/// alpha at [256, 512)
+template<typename T, ColorSpace SrcSpace, ColorSpace DstSpace> inline constexpr std::array<T, 512> u8_table = [] {
+    std::array<T, 512> ret {};
+
+    for (auto i = 0uz; i < 256; i++) {
+        const auto v = static_cast<double>(i) / 255.;
+
+        auto color = v;
+        if constexpr (SrcSpace == ColorSpace::SRGB && DstSpace == ColorSpace::Linear)
+            color = SRGB::to_linear(v);
+        else if constexpr (SrcSpace == ColorSpace::Linear && DstSpace == ColorSpace::SRGB)
+            color = SRGB::from_linear(v);
+
+        ret[i] = from_unit<T>(color);
+        ret[256 + i] = from_unit<T>(v);
+    }
+
+    return ret;
+}();
+
+template<typename SrcTraits, ColorFormat SrcFormat, ColorSpace SrcSpace, typename DstTraits, ColorFormat DstFormat, ColorSpace DstSpace>
+void lookup(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    using T = typename DstTraits::channel_type;
+    static constexpr auto src_layout = layout_of(SrcFormat);
+    static constexpr auto dst_channels = storage_channels<DstFormat, DstTraits::channel_count>();
+    constexpr auto& table = u8_table<T, SrcSpace, DstSpace>;
+
+    size_t i = 0;
+
+    // every output float is a gather from the table at the (swizzled) source byte, without any transposition
+    if constexpr (std::is_same_v<T, float> && SrcTraits::channel_count == 4 && DstTraits::channel_count == 4) {
+        constexpr size_t lanes = SIMD::native_lanes<float>;
+        constexpr size_t pixels = lanes / 4;
+        using I = SIMD::Vec<int32_t, lanes>;
+
+        // shuffling the bytes before widening them or widening them in one step gets scalarised
+        const auto shuffle = []<size_t... Is>(I v, std::index_sequence<Is...>) {
+            return __builtin_shufflevector(v, v, (Is / 4 * 4 + src_layout[dst_channels[Is % 4]])...);
+        };
+
+        const I alpha_offsets = [] {
+            I ret {};
+            for (auto j = 0uz; j < lanes; j++)
+                ret[j] = dst_channels[j % 4] == 3 ? 256 : 0;
+            return ret;
+        }();
+
+        const auto* const src_bytes = reinterpret_cast<const uint8_t*>(src);
+        auto* const dst_floats = reinterpret_cast<float*>(dst);
+
+        for (; i + pixels <= count; i += pixels) {
+            const auto bytes = SIMD::load<lanes>(src_bytes + i * 4);
+            const auto codes = shuffle(SIMD::convert<int32_t>(SIMD::convert<int16_t>(bytes)), std::make_index_sequence<lanes> {});
+            SIMD::store(dst_floats + i * 4, SIMD::gather(table.data(), codes + alpha_offsets));
+        }
+    }
+
+    for (; i < count; i++) {
+        typename DstTraits::color_type out;
+        for (auto c = 0uz; c < DstTraits::channel_count; c++) {
+            const auto from = src_layout[dst_channels[c]];
+            out[c] = from >= 0 ? table[(dst_channels[c] == 3 ? 256 : 0) + src[i][from]] : channel_max<T>;
+        }
+        dst[i] = out;
+    }
+}
+
+using Planes = std::array<std::array<float, block_size>, 4>;
+
+/// Channels `First` and `First + 1` of the 4 channel pixels of `a` followed by `b`
+template<size_t First, typename V, size_t... Is> V channel_pairs(V a, V b, std::index_sequence<Is...>) {
+    return __builtin_shufflevector(a, b, (Is / 2 * 4 + First + Is % 2)...);
+}
+
+/// Every other element of `a` followed by `b`, starting at `First`
+template<size_t First, typename V, size_t... Is> V every_other(V a, V b, std::index_sequence<Is...>) {
+    return __builtin_shufflevector(a, b, (Is * 2 + First)...);
+}
+
+/// The elements of the first (`Half` = 0) or second half of `a` and `b` alternated in units of `Unit`
+template<size_t Half, size_t Unit, typename V, size_t... Is> V zip_half(V a, V b, std::index_sequence<Is...>) {
+    constexpr auto n = SIMD::lane_count<V>;
+    return __builtin_shufflevector(a, b, (Is / Unit % 2 * n + (Half * n / 2 / Unit + Is / Unit / 2) * Unit + Is % Unit)...);
+}
+
+/// Four vectors of 4 channel pixels to a vector per storage channel
+template<typename V> std::array<V, 4> deinterleave4(V v0, V v1, V v2, V v3) {
+    constexpr auto seq = std::make_index_sequence<SIMD::lane_count<V>> {};
+
+    const auto t0 = channel_pairs<0>(v0, v1, seq);
+    const auto t1 = channel_pairs<2>(v0, v1, seq);
+    const auto t2 = channel_pairs<0>(v2, v3, seq);
+    const auto t3 = channel_pairs<2>(v2, v3, seq);
+
+    return { every_other<0>(t0, t2, seq), every_other<1>(t0, t2, seq), every_other<0>(t1, t3, seq), every_other<1>(t1, t3, seq) };
+}
+
+/// The inverse of deinterleave4
+template<typename V> std::array<V, 4> interleave4(V c0, V c1, V c2, V c3) {
+    constexpr auto seq = std::make_index_sequence<SIMD::lane_count<V>> {};
+
+    const auto t0 = zip_half<0, 1>(c0, c1, seq);
+    const auto t1 = zip_half<0, 1>(c2, c3, seq);
+    const auto t2 = zip_half<1, 1>(c0, c1, seq);
+    const auto t3 = zip_half<1, 1>(c2, c3, seq);
+
+    return { zip_half<0, 2>(t0, t1, seq), zip_half<1, 2>(t0, t1, seq), zip_half<0, 2>(t2, t3, seq), zip_half<1, 2>(t2, t3, seq) };
+}
+
+/// 4 channel 8 bit or float sources, a native vector of pixels at a time
+template<typename SrcTraits, ColorFormat SrcFormat, ColorSpace SrcSpace, ColorSpace DstSpace>
+size_t unpack_x4(const typename SrcTraits::color_type* src, Planes& planes, size_t count) {
+    using S = typename SrcTraits::channel_type;
+    static constexpr auto src_layout = layout_of(SrcFormat);
+    static constexpr auto logical_channels = storage_channels<SrcFormat, 4>();
+    constexpr size_t lanes = SIMD::native_lanes<float>;
+    using V = SIMD::Vec<float, lanes>;
+
+    const auto* const src_channels = reinterpret_cast<const S*>(src);
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        const auto* const p = src_channels + i * 4;
+
+        std::array<V, 4> channels;
+        if constexpr (sizeof(S) == 1 && std::endian::native == std::endian::little) {
+            // storage index c is byte c of the word, shifts and masks are cheaper than byte shuffles
+            using U = SIMD::Vec<uint32_t, lanes>;
+            U words;
+            std::memcpy(&words, p, sizeof(words));
+            for (auto c = 0uz; c < 4; c++) {
+                const auto codes = SIMD::convert<int32_t>((words >> static_cast<uint32_t>(c * 8)) & 0xFFu);
+                if constexpr (SrcSpace != DstSpace)
+                    channels[c] = SIMD::gather(u8_table<float, SrcSpace, DstSpace>.data() + (logical_channels[c] == 3 ? 256 : 0), codes);
+                else
+                    channels[c] = SIMD::convert<float>(codes) * (1.f / 255.f);
+            }
+        } else if constexpr (sizeof(S) == 1) {
+            return 0;
+        } else {
+            channels = deinterleave4(SIMD::load<lanes>(p), SIMD::load<lanes>(p + lanes), SIMD::load<lanes>(p + 2 * lanes), SIMD::load<lanes>(p + 3 * lanes));
+        }
+
+        for (auto c = 0uz; c < 4; c++)
+            SIMD::store(planes[c].data() + i, channels[src_layout[c]]);
+    }
+
+    return i;
+}
+
+/// 8 bit sources can also go from `SrcSpace` to `DstSpace` through u8_table
+template<typename SrcTraits, ColorFormat SrcFormat, ColorSpace SrcSpace = ColorSpace::Linear, ColorSpace DstSpace = SrcSpace>
+void unpack(const typename SrcTraits::color_type* src, Planes& planes, size_t count) {
+    using S = typename SrcTraits::channel_type;
+    constexpr auto src_layout = layout_of(SrcFormat);
+    static_assert(SrcSpace == DstSpace || sizeof(S) == 1, "only 8 bit sources can be converted while unpacking");
+
+    size_t first = 0;
+    if constexpr (SrcTraits::channel_count == 4 && (sizeof(S) == 1 || std::is_same_v<S, float>))
+        first = unpack_x4<SrcTraits, SrcFormat, SrcSpace, DstSpace>(src, planes, count);
+
+    for (auto c = 0uz; c < 4; c++) {
+        const auto from = src_layout[c];
+        auto* const plane = planes[c].data();
+
+        if (from < 0) {
+            std::fill_n(plane + first, count - first, 1.f);
+        } else if constexpr (SrcSpace != DstSpace) {
+            const auto* const table = u8_table<float, SrcSpace, DstSpace>.data() + (c == 3 ? 256 : 0);
+            for (auto i = first; i < count; i++)
+                plane[i] = table[src[i][from]];
+        } else if constexpr (std::is_floating_point_v<S>) {
+            for (auto i = first; i < count; i++)
+                plane[i] = static_cast<float>(src[i][from]);
+        } else {
+            // 32 bit integers do not fit in a float mantissa
+            using W = std::conditional_t<sizeof(S) >= 4, double, float>;
+            for (auto i = first; i < count; i++)
+                plane[i] = static_cast<float>(static_cast<W>(src[i][from]) * (W(1) / static_cast<W>(channel_max<S>)));
+        }
+    }
+}
+
+/// 4 channel 8 bit destinations, a native vector of pixels at a time
+template<typename DstTraits, ColorFormat DstFormat>
+size_t pack_u8x4(Planes const& planes, typename DstTraits::color_type* dst, size_t count, const SRGB::U8Quantizer<float>* quantizer) {
+    constexpr auto dst_channels = storage_channels<DstFormat, 4>();
+    constexpr size_t lanes = SIMD::native_lanes<float>;
+    using V = SIMD::Vec<float, lanes>;
+    using U = SIMD::Vec<uint32_t, lanes>;
+
+    auto* const dst_words = reinterpret_cast<uint32_t*>(dst);
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        U word {};
+        for (auto c = 0uz; c < 4; c++) {
+            auto v = SIMD::load<lanes>(planes[dst_channels[c]].data() + i);
+
+            U code;
+            if (quantizer != nullptr && dst_channels[c] != 3) {
+                code = reinterpret_cast<U>((*quantizer)(v));
+            } else {
+                // NaN goes to 0
+                v = v > 0.f ? v : V {};
+                v = v < 1.f ? v : V {} + 1.f;
+                code = SIMD::convert<uint32_t>(v * 255.f + 0.5f);
+            }
+
+            // little endian, storage index c is byte c of the word
+            word |= code << static_cast<uint32_t>(c * 8);
+        }
+
+        if constexpr (std::endian::native == std::endian::little)
+            SIMD::store(dst_words + i, word);
+        else
+            return 0;
+    }
+
+    return i;
+}
+
+/// 4 channel float destinations, a native vector of pixels at a time
+template<typename DstTraits, ColorFormat DstFormat> size_t pack_f32x4(Planes const& planes, typename DstTraits::color_type* dst, size_t count) {
+    constexpr auto dst_channels = storage_channels<DstFormat, 4>();
+    constexpr size_t lanes = SIMD::native_lanes<float>;
+
+    auto* const dst_floats = reinterpret_cast<float*>(dst);
+
+    size_t i = 0;
+    for (; i + lanes <= count; i += lanes) {
+        const auto pixels = interleave4(
+          SIMD::load<lanes>(planes[dst_channels[0]].data() + i), SIMD::load<lanes>(planes[dst_channels[1]].data() + i),
+          SIMD::load<lanes>(planes[dst_channels[2]].data() + i), SIMD::load<lanes>(planes[dst_channels[3]].data() + i)
+        );
+
+        for (auto j = 0uz; j < 4; j++)
+            SIMD::store(dst_floats + i * 4 + j * lanes, pixels[j]);
+    }
+
+    return i;
+}
+
+/// `quantizer`, if given, replaces the rounding of the color channels
+template<typename DstTraits, ColorFormat DstFormat>
+void pack(Planes const& planes, typename DstTraits::color_type* dst, size_t count, const SRGB::U8Quantizer<float>* quantizer = nullptr) {
+    using T = typename DstTraits::channel_type;
+    constexpr auto dst_channels = storage_channels<DstFormat, DstTraits::channel_count>();
+
+    size_t first = 0;
+    if constexpr (sizeof(T) == 1 && DstTraits::channel_count == 4)
+        first = pack_u8x4<DstTraits, DstFormat>(planes, dst, count, quantizer);
+    else if constexpr (std::is_same_v<T, float> && DstTraits::channel_count == 4)
+        first = pack_f32x4<DstTraits, DstFormat>(planes, dst, count);
+
+    for (auto c = 0uz; c < DstTraits::channel_count; c++) {
+        const auto* const plane = planes[dst_channels[c]].data();
+
+        if (quantizer != nullptr && dst_channels[c] != 3) {
+            for (auto i = first; i < count; i++)
+                dst[i][c] = (*quantizer)(plane[i]);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            for (auto i = first; i < count; i++)
+                dst[i][c] = static_cast<T>(plane[i]);
+        } else {
+            using W = std::conditional_t<sizeof(T) >= 4, double, float>;
+            for (auto i = first; i < count; i++) {
+                // NaN goes to 0
+                auto v = static_cast<W>(plane[i]);
+                v = v > 0 ? v : 0;
+                v = v < 1 ? v : 1;
+                dst[i][c] = static_cast<T>(v * static_cast<W>(channel_max<T>) + W(0.5));
+            }
+        }
+    }
+}
+
+inline void clamp_unit(std::span<float> plane) {
+    for (auto& v : plane) {
+        v = v > 0.f ? v : 0.f;
+        v = v < 1.f ? v : 1.f;
+    }
+}
+
+template<typename SrcTraits, ColorFormat SrcFormat, ColorSpace SrcSpace, typename DstTraits, ColorFormat DstFormat, ColorSpace DstSpace>
+void float_pipeline(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    constexpr bool to_linear = SrcSpace == ColorSpace::SRGB && DstSpace == ColorSpace::Linear;
+    constexpr bool from_linear = SrcSpace == ColorSpace::Linear && DstSpace == ColorSpace::SRGB;
+    constexpr bool quantize = sizeof(typename DstTraits::channel_type) == 1 && (to_linear || from_linear);
+
+    const SRGB::U8Quantizer<float>* quantizer = nullptr;
+    if constexpr (quantize)
+        quantizer = to_linear ? &SRGB::to_linear_u8<float> : &SRGB::from_linear_u8<float>;
+
+    alignas(SIMD::native_width) Planes planes;
+
+    for (auto first = 0uz; first < count; first += block_size) {
+        const auto n = std::min(block_size, count - first);
+
+        unpack<SrcTraits, SrcFormat>(src + first, planes, n);
+
+        for (auto c = 0uz; !quantize && c < 3; c++) {
+            const auto plane = std::span(planes[c]).first(n);
+
+            if constexpr (to_linear) {
+                SRGB::to_linear_lut<float>(plane, plane);
+            } else if constexpr (from_linear) {
+                // the table is only good to ~1e-4
+                clamp_unit(plane);
+                SRGB::from_linear<float>(plane, plane);
+            }
+        }
+
+        pack<DstTraits, DstFormat>(planes, dst + first, n, quantizer);
+    }
+}
+
+template<typename SrcTraits, ColorFormat SrcFormat, ColorSpace SrcSpace, typename DstTraits, ColorFormat DstFormat, ColorSpace DstSpace>
+void convert_pixels(const typename SrcTraits::color_type* src, typename DstTraits::color_type* dst, size_t count) {
+    using S = typename SrcTraits::channel_type;
+    using T = typename DstTraits::channel_type;
+
+    if constexpr (SrcSpace == DstSpace && std::is_same_v<S, T>) {
+        if constexpr (SrcFormat == DstFormat) {
+            std::memcpy(dst, src, count * sizeof(*src));
+        } else if constexpr (sizeof(S) == 1 && SrcTraits::channel_count == 4 && DstTraits::channel_count == 4) {
+            swizzle_u8x4<SrcTraits, SrcFormat, DstTraits, DstFormat>(src, dst, count);
+        } else {
+            swizzle<SrcTraits, SrcFormat, DstTraits, DstFormat>(src, dst, count);
+        }
+    } else if constexpr (SrcSpace == DstSpace && std::is_integral_v<S> && std::is_integral_v<T>) {
+        rescale<SrcTraits, SrcFormat, DstTraits, DstFormat>(src, dst, count);
+    } else if constexpr (sizeof(S) == 1) {
+        lookup<SrcTraits, SrcFormat, SrcSpace, DstTraits, DstFormat, DstSpace>(src, dst, count);
+    } else {
+        float_pipeline<SrcTraits, SrcFormat, SrcSpace, DstTraits, DstFormat, DstSpace>(src, dst, count);
+    }
+}
+
+template<
+  ColorFormat SrcFormat, ColorSpace SrcSpace, typename SrcTraits, typename SrcAllocator, //
+  ColorFormat DstFormat, ColorSpace DstSpace, typename DstTraits, typename DstAllocator>
+tl::expected<void, std::string_view> convert(
+  NewImage<SrcFormat, SrcSpace, SrcTraits, SrcAllocator> const& src, NewImage<DstFormat, DstSpace, DstTraits, DstAllocator>& dst,
+  ThreadPool& pool = ThreadPool::global()
+) {
+    if (src.dimensions() != dst.dimensions())
+        return tl::unexpected { "Image dimensions do not match" };
+
+    if (src.pixel_count() == 0)
+        return {};
+
+    if (static_cast<const void*>(src.data()) == static_cast<const void*>(dst.data()))
+        return tl::unexpected { "Can not convert in place" };
+
+    const auto width = src.dimensions()[0];
+    const auto* const src_pixels = src.pixels().data();
+    auto* const dst_pixels = dst.pixels().data();
+
+    // rows are contiguous, so a range of rows is a range of pixels
+    pool.parallel_for(0, src.dimensions()[1], std::max<size_t>(1, parallel_grain / std::max<size_t>(width, 1)), [&](size_t first, size_t last) {
+        convert_pixels<SrcTraits, SrcFormat, SrcSpace, DstTraits, DstFormat, DstSpace>(
+          src_pixels + first * width, dst_pixels + first * width, (last - first) * width
+        );
+    });
+
+    return {};
+}
+
+/// Converts into a new image
+template<
+  ColorFormat DstFormat, ColorSpace DstSpace, typename DstTraits = ColorTraits<DstFormat, DstSpace>,
+  typename DstAllocator = std::allocator<typename DstTraits::color_type>, ColorFormat SrcFormat, ColorSpace SrcSpace, typename SrcTraits,
+  typename SrcAllocator>
+NewImage<DstFormat, DstSpace, DstTraits, DstAllocator> convert(
+  NewImage<SrcFormat, SrcSpace, SrcTraits, SrcAllocator> const& src, ThreadPool& pool = ThreadPool::global(),
+  DstAllocator const& allocator = DstAllocator()
+) {
+    NewImage<DstFormat, DstSpace, DstTraits, DstAllocator> dst(allocator);
+    dst.create(src.dimensions());
+
+    // the dimensions match and a new image can not alias `src`
+    std::ignore = convert(src, dst, pool);
+
+    return dst;
+}
+
+}
+
+namespace Stf::Gfx {
+
+using Detail::Convert::convert;
+
+}
@@ -0,0 +1,450 @@
+#pragma once
+
+#include <Stuff/Graphics/Convert.hpp>
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/SRGB.hpp>
+#include <Stuff/Graphics/Tiles.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Maths/Transcendental.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+
+/// Lazy per-pixel expressions over images, evaluated in a single pass when they are assigned to an image.\n
+/// `expression(image)` wraps a NewImage (or a legacy Image, read as RGBA8u sRGB) into an expression; expressions are
+/// combined with the arithmetic operators, the colour operations below (premultiply, to_linear, over...) and with
+/// `map`/`zip` for custom per-pixel functions. Nothing is computed until `assign(dst, e)` or `evaluate<...>(e)`.\n
+/// Every pixel is an RGBA float quadruplet holding the normalised channels as stored (see Convert.hpp), missing
+/// alpha channels read as opaque. No colour space conversion happens implicitly: sRGB images have to go through
+/// `to_linear` for linear maths. Results are clamped to [0, 1] only when they are stored into integer channels.\n
+/// Rows are split over a thread pool and evaluated in runs of up to `block_size` pixels. Each node of an expression
+/// turns a run into planes of floats with vectorised loops, so intermediate results stay in L1 instead of going
+/// through memory as whole images. Since a pixel is only ever read and written within its own run, the destination
+/// may also be an operand.\n
+/// `to_linear` straight on an 8 bit image and `to_srgb` assigned to an 8 bit image use the exact tables of the
+/// conversions instead of evaluating the transfer functions.
+namespace Stf::Gfx::Concepts {
+
+template<typename T>
+concept ImageExpression = requires(T const& e, Vector<size_t, 2> coords, size_t count, Detail::Convert::Planes& planes) {
+                              { e.dimensions() } -> std::convertible_to<std::optional<Vector<size_t, 2>>>;
+                              { e.matches(coords) } -> std::convertible_to<bool>;
+                              e.evaluate(coords, count, planes);
+                          };
+
+}
+
+namespace Stf::Gfx::Detail::Expression {
+
+using Convert::block_size;
+using Convert::Planes;
+
+/// Minimum number of pixels per parallel task
+inline constexpr size_t parallel_grain = 1uz << 16;
+
+inline constexpr size_t lanes = SIMD::native_lanes<float>;
+
+/// Calls `fn(offset, index, run)` for the runs of pixels of [x, x + count) on row y that are contiguous in `layout`,
+/// `offset` being the position of the run within [x, x + count) and `index` its storage index
+template<typename Layout, typename Fn> void for_each_run(Layout const& layout, Vector<size_t, 2> origin, size_t count, Fn&& fn) {
+    const auto [x, y] = origin;
+    const auto row = layout.row_offset(y);
+
+    for (auto i = 0uz; i < count;) {
+        const auto run = std::min(count - i, Tiles::run_left(Layout::contiguous_run, x + i));
+        std::invoke(fn, i, layout.column_offset(x + i) + row, run);
+        i += run;
+    }
+}
+
+template<typename Layout> inline constexpr bool is_row_major = Layout::contiguous_run == std::numeric_limits<size_t>::max();
+
+/// Pixels of an image, 8 bit ones can be linearised with an exact table as they are read
+template<typename Traits, ColorFormat Format, typename Layout, bool Linearize = false> struct Source {
+    using color_type = typename Traits::color_type;
+
+    const color_type* pixels;
+    Vector<size_t, 2> extent;
+    Layout layout;
+
+    constexpr std::optional<Vector<size_t, 2>> dimensions() const { return extent; }
+    constexpr bool matches(Vector<size_t, 2> dims) const { return extent == dims; }
+
+    void evaluate(Vector<size_t, 2> origin, size_t count, Planes& out) const {
+        constexpr auto from = Linearize ? ColorSpace::SRGB : ColorSpace::Linear;
+
+        if constexpr (is_row_major<Layout>) {
+            Convert::unpack<Traits, Format, from, ColorSpace::Linear>(pixels + layout(origin), out, count);
+        } else {
+            std::array<color_type, block_size> staging;
+            for_each_run(layout, origin, count, [&](size_t offset, size_t index, size_t run) { std::copy_n(pixels + index, run, staging.data() + offset); });
+            Convert::unpack<Traits, Format, from, ColorSpace::Linear>(staging.data(), out, count);
+        }
+    }
+};
+
+/// The same colour everywhere, fits images of any size
+struct Constant {
+    std::array<float, 4> value;
+
+    constexpr std::optional<Vector<size_t, 2>> dimensions() const { return std::nullopt; }
+    constexpr bool matches(Vector<size_t, 2>) const { return true; }
+
+    void evaluate(Vector<size_t, 2>, size_t count, Planes& out) const {
+        for (auto c = 0uz; c < 4; c++)
+            std::fill_n(out[c].data(), count, value[c]);
+    }
+};
+
+/// `op(planes, count)` applied in place to the result of `e`
+template<Concepts::ImageExpression E, typename Op> struct PlaneMap {
+    E e;
+    Op op;
+
+    constexpr std::optional<Vector<size_t, 2>> dimensions() const { return e.dimensions(); }
+    constexpr bool matches(Vector<size_t, 2> dims) const { return e.matches(dims); }
+
+    void evaluate(Vector<size_t, 2> origin, size_t count, Planes& out) const {
+        e.evaluate(origin, count, out);
+        std::invoke(op, out, count);
+    }
+};
+
+/// `op(lhs_planes, rhs_planes, count)` writing into the planes of `lhs`
+template<Concepts::ImageExpression E0, Concepts::ImageExpression E1, typename Op> struct PlaneZip {
+    E0 lhs;
+    E1 rhs;
+    Op op;
+
+    constexpr std::optional<Vector<size_t, 2>> dimensions() const {
+        const auto ret = lhs.dimensions();
+        return ret ? ret : rhs.dimensions();
+    }
+
+    constexpr bool matches(Vector<size_t, 2> dims) const { return lhs.matches(dims) && rhs.matches(dims); }
+
+    void evaluate(Vector<size_t, 2> origin, size_t count, Planes& out) const {
+        lhs.evaluate(origin, count, out);
+
+        alignas(SIMD::native_width) Planes other;
+        rhs.evaluate(origin, count, other);
+
+        std::invoke(op, out, other, count);
+    }
+};
+
+template<typename Fn> struct Arithmetic {
+    void operator()(Planes& out, Planes const& other, size_t count) const {
+        for (auto c = 0uz; c < 4; c++)
+            for (auto i = 0uz; i < count; i++)
+                out[c][i] = Fn {}(out[c][i], other[c][i]);
+    }
+};
+
+/// `value` on the right hand side of `Fn`, or on the left if `Flipped`
+template<typename Fn, bool Flipped = false> struct ScalarArithmetic {
+    std::array<float, 4> value;
+
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 4; c++) {
+            const auto v = value[c];
+            for (auto i = 0uz; i < count; i++)
+                out[c][i] = Flipped ? Fn {}(v, out[c][i]) : Fn {}(out[c][i], v);
+        }
+    }
+};
+
+struct Premultiply {
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 3; c++)
+            for (auto i = 0uz; i < count; i++)
+                out[c][i] *= out[3][i];
+    }
+};
+
+/// Fully transparent pixels go to 0
+struct Unpremultiply {
+    void operator()(Planes& out, size_t count) const {
+        for (auto i = 0uz; i < count; i++) {
+            const auto a = out[3][i];
+            const auto inverse = a != 0.f ? 1.f / a : 0.f;
+            for (auto c = 0uz; c < 3; c++)
+                out[c][i] *= inverse;
+        }
+    }
+};
+
+struct Clamp {
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 4; c++)
+            Convert::clamp_unit(std::span(out[c]).first(count));
+    }
+};
+
+/// Colour channels only, like the conversions
+struct ToLinear {
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 3; c++) {
+            const auto plane = std::span(out[c]).first(count);
+            Convert::clamp_unit(plane);
+            SRGB::to_linear_lut<float>(plane, plane);
+        }
+    }
+};
+
+struct ToSRGB {
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 3; c++) {
+            const auto plane = std::span(out[c]).first(count);
+            Convert::clamp_unit(plane);
+            SRGB::from_linear<float>(plane, plane);
+        }
+    }
+};
+
+/// Colour channels to the power of `exponent`, negative values go to 0
+struct Gamma {
+    float exponent;
+
+    void operator()(Planes& out, size_t count) const {
+        for (auto c = 0uz; c < 3; c++) {
+            const auto plane = std::span(out[c]).first(count);
+            for (auto& v : plane)
+                v = v > 0.f ? v : 0.f;
+            Stf::pow<float>(plane, exponent, plane);
+        }
+    }
+};
+
+/// Porter-Duff source over destination, both premultiplied
+struct Over {
+    void operator()(Planes& out, Planes const& other, size_t count) const {
+        for (auto c = 0uz; c < 4; c++)
+            for (auto i = 0uz; i < count; i++)
+                out[c][i] += other[c][i] * (1.f - out[3][i]);
+    }
+};
+
+/// Loads the pixels of planes `i` to `i + N`, as a vector per channel
+template<size_t N> constexpr auto load_pixels(Planes const& planes, size_t i) {
+    if constexpr (N == 1) {
+        return std::array<float, 4> { planes[0][i], planes[1][i], planes[2][i], planes[3][i] };
+    } else {
+        return std::array<SIMD::Vec<float, N>, 4> {
+            SIMD::load<N>(planes[0].data() + i),
+            SIMD::load<N>(planes[1].data() + i),
+            SIMD::load<N>(planes[2].data() + i),
+            SIMD::load<N>(planes[3].data() + i),
+        };
+    }
+}
+
+template<typename Pixel> constexpr void store_pixels(Planes& planes, size_t i, Pixel const& pixel) {
+    for (auto c = 0uz; c < 4; c++) {
+        if constexpr (std::is_same_v<Pixel, std::array<float, 4>>)
+            planes[c][i] = pixel[c];
+        else
+            SIMD::store(planes[c].data() + i, pixel[c]);
+    }
+}
+
+/// `fn(pixel)` on `lanes` pixels at a time and on single pixels for the rest, see `map`
+template<typename Fn> struct PixelMap {
+    Fn fn;
+
+    void operator()(Planes& out, size_t count) const {
+        auto i = 0uz;
+        for (; i + lanes <= count; i += lanes)
+            store_pixels(out, i, std::invoke(fn, load_pixels<lanes>(out, i)));
+        for (; i < count; i++)
+            store_pixels(out, i, std::invoke(fn, load_pixels<1>(out, i)));
+    }
+};
+
+template<typename Fn> struct PixelZip {
+    Fn fn;
+
+    void operator()(Planes& out, Planes const& other, size_t count) const {
+        auto i = 0uz;
+        for (; i + lanes <= count; i += lanes)
+            store_pixels(out, i, std::invoke(fn, load_pixels<lanes>(out, i), load_pixels<lanes>(other, i)));
+        for (; i < count; i++)
+            store_pixels(out, i, std::invoke(fn, load_pixels<1>(out, i), load_pixels<1>(other, i)));
+    }
+};
+
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, typename Layout>
+constexpr Source<Traits, Format, Layout> expression(NewImage<Format, Space, Traits, Allocator, Layout> const& image) {
+    return { image.pixels().data(), image.dimensions(), image.layout() };
+}
+
+/// Legacy images are RGBA8u sRGB
+template<typename Allocator> constexpr auto expression(Gfx::Image<Allocator> const& image) {
+    using traits = ColorTraits<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+    return Source<traits, ColorFormat::RGBA8u, Layouts::Linear> {
+        reinterpret_cast<const traits::color_type*>(image.data()),
+        image.dimensions(),
+        Layouts::Linear(image.dimensions()),
+    };
+}
+
+constexpr Constant constant(std::array<float, 4> value) { return { value }; }
+
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, Premultiply> premultiply(E const& e) { return { e, {} }; }
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, Unpremultiply> unpremultiply(E const& e) { return { e, {} }; }
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, Clamp> clamp(E const& e) { return { e, {} }; }
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, ToLinear> to_linear(E const& e) { return { e, {} }; }
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, ToSRGB> to_srgb(E const& e) { return { e, {} }; }
+
+template<typename Traits, ColorFormat Format, typename Layout>
+    requires(sizeof(typename Traits::channel_type) == 1)
+constexpr Source<Traits, Format, Layout, true> to_linear(Source<Traits, Format, Layout> const& e) {
+    return { e.pixels, e.extent, e.layout };
+}
+
+template<Concepts::ImageExpression E> constexpr PlaneMap<E, Gamma> gamma(E const& e, float exponent) { return { e, { exponent } }; }
+
+/// `src` over `dst`, both with premultiplied alpha
+template<Concepts::ImageExpression E0, Concepts::ImageExpression E1> constexpr PlaneZip<E0, E1, Over> over(E0 const& src, E1 const& dst) {
+    return { src, dst, {} };
+}
+
+/// `fn` receives and returns a `std::array<V, 4>` of RGBA channels where `V` is either a SIMD::Vec of floats or a
+/// float, so it has to be generic over both, e.g. `[](auto p) { p[3] = 1 - p[3]; return p; }`
+template<Concepts::ImageExpression E, typename Fn> constexpr PlaneMap<E, PixelMap<Fn>> map(E const& e, Fn fn) { return { e, { std::move(fn) } }; }
+
+/// As `map`, with `fn(lhs_pixel, rhs_pixel)`
+template<Concepts::ImageExpression E0, Concepts::ImageExpression E1, typename Fn>
+constexpr PlaneZip<E0, E1, PixelZip<Fn>> zip(E0 const& lhs, E1 const& rhs, Fn fn) {
+    return { lhs, rhs, { std::move(fn) } };
+}
+
+#define IMAGE_EXPRESSION_OPERATORS(EXPR_SYM, EXPR_OP_TYPE)                                                                                  \
+    template<Concepts::ImageExpression E0, Concepts::ImageExpression E1>                                                                    \
+    constexpr PlaneZip<E0, E1, Arithmetic<EXPR_OP_TYPE>> operator EXPR_SYM(E0 const& lhs, E1 const& rhs) {                                  \
+        return { lhs, rhs, {} };                                                                                                            \
+    }                                                                                                                                       \
+                                                                                                                                            \
+    template<Concepts::ImageExpression E>                                                                                                   \
+    constexpr PlaneMap<E, ScalarArithmetic<EXPR_OP_TYPE>> operator EXPR_SYM(E const& e, std::array<float, 4> value) {                       \
+        return { e, { value } };                                                                                                            \
+    }                                                                                                                                       \
+                                                                                                                                            \
+    template<Concepts::ImageExpression E>                                                                                                   \
+    constexpr PlaneMap<E, ScalarArithmetic<EXPR_OP_TYPE, true>> operator EXPR_SYM(std::array<float, 4> value, E const& e) {                 \
+        return { e, { value } };                                                                                                            \
+    }                                                                                                                                       \
+                                                                                                                                            \
+    template<Concepts::ImageExpression E> constexpr auto operator EXPR_SYM(E const& e, float v) { return e EXPR_SYM std::array { v, v, v, v }; } \
+    template<Concepts::ImageExpression E> constexpr auto operator EXPR_SYM(float v, E const& e) { return std::array { v, v, v, v } EXPR_SYM e; }
+
+IMAGE_EXPRESSION_OPERATORS(+, std::plus<float>)
+IMAGE_EXPRESSION_OPERATORS(-, std::minus<float>)
+IMAGE_EXPRESSION_OPERATORS(*, std::multiplies<float>)
+IMAGE_EXPRESSION_OPERATORS(/, std::divides<float>)
+
+#undef IMAGE_EXPRESSION_OPERATORS
+
+template<typename E> struct IsToSRGB : std::false_type { };
+template<typename E> struct IsToSRGB<PlaneMap<E, ToSRGB>> : std::true_type { };
+
+/// Evaluates `e` into `dst`, which may be one of the images `e` reads
+template<Concepts::ImageExpression E, ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, typename Layout>
+tl::expected<void, std::string_view> assign(NewImage<Format, Space, Traits, Allocator, Layout>& dst, E const& e, ThreadPool& pool = ThreadPool::global()) {
+    if (!e.matches(dst.dimensions()))
+        return tl::unexpected { "Image dimensions do not match" };
+
+    if (dst.pixel_count() == 0)
+        return {};
+
+    const auto [width, height] = dst.dimensions();
+    const auto& layout = dst.layout();
+    auto* const dst_pixels = dst.pixels().data();
+
+    // an sRGB encoding stored into 8 bits goes to the nearest code directly
+    constexpr auto quantize = IsToSRGB<E>::value && sizeof(typename Traits::channel_type) == 1;
+    const auto& root = [&]() -> auto const& {
+        if constexpr (quantize)
+            return e.e;
+        else
+            return e;
+    }();
+    const SRGB::U8Quantizer<float>* quantizer = nullptr;
+    if constexpr (quantize)
+        quantizer = &SRGB::from_linear_u8<float>;
+
+    pool.parallel_for(0, height, std::max<size_t>(1, parallel_grain / width), [&](size_t first, size_t last) {
+        alignas(SIMD::native_width) Planes planes;
+
+        for (auto y = first; y < last; y++) {
+            for (auto x = 0uz; x < width; x += block_size) {
+                const auto count = std::min(block_size, width - x);
+                root.evaluate({ x, y }, count, planes);
+
+                if constexpr (is_row_major<Layout>) {
+                    Convert::pack<Traits, Format>(planes, dst_pixels + layout({ x, y }), count, quantizer);
+                } else {
+                    std::array<typename Traits::color_type, block_size> staging;
+                    Convert::pack<Traits, Format>(planes, staging.data(), count, quantizer);
+                    for_each_run(layout, { x, y }, count, [&](size_t offset, size_t index, size_t run) {
+                        std::copy_n(staging.data() + offset, run, dst_pixels + index);
+                    });
+                }
+            }
+        }
+    });
+
+    return {};
+}
+
+/// Legacy images are RGBA8u sRGB
+template<Concepts::ImageExpression E, typename Allocator>
+tl::expected<void, std::string_view> assign(Gfx::Image<Allocator>& dst, E const& e, ThreadPool& pool = ThreadPool::global()) {
+    using image_type = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+    auto view = image_type::view({ reinterpret_cast<image_type::color_type*>(dst.data()), dst.pixel_count() }, dst.dimensions());
+    return assign(view, e, pool);
+}
+
+/// Evaluates `e` into a new image, `e` has to read at least one image to give it its dimensions
+template<
+  ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>,
+  typename Layout = Layouts::Linear, Concepts::ImageExpression E>
+tl::expected<NewImage<Format, Space, Traits, Allocator, Layout>, std::string_view>
+evaluate(E const& e, ThreadPool& pool = ThreadPool::global(), Allocator const& allocator = Allocator()) {
+    const auto dimensions = e.dimensions();
+    if (!dimensions)
+        return tl::unexpected { "Expression has no dimensions" };
+
+    NewImage<Format, Space, Traits, Allocator, Layout> ret(allocator);
+    ret.create(*dimensions);
+    TRYX(assign(ret, e, pool));
+
+    return ret;
+}
+
+}
+
+namespace Stf::Gfx {
+
+using Detail::Expression::assign;
+using Detail::Expression::clamp;
+using Detail::Expression::constant;
+using Detail::Expression::evaluate;
+using Detail::Expression::expression;
+using Detail::Expression::gamma;
+using Detail::Expression::map;
+using Detail::Expression::over;
+using Detail::Expression::premultiply;
+using Detail::Expression::to_linear;
+using Detail::Expression::to_srgb;
+using Detail::Expression::unpremultiply;
+using Detail::Expression::zip;
+
+}
@@ -0,0 +1,451 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Util/Alloc.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+/// Separable filtering of NewImage: resampling with area, triangle (bilinear) and Lanczos filters, box and Gaussian
+/// convolution, and mipmap chains.\n
+/// Images are filtered in their own encoding, channel by channel, alpha included (nothing is premultiplied and sRGB
+/// images are not linearised, see <Stuff/Graphics/Convert.hpp> for that). Samples past the edges repeat the edge
+/// pixels. Integer channels are rounded and clamped to their range when they are stored.\n
+/// A filter is a 1D kernel in destination pixels: `support()` is its radius and `operator()(x)` its weight at `x`.
+/// When downsampling, the kernel is stretched to cover the source pixels under each destination pixel.
+namespace Stf::Gfx::Filters {
+
+/// Averages the source pixels under each destination pixel, weighted by how much of them it covers. Repeats the
+/// nearest pixel when upsampling.
+struct Area { };
+
+/// Linear interpolation between the two nearest pixels, bilinear filtering in 2D
+struct Triangle {
+    constexpr double support() const { return 1.; }
+    constexpr double operator()(double x) const { return std::max(0., 1. - std::abs(x)); }
+};
+
+/// Windowed sinc with `lobes` lobes on each side
+struct Lanczos {
+    size_t lobes = 3;
+
+    constexpr double support() const { return static_cast<double>(lobes); }
+
+    double operator()(double x) const {
+        const auto a = static_cast<double>(lobes);
+        if (x == 0.)
+            return 1.;
+        if (std::abs(x) >= a)
+            return 0.;
+
+        const auto px = std::numbers::pi * x;
+        return a * std::sin(px) * std::sin(px / a) / (px * px);
+    }
+};
+
+/// Uniform weights over the `2 * radius + 1` nearest pixels
+struct Box {
+    size_t radius = 1;
+
+    constexpr double support() const { return static_cast<double>(radius); }
+    constexpr double operator()(double x) const { return std::abs(x) <= support() ? 1. : 0.; }
+};
+
+/// Cut off at 3 sigma. A sigma of 0 or less is the identity.
+struct Gaussian {
+    double sigma = 1.;
+
+    double support() const { return sigma > 0. ? std::ceil(3. * sigma) : 0.; }
+
+    double operator()(double x) const {
+        if (!(sigma > 0.))
+            return x == 0. ? 1. : 0.;
+        return std::abs(x) <= support() ? std::exp(-x * x / (2. * sigma * sigma)) : 0.;
+    }
+};
+
+}
+
+namespace Stf::Gfx {
+
+namespace Detail::Filter {
+
+/// Destination rows per parallel chunk are picked to cover about this many destination pixels
+inline constexpr size_t parallel_grain = 1 << 16;
+
+/// Width of the columns the vertical pass works in, so that the rows it combines stay in L1
+inline constexpr size_t column_block = 128;
+
+/// The weights of one axis: destination pixel `i` is the sum of `values[i * taps + k] * source[starts[i] + k]`.
+/// `starts` never decreases.\n
+/// The pixels in [uniform_begin, uniform_end) all have the weights of uniform_begin and start one pixel after one
+/// another, which is the interior of every convolution.
+struct Weights {
+    size_t taps = 0;
+    std::vector<size_t> starts {};
+    std::vector<float> values {};
+
+    size_t uniform_begin = 0;
+    size_t uniform_end = 0;
+};
+
+template<typename Filter> Weights make_weights(size_t src_size, size_t dst_size, Filter const& filter) {
+    const auto scale = static_cast<double>(src_size) / static_cast<double>(dst_size);
+    const auto last = static_cast<ptrdiff_t>(src_size) - 1;
+
+    // the unclamped source range of every destination pixel and the weight of the source pixel `j` in it
+    const auto window = [&](size_t i) -> std::pair<ptrdiff_t, ptrdiff_t> {
+        if constexpr (std::is_same_v<Filter, Filters::Area>) {
+            const auto lo = static_cast<ptrdiff_t>(std::floor(static_cast<double>(i) * scale));
+            const auto hi = static_cast<ptrdiff_t>(std::ceil(static_cast<double>(i + 1) * scale)) - 1;
+            return { std::min(lo, last), std::clamp(hi, lo, last) };
+        } else {
+            const auto center = (static_cast<double>(i) + 0.5) * scale - 0.5;
+            const auto support = filter.support() * std::max(scale, 1.);
+            const auto lo = static_cast<ptrdiff_t>(std::ceil(center - support));
+            const auto hi = static_cast<ptrdiff_t>(std::floor(center + support));
+
+            // a kernel narrower than the spacing of the source pixels samples the nearest one
+            if (hi < lo) {
+                const auto nearest = static_cast<ptrdiff_t>(std::floor(center + 0.5));
+                return { nearest, nearest };
+            }
+
+            return { lo, hi };
+        }
+    };
+
+    const auto weight = [&](size_t i, ptrdiff_t j) {
+        const auto x = static_cast<double>(j);
+        if constexpr (std::is_same_v<Filter, Filters::Area>) {
+            const auto from = static_cast<double>(i) * scale;
+            const auto to = static_cast<double>(i + 1) * scale;
+            return std::max(0., std::min(x + 1., to) - std::max(x, from));
+        } else {
+            const auto center = (static_cast<double>(i) + 0.5) * scale - 0.5;
+            return filter((x - center) / std::max(scale, 1.));
+        }
+    };
+
+    Weights ret {};
+    for (auto i = 0uz; i < dst_size; i++) {
+        const auto [lo, hi] = window(i);
+        ret.taps = std::max(ret.taps, static_cast<size_t>(std::clamp(hi, ptrdiff_t(0), last) - std::clamp(lo, ptrdiff_t(0), last) + 1));
+    }
+
+    ret.starts.resize(dst_size);
+    ret.values.resize(dst_size * ret.taps);
+
+    std::vector<double> acc(ret.taps);
+    for (auto i = 0uz; i < dst_size; i++) {
+        const auto [lo, hi] = window(i);
+        const auto start = std::min(static_cast<size_t>(std::clamp(lo, ptrdiff_t(0), last)), src_size - ret.taps);
+
+        // the weights of the pixels past the edges go to the edge pixels
+        std::fill(acc.begin(), acc.end(), 0.);
+        for (auto j = lo; j <= hi; j++)
+            acc[static_cast<size_t>(std::clamp(j, ptrdiff_t(0), last)) - start] += weight(i, j);
+
+        double sum = 0.;
+        for (const auto w : acc)
+            sum += w;
+
+        // a kernel that misses every source pixel gives all the weight to the middle of its window
+        if (sum == 0.) {
+            acc[static_cast<size_t>(std::clamp((lo + hi) / 2, ptrdiff_t(0), last)) - start] = 1.;
+            sum = 1.;
+        }
+
+        ret.starts[i] = start;
+        for (auto k = 0uz; k < ret.taps; k++)
+            ret.values[i * ret.taps + k] = static_cast<float>(acc[k] / sum);
+    }
+
+    // the longest run of shifted copies
+    const auto same_as = [&](size_t i, size_t j) {
+        return ret.starts[i] + (j - i) == ret.starts[j]
+            && std::equal(ret.values.begin() + i * ret.taps, ret.values.begin() + (i + 1) * ret.taps, ret.values.begin() + j * ret.taps);
+    };
+
+    for (auto begin = 0uz; begin < dst_size;) {
+        auto end = begin + 1;
+        while (end < dst_size && same_as(begin, end))
+            end++;
+
+        if (end - begin > ret.uniform_end - ret.uniform_begin) {
+            ret.uniform_begin = begin;
+            ret.uniform_end = end;
+        }
+
+        begin = end;
+    }
+
+    return ret;
+}
+
+/// Buffers reused by every call on the same thread
+struct Scratch {
+    /// One source row
+    std::vector<float, AlignedAllocator<float>> row {};
+    /// The horizontally filtered source rows of a chunk
+    std::vector<float, AlignedAllocator<float>> rows {};
+    /// A block of a destination row
+    std::vector<float, AlignedAllocator<float>> out {};
+};
+
+inline Scratch& scratch() {
+    thread_local Scratch ret {};
+    return ret;
+}
+
+template<typename T, size_t Channels> void unpack_row(const std::array<T, Channels>* src, float* out, size_t width) {
+    const auto* const channels = reinterpret_cast<const T*>(src);
+    for (auto i = 0uz; i < width * Channels; i++)
+        out[i] = static_cast<float>(channels[i]);
+}
+
+template<typename T, size_t Channels> void pack_row(const float* in, std::array<T, Channels>* dst, size_t width) {
+    auto* const channels = reinterpret_cast<T*>(dst);
+    const auto count = width * Channels;
+
+    if constexpr (std::is_floating_point_v<T>) {
+        for (auto i = 0uz; i < count; i++)
+            channels[i] = static_cast<T>(in[i]);
+    } else if constexpr (sizeof(T) < 4) {
+        constexpr auto max = static_cast<float>(std::numeric_limits<T>::max());
+        constexpr auto lanes = SIMD::native_lanes<float>;
+
+        auto i = 0uz;
+        for (; i + lanes <= count; i += lanes) {
+            auto v = SIMD::load<lanes>(in + i);
+            // NaN goes to 0
+            v = v > 0.f ? v : SIMD::Vec<float, lanes> {};
+            v = v < max ? v : SIMD::Vec<float, lanes> {} + max;
+            const auto words = SIMD::convert<int32_t>(v + 0.5f);
+            for (auto j = 0uz; j < lanes; j++)
+                channels[i + j] = static_cast<T>(words[j]);
+        }
+
+        for (; i < count; i++)
+            channels[i] = static_cast<T>((in[i] > 0.f ? std::min(in[i], max) : 0.f) + 0.5f);
+    } else {
+        constexpr auto max = static_cast<double>(std::numeric_limits<T>::max());
+        for (auto i = 0uz; i < count; i++)
+            channels[i] = static_cast<T>((in[i] > 0.f ? std::min(static_cast<double>(in[i]), max) : 0.) + 0.5);
+    }
+}
+
+template<size_t Channels> void filter_row(const float* in, float* out, Weights const& weights) {
+    const auto taps = weights.taps;
+    const auto width = weights.starts.size();
+
+    auto x = 0uz;
+
+    const auto filter_pixels = [&](size_t end) {
+        if constexpr (Channels == 4) {
+            // a pixel is a vector, a few pixels at once keep independent sums in flight
+            constexpr auto pixels = 4uz;
+            for (; x + pixels <= end; x += pixels) {
+                std::array<SIMD::Vec<float, 4>, pixels> acc {};
+                for (auto k = 0uz; k < taps; k++)
+                    for (auto p = 0uz; p < pixels; p++)
+                        acc[p] += weights.values[(x + p) * taps + k] * SIMD::load<4>(in + (weights.starts[x + p] + k) * 4);
+
+                for (auto p = 0uz; p < pixels; p++)
+                    SIMD::store(out + (x + p) * 4, acc[p]);
+            }
+        }
+
+        for (; x < end; x++) {
+            const auto* const w = weights.values.data() + x * taps;
+            const auto* const src = in + weights.starts[x] * Channels;
+
+            std::array<float, Channels> acc {};
+            for (auto k = 0uz; k < taps; k++)
+                for (auto c = 0uz; c < Channels; c++)
+                    acc[c] += w[k] * src[k * Channels + c];
+            std::copy(acc.begin(), acc.end(), out + x * Channels);
+        }
+    };
+
+    filter_pixels(weights.uniform_begin);
+
+    // the same weights for every channel of every pixel, whole vectors of channels at once
+    if (weights.uniform_end - weights.uniform_begin > 1) {
+        const auto* const w = weights.values.data() + weights.uniform_begin * taps;
+        constexpr auto lanes = SIMD::native_lanes<float>;
+
+        // from a destination channel to the first source channel it reads, which may be before it
+        const auto offset = static_cast<ptrdiff_t>(weights.starts[weights.uniform_begin] * Channels) - static_cast<ptrdiff_t>(weights.uniform_begin * Channels);
+
+        auto i = weights.uniform_begin * Channels;
+        for (const auto end = weights.uniform_end * Channels; i + lanes <= end; i += lanes) {
+            const auto* const src = in + (static_cast<ptrdiff_t>(i) + offset);
+            auto acc = w[0] * SIMD::load<lanes>(src);
+            for (auto k = 1uz; k < taps; k++)
+                acc += w[k] * SIMD::load<lanes>(src + k * Channels);
+            SIMD::store(out + i, acc);
+        }
+
+        // the pixels the vectors did not cover
+        x = i / Channels;
+    }
+
+    filter_pixels(width);
+}
+
+/// `out = sum(weights[k] * rows[k])` over rows of `count` floats `stride` floats apart
+inline void combine_rows(const float* rows, size_t stride, const float* weights, size_t taps, float* out, size_t count) {
+    constexpr auto lanes = SIMD::native_lanes<float>;
+
+    // a few independent sums in flight
+    constexpr auto vectors = 4uz;
+
+    auto i = 0uz;
+    for (; i + vectors * lanes <= count; i += vectors * lanes) {
+        std::array<SIMD::Vec<float, lanes>, vectors> acc {};
+        for (auto k = 0uz; k < taps; k++)
+            for (auto v = 0uz; v < vectors; v++)
+                acc[v] += weights[k] * SIMD::load<lanes>(rows + k * stride + i + v * lanes);
+
+        for (auto v = 0uz; v < vectors; v++)
+            SIMD::store(out + i + v * lanes, acc[v]);
+    }
+
+    for (; i + lanes <= count; i += lanes) {
+        auto acc = weights[0] * SIMD::load<lanes>(rows + i);
+        for (auto k = 1uz; k < taps; k++)
+            acc += weights[k] * SIMD::load<lanes>(rows + k * stride + i);
+        SIMD::store(out + i, acc);
+    }
+
+    for (; i < count; i++) {
+        auto acc = weights[0] * rows[i];
+        for (auto k = 1uz; k < taps; k++)
+            acc += weights[k] * rows[k * stride + i];
+        out[i] = acc;
+    }
+}
+
+/// Every chunk of destination rows filters the source rows it needs horizontally into the thread's scratch, then
+/// combines them vertically. Chunks share a few source rows at their boundaries, which are filtered by both.
+template<typename Traits, typename SrcImage, typename DstImage>
+void run(SrcImage const& src, DstImage& dst, Weights const& horizontal, Weights const& vertical, ThreadPool& pool) {
+    constexpr auto channels = Traits::channel_count;
+
+    const auto [src_width, src_height] = src.dimensions();
+    const auto [dst_width, dst_height] = dst.dimensions();
+    const auto row_size = dst_width * channels;
+
+    const auto* const src_pixels = src.pixels().data();
+    auto* const dst_pixels = dst.pixels().data();
+
+    pool.parallel_for(0, dst_height, std::max<size_t>(1, parallel_grain / dst_width), [&](size_t first, size_t last) {
+        auto& buffers = scratch();
+
+        const auto first_row = vertical.starts[first];
+        const auto last_row = vertical.starts[last - 1] + vertical.taps;
+
+        buffers.row.resize(src_width * channels);
+        buffers.rows.resize((last_row - first_row) * row_size);
+        buffers.out.resize(column_block * channels);
+
+        for (auto y = first_row; y < last_row; y++) {
+            unpack_row(src_pixels + y * src_width, buffers.row.data(), src_width);
+            filter_row<channels>(buffers.row.data(), buffers.rows.data() + (y - first_row) * row_size, horizontal);
+        }
+
+        for (auto x = 0uz; x < dst_width; x += column_block) {
+            const auto width = std::min(column_block, dst_width - x);
+
+            for (auto y = first; y < last; y++) {
+                const auto* const rows = buffers.rows.data() + (vertical.starts[y] - first_row) * row_size + x * channels;
+                combine_rows(rows, row_size, vertical.values.data() + y * vertical.taps, vertical.taps, buffers.out.data(), width * channels);
+                pack_row(buffers.out.data(), dst_pixels + y * dst_width + x, width);
+            }
+        }
+    });
+}
+
+}
+
+/// Resamples `src` to the dimensions of `dst`
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename SrcAllocator, typename DstAllocator, typename Filter = Filters::Triangle>
+tl::expected<void, std::string_view> resample(
+  NewImage<Format, Space, Traits, SrcAllocator> const& src, NewImage<Format, Space, Traits, DstAllocator>& dst, Filter const& filter = Filter(),
+  ThreadPool& pool = ThreadPool::global()
+) {
+    if (dst.pixel_count() == 0)
+        return {};
+
+    if (src.pixel_count() == 0)
+        return tl::unexpected { "Can not resample an empty image" };
+
+    if (static_cast<const void*>(src.data()) == static_cast<const void*>(dst.data()))
+        return tl::unexpected { "Can not filter in place" };
+
+    const auto horizontal = Detail::Filter::make_weights(src.dimensions()[0], dst.dimensions()[0], filter);
+    const auto vertical = Detail::Filter::make_weights(src.dimensions()[1], dst.dimensions()[1], filter);
+    Detail::Filter::run<Traits>(src, dst, horizontal, vertical, pool);
+
+    return {};
+}
+
+/// Resamples into a new image of the given dimensions
+template<typename Filter = Filters::Triangle, ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator>
+NewImage<Format, Space, Traits, Allocator> resize(
+  NewImage<Format, Space, Traits, Allocator> const& src, Vector<size_t, 2> dimensions, Filter const& filter = Filter(),
+  ThreadPool& pool = ThreadPool::global(), Allocator const& allocator = Allocator()
+) {
+    NewImage<Format, Space, Traits, Allocator> dst(allocator);
+    dst.create(src.pixel_count() == 0 ? Vector<size_t, 2> { 0, 0 } : dimensions);
+
+    // the source is not empty unless the destination is, and a new image can not alias it
+    std::ignore = resample(src, dst, filter, pool);
+
+    return dst;
+}
+
+/// Convolves both axes with `filter` (Filters::Box, Filters::Gaussian...) at the same size
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename SrcAllocator, typename DstAllocator, typename Filter>
+tl::expected<void, std::string_view> convolve(
+  NewImage<Format, Space, Traits, SrcAllocator> const& src, NewImage<Format, Space, Traits, DstAllocator>& dst, Filter const& filter,
+  ThreadPool& pool = ThreadPool::global()
+) {
+    if (src.dimensions() != dst.dimensions())
+        return tl::unexpected { "Image dimensions do not match" };
+
+    return resample(src, dst, filter, pool);
+}
+
+/// The levels below `src` down to 1x1, each half the size of the previous one (rounded down), each resampled from the
+/// previous one
+template<typename Filter = Filters::Area, ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator>
+std::vector<NewImage<Format, Space, Traits, Allocator>> mipmaps(
+  NewImage<Format, Space, Traits, Allocator> const& src, Filter const& filter = Filter(), ThreadPool& pool = ThreadPool::global(),
+  Allocator const& allocator = Allocator()
+) {
+    std::vector<NewImage<Format, Space, Traits, Allocator>> ret {};
+
+    const auto next_dimensions = [](Vector<size_t, 2> dims) -> Vector<size_t, 2> {
+        return { std::max<size_t>(1, dims[0] / 2), std::max<size_t>(1, dims[1] / 2) };
+    };
+
+    if (src.pixel_count() == 0)
+        return ret;
+
+    for (auto dims = src.dimensions(); dims[0] > 1 || dims[1] > 1;) {
+        dims = next_dimensions(dims);
+        auto level = resize(ret.empty() ? src : ret.back(), dims, filter, pool, allocator);
+        ret.emplace_back(std::move(level));
+    }
+
+    return ret;
+}
+
+}
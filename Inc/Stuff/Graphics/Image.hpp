@@ -2,58 +2,120 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
 #include <iterator>
 #include <memory>
 #include <span>
+#include <utility>
 
 #include <Stuff/Maths/BLAS/Vector.hpp>
 
+#include "./Image/Layout.hpp"
 #include "./Traits.hpp"
 
 namespace Stf::Gfx {
 
-template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+/// Pixels are stored as laid out by `Layout` (see Layouts), row-major by default
+template<
+  ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>,
+  typename Layout = Layouts::Linear>
 struct NewImage {
     using traits = Traits;
+    using layout_type = Layout;
     using channel_type = typename traits::channel_type;
     using color_type = typename traits::color_type;
 
     constexpr NewImage(Allocator const& allocator = Allocator())
      : m_allocator(allocator) {}
 
+    constexpr NewImage(NewImage const&) = delete;
+
+    constexpr NewImage(NewImage&& other) noexcept
+        : m_allocator(other.m_allocator)
+        , m_dimensions(std::exchange(other.m_dimensions, { 0, 0 }))
+        , m_layout(std::exchange(other.m_layout, Layout {}))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_owning(other.m_owning) { }
+
     constexpr ~NewImage() noexcept {
         destroy();
     }
 
+    constexpr NewImage& operator=(NewImage const&) = delete;
+
+    constexpr NewImage& operator=(NewImage&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        destroy();
+
+        m_allocator = other.m_allocator;
+        m_dimensions = std::exchange(other.m_dimensions, { 0, 0 });
+        m_layout = std::exchange(other.m_layout, Layout {});
+        m_data = std::exchange(other.m_data, nullptr);
+        m_owning = other.m_owning;
+
+        return *this;
+    }
+
+    /// Non-owning image over `pixels` which have to outlive it. `pixels` must hold at least
+    /// `Layout(dimensions).storage_count()` colors.
+    static constexpr NewImage view(std::span<color_type> pixels, Vector<size_t, 2> dimensions, Allocator const& allocator = Allocator()) {
+        NewImage ret(allocator);
+        ret.m_dimensions = dimensions;
+        ret.m_layout = Layout(dimensions);
+        ret.m_data = pixels.data();
+        ret.m_owning = false;
+        return ret;
+    }
+
     /// Resets the image data and creates a new image with the specified
     /// information. Can be called multiple times.
     constexpr void create(Vector<size_t, 2> dimensions) {
         destroy();
         m_dimensions = dimensions;
-        m_data = m_allocator.allocate(pixel_count());
+        m_layout = Layout(dimensions);
+        m_data = m_allocator.allocate(storage_count());
+        m_owning = true;
     }
 
-    /// Resets the image
+    /// Resets the image, views let go of their pixels without freeing them
     constexpr void destroy() noexcept {
         if (m_data != nullptr) {
-            m_allocator.deallocate(m_data, pixel_count());
+            if (m_owning)
+                m_allocator.deallocate(m_data, storage_count());
+
+            m_data = nullptr;
             m_dimensions = { 0, 0 };
+            m_layout = Layout {};
         }
     }
 
+    /// Whether the pixels belong to this image, false for views
+    constexpr bool owning() const { return m_owning; }
+
     inline const uint8_t* data() const { return reinterpret_cast<const uint8_t*>(m_data); }
     inline uint8_t* data() { return reinterpret_cast<uint8_t*>(m_data); }
-    constexpr size_t size() { return pixel_count() * sizeof(color_type); }
+    constexpr size_t size() const { return storage_count() * sizeof(color_type); }
 
     constexpr Vector<size_t, 2> dimensions() const { return m_dimensions; }
 
-    constexpr std::span<color_type> pixels() { return { m_data, pixel_count() }; }
-    constexpr std::span<const color_type> pixels() const { return { m_data, pixel_count() }; }
+    constexpr Layout const& layout() const { return m_layout; }
+
+    /// All of the stored pixels in storage order, padding included
+    constexpr std::span<color_type> pixels() { return { m_data, storage_count() }; }
+    constexpr std::span<const color_type> pixels() const { return { m_data, storage_count() }; }
     constexpr size_t pixel_count() const { return m_dimensions[0] * m_dimensions[1]; }
+    /// The number of stored pixels, more than pixel_count() for layouts that pad the image
+    constexpr size_t storage_count() const { return m_layout.storage_count(); }
 
-    constexpr void fill(color_type color) { std::fill_n(m_data, pixel_count(), color); }
+    constexpr void fill(color_type color) { std::fill_n(m_data, storage_count(), color); }
 
-    constexpr size_t coords_to_index(Vector<size_t, 2> coords) const { return coords[0] + coords[1] * m_dimensions[0]; }
+    constexpr size_t coords_to_index(Vector<size_t, 2> coords) const { return m_layout(coords); }
+
+    /// Tiles of the layout's preferred size, see for_each_tile for processing them in parallel
+    constexpr TileGrid tiles() const { return tiles(Layout::tile_dimensions); }
+    constexpr TileGrid tiles(Vector<size_t, 2> tile_dimensions) const { return { m_dimensions, tile_dimensions }; }
 
     constexpr color_type& operator[](size_t index) & { return m_data[index]; }
     constexpr color_type operator[](size_t index) const& { return m_data[index]; }
@@ -66,8 +128,10 @@ private:
     Allocator m_allocator;
 
     Vector<size_t, 2> m_dimensions { 0, 0 };
+    Layout m_layout {};
 
     color_type* m_data { nullptr };
+    bool m_owning = true;
 };
 
 using Color = std::array<uint8_t, 4>;
@@ -85,19 +149,34 @@ template<typename Allocator = std::allocator<uint8_t>> struct Image {
     constexpr Image(Allocator const& alloc = Allocator()) noexcept
         : m_allocator(alloc) { }
 
-    constexpr Image(Image const& other, Allocator const& alloc = Allocator()) noexcept(noexcept(Allocator(alloc)))
-        : m_allocator(alloc) {
+    constexpr Image(Image const& other)
+        : Image(other, std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_allocator)) { }
+
+    constexpr Image(Image const& other, Allocator const& alloc)
+        : m_allocator(alloc)
+        , m_color_format_hint(other.m_color_format_hint)
+        , m_color_space_hint(other.m_color_space_hint) {
         create(other.m_width, other.m_height);
-        std::copy_n(other.m_data, m_capacity, m_data);
+        std::copy_n(other.m_data, size(), m_data);
     }
 
-    constexpr Image(Image&& other, Allocator const& alloc = Allocator()) noexcept(noexcept(Allocator(alloc)))
-        : m_allocator(alloc)
-        , m_width(other.m_width)
-        , m_height(other.m_height)
-        , m_data(other.m_data) {
-        other.m_data = nullptr;
-        other.reset();
+    constexpr Image(Image&& other) noexcept
+        : m_allocator(other.m_allocator) {
+        take(other);
+    }
+
+    /// Takes the buffer of `other` if `alloc` can free it, copies it otherwise
+    constexpr Image(Image&& other, Allocator const& alloc)
+        : m_allocator(alloc) {
+        if (m_allocator == other.m_allocator) {
+            take(other);
+        } else {
+            m_color_format_hint = other.m_color_format_hint;
+            m_color_space_hint = other.m_color_space_hint;
+            create(other.m_width, other.m_height);
+            std::copy_n(other.m_data, size(), m_data);
+            other.reset();
+        }
     }
 
     constexpr Image(size_t width, size_t height, Allocator const& alloc = Allocator()) noexcept(noexcept(Allocator(alloc)))
@@ -115,29 +194,39 @@ template<typename Allocator = std::allocator<uint8_t>> struct Image {
 
     constexpr ~Image() noexcept(noexcept(m_allocator.deallocate(m_data, m_width* m_height))) { reset(); }
 
-    constexpr Image& operator=(Image&& other) {
+    constexpr Image& operator=(Image&& other) noexcept {
+        if (this == &other)
+            return *this;
+
+        // the buffer has to go back to the allocator it came from
+        reset();
         m_allocator = other.m_allocator;
-        m_color_format_hint = other.m_color_format_hint;
-        m_color_space_hint = other.m_color_space_hint;
-        m_width = other.m_width;
-        m_height = other.m_height;
-        m_data = other.m_data;
-        other.m_data = nullptr;
-        other.reset();
+        take(other);
+
         return *this;
     }
 
+    /// Reuses the buffer if it already has the right size
     constexpr Image& operator=(Image const& other) {
-        m_allocator = other.m_allocator;
+        if (this == &other)
+            return *this;
+
+        if (!(m_allocator == other.m_allocator)) {
+            reset();
+            m_allocator = other.m_allocator;
+        }
+
         m_color_format_hint = other.m_color_format_hint;
         m_color_space_hint = other.m_color_space_hint;
 
         create(other.m_width, other.m_height);
-        std::copy_n(other.m_data, m_capacity, m_data);
+        std::copy_n(other.m_data, size(), m_data);
 
         return *this;
     }
 
+    constexpr allocator_type get_allocator() const { return m_allocator; }
+
     constexpr void fill(Color fill_color) {
         uint32_t col = std::bit_cast<uint32_t>(fill_color);
         auto* const out_ptr = reinterpret_cast<uint32_t*>(m_data);
@@ -179,7 +268,14 @@ template<typename Allocator = std::allocator<uint8_t>> struct Image {
         m_data = nullptr;
     }
 
+    /// Keeps the current buffer if it has the same size, the pixels are left unspecified either way
     constexpr void create(size_t width, size_t height) {
+        if (m_data != nullptr && m_capacity == width * height * 4) {
+            m_width = width;
+            m_height = height;
+            return;
+        }
+
         reset();
 
         m_width = width;
@@ -188,14 +284,21 @@ template<typename Allocator = std::allocator<uint8_t>> struct Image {
         m_data = m_allocator.allocate(m_capacity);
     }
 
-    constexpr void resize(size_t width, size_t height) {
-        Image image(width, height, m_allocator);
-        *this = image;
-    }
+    /// Does not resample, see <Stuff/Graphics/Filter.hpp>
+    constexpr void resize(size_t width, size_t height) { create(width, height); }
 
 private:
     allocator_type m_allocator;
 
+    constexpr void take(Image& other) noexcept {
+        m_color_format_hint = other.m_color_format_hint;
+        m_color_space_hint = other.m_color_space_hint;
+        m_width = std::exchange(other.m_width, 0);
+        m_height = std::exchange(other.m_height, 0);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_data = std::exchange(other.m_data, nullptr);
+    }
+
     ColorFormat m_color_format_hint = ColorFormat::RGBA8u;
     ColorSpace m_color_space_hint = ColorSpace::SRGB;
 
@@ -205,10 +308,48 @@ private:
     uint8_t* m_data = nullptr;
 };
 
+/// An Image shared between copies until one of them writes to it.\n
+/// Copies are O(1) and may be handed to other threads, the reference count is atomic. A single SharedImage object
+/// however is not synchronised: `write()` must not race with other uses of the same object.
+template<typename Allocator = std::allocator<uint8_t>> struct SharedImage {
+    using image_type = Image<Allocator>;
+    using allocator_type = Allocator;
+
+    SharedImage(Allocator const& alloc = Allocator())
+        : SharedImage(image_type(alloc)) { }
+
+    SharedImage(image_type&& image)
+        : m_image(std::allocate_shared<image_type>(image.get_allocator(), std::move(image))) { }
+
+    SharedImage(image_type const& image)
+        : m_image(std::allocate_shared<image_type>(image.get_allocator(), image)) { }
+
+    constexpr image_type const& read() const { return *m_image; }
+    constexpr image_type const& operator*() const { return read(); }
+    constexpr image_type const* operator->() const { return &read(); }
+
+    /// Clones the image first if it is shared with another SharedImage
+    image_type& write() {
+        if (m_image.use_count() > 1)
+            m_image = std::allocate_shared<image_type>(m_image->get_allocator(), *m_image);
+
+        // use_count() is a relaxed load, the fence orders the reads through copies released on other threads before
+        // the writes through this one
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return *m_image;
+    }
+
+    bool unique() const { return m_image.use_count() == 1; }
+    long use_count() const { return m_image.use_count(); }
+
+private:
+    std::shared_ptr<image_type> m_image;
+};
+
 }
 
 #include "./Image/QoI.ipp"
-// #include "./Image/TGA.ipp"
 
 namespace Gfx {
 
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <Stuff/Graphics/Convert.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+/// Row transfers between the interleaved pixels of file formats (e.g. BGR for TGA, big endian RGB for PPM) and the
+/// storage of a NewImage. Every transfer is a fixed byte permutation per pixel, which is done with one byte shuffle for
+/// several pixels at a time, or a plain memcpy when the two sides match.
+namespace Stf::Gfx::Detail::Image::Interleaved {
+
+/// How a file stores a pixel: `channels` samples of `sample_size` bytes, big endian when wider than a byte, and the
+/// sample holding the red, green, blue and alpha channels. Gray files hold the same sample for all three colors, a
+/// missing alpha is -1 and reads as opaque.
+struct FileLayout {
+    size_t channels;
+    size_t sample_size;
+    std::array<int, 4> samples;
+
+    constexpr size_t pixel_size() const { return channels * sample_size; }
+    constexpr bool has_alpha() const { return samples[3] >= 0; }
+};
+
+template<size_t SampleSize> inline constexpr FileLayout gray { 1, SampleSize, { 0, 0, 0, -1 } };
+template<size_t SampleSize> inline constexpr FileLayout gray_alpha { 2, SampleSize, { 0, 0, 0, 1 } };
+template<size_t SampleSize> inline constexpr FileLayout rgb { 3, SampleSize, { 0, 1, 2, -1 } };
+template<size_t SampleSize> inline constexpr FileLayout rgba { 4, SampleSize, { 0, 1, 2, 3 } };
+inline constexpr FileLayout bgr8 { 3, 1, { 2, 1, 0, -1 } };
+inline constexpr FileLayout bgra8 { 4, 1, { 2, 1, 0, 3 } };
+
+/// Offset of the byte of significance `significance` (0 = least) within a native integer of `size` bytes
+constexpr size_t native_byte(size_t significance, size_t size) {
+    return std::endian::native == std::endian::little ? significance : size - 1 - significance;
+}
+
+/// Source byte of every destination byte of a pixel, -1 for bytes set to 0xFF
+template<size_t N> using ByteMap = std::array<int, N>;
+
+/// File pixel -> image pixel, the samples have to be as wide as the channels
+template<FileLayout File, typename Traits, ColorFormat Format> constexpr ByteMap<sizeof(typename Traits::color_type)> read_map() {
+    constexpr auto size = sizeof(typename Traits::channel_type);
+    static_assert(File.sample_size == size);
+
+    ByteMap<sizeof(typename Traits::color_type)> ret {};
+    for (auto logical = 0uz; logical < 4; logical++) {
+        const auto index = Convert::layout_of(Format)[logical];
+        if (index < 0)
+            continue;
+
+        for (auto significance = 0uz; significance < size; significance++) {
+            const auto sample = File.samples[logical];
+            const auto to = static_cast<size_t>(index) * size + native_byte(significance, size);
+            ret[to] = sample < 0 ? -1 : static_cast<int>(static_cast<size_t>(sample) * size + size - 1 - significance);
+        }
+    }
+
+    return ret;
+}
+
+/// Image pixel -> file pixel, for files with distinct color samples
+template<FileLayout File, typename Traits, ColorFormat Format> constexpr ByteMap<File.pixel_size()> write_map() {
+    constexpr auto size = sizeof(typename Traits::channel_type);
+    static_assert(File.sample_size == size);
+
+    ByteMap<File.pixel_size()> ret {};
+    for (auto logical = 0uz; logical < 4; logical++) {
+        const auto sample = File.samples[logical];
+        if (sample < 0)
+            continue;
+
+        for (auto significance = 0uz; significance < size; significance++) {
+            const auto index = Convert::layout_of(Format)[logical];
+            const auto to = static_cast<size_t>(sample) * size + size - 1 - significance;
+            ret[to] = index < 0 ? -1 : static_cast<int>(static_cast<size_t>(index) * size + native_byte(significance, size));
+        }
+    }
+
+    return ret;
+}
+
+template<size_t SrcSize, size_t DstSize, ByteMap<DstSize> Map> constexpr bool is_identity() {
+    if constexpr (SrcSize != DstSize) {
+        return false;
+    } else {
+        for (auto i = 0uz; i < DstSize; i++)
+            if (Map[i] != static_cast<int>(i))
+                return false;
+        return true;
+    }
+}
+
+/// Bytes per shuffle, AVX-512 VBMI permutes a whole register, everything else shuffles within 16 byte lanes
+inline constexpr size_t shuffle_width =
+#if defined(__AVX512VBMI__)
+  64;
+#else
+  16;
+#endif
+
+/// Permutes the bytes of `count` pixels of `SrcSize` bytes into pixels of `DstSize` bytes as described by `Map`
+template<size_t SrcSize, size_t DstSize, ByteMap<DstSize> Map> void shuffle_pixels(const uint8_t* src, uint8_t* dst, size_t count) {
+    if constexpr (is_identity<SrcSize, DstSize, Map>()) {
+        std::memcpy(dst, src, count * SrcSize);
+    } else {
+        constexpr size_t width = shuffle_width;
+        constexpr size_t pixels = width / std::max(SrcSize, DstSize);
+        using V = SIMD::Vec<uint8_t, width>;
+
+        static constexpr auto indices = [] {
+            std::array<size_t, width> ret {};
+            for (auto i = 0uz; i < pixels * DstSize; i++) {
+                const auto from = Map[i % DstSize];
+                ret[i] = from < 0 ? width : i / DstSize * SrcSize + static_cast<size_t>(from);
+            }
+            return ret;
+        }();
+
+        const auto shuffle = []<size_t... Is>(V v, std::index_sequence<Is...>) {
+            return __builtin_shufflevector(v, SIMD::broadcast<width>(uint8_t(0xFF)), indices[Is]...);
+        };
+
+        size_t i = 0;
+        if constexpr (pixels != 0) {
+            // whole registers are loaded, the last pixels of a row go through the scalar loop instead of reading past it
+            for (; i * SrcSize + width <= count * SrcSize; i += pixels) {
+                const auto out = shuffle(SIMD::load<width>(src + i * SrcSize), std::make_index_sequence<width> {});
+                std::memcpy(dst + i * DstSize, &out, pixels * DstSize);
+            }
+        }
+
+        for (; i < count; i++)
+            for (auto b = 0uz; b < DstSize; b++)
+                dst[i * DstSize + b] = Map[b] < 0 ? uint8_t(0xFF) : src[i * SrcSize + static_cast<size_t>(Map[b])];
+    }
+}
+
+template<FileLayout File, typename Traits, ColorFormat Format>
+void read_pixels(const uint8_t* src, typename Traits::color_type* dst, size_t count) {
+    constexpr auto size = sizeof(typename Traits::color_type);
+    shuffle_pixels<File.pixel_size(), size, read_map<File, Traits, Format>()>(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+template<FileLayout File, typename Traits, ColorFormat Format>
+void write_pixels(const typename Traits::color_type* src, uint8_t* dst, size_t count) {
+    constexpr auto size = sizeof(typename Traits::color_type);
+    shuffle_pixels<size, File.pixel_size(), write_map<File, Traits, Format>()>(reinterpret_cast<const uint8_t*>(src), dst, count);
+}
+
+/// File pixels with a maximum sample value other than the full range of their width (e.g. a PPM with a maxval of 1023)
+/// or of a width other than the channels', rescaled to the full range of the channels with rounding
+template<FileLayout File, typename Traits, ColorFormat Format>
+void read_pixels_rescaled(const uint8_t* src, typename Traits::color_type* dst, size_t count, uint32_t max_value) {
+    using T = typename Traits::channel_type;
+    constexpr auto storage = Convert::layout_of(Format);
+    constexpr uint64_t channel_max = std::numeric_limits<T>::max();
+
+    for (auto i = 0uz; i < count; i++) {
+        const auto* const pixel = src + i * File.pixel_size();
+
+        typename Traits::color_type out;
+        for (auto logical = 0uz; logical < 4; logical++) {
+            if (storage[logical] < 0)
+                continue;
+
+            const auto sample = File.samples[logical];
+            if (sample < 0) {
+                out[storage[logical]] = static_cast<T>(channel_max);
+                continue;
+            }
+
+            uint64_t value = 0;
+            for (auto b = 0uz; b < File.sample_size; b++)
+                value = value << 8 | pixel[static_cast<size_t>(sample) * File.sample_size + b];
+
+            value = std::min<uint64_t>(value, max_value);
+            out[storage[logical]] = static_cast<T>((value * channel_max * 2 + max_value) / (uint64_t(max_value) * 2));
+        }
+
+        dst[i] = out;
+    }
+}
+
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <Stuff/Maths/BLAS/Vector.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+#if defined(__BMI2__)
+#include <immintrin.h>
+#endif
+
+/// Storage layouts of NewImage: how pixel coordinates map to the index of the pixel in memory.\n
+/// A layout is constructed from the image dimensions and provides:\n
+/// - `storage_count()`, the number of pixels to allocate, which may include padding\n
+/// - `operator()(coords)`, the index of a pixel, which is always `column_offset(x) + row_offset(y)` so that loops can
+///   hoist the row part\n
+/// - `contiguous_run`, horizontal runs of this many pixels starting at a multiple of it are contiguous in memory\n
+/// - `tile_dimensions`, the size of the blocks to walk the image in to stay in cache
+namespace Stf::Gfx::Layouts {
+
+/// Rows top to bottom, without padding
+struct Linear {
+    static constexpr size_t contiguous_run = std::numeric_limits<size_t>::max();
+    static constexpr Vector<size_t, 2> tile_dimensions { 64, 64 };
+
+    constexpr Linear() = default;
+
+    constexpr explicit Linear(Vector<size_t, 2> dimensions)
+        : m_width(dimensions[0])
+        , m_storage_count(dimensions[0] * dimensions[1]) { }
+
+    constexpr size_t storage_count() const { return m_storage_count; }
+
+    constexpr size_t column_offset(size_t x) const { return x; }
+    constexpr size_t row_offset(size_t y) const { return y * m_width; }
+
+    constexpr size_t operator()(Vector<size_t, 2> coords) const { return column_offset(coords[0]) + row_offset(coords[1]); }
+
+private:
+    size_t m_width = 0;
+    size_t m_storage_count = 0;
+};
+
+/// Row-major `Width`x`Height` tiles stored row-major one after the other. The image is padded to whole tiles.
+template<size_t Width = 8, size_t Height = Width> struct Tiled {
+    static_assert(std::has_single_bit(Width) && std::has_single_bit(Height), "tile dimensions must be powers of two");
+
+    static constexpr size_t contiguous_run = Width;
+    static constexpr Vector<size_t, 2> tile_dimensions { Width, Height };
+
+    constexpr Tiled() = default;
+
+    constexpr explicit Tiled(Vector<size_t, 2> dimensions)
+        : m_tile_row_size((dimensions[0] + Width - 1) / Width * Width * Height)
+        , m_storage_count(m_tile_row_size * ((dimensions[1] + Height - 1) / Height)) { }
+
+    constexpr size_t storage_count() const { return m_storage_count; }
+
+    constexpr size_t column_offset(size_t x) const { return x / Width * (Width * Height) + x % Width; }
+    constexpr size_t row_offset(size_t y) const { return y / Height * m_tile_row_size + y % Height * Width; }
+
+    constexpr size_t operator()(Vector<size_t, 2> coords) const { return column_offset(coords[0]) + row_offset(coords[1]); }
+
+private:
+    /// Pixels in a row of tiles
+    size_t m_tile_row_size = 0;
+    size_t m_storage_count = 0;
+};
+
+namespace Detail {
+
+/// Moves bit `i` of `v` to bit `2i`
+constexpr uint64_t spread_bits(uint32_t v) {
+#if defined(__BMI2__)
+    if (!std::is_constant_evaluated())
+        return _pdep_u64(v, 0x5555'5555'5555'5555ull);
+#endif
+
+    uint64_t x = v;
+    x = (x | (x << 16)) & 0x0000'FFFF'0000'FFFFull;
+    x = (x | (x << 8)) & 0x00FF'00FF'00FF'00FFull;
+    x = (x | (x << 4)) & 0x0F0F'0F0F'0F0F'0F0Full;
+    x = (x | (x << 2)) & 0x3333'3333'3333'3333ull;
+    x = (x | (x << 1)) & 0x5555'5555'5555'5555ull;
+    return x;
+}
+
+}
+
+/// Z-order curve: the bits of x and y are interleaved (x in the even bits) so that every aligned power of two square
+/// is contiguous. Each dimension is padded to a power of two, the bits the larger one has over the smaller one are
+/// stored above the interleaved ones.
+struct Morton {
+    static constexpr size_t contiguous_run = 2;
+    static constexpr Vector<size_t, 2> tile_dimensions { 64, 64 };
+
+    constexpr Morton() = default;
+
+    constexpr explicit Morton(Vector<size_t, 2> dimensions)
+        : m_interleaved_bits(std::min(std::bit_width(dimensions[0] - (dimensions[0] != 0)), std::bit_width(dimensions[1] - (dimensions[1] != 0))))
+        , m_storage_count(dimensions[0] == 0 || dimensions[1] == 0 ? 0 : std::bit_ceil(dimensions[0]) * std::bit_ceil(dimensions[1])) { }
+
+    constexpr size_t storage_count() const { return m_storage_count; }
+
+    /// The bits of x and y are disjoint, at most one of them has bits above the interleaved ones
+    constexpr size_t column_offset(size_t x) const { return offset(x, 0); }
+    constexpr size_t row_offset(size_t y) const { return offset(y, 1); }
+
+    constexpr size_t operator()(Vector<size_t, 2> coords) const { return column_offset(coords[0]) + row_offset(coords[1]); }
+
+private:
+    size_t m_interleaved_bits = 0;
+    size_t m_storage_count = 0;
+
+    constexpr size_t offset(size_t v, size_t shift) const {
+        const auto mask = (size_t(1) << m_interleaved_bits) - 1;
+        const auto low = static_cast<size_t>(Detail::spread_bits(static_cast<uint32_t>(v & mask))) << shift;
+        return low | (v >> m_interleaved_bits) << (2 * m_interleaved_bits);
+    }
+};
+
+}
+
+namespace Stf::Gfx {
+
+/// A block of an image, the ones at the right and bottom edges may be smaller than the rest
+struct Tile {
+    Vector<size_t, 2> origin;
+    Vector<size_t, 2> extent;
+};
+
+/// The tiles covering an image, row-major
+struct TileGrid {
+    struct iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Tile;
+        using difference_type = std::ptrdiff_t;
+
+        constexpr Tile operator*() const { return (*m_grid)[m_index]; }
+
+        constexpr iterator& operator++() {
+            ++m_index;
+            return *this;
+        }
+
+        constexpr iterator operator++(int) {
+            auto ret = *this;
+            ++m_index;
+            return ret;
+        }
+
+        constexpr bool operator==(iterator const& other) const { return m_index == other.m_index; }
+
+        const TileGrid* m_grid = nullptr;
+        size_t m_index = 0;
+    };
+
+    constexpr TileGrid(Vector<size_t, 2> dimensions, Vector<size_t, 2> tile_dimensions)
+        : m_dimensions(dimensions)
+        , m_tile_dimensions(tile_dimensions)
+        , m_tiles_per_row((dimensions[0] + tile_dimensions[0] - 1) / tile_dimensions[0])
+        , m_size(m_tiles_per_row * ((dimensions[1] + tile_dimensions[1] - 1) / tile_dimensions[1])) { }
+
+    constexpr size_t size() const { return m_size; }
+
+    constexpr Vector<size_t, 2> tile_dimensions() const { return m_tile_dimensions; }
+
+    constexpr Tile operator[](size_t index) const {
+        const Vector<size_t, 2> origin { index % m_tiles_per_row * m_tile_dimensions[0], index / m_tiles_per_row * m_tile_dimensions[1] };
+        return {
+            .origin = origin,
+            .extent = { std::min(m_tile_dimensions[0], m_dimensions[0] - origin[0]), std::min(m_tile_dimensions[1], m_dimensions[1] - origin[1]) },
+        };
+    }
+
+    constexpr iterator begin() const { return { this, 0 }; }
+    constexpr iterator end() const { return { this, m_size }; }
+
+private:
+    Vector<size_t, 2> m_dimensions;
+    Vector<size_t, 2> m_tile_dimensions;
+    size_t m_tiles_per_row;
+    size_t m_size;
+};
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/PNM.hpp>
+#include <Stuff/Graphics/Image/QoIStriped.hpp>
+#include <Stuff/Graphics/Image/Raw.hpp>
+#include <Stuff/Graphics/Image/TGA.hpp>
+#include <Stuff/Util/MMap.hpp>
+
+#include <memory>
+#include <string>
+
+/// Loaders that read images straight out of a read-only memory mapping of the file instead of through a stream or an
+/// intermediate buffer.
+namespace Stf::Gfx {
+
+namespace Detail::Image {
+
+inline tl::expected<std::unique_ptr<MMapStringView>, std::string_view> map_file(std::string const& filename) {
+    auto file = std::make_unique<MMapStringView>(filename, true);
+    if (file->data() == nullptr)
+        return tl::unexpected { "Could not map the file" };
+
+    return file;
+}
+
+inline std::span<const uint8_t> bytes_of(MMapStringView const& file) {
+    return { reinterpret_cast<const uint8_t*>(file.data()), file.size() };
+}
+
+}
+
+/// A raw image file (see Formats::Raw) mapped read-only and viewed in place. The pixels are paged in as they are read
+/// and never copied.
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>> struct MappedImage {
+    using image_type = NewImage<Format, Space, Traits>;
+
+    static tl::expected<MappedImage, std::string_view> open(std::string const& filename) {
+        auto file = TRYX(Detail::Image::map_file(filename));
+
+        // the mapping is read-only, the view is only ever handed out as const
+        const auto bytes = Detail::Image::bytes_of(*file);
+        auto image = TRYX((Formats::Raw::view<Format, Space, Traits>({ const_cast<uint8_t*>(bytes.data()), bytes.size() })));
+
+        return MappedImage(std::move(file), std::move(image));
+    }
+
+    image_type const& image() const { return m_image; }
+
+    image_type const* operator->() const { return &m_image; }
+
+    image_type const& operator*() const { return m_image; }
+
+private:
+    MappedImage(std::unique_ptr<MMapStringView>&& file, image_type&& image)
+        : m_file(std::move(file))
+        , m_image(std::move(image)) { }
+
+    std::unique_ptr<MMapStringView> m_file;
+    image_type m_image;
+};
+
+}
+
+namespace Stf::Gfx::Formats::Raw {
+
+/// Decodes the file into a new image that owns a copy of the pixels, see MappedImage for viewing the file in place
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> load(std::string const& filename, Allocator const& allocator = Allocator()) {
+    const auto file = TRYX(Gfx::Detail::Image::map_file(filename));
+    return decode<Format, Space, Traits>(Gfx::Detail::Image::bytes_of(*file), allocator);
+}
+
+}
+
+namespace Stf::Gfx::Formats::QoI {
+
+/// Decodes directly out of the mapping, which takes the contiguous input fast path of the decoder
+template<typename Allocator = std::allocator<uint8_t>>
+tl::expected<Gfx::Image<Allocator>, std::string_view> load(std::string const& filename, Allocator const& allocator = Allocator()) {
+    const auto file = TRYX(Gfx::Detail::Image::map_file(filename));
+    const auto bytes = Gfx::Detail::Image::bytes_of(*file);
+
+    return decode(bytes.data(), bytes.data() + bytes.size(), allocator);
+}
+
+template<typename Allocator = std::allocator<uint8_t>>
+tl::expected<Gfx::Image<Allocator>, std::string_view>
+load_striped(std::string const& filename, ThreadPool& pool = ThreadPool::global(), Allocator const& allocator = Allocator()) {
+    const auto file = TRYX(Gfx::Detail::Image::map_file(filename));
+    return decode_striped(Gfx::Detail::Image::bytes_of(*file), pool, allocator);
+}
+
+}
+
+namespace Stf::Gfx::Formats::TGA {
+
+/// Rows are converted straight out of the mapping
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> load(std::string const& filename, Allocator const& allocator = Allocator()) {
+    const auto file = TRYX(Gfx::Detail::Image::map_file(filename));
+    return decode<Format, Space, Traits>(Gfx::Detail::Image::bytes_of(*file), allocator);
+}
+
+}
+
+namespace Stf::Gfx::Formats::PNM {
+
+/// Samples are converted straight out of the mapping
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> load(std::string const& filename, Allocator const& allocator = Allocator()) {
+    const auto file = TRYX(Gfx::Detail::Image::map_file(filename));
+    return decode<Format, Space, Traits>(Gfx::Detail::Image::bytes_of(*file), allocator);
+}
+
+}
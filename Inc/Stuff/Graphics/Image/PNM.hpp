@@ -0,0 +1,261 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/Interleaved.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <vector>
+
+/// Binary Netpbm images: PGM (P5), PPM (P6) and PAM (P7) with 1 to 4 channels (gray, gray and alpha, RGB, RGB and
+/// alpha), 8 bit samples or big endian 16 bit samples.\n
+/// Samples whose maximum value is the full range of the channels they are read into (e.g. a maxval of 255 into 8 bit
+/// channels) are moved with one byte shuffle for several pixels at a time (see Interleaved), which also swaps the bytes
+/// of 16 bit samples. Anything else is rescaled sample by sample. The PAM tuple type is not checked, the channels are
+/// told apart by the depth alone.\n
+/// Images without alpha are encoded as PPM, images with alpha as PAM with the RGB_ALPHA tuple type, both with the full
+/// range of the channels as the maximum value.
+namespace Stf::Gfx::Detail::Image::PNM {
+
+enum class Kind : uint8_t {
+    PGM = 5,
+    PPM = 6,
+    PAM = 7,
+};
+
+struct Header {
+    Kind kind;
+    Vector<size_t, 2> dims;
+    /// Samples per pixel
+    size_t depth;
+    uint32_t max_value;
+
+    size_t data_offset = 0;
+
+    constexpr size_t sample_size() const { return max_value > 255 ? 2 : 1; }
+    constexpr size_t pixel_size() const { return depth * sample_size(); }
+
+    std::string to_string() const {
+        const auto dimensions = std::to_string(dims[0]) + ' ' + std::to_string(dims[1]);
+
+        if (kind != Kind::PAM)
+            return std::string { 'P', static_cast<char>('0' + static_cast<int>(kind)), '\n' } + dimensions + '\n' + std::to_string(max_value) + '\n';
+
+        constexpr std::array<const char*, 4> tuple_types { "GRAYSCALE", "GRAYSCALE_ALPHA", "RGB", "RGB_ALPHA" };
+
+        return "P7\nWIDTH " + std::to_string(dims[0]) + "\nHEIGHT " + std::to_string(dims[1]) + "\nDEPTH " + std::to_string(depth) + "\nMAXVAL "
+             + std::to_string(max_value) + "\nTUPLTYPE " + tuple_types[depth - 1] + "\nENDHDR\n";
+    }
+
+    static constexpr tl::expected<Header, std::string_view> from_bytes(std::span<const uint8_t> data) {
+        if (data.size() < 3 || data[0] != 'P' || data[1] < '5' || data[1] > '7')
+            return tl::unexpected { "Bad header magic" };
+
+        Header header {
+            .kind = static_cast<Kind>(data[1] - '0'),
+            .dims = { 0, 0 },
+            .depth = 0,
+            .max_value = 0,
+        };
+
+        auto it = data.begin() + 2;
+
+        const auto is_space = [](uint8_t c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f'; };
+
+        // whitespace and comments, which run to the end of the line
+        const auto skip = [&] {
+            while (it != data.end()) {
+                if (*it == '#')
+                    it = std::find(it, data.end(), '\n');
+                else if (is_space(*it))
+                    ++it;
+                else
+                    break;
+            }
+        };
+
+        const auto number = [&]() -> tl::expected<size_t, std::string_view> {
+            skip();
+            if (it == data.end())
+                return tl::unexpected { "Insufficient data (while reading the header)" };
+            if (*it < '0' || *it > '9')
+                return tl::unexpected { "Bad header number" };
+
+            size_t ret = 0;
+            for (; it != data.end() && *it >= '0' && *it <= '9'; ++it) {
+                ret = ret * 10 + (*it - '0');
+                if (ret > std::numeric_limits<uint32_t>::max())
+                    return tl::unexpected { "Bad header number" };
+            }
+
+            return ret;
+        };
+
+        if (header.kind != Kind::PAM) {
+            header.dims[0] = TRYX(number());
+            header.dims[1] = TRYX(number());
+            header.max_value = static_cast<uint32_t>(TRYX(number()));
+            header.depth = header.kind == Kind::PGM ? 1 : 3;
+
+            // exactly one whitespace character separates the maximum value from the samples
+            if (it == data.end())
+                return tl::unexpected { "Insufficient data (while reading the header)" };
+            if (!is_space(*it))
+                return tl::unexpected { "Bad header number" };
+            ++it;
+        } else {
+            const auto keyword = [&](std::string_view word) {
+                if (static_cast<size_t>(data.end() - it) < word.size() || !std::equal(word.begin(), word.end(), it))
+                    return false;
+
+                const auto after = it + static_cast<ptrdiff_t>(word.size());
+                if (after != data.end() && !is_space(*after))
+                    return false;
+
+                it = after;
+                return true;
+            };
+
+            for (;;) {
+                skip();
+                if (it == data.end())
+                    return tl::unexpected { "Insufficient data (while reading the header)" };
+
+                if (keyword("ENDHDR")) {
+                    // the line ends right after the keyword
+                    if (it == data.end() || *it++ != '\n')
+                        return tl::unexpected { "Insufficient data (while reading the header)" };
+                    break;
+                }
+
+                if (keyword("WIDTH"))
+                    header.dims[0] = TRYX(number());
+                else if (keyword("HEIGHT"))
+                    header.dims[1] = TRYX(number());
+                else if (keyword("DEPTH"))
+                    header.depth = TRYX(number());
+                else if (keyword("MAXVAL"))
+                    header.max_value = static_cast<uint32_t>(TRYX(number()));
+                else if (keyword("TUPLTYPE"))
+                    it = std::find(it, data.end(), '\n');
+                else
+                    return tl::unexpected { "Bad header keyword" };
+            }
+        }
+
+        if (header.dims[0] == 0 || header.dims[1] == 0)
+            return tl::unexpected { "Bad header dimensions" };
+
+        if (header.depth == 0 || header.depth > 4)
+            return tl::unexpected { "Unsupported depth, only 1 to 4 channels are supported" };
+
+        if (header.max_value == 0 || header.max_value > 65535)
+            return tl::unexpected { "Bad maximum value" };
+
+        header.data_offset = static_cast<size_t>(it - data.begin());
+
+        const auto [width, height] = header.dims;
+        if (height > std::numeric_limits<size_t>::max() / header.pixel_size() / width)
+            return tl::unexpected { "Image too large" };
+
+        if (data.size() - header.data_offset < width * height * header.pixel_size())
+            return tl::unexpected { "Insufficient data (while reading the pixels)" };
+
+        return header;
+    }
+
+    template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator>
+    static constexpr Header from_image(NewImage<Format, Space, Traits, Allocator> const& image) {
+        constexpr bool alpha = Traits::channel_count == 4;
+
+        return Header {
+            .kind = alpha ? Kind::PAM : Kind::PPM,
+            .dims = image.dimensions(),
+            .depth = Traits::channel_count,
+            .max_value = std::numeric_limits<typename Traits::channel_type>::max(),
+        };
+    }
+};
+
+template<Interleaved::FileLayout File, typename Traits, ColorFormat Format>
+void decode_pixels(Header const& header, const uint8_t* src, typename Traits::color_type* dst) {
+    using T = typename Traits::channel_type;
+
+    const auto count = header.dims[0] * header.dims[1];
+
+    if constexpr (File.sample_size == sizeof(T)) {
+        // rows are unpadded on both sides, the whole image goes at once
+        if (header.max_value == std::numeric_limits<T>::max())
+            return Interleaved::read_pixels<File, Traits, Format>(src, dst, count);
+    }
+
+    Interleaved::read_pixels_rescaled<File, Traits, Format>(src, dst, count, header.max_value);
+}
+
+template<size_t SampleSize, typename Traits, ColorFormat Format>
+void decode_pixels(Header const& header, const uint8_t* src, typename Traits::color_type* dst) {
+    switch (header.depth) {
+    case 1: return decode_pixels<Interleaved::gray<SampleSize>, Traits, Format>(header, src, dst);
+    case 2: return decode_pixels<Interleaved::gray_alpha<SampleSize>, Traits, Format>(header, src, dst);
+    case 3: return decode_pixels<Interleaved::rgb<SampleSize>, Traits, Format>(header, src, dst);
+    default: return decode_pixels<Interleaved::rgba<SampleSize>, Traits, Format>(header, src, dst);
+    }
+}
+
+/// Decodes into any of the unsigned integer formats, gray images are replicated into the color channels and images
+/// without alpha read as opaque
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> decode(std::span<const uint8_t> data, Allocator const& allocator = Allocator()) {
+    static_assert(std::is_unsigned_v<typename Traits::channel_type>, "Netpbm images are decoded into unsigned integer formats");
+
+    const auto header = TRYX(Header::from_bytes(data));
+
+    NewImage<Format, Space, Traits, Allocator> image(allocator);
+    image.create(header.dims);
+
+    auto* const dst = image.pixels().data();
+    if (header.sample_size() == 1)
+        decode_pixels<1, Traits, Format>(header, data.data() + header.data_offset, dst);
+    else
+        decode_pixels<2, Traits, Format>(header, data.data() + header.data_offset, dst);
+
+    return image;
+}
+
+/// Encodes 8 and 16 bit images, RGB as PPM and RGBA as PAM
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, std::output_iterator<uint8_t> OIter>
+OIter encode(OIter out_it, NewImage<Format, Space, Traits, Allocator> const& image) {
+    using T = typename Traits::channel_type;
+    static_assert(std::is_same_v<T, uint8_t> || std::is_same_v<T, uint16_t>, "Netpbm images are encoded from 8 and 16 bit formats");
+
+    constexpr auto file = Traits::channel_count == 4 ? Interleaved::rgba<sizeof(T)> : Interleaved::rgb<sizeof(T)>;
+
+    const auto header = Header::from_image(image).to_string();
+    out_it = std::copy(header.begin(), header.end(), out_it);
+
+    const auto [width, height] = image.dimensions();
+    const auto row_size = width * file.pixel_size();
+
+    std::vector<uint8_t> row(row_size);
+    for (auto y = 0uz; y < height; y++) {
+        Interleaved::write_pixels<file, Traits, Format>(image.pixels().data() + y * width, row.data(), width);
+        out_it = std::copy_n(row.data(), row_size, out_it);
+    }
+
+    return out_it;
+}
+
+}
+
+namespace Stf::Gfx::Formats::PNM {
+
+using Gfx::Detail::Image::PNM::decode;
+using Gfx::Detail::Image::PNM::encode;
+using Gfx::Detail::Image::PNM::Header;
+using Gfx::Detail::Image::PNM::Kind;
+
+}
@@ -5,6 +5,8 @@
 
 #include <concepts>
 #include <cstddef>
+#include <cstring>
+#include <iterator>
 
 // types etc.
 namespace Stf::Gfx::Detail::Image::QoI {
@@ -239,11 +241,17 @@ using QoIColorMap = ColorMap<uint8_t, 3, 5, 7, 11, 64>;
 
 namespace Stf::Gfx::Detail::Image::QoI {
 
+/// Operations with CheckRemaining = false do not check the output bounds, the caller must make sure that there is room
+/// for at least `unchecked_margin` more pixels. Runs are written in blocks of 4 pixels and may write past their end
+/// within that margin.
 struct QoIDecoder {
     using color_type = QoIColorMap::color_type;
 
-    uint8_t* const out_beg = nullptr;
-    uint8_t* const out_end = nullptr;
+    /// Longest run + rounding to the block size of run()
+    static constexpr size_t unchecked_margin = 64;
+
+    uint8_t* out_beg = nullptr;
+    uint8_t* out_end = nullptr;
     uint8_t* it = out_beg;
     QoIColorMap map {};
     color_type last_seen { 0, 0, 0, 255 };
@@ -292,6 +300,18 @@ struct QoIDecoder {
                 return false;
         }
 
+        if constexpr (!CheckRemaining) {
+            if !consteval {
+                const std::array<color_type, 4> block { last_seen, last_seen, last_seen, last_seen };
+
+                for (size_t i = 0; i <= run_length; i += block.size())
+                    std::memcpy(it + i * sizeof(color_type), block.data(), sizeof(block));
+
+                it += (run_length + 1) * sizeof(color_type);
+                return;
+            }
+        }
+
         for (uint8_t i = 0; i <= run_length; i++)
             it = std::copy_n(last_seen.begin(), 4, it);
 
@@ -316,12 +336,8 @@ struct QoIDecoder {
     }
 };
 
-template<std::input_iterator IIter> constexpr tl::expected<IIter, std::string_view> decode_payload(IIter it, IIter end, std::span<uint8_t> out_image_data) {
-    QoIDecoder state {
-        .out_beg = out_image_data.data(),
-        .out_end = out_image_data.data() + out_image_data.size(),
-    };
-
+/// Decodes blocks with bounds checks on both the input and the output, fails unless the output gets filled
+template<std::input_iterator IIter> constexpr tl::expected<IIter, std::string_view> decode_blocks(QoIDecoder& state, IIter it, IIter end) {
     while (state.it != state.out_end) {
         std::array<uint8_t, 4> extra_data = state.last_seen;
 
@@ -342,9 +358,66 @@ template<std::input_iterator IIter> constexpr tl::expected<IIter, std::string_vi
             return tl::unexpected { "Overflow while reading QoI blocks" };
     }
 
+    if (state.it != state.out_end)
+        return tl::unexpected { "Insufficient data (while reading QoI blocks)" };
+
+    return it;
+}
+
+/// Decodes blocks without any bounds checks for as long as a whole block of input and QoIDecoder::unchecked_margin
+/// pixels of output are left. Returns where it stopped, the rest is up to decode_blocks.
+constexpr const uint8_t* decode_blocks_unchecked(QoIDecoder& state, const uint8_t* it, const uint8_t* end) {
+    // RGBA blocks are the longest at 5 bytes
+    constexpr ptrdiff_t max_block_size = 5;
+
+    while (end - it >= max_block_size && state.has_remaining(QoIDecoder::unchecked_margin)) {
+        const uint8_t leading = *it++;
+
+        // a single jump on the 2 bit tag, the 8 bit RGB(A) tags hide in the run range as run lengths 62 and 63
+        switch (leading >> 6) {
+        case 0: state.index<false>(leading & 0x3F); break;
+        case 1: state.diff<false>((leading >> 4) & 3, (leading >> 2) & 3, leading & 3); break;
+        case 2:
+            state.luma<false>(leading & 0x3F, (it[0] >> 4) & 0xF, it[0] & 0xF);
+            it += 1;
+            break;
+        case 3:
+            if (leading < 0xFE) [[likely]] {
+                state.run<false>(leading & 0x3F);
+            } else if (leading == 0xFE) {
+                state.rgba<false>({ it[0], it[1], it[2], state.last_seen[3] });
+                it += 3;
+            } else {
+                state.rgba<false>({ it[0], it[1], it[2], it[3] });
+                it += 4;
+            }
+            break;
+        default: std::unreachable();
+        }
+    }
+
     return it;
 }
 
+template<std::input_iterator IIter> constexpr tl::expected<IIter, std::string_view> decode_payload(IIter it, IIter end, std::span<uint8_t> out_image_data) {
+    QoIDecoder state {
+        .out_beg = out_image_data.data(),
+        .out_end = out_image_data.data() + out_image_data.size(),
+    };
+
+    // byte buffers (pointers, std::vector<uint8_t>, std::span<const char>...) go through the unchecked fast path first
+    if constexpr (std::contiguous_iterator<IIter> && sizeof(std::iter_value_t<IIter>) == 1) {
+        if !consteval {
+            const auto* const begin = reinterpret_cast<const uint8_t*>(std::to_address(it));
+            const auto* const last = reinterpret_cast<const uint8_t*>(std::to_address(end));
+
+            it += decode_blocks_unchecked(state, begin, last) - begin;
+        }
+    }
+
+    return decode_blocks(state, it, end);
+}
+
 template<typename Allocator = std::allocator<uint8_t>, std::input_iterator IIter>
 constexpr tl::expected<IIter, std::string_view> decode(IIter begin, IIter end, Gfx::Image<Allocator>& image, std::optional<Header> given_header = std::nullopt) {
     IIter it = begin;
@@ -385,105 +458,103 @@ constexpr tl::expected<Gfx::Image<Allocator>, std::string_view> decode(IIter beg
     return image;
 }
 
-template<typename Allocator = std::allocator<uint8_t>, std::output_iterator<uint8_t> OIter>
-constexpr tl::expected<OIter, std::string_view> encode(OIter out_beg, Gfx::Image<Allocator> const& image) {
-    const auto header = TRYX(Header::from_image(image));
-    const auto header_bytes = header.to_bytes();
-
+/// QoI encoder state: pixels are pushed one by one and their chunks are written to an output iterator
+struct QoIEncoder {
     using color_type = QoIColorMap::color_type;
 
+    /// Most bytes written by a single push: a run that has to be cut short and an RGBA chunk
+    static constexpr size_t max_push_size = 6;
+
     QoIColorMap map {};
     color_type last_seen { 0, 0, 0, 255 };
     uint8_t run_length = 0;
-    auto out_it = std::copy(header_bytes.cbegin(), header_bytes.cend(), out_beg);
 
-    const auto do_emit_run = [&] {
-        *out_it++ = ((run_length - 1) & 0x3F) | 0xC0;
-        run_length = 0;
-    };
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter push(color_type cur, OIter out_it) {
+        const auto do_emit_run = [&] {
+            *out_it++ = ((run_length - 1) & 0x3F) | 0xC0;
+            run_length = 0;
+        };
 
-    const auto emit_run = [&](color_type pixel) {
-        if (run_length >= 62)
-            do_emit_run();
+        const auto emit_run = [&](color_type pixel) {
+            if (run_length >= 62)
+                do_emit_run();
 
-        if (pixel == last_seen) {
-            ++run_length;
-            return true;
-        } else if (run_length != 0) {
-            do_emit_run();
-        }
+            if (pixel == last_seen) {
+                ++run_length;
+                return true;
+            } else if (run_length != 0) {
+                do_emit_run();
+            }
 
-        return false;
-    };
+            return false;
+        };
 
-    const auto emit_rgba = [&](color_type pixel) {
-        bool emit_alpha = pixel[3] != last_seen[3];
+        const auto emit_rgba = [&](color_type pixel) {
+            bool emit_alpha = pixel[3] != last_seen[3];
 
-        if (emit_alpha)
-            *out_it++ = 0xFF;
-        else
-            *out_it++ = 0xFE;
+            if (emit_alpha)
+                *out_it++ = 0xFF;
+            else
+                *out_it++ = 0xFE;
 
-        *out_it++ = pixel[0];
-        *out_it++ = pixel[1];
-        *out_it++ = pixel[2];
-        if (emit_alpha)
-            *out_it++ = pixel[3];
-    };
+            *out_it++ = pixel[0];
+            *out_it++ = pixel[1];
+            *out_it++ = pixel[2];
+            if (emit_alpha)
+                *out_it++ = pixel[3];
+        };
 
-    const auto emit_index = [&](color_type pixel, uint8_t hash) {
-        if (map[hash] != pixel)
-            return false;
-        *out_it++ = hash & 0x3F;
-        return true;
-    };
+        const auto emit_index = [&](color_type pixel, uint8_t hash) {
+            if (map[hash] != pixel)
+                return false;
+            *out_it++ = hash & 0x3F;
+            return true;
+        };
 
-    const auto emit_diff = [&](color_type pixel) -> bool {
-        if (pixel[3] != last_seen[3])
-            return false;
+        const auto emit_diff = [&](color_type pixel) -> bool {
+            if (pixel[3] != last_seen[3])
+                return false;
 
-        std::array<int, 3> deltas {
-            pixel[0] - last_seen[0],
-            pixel[1] - last_seen[1],
-            pixel[2] - last_seen[2],
-        };
+            std::array<int, 3> deltas {
+                pixel[0] - last_seen[0],
+                pixel[1] - last_seen[1],
+                pixel[2] - last_seen[2],
+            };
 
-        for (auto& v : deltas)
-            v += 2;
+            for (auto& v : deltas)
+                v += 2;
 
-        if (!std::ranges::all_of(deltas, [](int v) { return 3 >= v && v >= 0; }))
-            return false;
+            if (!std::ranges::all_of(deltas, [](int v) { return 3 >= v && v >= 0; }))
+                return false;
 
-        deltas[0] <<= 4;
-        deltas[1] <<= 2;
+            deltas[0] <<= 4;
+            deltas[1] <<= 2;
 
-        *out_it++ = 0x40 | deltas[0] | deltas[1] | deltas[2];
-        return true;
-    };
+            *out_it++ = 0x40 | deltas[0] | deltas[1] | deltas[2];
+            return true;
+        };
 
-    const auto emit_luma = [&](color_type pixel) -> bool {
-        if (pixel[3] != last_seen[3])
-            return false;
+        const auto emit_luma = [&](color_type pixel) -> bool {
+            if (pixel[3] != last_seen[3])
+                return false;
 
-        const auto dg = pixel[1] - last_seen[1];
-        const auto dr = pixel[0] - last_seen[0] - dg;
-        const auto db = pixel[2] - last_seen[2] - dg;
+            const auto dg = pixel[1] - last_seen[1];
+            const auto dr = pixel[0] - last_seen[0] - dg;
+            const auto db = pixel[2] - last_seen[2] - dg;
 
-        if (-32 > dg || dg > 31 || -8 > dr || dr > 7 || -8 > db || db > 7)
-            return false;
+            if (-32 > dg || dg > 31 || -8 > dr || dr > 7 || -8 > db || db > 7)
+                return false;
 
-        const auto dro = dr + 8;
-        const auto dgo = dg + 32;
-        const auto dbo = db + 8;
+            const auto dro = dr + 8;
+            const auto dgo = dg + 32;
+            const auto dbo = db + 8;
 
-        *out_it++ = 0x80 | dgo;
-        *out_it++ = (dro << 4) | dbo;
+            *out_it++ = 0x80 | dgo;
+            *out_it++ = (dro << 4) | dbo;
 
-        return true;
-    };
+            return true;
+        };
 
-    for (size_t i = 0; i < image.pixel_count(); i++) {
-        const auto cur = image.get_pixel(i);
         const auto cur_hash = QoIColorMap::hash(cur);
 
         if (emit_run(cur))
@@ -499,22 +570,290 @@ constexpr tl::expected<OIter, std::string_view> encode(OIter out_beg, Gfx::Image
 
         last_seen = cur;
         map[cur_hash] = last_seen;
+
+        return out_it;
+    }
+
+    /// Emits the pending run, if any
+    template<std::output_iterator<uint8_t> OIter> constexpr OIter flush(OIter out_it) {
+        if (run_length != 0) {
+            *out_it++ = ((run_length - 1) & 0x3F) | 0xC0;
+            run_length = 0;
+        }
+
+        return out_it;
     }
+};
+
+/// Encodes pixels [first_pixel, last_pixel) of `image` as QoI chunks starting from a fresh encoder state, without the
+/// header and the end marker
+template<typename Allocator = std::allocator<uint8_t>, std::output_iterator<uint8_t> OIter>
+constexpr OIter encode_payload(OIter out_it, Gfx::Image<Allocator> const& image, size_t first_pixel, size_t last_pixel) {
+    QoIEncoder encoder {};
+
+    for (size_t i = first_pixel; i < last_pixel; i++)
+        out_it = encoder.push(image.get_pixel(i), out_it);
+
+    return encoder.flush(out_it);
+}
+
+inline constexpr std::array<uint8_t, 8> end_marker { 0, 0, 0, 0, 0, 0, 0, 1 };
 
-    if (run_length != 0)
-        do_emit_run();
+template<typename Allocator = std::allocator<uint8_t>, std::output_iterator<uint8_t> OIter>
+constexpr tl::expected<OIter, std::string_view> encode(OIter out_beg, Gfx::Image<Allocator> const& image) {
+    const auto header = TRYX(Header::from_image(image));
+    const auto header_bytes = header.to_bytes();
 
-    out_it = std::fill_n(out_it, 7, 0);
-    *out_it++ = 1;
+    auto out_it = std::copy(header_bytes.cbegin(), header_bytes.cend(), out_beg);
+    out_it = encode_payload(out_it, image, 0, image.pixel_count());
 
-    return out_it;
+    return std::copy(end_marker.cbegin(), end_marker.cend(), out_it);
 }
 
+/// Bytes taken from the input and written to the output by one call to a stream encoder or decoder
+struct StreamProgress {
+    size_t consumed = 0;
+    size_t produced = 0;
+};
+
+/// Incremental decoder: compressed data is fed in chunks of any size (down to single bytes) and pixels come out into
+/// caller-provided buffers, the decoder never allocates. Decoding resumes anywhere, including in the middle of a chunk
+/// or a run, so the caller only needs buffers of its chosen size (e.g. one row) instead of the whole frame.\n
+/// Each call consumes input until either the input runs out or the output is full, the output always receives whole
+/// RGBA8 pixels. `header()` becomes available as soon as the first 14 bytes went through and `finished()` once the end
+/// marker has been validated, input past it is not consumed. After an error the decoder can not be used any further.
+struct QoIStreamDecoder {
+    using color_type = QoIColorMap::color_type;
+
+    constexpr QoIStreamDecoder() = default;
+
+    constexpr tl::expected<StreamProgress, std::string_view> decode(std::span<const uint8_t> in, std::span<uint8_t> out) {
+        const uint8_t* in_it = in.data();
+        const uint8_t* const in_end = in.data() + in.size();
+
+        uint8_t* const out_beg = out.data();
+        uint8_t* out_it = out.data();
+        uint8_t* const out_end = out.data() + out.size() - out.size() % sizeof(color_type);
+
+        if (m_header_size != m_header_bytes.size()) {
+            const auto count = std::min<size_t>(m_header_bytes.size() - m_header_size, in_end - in_it);
+            std::copy_n(in_it, count, m_header_bytes.begin() + m_header_size);
+            in_it += count;
+            m_header_size += count;
+
+            if (m_header_size != m_header_bytes.size())
+                return StreamProgress { .consumed = in.size() };
+
+            auto header_it = m_header_bytes.cbegin();
+            m_header = TRYX(Header::from_bytes(std::move(header_it), m_header_bytes.cend()));
+            m_pixels_left = static_cast<size_t>(m_header->dims[0]) * m_header->dims[1];
+        }
+
+        while (m_pixels_left != 0) {
+            if (m_run_left != 0) {
+                const auto count = std::min<size_t>(m_run_left, (out_end - out_it) / sizeof(color_type));
+                for (size_t i = 0; i < count; i++)
+                    out_it = std::copy_n(m_state.last_seen.begin(), sizeof(color_type), out_it);
+
+                m_run_left -= count;
+                m_pixels_left -= count;
+
+                if (m_run_left != 0)
+                    break;
+
+                continue;
+            }
+
+            if (out_it == out_end)
+                break;
+
+            const auto pixels_available = std::min<size_t>(m_pixels_left, (out_end - out_it) / sizeof(color_type));
+            m_state.out_beg = out_it;
+            m_state.out_end = out_it + pixels_available * sizeof(color_type);
+            m_state.it = out_it;
+
+            if (m_block_size == 0) {
+                if !consteval {
+                    in_it = decode_blocks_unchecked(m_state, in_it, in_end);
+
+                    m_pixels_left -= (m_state.it - out_it) / sizeof(color_type);
+                    out_it = m_state.it;
+
+                    if (m_pixels_left == 0 || out_it == out_end)
+                        continue;
+                }
+            }
+
+            // one chunk at a time from here, it may be split across calls
+            if (in_it == in_end)
+                break;
+
+            m_block[m_block_size++] = *in_it++;
+            const auto type = block_type(m_block[0]);
+            const auto block_size = 1 + extra_data_size(type);
+
+            const auto count = std::min<size_t>(block_size - m_block_size, in_end - in_it);
+            std::copy_n(in_it, count, m_block.begin() + m_block_size);
+            in_it += count;
+            m_block_size += count;
+
+            if (m_block_size != block_size)
+                break;
+
+            m_block_size = 0;
+
+            if (type == BlockType::Run) {
+                m_run_left = (m_block[0] & 0x3F) + 1;
+                if (m_run_left > m_pixels_left)
+                    return tl::unexpected { "Overflow while reading QoI blocks" };
+
+                continue;
+            }
+
+            std::array<uint8_t, 4> extra_data = m_state.last_seen;
+            std::copy_n(m_block.begin() + 1, block_size - 1, extra_data.begin());
+
+            m_state.process_block(m_block[0], extra_data);
+            out_it = m_state.it;
+            m_pixels_left--;
+        }
+
+        if (m_pixels_left == 0) {
+            while (in_it != in_end && m_end_marker_size != end_marker.size()) {
+                if (*in_it++ != end_marker[m_end_marker_size++])
+                    return tl::unexpected { "Bad ending bytes" };
+            }
+        }
+
+        return StreamProgress {
+            .consumed = static_cast<size_t>(in_it - in.data()),
+            .produced = static_cast<size_t>(out_it - out_beg),
+        };
+    }
+
+    constexpr std::optional<Header> header() const { return m_header; }
+
+    /// Pixels not yet written out
+    constexpr size_t pixels_left() const { return m_pixels_left; }
+
+    constexpr bool finished() const { return m_header && m_pixels_left == 0 && m_end_marker_size == end_marker.size(); }
+
+private:
+    std::array<uint8_t, 14> m_header_bytes {};
+    size_t m_header_size = 0;
+    std::optional<Header> m_header = std::nullopt;
+
+    QoIDecoder m_state {};
+    size_t m_pixels_left = 0;
+    size_t m_run_left = 0;
+
+    /// A chunk that was split between two calls
+    std::array<uint8_t, 5> m_block {};
+    size_t m_block_size = 0;
+
+    size_t m_end_marker_size = 0;
+};
+
+/// Incremental encoder: RGBA8 pixels are fed in chunks of any size and the compressed stream comes out into
+/// caller-provided buffers of any size, the encoder never allocates. The header is emitted first and the end marker
+/// right after the last pixel of the image described by the header, keep calling with an empty input until
+/// `finished()` to drain the output.
+struct QoIStreamEncoder {
+    using color_type = QoIColorMap::color_type;
+
+    constexpr explicit QoIStreamEncoder(Header const& header)
+        : m_pixels_left(static_cast<size_t>(header.dims[0]) * header.dims[1]) {
+        const auto header_bytes = header.to_bytes();
+        m_pending_size = std::copy(header_bytes.cbegin(), header_bytes.cend(), m_pending.begin()) - m_pending.begin();
+    }
+
+    constexpr StreamProgress encode(std::span<const uint8_t> in, std::span<uint8_t> out) {
+        const uint8_t* in_it = in.data();
+        const uint8_t* const in_end = in.data() + in.size() - in.size() % sizeof(color_type);
+
+        uint8_t* out_it = out.data();
+        uint8_t* const out_end = out.data() + out.size();
+
+        out_it = drain(out_it, out_end);
+
+        // the output is written through uint8_t pointers which may alias the members, the encoder state is kept in
+        // locals so that it does not have to be reloaded after every byte
+        auto encoder = m_encoder;
+        auto pixels_left = m_pixels_left;
+
+        const auto read_pixel = [&] {
+            color_type pixel;
+            std::copy_n(in_it, sizeof(color_type), pixel.begin());
+            in_it += sizeof(color_type);
+            pixels_left--;
+            return pixel;
+        };
+
+        if (m_pending_size == m_pending_done && pixels_left != 0) {
+            // everything but the last pixel, straight into the output while any chunk is sure to fit
+            const auto pixels_in = std::min<size_t>((in_end - in_it) / sizeof(color_type), pixels_left - 1);
+            const auto* const fast_end = in_it + pixels_in * sizeof(color_type);
+
+            while (in_it != fast_end && static_cast<size_t>(out_end - out_it) >= QoIEncoder::max_push_size)
+                out_it = encoder.push(read_pixel(), out_it);
+        }
+
+        // chunks near the end of the output are staged and drained as far as they fit
+        while (m_pending_size == m_pending_done && pixels_left != 0 && in_it != in_end) {
+            const auto pixel = read_pixel();
+
+            m_pending_done = 0;
+            m_pending_size = encoder.push(pixel, m_pending.begin()) - m_pending.begin();
+
+            if (pixels_left == 0) {
+                auto* const pending_end = std::copy(end_marker.cbegin(), end_marker.cend(), encoder.flush(m_pending.begin() + m_pending_size));
+                m_pending_size = pending_end - m_pending.begin();
+            }
+
+            out_it = drain(out_it, out_end);
+        }
+
+        m_encoder = encoder;
+        m_pixels_left = pixels_left;
+
+        return StreamProgress {
+            .consumed = static_cast<size_t>(in_it - in.data()),
+            .produced = static_cast<size_t>(out_it - out.data()),
+        };
+    }
+
+    /// Pixels not yet fed in
+    constexpr size_t pixels_left() const { return m_pixels_left; }
+
+    constexpr bool finished() const { return m_pixels_left == 0 && m_pending_done == m_pending_size; }
+
+private:
+    QoIEncoder m_encoder {};
+    size_t m_pixels_left;
+
+    /// The header at first, then chunks that did not fit into the output
+    std::array<uint8_t, 16> m_pending {};
+    size_t m_pending_size = 0;
+    size_t m_pending_done = 0;
+
+    constexpr uint8_t* drain(uint8_t* out_it, uint8_t* out_end) {
+        const auto count = std::min<size_t>(m_pending_size - m_pending_done, out_end - out_it);
+        out_it = std::copy_n(m_pending.begin() + m_pending_done, count, out_it);
+        m_pending_done += count;
+
+        return out_it;
+    }
+};
+
 }
 
 namespace Stf::Gfx::Formats::QoI {
 
 using Gfx::Detail::Image::QoI::decode;
 using Gfx::Detail::Image::QoI::encode;
+using Gfx::Detail::Image::QoI::StreamProgress;
+
+using StreamDecoder = Gfx::Detail::Image::QoI::QoIStreamDecoder;
+using StreamEncoder = Gfx::Detail::Image::QoI::QoIStreamEncoder;
 
 }
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <memory>
+#include <span>
+#include <vector>
+
+/// Striped QoI container: the image is cut into horizontal stripes that are QoI-encoded independently (each starting
+/// from a fresh run/index state) so that both encoding and decoding can process stripes in parallel.\n
+/// Layout, all integers are big endian:\n
+/// - the 14 byte QoI header, with the magic "qoiS" so that plain QoI decoders reject the file\n
+/// - rows per stripe (u32), the last stripe may be shorter\n
+/// - for every stripe, the offset of the end of its chunks relative to the start of the first stripe (u64)\n
+/// - the chunks of every stripe, without headers or end markers\n
+/// - the QoI end marker\n
+/// The stripe height is picked by the encoder, the output never depends on the number of threads.
+namespace Stf::Gfx::Detail::Image::QoI {
+
+inline constexpr std::array<uint8_t, 4> striped_magic { 'q', 'o', 'i', 'S' };
+
+/// ~68 stripes for 8K frames, the compression lost to the state resets is negligible at that height
+inline constexpr size_t default_stripe_height = 64;
+
+template<typename T> constexpr std::array<uint8_t, sizeof(T)> to_big_endian(T v) {
+    return std::bit_cast<std::array<uint8_t, sizeof(T)>>(Stf::convert_endian(v, std::endian::native, std::endian::big));
+}
+
+template<typename T> constexpr T from_big_endian(const uint8_t* p) {
+    std::array<uint8_t, sizeof(T)> bytes;
+    std::copy_n(p, sizeof(T), bytes.begin());
+    return Stf::convert_endian(std::bit_cast<T>(bytes), std::endian::big);
+}
+
+struct StripedLayout {
+    Header header;
+    size_t stripe_height;
+    size_t stripe_count;
+
+    /// Raw offset table, stripe_count big endian u64s
+    std::span<const uint8_t> offsets;
+    /// The chunks of all stripes
+    std::span<const uint8_t> payload;
+
+    static constexpr tl::expected<StripedLayout, std::string_view> from_bytes(std::span<const uint8_t> data) {
+        const uint8_t* it = data.data();
+        const uint8_t* const end = data.data() + data.size();
+
+        auto raw_header = TRYX(RawHeader::from_bytes(std::move(it), end));
+        if (raw_header.magic != striped_magic)
+            return tl::unexpected { "Bad header magic" };
+
+        raw_header.magic = { 'q', 'o', 'i', 'f' };
+        const auto header = TRYX(Header::from_raw(raw_header));
+
+        if (end - it < 4)
+            return tl::unexpected { "Insufficient data (while reading the stripe height)" };
+
+        const size_t stripe_height = from_big_endian<uint32_t>(it);
+        it += 4;
+
+        if (stripe_height == 0)
+            return tl::unexpected { "Bad stripe height" };
+
+        const size_t stripe_count = (header.dims[1] + stripe_height - 1) / stripe_height;
+
+        if (static_cast<size_t>(end - it) < stripe_count * sizeof(uint64_t) + end_marker.size())
+            return tl::unexpected { "Insufficient data (while reading the stripe offsets)" };
+
+        const std::span<const uint8_t> offsets(it, stripe_count * sizeof(uint64_t));
+        it += offsets.size();
+
+        const std::span<const uint8_t> payload(it, end - end_marker.size());
+
+        if (!std::ranges::equal(std::span(payload.data() + payload.size(), end_marker.size()), end_marker))
+            return tl::unexpected { "Bad ending bytes" };
+
+        uint64_t last_offset = 0;
+        for (size_t i = 0; i < stripe_count; i++) {
+            const auto offset = from_big_endian<uint64_t>(offsets.data() + i * sizeof(uint64_t));
+            if (offset < last_offset || offset > payload.size())
+                return tl::unexpected { "Bad stripe offset" };
+
+            last_offset = offset;
+        }
+
+        if (last_offset != payload.size())
+            return tl::unexpected { "Bad stripe offset" };
+
+        return StripedLayout {
+            .header = header,
+            .stripe_height = stripe_height,
+            .stripe_count = stripe_count,
+            .offsets = offsets,
+            .payload = payload,
+        };
+    }
+
+    constexpr std::span<const uint8_t> stripe(size_t i) const {
+        const auto stripe_end = from_big_endian<uint64_t>(offsets.data() + i * sizeof(uint64_t));
+        const auto stripe_begin = i == 0 ? 0 : from_big_endian<uint64_t>(offsets.data() + (i - 1) * sizeof(uint64_t));
+
+        return payload.subspan(stripe_begin, stripe_end - stripe_begin);
+    }
+
+    /// Rows [first, last) of the image
+    constexpr std::pair<size_t, size_t> stripe_rows(size_t i) const {
+        return { i * stripe_height, std::min<size_t>(header.dims[1], (i + 1) * stripe_height) };
+    }
+};
+
+template<typename Allocator = std::allocator<uint8_t>, std::output_iterator<uint8_t> OIter>
+tl::expected<OIter, std::string_view> encode_striped(
+  OIter out_it, Gfx::Image<Allocator> const& image, size_t stripe_height = default_stripe_height, ThreadPool& pool = ThreadPool::global()
+) {
+    auto raw_header = TRYX(Header::from_image(image)).raw();
+    raw_header.magic = striped_magic;
+
+    if (stripe_height == 0 || stripe_height > std::numeric_limits<uint32_t>::max())
+        return tl::unexpected { "Bad stripe height" };
+
+    const auto [width, height] = image.dimensions();
+    const auto stripe_count = (height + stripe_height - 1) / stripe_height;
+
+    // every stripe gets room for its worst case (5 byte RGBA chunks only) in one scratch buffer, pages that are never
+    // written to are never touched
+    const auto stripe_capacity = stripe_height * width * 5;
+    const auto scratch = std::make_unique_for_overwrite<uint8_t[]>(stripe_capacity * stripe_count);
+    std::vector<size_t> stripe_sizes(stripe_count);
+
+    pool.parallel_for(0, stripe_count, 1, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; i++) {
+            const auto first_pixel = i * stripe_height * width;
+            const auto last_pixel = std::min(height, (i + 1) * stripe_height) * width;
+
+            auto* const stripe_begin = scratch.get() + i * stripe_capacity;
+            stripe_sizes[i] = encode_payload(stripe_begin, image, first_pixel, last_pixel) - stripe_begin;
+        }
+    });
+
+    const auto header_bytes = raw_header.to_bytes();
+    out_it = std::copy(header_bytes.cbegin(), header_bytes.cend(), out_it);
+
+    const auto stripe_height_bytes = to_big_endian(static_cast<uint32_t>(stripe_height));
+    out_it = std::copy(stripe_height_bytes.cbegin(), stripe_height_bytes.cend(), out_it);
+
+    uint64_t offset = 0;
+    for (const auto size : stripe_sizes) {
+        offset += size;
+
+        const auto offset_bytes = to_big_endian(offset);
+        out_it = std::copy(offset_bytes.cbegin(), offset_bytes.cend(), out_it);
+    }
+
+    for (size_t i = 0; i < stripe_count; i++)
+        out_it = std::copy_n(scratch.get() + i * stripe_capacity, stripe_sizes[i], out_it);
+
+    return std::copy(end_marker.cbegin(), end_marker.cend(), out_it);
+}
+
+template<typename Allocator = std::allocator<uint8_t>>
+tl::expected<void, std::string_view> decode_striped(std::span<const uint8_t> data, Gfx::Image<Allocator>& image, ThreadPool& pool = ThreadPool::global()) {
+    const auto layout = TRYX(StripedLayout::from_bytes(data));
+
+    const auto [i_w, i_h] = image.dimensions();
+    const auto [h_w, h_h] = layout.header.dims;
+
+    if (i_w != h_w || i_h != h_h)
+        return tl::unexpected { "Image metadata does not match header metadata" };
+
+    std::vector<std::string_view> errors(layout.stripe_count);
+
+    pool.parallel_for(0, layout.stripe_count, 1, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; i++) {
+            const auto stripe = layout.stripe(i);
+            const auto [first_row, last_row] = layout.stripe_rows(i);
+            const std::span<uint8_t> out(image.data() + first_row * i_w * 4, (last_row - first_row) * i_w * 4);
+
+            if (const auto res = decode_payload(stripe.begin(), stripe.end(), out); !res)
+                errors[i] = res.error();
+            else if (*res != stripe.end())
+                errors[i] = "Trailing data in stripe";
+        }
+    });
+
+    if (const auto it = std::ranges::find_if(errors, [](auto error) { return !error.empty(); }); it != errors.end())
+        return tl::unexpected { *it };
+
+    return {};
+}
+
+template<typename Allocator = std::allocator<uint8_t>>
+tl::expected<Gfx::Image<Allocator>, std::string_view>
+decode_striped(std::span<const uint8_t> data, ThreadPool& pool = ThreadPool::global(), Allocator const& allocator = Allocator()) {
+    const auto layout = TRYX(StripedLayout::from_bytes(data));
+
+    Gfx::Image<Allocator> image(layout.header.dims[0], layout.header.dims[1], allocator);
+    TRYX(decode_striped(data, image, pool));
+
+    return image;
+}
+
+}
+
+namespace Stf::Gfx::Formats::QoI {
+
+using Gfx::Detail::Image::QoI::decode_striped;
+using Gfx::Detail::Image::QoI::default_stripe_height;
+using Gfx::Detail::Image::QoI::encode_striped;
+
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Maths/Bit.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+/// Uncompressed container meant to be memory mapped and used in place: the pixels are stored exactly as NewImage holds
+/// them in memory so that a mapping of the file can be viewed without a copy.\n
+/// Layout, all integers are little endian:\n
+/// - the magic "stfR" and the version (u32)\n
+/// - the ColorFormat and ColorSpace (u32 each)\n
+/// - the width and height (u64 each)\n
+/// - the offset of the pixels from the start of the file and their size in bytes (u64 each)\n
+/// - zeroes up to the pixels\n
+/// - the pixels, rows top to bottom without padding\n
+/// The pixel offset is a multiple of `alignment`. Mappings start on page boundaries so a mapped file's pixels are
+/// aligned for any SIMD load. Multi-byte channels are little endian as well, big endian hosts can not view them.
+namespace Stf::Gfx::Detail::Image::Raw {
+
+inline constexpr std::array<uint8_t, 4> magic { 's', 't', 'f', 'R' };
+inline constexpr uint32_t version = 1;
+
+/// A cache line and the widest vector register
+inline constexpr size_t alignment = 64;
+inline constexpr size_t header_size = 48;
+
+template<typename T> constexpr void store_le(uint8_t* p, T v) {
+    const auto bytes = std::bit_cast<std::array<uint8_t, sizeof(T)>>(Stf::convert_endian(v, std::endian::native, std::endian::little));
+    std::copy(bytes.begin(), bytes.end(), p);
+}
+
+template<typename T> constexpr T load_le(const uint8_t* p) {
+    std::array<uint8_t, sizeof(T)> bytes;
+    std::copy_n(p, sizeof(T), bytes.begin());
+    return Stf::convert_endian(std::bit_cast<T>(bytes), std::endian::little);
+}
+
+struct Header {
+    ColorFormat format;
+    ColorSpace space;
+    Vector<size_t, 2> dims;
+
+    size_t data_offset;
+    size_t data_size;
+
+    constexpr std::array<uint8_t, header_size> to_bytes() const {
+        std::array<uint8_t, header_size> ret {};
+
+        std::copy(magic.begin(), magic.end(), ret.begin());
+        store_le<uint32_t>(ret.data() + 4, version);
+        store_le<uint32_t>(ret.data() + 8, static_cast<uint32_t>(format));
+        store_le<uint32_t>(ret.data() + 12, static_cast<uint32_t>(space));
+        store_le<uint64_t>(ret.data() + 16, dims[0]);
+        store_le<uint64_t>(ret.data() + 24, dims[1]);
+        store_le<uint64_t>(ret.data() + 32, data_offset);
+        store_le<uint64_t>(ret.data() + 40, data_size);
+
+        return ret;
+    }
+
+    /// Validates everything but the pixel size, which depends on the color type the file is read as
+    static constexpr tl::expected<Header, std::string_view> from_bytes(std::span<const uint8_t> data) {
+        if (data.size() < header_size)
+            return tl::unexpected { "Insufficient data (while reading the header)" };
+
+        if (!std::equal(magic.begin(), magic.end(), data.begin()))
+            return tl::unexpected { "Bad header magic" };
+
+        if (load_le<uint32_t>(data.data() + 4) != version)
+            return tl::unexpected { "Unsupported version" };
+
+        const auto format = load_le<uint32_t>(data.data() + 8);
+        const auto space = load_le<uint32_t>(data.data() + 12);
+        if (format > static_cast<uint32_t>(ColorFormat::RGBA32f) || space > static_cast<uint32_t>(ColorSpace::Linear))
+            return tl::unexpected { "Bad color format or space" };
+
+        Header header {
+            .format = static_cast<ColorFormat>(format),
+            .space = static_cast<ColorSpace>(space),
+            .dims = { load_le<uint64_t>(data.data() + 16), load_le<uint64_t>(data.data() + 24) },
+            .data_offset = load_le<uint64_t>(data.data() + 32),
+            .data_size = load_le<uint64_t>(data.data() + 40),
+        };
+
+        if (header.data_offset < header_size || header.data_offset % alignment != 0)
+            return tl::unexpected { "Bad pixel offset" };
+
+        if (header.data_offset > data.size() || header.data_size > data.size() - header.data_offset)
+            return tl::unexpected { "Insufficient data (while reading the pixels)" };
+
+        return header;
+    }
+};
+
+/// Checks the header against the image type the file is read as and returns the pixels
+template<ColorFormat Format, ColorSpace Space, typename Traits>
+constexpr tl::expected<std::pair<Header, std::span<const uint8_t>>, std::string_view> pixels_of(std::span<const uint8_t> data) {
+    using color_type = typename Traits::color_type;
+
+    if constexpr (sizeof(typename Traits::channel_type) != 1 && std::endian::native != std::endian::little)
+        return tl::unexpected { "Multi-byte channels are stored little endian" };
+
+    const auto header = TRYX(Header::from_bytes(data));
+
+    if (header.format != Format || header.space != Space)
+        return tl::unexpected { "Image metadata does not match header metadata" };
+
+    const auto [width, height] = header.dims;
+    if (width != 0 && height > std::numeric_limits<size_t>::max() / sizeof(color_type) / width)
+        return tl::unexpected { "Image too large" };
+
+    if (header.data_size != width * height * sizeof(color_type))
+        return tl::unexpected { "Bad pixel data size" };
+
+    return std::pair { header, data.subspan(header.data_offset, header.data_size) };
+}
+
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, std::output_iterator<uint8_t> OIter>
+constexpr OIter encode(OIter out_it, NewImage<Format, Space, Traits, Allocator> const& image) {
+    const Header header {
+        .format = Format,
+        .space = Space,
+        .dims = image.dimensions(),
+        .data_offset = alignment,
+        .data_size = image.size(),
+    };
+
+    const auto header_bytes = header.to_bytes();
+    out_it = std::copy(header_bytes.begin(), header_bytes.end(), out_it);
+    out_it = std::fill_n(out_it, alignment - header_size, uint8_t(0));
+
+    return std::copy_n(image.data(), image.size(), out_it);
+}
+
+/// Decodes into a new image that owns a copy of the pixels
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> decode(std::span<const uint8_t> data, Allocator const& allocator = Allocator()) {
+    const auto [header, pixels] = TRYX((pixels_of<Format, Space, Traits>(data)));
+
+    NewImage<Format, Space, Traits, Allocator> image(allocator);
+    image.create(header.dims);
+    std::memcpy(image.data(), pixels.data(), pixels.size());
+
+    return image;
+}
+
+/// Non-owning image over the pixels in `data`, which has to outlive it. `data` has to be aligned for the color type,
+/// which memory mappings always are.
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> view(std::span<uint8_t> data, Allocator const& allocator = Allocator()) {
+    using color_type = typename Traits::color_type;
+
+    const auto [header, pixels] = TRYX((pixels_of<Format, Space, Traits>(data)));
+
+    if (reinterpret_cast<uintptr_t>(pixels.data()) % alignof(color_type) != 0)
+        return tl::unexpected { "Misaligned pixel data" };
+
+    // the pixels are in `data`, which is mutable
+    auto* const first = reinterpret_cast<color_type*>(const_cast<uint8_t*>(pixels.data()));
+    return NewImage<Format, Space, Traits, Allocator>::view({ first, header.dims[0] * header.dims[1] }, header.dims, allocator);
+}
+
+}
+
+namespace Stf::Gfx::Formats::Raw {
+
+using Gfx::Detail::Image::Raw::alignment;
+using Gfx::Detail::Image::Raw::decode;
+using Gfx::Detail::Image::Raw::encode;
+using Gfx::Detail::Image::Raw::Header;
+using Gfx::Detail::Image::Raw::view;
+
+}
@@ -0,0 +1,298 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/Interleaved.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <vector>
+
+/// Truevision TGA, uncompressed and run-length encoded, 24 and 32 bit BGR(A) true color and 8 bit grayscale.\n
+/// Rows are moved between the file and the image whole, with one byte shuffle for several pixels at a time (see
+/// Interleaved), runs are expanded with a fill of the converted pixel. Color mapped and 15/16 bit images are not
+/// supported. Encoded files are top to bottom, 24 bit for images without alpha and 32 bit with 8 alpha bits otherwise.
+namespace Stf::Gfx::Detail::Image::TGA {
+
+inline constexpr size_t header_size = 18;
+
+/// The largest width and height, both are stored as u16
+inline constexpr size_t max_dimension = 65535;
+
+enum class Type : uint8_t {
+    TrueColor = 2,
+    Gray = 3,
+    RLETrueColor = 10,
+    RLEGray = 11,
+};
+
+/// Image descriptor bits
+inline constexpr uint8_t right_to_left = 0x10;
+inline constexpr uint8_t top_to_bottom = 0x20;
+
+/// Packet headers of RLE images, the low 7 bits are the pixel count minus one
+inline constexpr uint8_t run_packet = 0x80;
+inline constexpr size_t max_packet_length = 128;
+
+struct Header {
+    Type type;
+    Vector<size_t, 2> dims;
+    uint8_t pixel_depth;
+    uint8_t descriptor;
+
+    /// Bytes of the image ID and of the (ignored) color map, between the header and the pixels
+    size_t skipped_size = 0;
+
+    constexpr bool rle() const { return type == Type::RLETrueColor || type == Type::RLEGray; }
+    constexpr bool gray() const { return type == Type::Gray || type == Type::RLEGray; }
+    constexpr bool flipped() const { return (descriptor & top_to_bottom) == 0; }
+    constexpr size_t data_offset() const { return header_size + skipped_size; }
+
+    constexpr std::array<uint8_t, header_size> to_bytes() const {
+        std::array<uint8_t, header_size> ret {};
+
+        ret[2] = static_cast<uint8_t>(type);
+        ret[12] = static_cast<uint8_t>(dims[0]);
+        ret[13] = static_cast<uint8_t>(dims[0] >> 8);
+        ret[14] = static_cast<uint8_t>(dims[1]);
+        ret[15] = static_cast<uint8_t>(dims[1] >> 8);
+        ret[16] = pixel_depth;
+        ret[17] = descriptor;
+
+        return ret;
+    }
+
+    static constexpr tl::expected<Header, std::string_view> from_bytes(std::span<const uint8_t> data) {
+        if (data.size() < header_size)
+            return tl::unexpected { "Insufficient data (while reading the header)" };
+
+        const auto u16_at = [&](size_t offset) { return static_cast<size_t>(data[offset] | data[offset + 1] << 8); };
+
+        const auto id_length = static_cast<size_t>(data[0]);
+        const auto color_map_type = data[1];
+        const auto color_map_length = u16_at(5);
+        const auto color_map_entry_bits = static_cast<size_t>(data[7]);
+
+        if (color_map_type > 1)
+            return tl::unexpected { "Bad color map type" };
+
+        Header header {
+            .type = static_cast<Type>(data[2]),
+            .dims = { u16_at(12), u16_at(14) },
+            .pixel_depth = data[16],
+            .descriptor = data[17],
+            .skipped_size = id_length + (color_map_type == 1 ? color_map_length * ((color_map_entry_bits + 7) / 8) : 0),
+        };
+
+        switch (header.type) {
+        case Type::TrueColor:
+        case Type::RLETrueColor:
+            if (header.pixel_depth != 24 && header.pixel_depth != 32)
+                return tl::unexpected { "Unsupported pixel depth" };
+            break;
+        case Type::Gray:
+        case Type::RLEGray:
+            if (header.pixel_depth != 8)
+                return tl::unexpected { "Unsupported pixel depth" };
+            break;
+        default: return tl::unexpected { "Unsupported image type, only true color and grayscale images are supported" };
+        }
+
+        if ((header.descriptor & right_to_left) != 0)
+            return tl::unexpected { "Unsupported pixel order (right to left)" };
+
+        if (header.data_offset() > data.size())
+            return tl::unexpected { "Insufficient data (while reading the image ID and the color map)" };
+
+        return header;
+    }
+
+    template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator>
+    static constexpr tl::expected<Header, std::string_view> from_image(NewImage<Format, Space, Traits, Allocator> const& image, bool rle) {
+        const auto [width, height] = image.dimensions();
+        if (width > max_dimension || height > max_dimension)
+            return tl::unexpected { "Image is too large, TGA dimensions are at most 65535" };
+
+        constexpr bool alpha = Traits::channel_count == 4;
+
+        return Header {
+            .type = rle ? Type::RLETrueColor : Type::TrueColor,
+            .dims = image.dimensions(),
+            .pixel_depth = alpha ? uint8_t(32) : uint8_t(24),
+            .descriptor = static_cast<uint8_t>(top_to_bottom | (alpha ? 8 : 0)),
+        };
+    }
+};
+
+/// Row of the image held by row `file_row` of the file, files are bottom to top unless the descriptor says otherwise
+constexpr size_t image_row(Header const& header, size_t file_row) { return header.flipped() ? header.dims[1] - 1 - file_row : file_row; }
+
+template<Interleaved::FileLayout File, typename Traits, ColorFormat Format, typename Dst>
+tl::expected<void, std::string_view> decode_uncompressed(Header const& header, std::span<const uint8_t> pixels, Dst& image) {
+    const auto [width, height] = header.dims;
+    const auto row_size = width * File.pixel_size();
+
+    if (pixels.size() < row_size * height)
+        return tl::unexpected { "Insufficient data (while reading the pixels)" };
+
+    auto* const dst = image.pixels().data();
+    for (auto row = 0uz; row < height; row++)
+        Interleaved::read_pixels<File, Traits, Format>(pixels.data() + row * row_size, dst + image_row(header, row) * width, width);
+
+    return {};
+}
+
+/// Packets are allowed to cross rows, a packet is split at the end of a row and its rest is carried into the next one
+template<Interleaved::FileLayout File, typename Traits, ColorFormat Format, typename Dst>
+tl::expected<void, std::string_view> decode_rle(Header const& header, std::span<const uint8_t> pixels, Dst& image) {
+    using color_type = typename Traits::color_type;
+
+    const auto [width, height] = header.dims;
+
+    const uint8_t* it = pixels.data();
+    const uint8_t* const end = pixels.data() + pixels.size();
+
+    // what is left of the current packet
+    size_t remaining = 0;
+    bool run = false;
+    color_type run_color {};
+
+    for (auto row = 0uz; row < height; row++) {
+        auto* const dst = image.pixels().data() + image_row(header, row) * width;
+
+        for (auto x = 0uz; x < width;) {
+            if (remaining == 0) {
+                if (it == end)
+                    return tl::unexpected { "Insufficient data (while reading RLE packets)" };
+
+                const auto packet = *it++;
+                run = (packet & run_packet) != 0;
+                remaining = (packet & (run_packet - 1)) + 1uz;
+
+                if (run) {
+                    if (static_cast<size_t>(end - it) < File.pixel_size())
+                        return tl::unexpected { "Insufficient data (while reading RLE packets)" };
+
+                    Interleaved::read_pixels<File, Traits, Format>(it, &run_color, 1);
+                    it += File.pixel_size();
+                }
+            }
+
+            const auto count = std::min(remaining, width - x);
+            if (run) {
+                std::fill_n(dst + x, count, run_color);
+            } else {
+                if (static_cast<size_t>(end - it) < count * File.pixel_size())
+                    return tl::unexpected { "Insufficient data (while reading RLE packets)" };
+
+                Interleaved::read_pixels<File, Traits, Format>(it, dst + x, count);
+                it += count * File.pixel_size();
+            }
+
+            x += count;
+            remaining -= count;
+        }
+    }
+
+    return {};
+}
+
+template<Interleaved::FileLayout File, typename Traits, ColorFormat Format, typename Dst>
+tl::expected<void, std::string_view> decode_pixels(Header const& header, std::span<const uint8_t> pixels, Dst& image) {
+    if (header.rle())
+        return decode_rle<File, Traits, Format>(header, pixels, image);
+    return decode_uncompressed<File, Traits, Format>(header, pixels, image);
+}
+
+/// Decodes into any of the 8 bit formats, gray files are replicated into the color channels and images without alpha
+/// read as opaque
+template<ColorFormat Format, ColorSpace Space, typename Traits = ColorTraits<Format, Space>, typename Allocator = std::allocator<typename Traits::color_type>>
+tl::expected<NewImage<Format, Space, Traits, Allocator>, std::string_view> decode(std::span<const uint8_t> data, Allocator const& allocator = Allocator()) {
+    static_assert(std::is_same_v<typename Traits::channel_type, uint8_t>, "TGA images are decoded into 8 bit formats");
+
+    const auto header = TRYX(Header::from_bytes(data));
+    const auto pixels = data.subspan(header.data_offset());
+
+    NewImage<Format, Space, Traits, Allocator> image(allocator);
+    image.create(header.dims);
+
+    if (header.gray())
+        TRYX((decode_pixels<Interleaved::gray<1>, Traits, Format>(header, pixels, image)));
+    else if (header.pixel_depth == 24)
+        TRYX((decode_pixels<Interleaved::bgr8, Traits, Format>(header, pixels, image)));
+    else
+        TRYX((decode_pixels<Interleaved::bgra8, Traits, Format>(header, pixels, image)));
+
+    return image;
+}
+
+/// Writes the packets of a row: runs of at least 2 identical pixels become run packets, everything else is gathered into
+/// raw packets. Packets never cross rows.
+template<size_t PixelSize> uint8_t* encode_rle_row(const uint8_t* row, size_t width, uint8_t* out) {
+    const auto same = [row](size_t a, size_t b) { return std::memcmp(row + a * PixelSize, row + b * PixelSize, PixelSize) == 0; };
+
+    for (auto x = 0uz; x < width;) {
+        auto run = 1uz;
+        while (x + run < width && run < max_packet_length && same(x, x + run))
+            run++;
+
+        if (run > 1) {
+            *out++ = static_cast<uint8_t>(run_packet | (run - 1));
+            out = std::copy_n(row + x * PixelSize, PixelSize, out);
+            x += run;
+            continue;
+        }
+
+        // a raw packet ends where the next run of two starts
+        auto raw = 1uz;
+        while (x + raw < width && raw < max_packet_length && !(x + raw + 1 < width && same(x + raw, x + raw + 1)))
+            raw++;
+
+        *out++ = static_cast<uint8_t>(raw - 1);
+        out = std::copy_n(row + x * PixelSize, raw * PixelSize, out);
+        x += raw;
+    }
+
+    return out;
+}
+
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, std::output_iterator<uint8_t> OIter>
+tl::expected<OIter, std::string_view> encode(OIter out_it, NewImage<Format, Space, Traits, Allocator> const& image, bool rle = false) {
+    static_assert(std::is_same_v<typename Traits::channel_type, uint8_t>, "TGA images are encoded from 8 bit formats");
+    constexpr auto file = Traits::channel_count == 4 ? Interleaved::bgra8 : Interleaved::bgr8;
+
+    const auto header = TRYX(Header::from_image(image, rle));
+    const auto header_bytes = header.to_bytes();
+    out_it = std::copy(header_bytes.begin(), header_bytes.end(), out_it);
+
+    const auto [width, height] = image.dimensions();
+    const auto row_size = width * file.pixel_size();
+
+    // a row of pixels and, for RLE, its packets which take at most a byte more per 128 pixels
+    std::vector<uint8_t> buffer(row_size + (rle ? row_size + width / max_packet_length + 1 : 0));
+    for (auto y = 0uz; y < height; y++) {
+        Interleaved::write_pixels<file, Traits, Format>(image.pixels().data() + y * width, buffer.data(), width);
+
+        if (rle) {
+            auto* const packets = buffer.data() + row_size;
+            const auto* const packets_end = encode_rle_row<file.pixel_size()>(buffer.data(), width, packets);
+            out_it = std::copy(static_cast<const uint8_t*>(packets), packets_end, out_it);
+        } else {
+            out_it = std::copy_n(buffer.data(), row_size, out_it);
+        }
+    }
+
+    return out_it;
+}
+
+}
+
+namespace Stf::Gfx::Formats::TGA {
+
+using Gfx::Detail::Image::TGA::decode;
+using Gfx::Detail::Image::TGA::encode;
+using Gfx::Detail::Image::TGA::Header;
+
+}
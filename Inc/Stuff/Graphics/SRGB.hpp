@@ -0,0 +1,171 @@
+#pragma once
+
+#include <Stuff/Maths/LUT.hpp>
+#include <Stuff/Maths/Scalar.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Maths/Transcendental.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+/// sRGB transfer functions (IEC 61966-2-1) and precomputed tables for them.\n
+/// The tables are variable templates so that they are only built in the translation units that use them, building
+/// one takes on the order of a second of compile time.
+namespace Stf::Gfx::SRGB {
+
+/// Non-linear sRGB in [0, 1] to linear
+template<std::floating_point T> constexpr T to_linear(T v) {
+    if (v <= static_cast<T>(0.04045))
+        return v / static_cast<T>(12.92);
+
+    return Stf::pow((v + static_cast<T>(0.055)) / static_cast<T>(1.055), static_cast<T>(2.4));
+}
+
+/// Linear in [0, 1] to non-linear sRGB
+template<std::floating_point T> constexpr T from_linear(T v) {
+    if (v <= static_cast<T>(0.0031308))
+        return v * static_cast<T>(12.92);
+
+    return static_cast<T>(1.055) * Stf::pow(v, static_cast<T>(1. / 2.4)) - static_cast<T>(0.055);
+}
+
+/// Vectorised to_linear over spans, see Stf::pow for the error. Outputs may alias inputs.
+template<std::floating_point T> void to_linear(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Stf::Detail::Transcendental::unary<T, Stf::Detail::Transcendental::widening_lanes<T>>(in, out, [](auto v) {
+        using V = decltype(v);
+        constexpr auto splat = [](auto x) { return Stf::Detail::Kernels::splat<V>(static_cast<T>(x)); };
+
+        // the linear segment would send pow down its slow path for v <= 0
+        const auto curve = v > static_cast<T>(0.04045);
+        const V base = (SIMD::select(curve, v, splat(1)) + static_cast<T>(0.055)) / static_cast<T>(1.055);
+
+        return SIMD::select(curve, Stf::Detail::Transcendental::pow(base, splat(2.4)), v / static_cast<T>(12.92));
+    });
+}
+
+/// Vectorised from_linear over spans, see Stf::pow for the error. Outputs may alias inputs.
+template<std::floating_point T> void from_linear(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Stf::Detail::Transcendental::unary<T, Stf::Detail::Transcendental::widening_lanes<T>>(in, out, [](auto v) {
+        using V = decltype(v);
+        constexpr auto splat = [](auto x) { return Stf::Detail::Kernels::splat<V>(static_cast<T>(x)); };
+
+        const auto curve = v > static_cast<T>(0.0031308);
+        const V curved = static_cast<T>(1.055) * Stf::Detail::Transcendental::pow(SIMD::select(curve, v, splat(1)), splat(1. / 2.4));
+
+        return SIMD::select(curve, curved - static_cast<T>(0.055), v * static_cast<T>(12.92));
+    });
+}
+
+/// Exact linear value of every 8 bit sRGB code
+template<std::floating_point T = float> inline constexpr std::array<T, 256> u8_to_linear = [] {
+    std::array<T, 256> ret {};
+
+    for (auto i = 0uz; i < ret.size(); i++)
+        ret[i] = to_linear(static_cast<T>(i) / static_cast<T>(255));
+
+    return ret;
+}();
+
+/// Maps [0, 1] to the 8 bit code nearest to 255 * fn(v) for a monotonic `fn`, rounding exactly (up to the float
+/// representation of the rounding thresholds) at the cost of two table lookups and a comparison.\n
+/// A uniform table holds the code at the start of every bucket, at most one threshold between codes falls into a
+/// bucket and is checked for. This needs the thresholds to be further apart than the buckets, sRGB curves are at most
+/// 12.92 times steeper than the identity.
+template<std::floating_point T> struct U8Quantizer {
+    static constexpr size_t bucket_count = 4096;
+
+    using index_type = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+
+    /// `inverse` maps codes (normalised to [0, 1]) back to inputs
+    template<typename Fn> constexpr U8Quantizer(Fn&& inverse) {
+        m_thresholds[0] = -std::numeric_limits<T>::infinity();
+        m_thresholds[256] = std::numeric_limits<T>::infinity();
+        for (auto c = 1uz; c < 256; c++)
+            m_thresholds[c] = static_cast<T>(inverse((static_cast<double>(c) - 0.5) / 255.));
+
+        using bits_type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        const auto step = [](T v, int direction) { return std::bit_cast<T>(static_cast<bits_type>(std::bit_cast<bits_type>(v) + direction)); };
+
+        index_type code = 0;
+        for (auto i = 0uz; i < bucket_count; i++) {
+            // the smallest input that lands in the bucket with the rounding of `evaluate`
+            auto first = static_cast<T>(i) / static_cast<T>(bucket_count - 1);
+            // inputs are in [0, 1], so are the buckets never negative
+            while (first > 0 && static_cast<size_t>(bucket_of(step(first, -1))) >= i)
+                first = step(first, -1);
+            while (static_cast<size_t>(bucket_of(first)) < i)
+                first = step(first, 1);
+
+            while (first >= m_thresholds[code + 1])
+                code++;
+
+            m_buckets[i] = code;
+        }
+    }
+
+    constexpr uint8_t operator()(T v) const { return static_cast<uint8_t>(evaluate(v)); }
+
+    /// Lane-wise codes in integer lanes as wide as T, with gathers from the tables
+    template<typename V>
+        requires Stf::Detail::Kernels::Traits<V>::is_vector
+    typename Stf::Detail::Kernels::Traits<V>::integer operator()(V v) const {
+        return evaluate(v);
+    }
+
+private:
+    /// Smallest input for every code, padded with infinities
+    std::array<T, 257> m_thresholds {};
+    /// Wide entries so that they can be gathered
+    std::array<index_type, bucket_count> m_buckets {};
+
+    template<typename V> static constexpr auto bucket_of(V v) {
+        using I = typename Stf::Detail::Kernels::Traits<V>::integer;
+        return Stf::Detail::Kernels::convert<I>(v * static_cast<T>(bucket_count - 1));
+    }
+
+    template<typename I> constexpr auto fetch(const auto* table, I index) const {
+        if constexpr (Stf::Detail::Kernels::Traits<I>::is_vector) {
+            return SIMD::gather(table, index);
+        } else {
+            return table[index];
+        }
+    }
+
+    /// Shared by the scalar (constexpr) and the vector paths, V is either T or a SIMD::Vec of T
+    template<typename V> constexpr auto evaluate(V v) const {
+        using I = typename Stf::Detail::Kernels::Traits<V>::integer;
+
+        // NaN goes to 0
+        v = v > 0 ? v : Stf::Detail::Kernels::splat<V>(0);
+        v = v < 1 ? v : Stf::Detail::Kernels::splat<V>(1);
+
+        I code = fetch(m_buckets.data(), bucket_of(v));
+
+        // vector comparisons yield -1 for true
+        if constexpr (Stf::Detail::Kernels::Traits<V>::is_vector)
+            code -= v >= fetch(m_thresholds.data(), code + 1);
+        else
+            code += v >= m_thresholds[code + 1];
+
+        return code;
+    }
+};
+
+/// Linear in [0, 1] to the nearest 8 bit sRGB code
+template<std::floating_point T = float> inline constexpr U8Quantizer<T> from_linear_u8([](double v) { return to_linear(v); });
+
+/// Non-linear sRGB in [0, 1] to the nearest 8 bit linear code
+template<std::floating_point T = float> inline constexpr U8Quantizer<T> to_linear_u8([](double v) { return from_linear(v); });
+
+/// Max error: ~1.2e-6 for the default float table
+template<std::floating_point T = float, size_t N = 256>
+inline constexpr LUT<T, N, LUTInterpolation::Cubic> to_linear_lut([](T v) { return to_linear(v); }, T(0), T(1));
+
+/// Max error: ~1e-4 for the default float table, near the kink of the curve at 0.0031308 which needs the extra entries
+template<std::floating_point T = float, size_t N = 512>
+inline constexpr LUT<T, N, LUTInterpolation::Cubic> from_linear_lut([](T v) { return from_linear(v); }, T(0), T(1));
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <type_traits>
+
+/// Tile-wise processing of NewImage and conversion between storage layouts
+namespace Stf::Gfx {
+
+/// Calls `fn(tile)` on every tile of `grid`, spread over `pool`. Tiles are handed out in the grid's order in chunks
+/// of `grain`.
+template<typename Fn> void for_each_tile(TileGrid const& grid, ThreadPool& pool, Fn&& fn, size_t grain = 1) {
+    pool.parallel_for(0, grid.size(), grain, [&](size_t first, size_t last) {
+        for (auto i = first; i < last; i++)
+            std::invoke(fn, grid[i]);
+    });
+}
+
+namespace Detail::Tiles {
+
+/// Pixels per parallel chunk
+inline constexpr size_t parallel_grain = 1 << 16;
+
+/// The number of pixels from `x` on that are contiguous in a layout with runs of `run` pixels
+constexpr size_t run_left(size_t run, size_t x) { return run - x % run; }
+
+}
+
+/// Copies `src` into `dst`, which may be laid out differently. The copy is done tile by tile of `dst` in runs of
+/// pixels that are contiguous in both images.
+template<ColorFormat Format, ColorSpace Space, typename Traits, typename SrcAllocator, typename SrcLayout, typename DstAllocator, typename DstLayout>
+tl::expected<void, std::string_view> relayout(
+  NewImage<Format, Space, Traits, SrcAllocator, SrcLayout> const& src, NewImage<Format, Space, Traits, DstAllocator, DstLayout>& dst,
+  ThreadPool& pool = ThreadPool::global()
+) {
+    if (src.dimensions() != dst.dimensions())
+        return tl::unexpected { "Image dimensions do not match" };
+
+    if (src.pixel_count() == 0)
+        return {};
+
+    if (static_cast<const void*>(src.data()) == static_cast<const void*>(dst.data()))
+        return tl::unexpected { "Can not convert in place" };
+
+    const auto* const src_pixels = src.pixels().data();
+    auto* const dst_pixels = dst.pixels().data();
+
+    if constexpr (std::is_same_v<SrcLayout, DstLayout>) {
+        std::copy_n(src_pixels, src.storage_count(), dst_pixels);
+    } else {
+        const auto grid = dst.tiles();
+        const auto [tile_width, tile_height] = grid.tile_dimensions();
+
+        for_each_tile(grid, pool, [&](Tile tile) {
+            const auto [x0, y0] = tile.origin;
+            const auto [width, height] = tile.extent;
+
+            for (auto y = y0; y < y0 + height; y++) {
+                for (auto x = x0; x < x0 + width;) {
+                    const auto run = std::min({
+                      x0 + width - x,
+                      Detail::Tiles::run_left(SrcLayout::contiguous_run, x),
+                      Detail::Tiles::run_left(DstLayout::contiguous_run, x),
+                    });
+                    std::copy_n(src_pixels + src.coords_to_index({ x, y }), run, dst_pixels + dst.coords_to_index({ x, y }));
+                    x += run;
+                }
+            }
+        }, std::max<size_t>(1, Detail::Tiles::parallel_grain / (tile_width * tile_height)));
+    }
+
+    return {};
+}
+
+/// Copies `src` into a new image laid out as `DstLayout`
+template<typename DstLayout, ColorFormat Format, ColorSpace Space, typename Traits, typename Allocator, typename SrcLayout>
+NewImage<Format, Space, Traits, Allocator, DstLayout>
+relayout(NewImage<Format, Space, Traits, Allocator, SrcLayout> const& src, ThreadPool& pool = ThreadPool::global(), Allocator const& allocator = Allocator()) {
+    NewImage<Format, Space, Traits, Allocator, DstLayout> dst(allocator);
+    dst.create(src.dimensions());
+
+    // the dimensions match and a new image can not alias `src`
+    std::ignore = relayout(src, dst, pool);
+
+    return dst;
+}
+
+}
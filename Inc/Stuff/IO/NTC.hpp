@@ -1,5 +1,8 @@
 #pragma once
 
+#include <Stuff/Maths/LUT.hpp>
+#include <Stuff/Maths/Scalar.hpp>
+
 #include <array>
 #include <cmath>
 #include <utility>
@@ -129,7 +132,7 @@ constexpr float calculate_ntc(Nominal r_nom, float r_ntc) {
     const auto [regular_coeff, inverse_coeff] = get_ntc_coefficients(r_nom);
     auto const& [a, b, c, d] = inverse_coeff;
 
-    const float ln_r_t = std::log(r_ntc / static_cast<float>(static_cast<int>(r_nom)));
+    const float ln_r_t = Stf::log(r_ntc / static_cast<float>(static_cast<int>(r_nom)));
 
     const float pow_0 = 1.f;
     const float pow_1 = ln_r_t * pow_0;
@@ -141,4 +144,20 @@ constexpr float calculate_ntc(Nominal r_nom, float r_ntc) {
     return 1.f / quotient;
 }
 
+/// Temperature (in kelvin) of an NTC forming the lower half of a voltage divider (R2 in solve_voltage_divider) as a
+/// function of v_m / v_cc, to be built at compile time:
+/// @code
+/// constexpr auto lut = Stf::NTC::divider_lut(Stf::NTC::Nominal::R10K, 10'000.f);
+/// static_assert(lut.max_error() < 0.05f);
+/// const float kelvin = lut(adc_reading / 4095.f);
+/// @endcode
+/// Ratios outside [ratio_min, ratio_max] are clamped, the curve gets too steep near 0 and 1 to be tabulated
+/// uniformly. With the defaults and a 10K/3977 part that is about -45 to 145°C with a max error of 0.03K.
+template<size_t N = 256, LUTInterpolation Interpolation = LUTInterpolation::Cubic>
+constexpr LUT<float, N, Interpolation> divider_lut(Nominal r_nom, float r_known, float ratio_min = 0.02f, float ratio_max = 0.98f) {
+    return LUT<float, N, Interpolation>(
+      [r_nom, r_known](float ratio) { return calculate_ntc(r_nom, r_known * ratio / (1.f - ratio)); }, ratio_min, ratio_max
+    );
+}
+
 }
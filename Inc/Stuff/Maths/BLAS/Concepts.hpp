@@ -20,4 +20,17 @@ concept MatrixExpression = requires(T const& self, size_t i, size_t j) {
                                { T::rows } -> std::convertible_to<size_t>;
                            };
 
+template<typename T>
+concept DynamicVectorExpression = requires(T const& cv, size_t i) {
+                                      { cv[i] } -> std::convertible_to<typename T::value_type>;
+                                      { cv.size() } -> std::convertible_to<size_t>;
+                                  };
+
+template<typename T>
+concept DynamicMatrixExpression = requires(T const& self, size_t i, size_t j) {
+                                      { self.at(i, j) } -> std::convertible_to<typename T::value_type>;
+                                      { self.cols() } -> std::convertible_to<size_t>;
+                                      { self.rows() } -> std::convertible_to<size_t>;
+                                  };
+
 }
@@ -0,0 +1,499 @@
+#pragma once
+
+#include "./MatVec.hpp"
+
+#include <Stuff/Maths/SIMD.hpp>
+#include <Stuff/Util/Alloc.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Stf {
+
+/// A heap-backed vector whose size is only known at runtime.\n
+/// Storage is aligned to 64 bytes by default so that SIMD kernels can use aligned loads on the first element.
+template<typename T, typename Allocator = AlignedAllocator<T>> struct DynVector {
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    DynVector(Allocator const& alloc = Allocator())
+        : m_data(alloc) { }
+
+    explicit DynVector(size_t size, T fill = T {}, Allocator const& alloc = Allocator())
+        : m_data(size, fill, alloc) { }
+
+    DynVector(std::initializer_list<T> values, Allocator const& alloc = Allocator())
+        : m_data(values, alloc) { }
+
+    explicit DynVector(std::span<const T> values, Allocator const& alloc = Allocator())
+        : m_data(values.begin(), values.end(), alloc) { }
+
+    template<Concepts::VectorExpression E>
+    explicit DynVector(E const& e, Allocator const& alloc = Allocator())
+        : m_data(E::vector_size, alloc) {
+        for (auto i = 0uz; i < E::vector_size; i++)
+            m_data[i] = static_cast<T>(e[i]);
+    }
+
+    template<Concepts::DynamicVectorExpression E>
+    explicit DynVector(E const& e, Allocator const& alloc = Allocator())
+        : m_data(e.size(), alloc) {
+        for (auto i = 0uz; i < e.size(); i++)
+            m_data[i] = static_cast<T>(e[i]);
+    }
+
+    size_t size() const noexcept { return m_data.size(); }
+
+    T* data() noexcept { return m_data.data(); }
+    const T* data() const noexcept { return m_data.data(); }
+
+    T operator[](size_t i) const { return m_data[i]; }
+    T& operator[](size_t i) { return m_data[i]; }
+
+    std::span<T> span() noexcept { return m_data; }
+    std::span<const T> span() const noexcept { return m_data; }
+
+    void resize(size_t size, T fill = T {}) { m_data.resize(size, fill); }
+
+    template<size_t N> Vector<T, N> to_static() const {
+        Vector<T, N> ret {};
+        std::copy_n(m_data.begin(), std::min(N, size()), ret.data);
+        return ret;
+    }
+
+private:
+    std::vector<T, Allocator> m_data;
+};
+
+/// A heap-backed, row-major matrix whose dimensions are only known at runtime.\n
+/// Element (i, j) lives at `data()[i * cols() + j]`, same as `Stf::Matrix`.
+template<typename T, typename Allocator = AlignedAllocator<T>> struct DynMatrix {
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    DynMatrix(Allocator const& alloc = Allocator())
+        : m_data(alloc) { }
+
+    DynMatrix(size_t rows, size_t cols, T fill = T {}, Allocator const& alloc = Allocator())
+        : m_rows(rows)
+        , m_cols(cols)
+        , m_data(rows * cols, fill, alloc) { }
+
+    template<Concepts::MatrixExpression E>
+    explicit DynMatrix(E const& e, Allocator const& alloc = Allocator())
+        : DynMatrix(E::rows, E::cols, T {}, alloc) {
+        for (auto i = 0uz; i < E::rows; i++)
+            for (auto j = 0uz; j < E::cols; j++)
+                at(i, j) = static_cast<T>(e.at(i, j));
+    }
+
+    template<Concepts::DynamicMatrixExpression E>
+    explicit DynMatrix(E const& e, Allocator const& alloc = Allocator())
+        : DynMatrix(e.rows(), e.cols(), T {}, alloc) {
+        for (auto i = 0uz; i < m_rows; i++)
+            for (auto j = 0uz; j < m_cols; j++)
+                at(i, j) = static_cast<T>(e.at(i, j));
+    }
+
+    static DynMatrix identity(size_t n, Allocator const& alloc = Allocator()) {
+        DynMatrix ret(n, n, T {}, alloc);
+        for (auto i = 0uz; i < n; i++)
+            ret.at(i, i) = 1;
+        return ret;
+    }
+
+    size_t rows() const noexcept { return m_rows; }
+    size_t cols() const noexcept { return m_cols; }
+
+    T* data() noexcept { return m_data.data(); }
+    const T* data() const noexcept { return m_data.data(); }
+
+    T at(size_t i, size_t j) const { return m_data[i * m_cols + j]; }
+    T& at(size_t i, size_t j) { return m_data[i * m_cols + j]; }
+
+    std::span<T> row(size_t i) noexcept { return { data() + i * m_cols, m_cols }; }
+    std::span<const T> row(size_t i) const noexcept { return { data() + i * m_cols, m_cols }; }
+
+    void fill(T v) { std::fill(m_data.begin(), m_data.end(), v); }
+
+    DynMatrix transposed() const {
+        DynMatrix ret(m_cols, m_rows, T {}, m_data.get_allocator());
+        for (auto i = 0uz; i < m_rows; i++)
+            for (auto j = 0uz; j < m_cols; j++)
+                ret.at(j, i) = at(i, j);
+        return ret;
+    }
+
+    template<size_t R, size_t C> Matrix<T, R, C> to_static() const {
+        Matrix<T, R, C> ret {};
+        for (auto i = 0uz; i < std::min(R, m_rows); i++)
+            for (auto j = 0uz; j < std::min(C, m_cols); j++)
+                ret.at(i, j) = at(i, j);
+        return ret;
+    }
+
+private:
+    size_t m_rows = 0;
+    size_t m_cols = 0;
+    std::vector<T, Allocator> m_data;
+};
+
+}
+
+namespace Stf::Detail::GEMM {
+
+/// Register blocking: an MR x NR tile of C is kept in registers, NR being two native vectors wide
+template<typename T> struct Blocking {
+    static constexpr size_t nr = SIMD::native_lanes<T> * 2;
+    static constexpr size_t mr = 6;
+
+    /// cache blocking: a KC x NR sliver of B stays in L1, an MC x KC block of A in L2, a KC x NC panel of B in L3
+    static constexpr size_t kc = 256;
+    static constexpr size_t mc = mr * 20;
+    static constexpr size_t nc = nr * 128;
+};
+
+/// Packs a kc x nc panel of B (row-major, leading dimension ldb) into NR-wide column slivers, zero padded
+template<typename T> void pack_b(const T* b, size_t ldb, size_t kc, size_t nc, T* out) {
+    constexpr size_t nr = Blocking<T>::nr;
+
+    for (size_t j = 0; j < nc; j += nr) {
+        const size_t cols = std::min(nr, nc - j);
+
+        for (size_t k = 0; k < kc; k++) {
+            const T* src = b + k * ldb + j;
+            std::copy_n(src, cols, out);
+            std::fill(out + cols, out + nr, T {});
+            out += nr;
+        }
+    }
+}
+
+/// Packs an mc x kc block of A (row-major, leading dimension lda) into MR-tall row slivers, k-major, zero padded
+template<typename T> void pack_a(const T* a, size_t lda, size_t mc, size_t kc, T* out) {
+    constexpr size_t mr = Blocking<T>::mr;
+
+    for (size_t i = 0; i < mc; i += mr) {
+        const size_t rows = std::min(mr, mc - i);
+
+        for (size_t k = 0; k < kc; k++) {
+            for (size_t r = 0; r < rows; r++)
+                out[r] = a[(i + r) * lda + k];
+            for (size_t r = rows; r < mr; r++)
+                out[r] = T {};
+            out += mr;
+        }
+    }
+}
+
+/// C[0..rows, 0..cols] += alpha * (packed A sliver) * (packed B sliver)
+template<typename T> void micro_kernel(size_t kc, const T* a, const T* b, T* c, size_t ldc, size_t rows, size_t cols, T alpha) {
+    constexpr size_t mr = Blocking<T>::mr;
+    constexpr size_t nr = Blocking<T>::nr;
+    using vec_type = SIMD::Vec<T, nr>;
+
+    // a vec_type is a register pair, it is moved with memcpy rather than SIMD::load/store so that it is never passed
+    // to or returned from a function (whose ABI would depend on the target, see -Wpsabi)
+    vec_type acc[mr] {};
+
+    for (size_t k = 0; k < kc; k++) {
+        vec_type b_row;
+        std::memcpy(&b_row, b + k * nr, sizeof(b_row));
+        for (size_t r = 0; r < mr; r++)
+            acc[r] += a[k * mr + r] * b_row;
+    }
+
+    if (cols == nr) {
+        for (size_t r = 0; r < rows; r++) {
+            T* const c_row = c + r * ldc;
+            vec_type c_vec;
+            std::memcpy(&c_vec, c_row, sizeof(c_vec));
+            c_vec += alpha * acc[r];
+            std::memcpy(c_row, &c_vec, sizeof(c_vec));
+        }
+        return;
+    }
+
+    for (size_t r = 0; r < rows; r++)
+        for (size_t j = 0; j < cols; j++)
+            c[r * ldc + j] += alpha * acc[r][j];
+}
+
+template<typename T> void scale(T* c, size_t count, T beta) {
+    if (beta == T { 1 })
+        return;
+
+    if (beta == T {}) {
+        std::fill_n(c, count, T {});
+        return;
+    }
+
+    for (size_t i = 0; i < count; i++)
+        c[i] *= beta;
+}
+
+/// C = alpha * A * B + beta * C for row-major operands
+template<typename T>
+void gemm(size_t m, size_t n, size_t k, T alpha, const T* a, size_t lda, const T* b, size_t ldb, T beta, T* c, size_t ldc, ThreadPool& pool) {
+    using B = Blocking<T>;
+
+    for (size_t i = 0; i < m; i++)
+        scale(c + i * ldc, n, beta);
+
+    if (k == 0 || alpha == T {})
+        return;
+
+    std::vector<T, AlignedAllocator<T>> b_pack(B::kc * ((std::min(B::nc, n) + B::nr - 1) / B::nr * B::nr));
+
+    for (size_t jc = 0; jc < n; jc += B::nc) {
+        const size_t nc = std::min(B::nc, n - jc);
+
+        for (size_t pc = 0; pc < k; pc += B::kc) {
+            const size_t kc = std::min(B::kc, k - pc);
+
+            pack_b(b + pc * ldb + jc, ldb, kc, nc, b_pack.data());
+
+            const size_t block_count = (m + B::mc - 1) / B::mc;
+            const size_t grain = std::max<size_t>(1, (128 * 128 * 128) / (B::mc * nc * kc + 1));
+
+            pool.parallel_for(0, block_count, grain, [&](size_t block_begin, size_t block_end) {
+                thread_local std::vector<T, AlignedAllocator<T>> a_pack {};
+                a_pack.resize(B::mc * B::kc);
+
+                for (size_t block = block_begin; block < block_end; block++) {
+                    const size_t ic = block * B::mc;
+                    const size_t mc = std::min(B::mc, m - ic);
+
+                    pack_a(a + ic * lda + pc, lda, mc, kc, a_pack.data());
+
+                    for (size_t jr = 0; jr < nc; jr += B::nr) {
+                        for (size_t ir = 0; ir < mc; ir += B::mr) {
+                            micro_kernel(
+                              kc, a_pack.data() + ir * kc, b_pack.data() + jr * kc, c + (ic + ir) * ldc + jc + jr, ldc,
+                              std::min(B::mr, mc - ir), std::min(B::nr, nc - jr), alpha
+                            );
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+template<typename T> T dot(const T* lhs, const T* rhs, size_t n) {
+    constexpr size_t lanes = SIMD::native_lanes<T>;
+    using vec_type = SIMD::Vec<T, lanes>;
+
+    vec_type acc_0 {};
+    vec_type acc_1 {};
+
+    size_t i = 0;
+    for (; i + 2 * lanes <= n; i += 2 * lanes) {
+        acc_0 += SIMD::load<lanes>(lhs + i) * SIMD::load<lanes>(rhs + i);
+        acc_1 += SIMD::load<lanes>(lhs + i + lanes) * SIMD::load<lanes>(rhs + i + lanes);
+    }
+
+    T ret = SIMD::reduce_add(acc_0 + acc_1);
+    for (; i < n; i++)
+        ret += lhs[i] * rhs[i];
+
+    return ret;
+}
+
+/// y = alpha * A * x + beta * y for a row-major A
+template<typename T> void gemv(size_t m, size_t n, T alpha, const T* a, size_t lda, const T* x, T beta, T* y, ThreadPool& pool) {
+    const size_t grain = std::max<size_t>(1, 32768 / (n + 1));
+
+    pool.parallel_for(0, m, grain, [&](size_t row_begin, size_t row_end) {
+        for (size_t i = row_begin; i < row_end; i++) {
+            const T prev = beta == T {} ? T {} : beta * y[i];
+            y[i] = prev + alpha * dot(a + i * lda, x, n);
+        }
+    });
+}
+
+/// row[0..n] -= factor * pivot_row[0..n]
+template<typename T> void axpy_row(T* row, const T* pivot_row, size_t n, T factor) {
+    for (size_t j = 0; j < n; j++)
+        row[j] -= factor * pivot_row[j];
+}
+
+}
+
+namespace Stf {
+
+/// C = alpha * A * B + beta * C
+template<typename T, typename Alloc>
+tl::expected<void, std::string_view>
+gemm(T alpha, DynMatrix<T, Alloc> const& a, DynMatrix<T, Alloc> const& b, T beta, DynMatrix<T, Alloc>& c, ThreadPool& pool = ThreadPool::global()) {
+    if (a.cols() != b.rows())
+        return tl::unexpected { "The columns of A do not match the rows of B" };
+    if (c.rows() != a.rows() || c.cols() != b.cols())
+        return tl::unexpected { "C is not of the shape of A * B" };
+
+    Detail::GEMM::gemm(a.rows(), b.cols(), a.cols(), alpha, a.data(), a.cols(), b.data(), b.cols(), beta, c.data(), c.cols(), pool);
+    return {};
+}
+
+/// y = alpha * A * x + beta * y
+template<typename T, typename MAlloc, typename VAlloc>
+tl::expected<void, std::string_view>
+gemv(T alpha, DynMatrix<T, MAlloc> const& a, DynVector<T, VAlloc> const& x, T beta, DynVector<T, VAlloc>& y, ThreadPool& pool = ThreadPool::global()) {
+    if (a.cols() != x.size())
+        return tl::unexpected { "The columns of A do not match the size of x" };
+    if (a.rows() != y.size())
+        return tl::unexpected { "The rows of A do not match the size of y" };
+
+    Detail::GEMM::gemv(a.rows(), a.cols(), alpha, a.data(), a.cols(), x.data(), beta, y.data(), pool);
+    return {};
+}
+
+/// Mismatched shapes are a programming error: asserted, and the result is left zeroed when assertions are disabled
+template<typename T, typename Alloc> DynMatrix<T, Alloc> operator*(DynMatrix<T, Alloc> const& lhs, DynMatrix<T, Alloc> const& rhs) {
+    DynMatrix<T, Alloc> ret(lhs.rows(), rhs.cols());
+    [[maybe_unused]] const auto res = gemm(T { 1 }, lhs, rhs, T {}, ret);
+    assert(res);
+    return ret;
+}
+
+template<typename T, typename MAlloc, typename VAlloc>
+DynVector<T, VAlloc> operator*(DynMatrix<T, MAlloc> const& lhs, DynVector<T, VAlloc> const& rhs) {
+    DynVector<T, VAlloc> ret(lhs.rows());
+    [[maybe_unused]] const auto res = gemv(T { 1 }, lhs, rhs, T {}, ret);
+    assert(res);
+    return ret;
+}
+
+/// PA = LU with partial pivoting. L (unit diagonal, implicit) and U are stored packed in `lu`.
+template<typename T, typename Alloc = AlignedAllocator<T>> struct LUDecomposition {
+    DynMatrix<T, Alloc> lu;
+    std::vector<size_t> permutation;
+    int permutation_sign = 1;
+
+    T determinant() const {
+        T ret = static_cast<T>(permutation_sign);
+        for (auto i = 0uz; i < lu.rows(); i++)
+            ret *= lu.at(i, i);
+        return ret;
+    }
+
+    template<typename VAlloc> DynVector<T, VAlloc> solve(DynVector<T, VAlloc> const& b) const {
+        const auto n = lu.rows();
+        DynVector<T, VAlloc> x(n);
+
+        for (auto i = 0uz; i < n; i++)
+            x[i] = b[permutation[i]] - Detail::GEMM::dot(lu.row(i).data(), x.data(), i);
+
+        for (auto i = n; i-- > 0;) {
+            const auto tail = Detail::GEMM::dot(lu.row(i).data() + i + 1, x.data() + i + 1, n - i - 1);
+            x[i] = (x[i] - tail) / lu.at(i, i);
+        }
+
+        return x;
+    }
+};
+
+template<typename T, typename Alloc>
+tl::expected<LUDecomposition<T, Alloc>, std::string_view> lu_decompose(DynMatrix<T, Alloc> a, ThreadPool& pool = ThreadPool::global()) {
+    if (a.rows() != a.cols())
+        return tl::unexpected { "LU decomposition requires a square matrix" };
+
+    const auto n = a.rows();
+
+    LUDecomposition<T, Alloc> ret { std::move(a), std::vector<size_t>(n), 1 };
+    auto& lu = ret.lu;
+
+    for (auto i = 0uz; i < n; i++)
+        ret.permutation[i] = i;
+
+    for (auto k = 0uz; k < n; k++) {
+        auto pivot = k;
+        for (auto i = k + 1; i < n; i++)
+            if (std::abs(lu.at(i, k)) > std::abs(lu.at(pivot, k)))
+                pivot = i;
+
+        if (lu.at(pivot, k) == T {})
+            return tl::unexpected { "Matrix is singular" };
+
+        if (pivot != k) {
+            std::swap_ranges(lu.row(k).begin(), lu.row(k).end(), lu.row(pivot).begin());
+            std::swap(ret.permutation[k], ret.permutation[pivot]);
+            ret.permutation_sign = -ret.permutation_sign;
+        }
+
+        const T* const pivot_row = lu.row(k).data();
+        const T pivot_value = pivot_row[k];
+        const auto tail = n - k - 1;
+
+        pool.parallel_for(k + 1, n, std::max<size_t>(1, 16384 / (tail + 1)), [&](size_t row_begin, size_t row_end) {
+            for (auto i = row_begin; i < row_end; i++) {
+                T* const row = lu.row(i).data();
+                const T factor = row[k] / pivot_value;
+                row[k] = factor;
+                Detail::GEMM::axpy_row(row + k + 1, pivot_row + k + 1, tail, factor);
+            }
+        });
+    }
+
+    return ret;
+}
+
+/// A = L * L^T for a symmetric positive definite A. Only the lower triangle of `l` is meaningful.
+template<typename T, typename Alloc = AlignedAllocator<T>> struct CholeskyDecomposition {
+    DynMatrix<T, Alloc> l;
+
+    template<typename VAlloc> DynVector<T, VAlloc> solve(DynVector<T, VAlloc> const& b) const {
+        const auto n = l.rows();
+        DynVector<T, VAlloc> x(n);
+
+        for (auto i = 0uz; i < n; i++)
+            x[i] = (b[i] - Detail::GEMM::dot(l.row(i).data(), x.data(), i)) / l.at(i, i);
+
+        for (auto i = n; i-- > 0;) {
+            T sum = x[i];
+            for (auto j = i + 1; j < n; j++)
+                sum -= l.at(j, i) * x[j];
+            x[i] = sum / l.at(i, i);
+        }
+
+        return x;
+    }
+};
+
+template<typename T, typename Alloc>
+tl::expected<CholeskyDecomposition<T, Alloc>, std::string_view> cholesky_decompose(DynMatrix<T, Alloc> a) {
+    if (a.rows() != a.cols())
+        return tl::unexpected { "Cholesky decomposition requires a square matrix" };
+
+    const auto n = a.rows();
+
+    for (auto j = 0uz; j < n; j++) {
+        const T* const row_j = a.row(j).data();
+        const T diag = a.at(j, j) - Detail::GEMM::dot(row_j, row_j, j);
+
+        if (!(diag > T {}))
+            return tl::unexpected { "Matrix is not positive definite" };
+
+        const T l_jj = std::sqrt(diag);
+        a.at(j, j) = l_jj;
+
+        for (auto i = j + 1; i < n; i++) {
+            const T* const row_i = a.row(i).data();
+            a.at(i, j) = (a.at(i, j) - Detail::GEMM::dot(row_i, row_j, j)) / l_jj;
+        }
+
+        for (auto k = j + 1; k < n; k++)
+            a.at(j, k) = T {};
+    }
+
+    return CholeskyDecomposition<T, Alloc> { std::move(a) };
+}
+
+}
@@ -49,17 +49,17 @@ template<Concepts::VectorExpression E, size_t C, bool owning = true> struct Vect
 
 namespace Stf {
 
-template<Concepts::MatrixExpression E> constexpr Detail::MatrixTransposeExpression<E> transpose(E const& e) { return { {}, e }; }
+template<Concepts::MatrixExpression E> constexpr Detail::MatrixTransposeExpression<E> transpose(E const& e) { return { e }; }
 
 template<Concepts::VectorExpression E> constexpr Detail::VectorToMatrixExpression<E, 1> transpose(E const& e) {
-    const auto vec_mat = Detail::VectorToMatrixExpression<E, 1> { {}, e };
+    const auto vec_mat = Detail::VectorToMatrixExpression<E, 1> { e };
     return vec_mat;
 }
 
 template<Concepts::MatrixExpression E0, Concepts::VectorExpression E1> constexpr auto operator*(E0 const& mat, E1 const& vec) {
     const auto vec_mat_T = transpose(vec);
     const auto mult = transpose(mat * vec_mat_T);
-    const Detail::MatrixToVectorExpression<decltype(mult), true> mult_vec { {}, mult };
+    const Detail::MatrixToVectorExpression<decltype(mult), true> mult_vec { mult };
     return mult_vec;
 }
 
@@ -2,6 +2,7 @@
 
 #include "./Concepts.hpp"
 #include "./Util.hpp"
+#include "./Vector.hpp"
 
 namespace Stf {
 
@@ -161,11 +162,11 @@ struct ElementwiseBinaryMatrixExpression {
                                                                                                                                                                \
     template<Concepts::MatrixExpression E, Concepts::MatrixExpression... Es>                                                                                   \
     constexpr Matrix##EXPR_NAME##Expression<Es..., E> operator EXPR_SYM(Matrix##EXPR_NAME##Expression<Es...> e_s, E e) {                                       \
-        return { {}, {}, std::tuple_cat(std::move(e_s.expressions), std::tuple<E>(e)) };                                                                       \
+        return { {}, std::tuple_cat(std::move(e_s.expressions), std::tuple<E>(e)) };                                                                           \
     }                                                                                                                                                          \
                                                                                                                                                                \
     template<Concepts::MatrixExpression E0, Concepts::MatrixExpression E1> constexpr Matrix##EXPR_NAME##Expression<E0, E1> operator EXPR_SYM(E0 e_0, E1 e_1) { \
-        return { {}, {}, { e_0, e_1 } };                                                                                                                       \
+        return { {}, { e_0, e_1 } };                                                                                                                           \
     }
 
 BASIC_BINARY_FACTORY(Addition, +, std::plus<>)
@@ -200,7 +201,7 @@ struct MatrixMultiplicationExpression {
 
 template<Concepts::MatrixExpression E0, Concepts::MatrixExpression E1>
 constexpr MatrixMultiplicationExpression<E0, E1> operator*(E0 const& e_0, E1 const& e_1) {
-    return { {}, e_0, e_1 };
+    return { e_0, e_1 };
 }
 
 }
@@ -8,10 +8,21 @@ namespace Stf {
 template<typename T> struct Quaternion {
     T x, y, z, w;
 
-    constexpr Quaternion conujugate() const {
-        return { x, -y, -z, -w };
+    static constexpr Quaternion identity() { return { 0, 0, 0, 1 }; }
+
+    constexpr Quaternion conjugate() const { return { -x, -y, -z, w }; }
+
+    constexpr T norm_squared() const { return x * x + y * y + z * z + w * w; }
+
+    constexpr T norm() const { return std::sqrt(norm_squared()); }
+
+    constexpr Quaternion normalized() const {
+        const auto inv_norm = 1 / norm();
+        return { x * inv_norm, y * inv_norm, z * inv_norm, w * inv_norm };
     }
 
+    constexpr T dot(Quaternion const& other) const { return x * other.x + y * other.y + z * other.z + w * other.w; }
+
     friend constexpr Quaternion operator*(Quaternion const& q1, Quaternion const& q2) {
         return Quaternion {
             .x = (q1.w * q2.x) + (q1.x * q2.w) + (q1.y * q2.z) - (q1.z * q2.y),
@@ -21,16 +32,118 @@ template<typename T> struct Quaternion {
         };
     }
 
+    friend constexpr bool operator==(Quaternion const&, Quaternion const&) = default;
+
+    /// Rotates `v` by this quaternion, which must be of unit length.\n
+    /// Uses the two cross product form: t = 2 (q.xyz × v), v' = v + w t + q.xyz × t
+    constexpr Vector<T, 3> rotate(Vector<T, 3> v) const {
+        const auto tx = 2 * (y * v[2] - z * v[1]);
+        const auto ty = 2 * (z * v[0] - x * v[2]);
+        const auto tz = 2 * (x * v[1] - y * v[0]);
+
+        return {
+            v[0] + w * tx + (y * tz - z * ty),
+            v[1] + w * ty + (z * tx - x * tz),
+            v[2] + w * tz + (x * ty - y * tx),
+        };
+    }
+
+    /// @param axis the axis of rotation, must be of unit length
     static constexpr Quaternion from_axis_angle(Vector<T, 3> axis, T angle) {
-        const auto half_deg = angle / 2;
+        const auto half_angle = angle / 2;
+        const auto sin_half = std::sin(half_angle);
 
         return Quaternion {
-            .x = axis[0] * std::sin(half_deg),
-            .y = axis[0] * std::sin(half_deg),
-            .z = axis[0] * std::sin(half_deg),
-            .w = std::cos(half_deg),
+            .x = axis[0] * sin_half,
+            .y = axis[1] * sin_half,
+            .z = axis[2] * sin_half,
+            .w = std::cos(half_angle),
+        };
+    }
+
+    /// The rotation matrix R such that R * v == rotate(v), for a unit quaternion
+    constexpr Matrix<T, 3, 3> to_matrix3() const {
+        const auto xx = x * x, yy = y * y, zz = z * z;
+        const auto xy = x * y, xz = x * z, yz = y * z;
+        const auto wx = w * x, wy = w * y, wz = w * z;
+
+        return {
+            1 - 2 * (yy + zz), 2 * (xy - wz), 2 * (xz + wy),     //
+            2 * (xy + wz), 1 - 2 * (xx + zz), 2 * (yz - wx),     //
+            2 * (xz - wy), 2 * (yz + wx), 1 - 2 * (xx + yy),     //
         };
     }
+
+    constexpr Matrix<T, 4, 4> to_matrix4() const {
+        const auto base = to_matrix3();
+
+        return {
+            base.at(0, 0), base.at(0, 1), base.at(0, 2), 0, //
+            base.at(1, 0), base.at(1, 1), base.at(1, 2), 0, //
+            base.at(2, 0), base.at(2, 1), base.at(2, 2), 0, //
+            0, 0, 0, 1                                      //
+        };
+    }
+
+    /// Extracts the rotation from an orthonormal matrix (Shepperd's method, picks the numerically largest pivot)
+    static constexpr Quaternion from_matrix(Matrix<T, 3, 3> const& m) {
+        const auto trace = m.at(0, 0) + m.at(1, 1) + m.at(2, 2);
+
+        if (trace > 0) {
+            const auto s = std::sqrt(trace + 1) * 2;
+            return { (m.at(2, 1) - m.at(1, 2)) / s, (m.at(0, 2) - m.at(2, 0)) / s, (m.at(1, 0) - m.at(0, 1)) / s, s / 4 };
+        }
+
+        if (m.at(0, 0) > m.at(1, 1) && m.at(0, 0) > m.at(2, 2)) {
+            const auto s = std::sqrt(1 + m.at(0, 0) - m.at(1, 1) - m.at(2, 2)) * 2;
+            return { s / 4, (m.at(0, 1) + m.at(1, 0)) / s, (m.at(0, 2) + m.at(2, 0)) / s, (m.at(2, 1) - m.at(1, 2)) / s };
+        }
+
+        if (m.at(1, 1) > m.at(2, 2)) {
+            const auto s = std::sqrt(1 + m.at(1, 1) - m.at(0, 0) - m.at(2, 2)) * 2;
+            return { (m.at(0, 1) + m.at(1, 0)) / s, s / 4, (m.at(1, 2) + m.at(2, 1)) / s, (m.at(0, 2) - m.at(2, 0)) / s };
+        }
+
+        const auto s = std::sqrt(1 + m.at(2, 2) - m.at(0, 0) - m.at(1, 1)) * 2;
+        return { (m.at(0, 2) + m.at(2, 0)) / s, (m.at(1, 2) + m.at(2, 1)) / s, s / 4, (m.at(1, 0) - m.at(0, 1)) / s };
+    }
+
+    /// Uses the upper-left 3x3 block
+    static constexpr Quaternion from_matrix(Matrix<T, 4, 4> const& m) {
+        return from_matrix(Matrix<T, 3, 3> {
+          m.at(0, 0), m.at(0, 1), m.at(0, 2), //
+          m.at(1, 0), m.at(1, 1), m.at(1, 2), //
+          m.at(2, 0), m.at(2, 1), m.at(2, 2), //
+        });
+    }
 };
 
-}
\ No newline at end of file
+/// Normalised linear interpolation along the shortest arc
+template<typename T> constexpr Quaternion<T> nlerp(Quaternion<T> const& a, Quaternion<T> b, T t) {
+    if (a.dot(b) < 0)
+        b = { -b.x, -b.y, -b.z, -b.w };
+
+    const auto s = 1 - t;
+    return Quaternion<T> { s * a.x + t * b.x, s * a.y + t * b.y, s * a.z + t * b.z, s * a.w + t * b.w }.normalized();
+}
+
+/// Spherical linear interpolation along the shortest arc, falls back to nlerp for nearly parallel inputs
+template<typename T> constexpr Quaternion<T> slerp(Quaternion<T> const& a, Quaternion<T> b, T t) {
+    auto cos_theta = a.dot(b);
+    if (cos_theta < 0) {
+        b = { -b.x, -b.y, -b.z, -b.w };
+        cos_theta = -cos_theta;
+    }
+
+    if (cos_theta > static_cast<T>(0.9995))
+        return nlerp(a, b, t);
+
+    const auto theta = std::acos(cos_theta);
+    const auto inv_sin_theta = 1 / std::sin(theta);
+    const auto s_a = std::sin((1 - t) * theta) * inv_sin_theta;
+    const auto s_b = std::sin(t * theta) * inv_sin_theta;
+
+    return { s_a * a.x + s_b * b.x, s_a * a.y + s_b * b.y, s_a * a.z + s_b * b.z, s_a * a.w + s_b * b.w };
+}
+
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "./Quat.hpp"
+
+#include <Stuff/Maths/SIMD.hpp>
+
+#include <span>
+#include <type_traits>
+
+namespace Stf {
+
+/// Structure-of-arrays view over a batch of quaternions. `T` may be const qualified for read-only batches.
+template<typename T> struct QuaternionSoA {
+    std::span<T> x, y, z, w;
+
+    constexpr size_t size() const noexcept { return x.size(); }
+
+    constexpr Quaternion<std::remove_const_t<T>> operator[](size_t i) const { return { x[i], y[i], z[i], w[i] }; }
+
+    constexpr operator QuaternionSoA<const T>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return { x, y, z, w };
+    }
+};
+
+/// Structure-of-arrays view over a batch of 3D vectors. `T` may be const qualified for read-only batches.
+template<typename T> struct Vector3SoA {
+    std::span<T> x, y, z;
+
+    constexpr size_t size() const noexcept { return x.size(); }
+
+    constexpr Vector<std::remove_const_t<T>, 3> operator[](size_t i) const { return { x[i], y[i], z[i] }; }
+
+    constexpr operator Vector3SoA<const T>() const noexcept
+        requires(!std::is_const_v<T>)
+    {
+        return { x, y, z };
+    }
+};
+
+}
+
+namespace Stf::Detail::QuatBatch {
+
+template<typename V> struct QuatLanes {
+    V x, y, z, w;
+};
+
+template<typename V> struct Vec3Lanes {
+    V x, y, z;
+};
+
+template<size_t N, typename T> inline QuatLanes<SIMD::Vec<T, N>> load(QuaternionSoA<const T> q, size_t i) {
+    return { SIMD::load<N>(q.x.data() + i), SIMD::load<N>(q.y.data() + i), SIMD::load<N>(q.z.data() + i), SIMD::load<N>(q.w.data() + i) };
+}
+
+template<size_t N, typename T> inline Vec3Lanes<SIMD::Vec<T, N>> load(Vector3SoA<const T> v, size_t i) {
+    return { SIMD::load<N>(v.x.data() + i), SIMD::load<N>(v.y.data() + i), SIMD::load<N>(v.z.data() + i) };
+}
+
+template<size_t N, typename T> inline QuatLanes<SIMD::Vec<T, N>> broadcast(Quaternion<T> const& q) {
+    return { SIMD::broadcast<N>(q.x), SIMD::broadcast<N>(q.y), SIMD::broadcast<N>(q.z), SIMD::broadcast<N>(q.w) };
+}
+
+template<typename T, typename V> inline void store(QuaternionSoA<T> q, size_t i, QuatLanes<V> const& v) {
+    SIMD::store(q.x.data() + i, v.x);
+    SIMD::store(q.y.data() + i, v.y);
+    SIMD::store(q.z.data() + i, v.z);
+    SIMD::store(q.w.data() + i, v.w);
+}
+
+template<typename T, typename V> inline void store(Vector3SoA<T> q, size_t i, Vec3Lanes<V> const& v) {
+    SIMD::store(q.x.data() + i, v.x);
+    SIMD::store(q.y.data() + i, v.y);
+    SIMD::store(q.z.data() + i, v.z);
+}
+
+/// Calls `fn.template operator()<N>(i)` over [0, n) with N being the native lane count for full blocks and 1 for the
+/// remainder, so that a single kernel body serves both the vector loop and the scalar tail
+template<typename T, typename Fn> inline void for_each_block(size_t n, Fn&& fn) {
+    constexpr size_t lanes = SIMD::native_lanes<T>;
+
+    size_t i = 0;
+    for (; i + lanes <= n; i += lanes)
+        fn.template operator()<lanes>(i);
+    for (; i < n; i++)
+        fn.template operator()<1>(i);
+}
+
+template<typename V> inline QuatLanes<V> multiply(QuatLanes<V> const& a, QuatLanes<V> const& b) {
+    return {
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
+
+template<typename V> inline V dot(QuatLanes<V> const& a, QuatLanes<V> const& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+
+template<typename V> inline QuatLanes<V> normalize(QuatLanes<V> const& q) {
+    const auto inv_norm = 1 / SIMD::sqrt(dot(q, q));
+    return { q.x * inv_norm, q.y * inv_norm, q.z * inv_norm, q.w * inv_norm };
+}
+
+template<typename V> inline Vec3Lanes<V> rotate(QuatLanes<V> const& q, Vec3Lanes<V> const& v) {
+    const auto tx = 2 * (q.y * v.z - q.z * v.y);
+    const auto ty = 2 * (q.z * v.x - q.x * v.z);
+    const auto tz = 2 * (q.x * v.y - q.y * v.x);
+
+    return {
+        v.x + q.w * tx + (q.y * tz - q.z * ty),
+        v.y + q.w * ty + (q.z * tx - q.x * tz),
+        v.z + q.w * tz + (q.x * ty - q.y * tx),
+    };
+}
+
+/// Weighted sum s_a * a + s_b * b with b negated on lanes where it is on the other hemisphere
+template<typename V> inline QuatLanes<V> blend(QuatLanes<V> const& a, QuatLanes<V> const& b, V s_a, V s_b) {
+    return { s_a * a.x + s_b * b.x, s_a * a.y + s_b * b.y, s_a * a.z + s_b * b.z, s_a * a.w + s_b * b.w };
+}
+
+}
+
+namespace Stf {
+
+/// out[i] = lhs[i] * rhs[i]. `out` may alias either input.
+template<typename T>
+void multiply(std::type_identity_t<QuaternionSoA<const T>> lhs, std::type_identity_t<QuaternionSoA<const T>> rhs, QuaternionSoA<T> out) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::multiply(Detail::QuatBatch::load<N>(lhs, i), Detail::QuatBatch::load<N>(rhs, i)));
+    });
+}
+
+/// out[i] = lhs * rhs[i]. `out` may alias `rhs`.
+template<typename T> void multiply(Quaternion<T> const& lhs, std::type_identity_t<QuaternionSoA<const T>> rhs, QuaternionSoA<T> out) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::multiply(Detail::QuatBatch::broadcast<N>(lhs), Detail::QuatBatch::load<N>(rhs, i)));
+    });
+}
+
+/// out[i] = in[i] / |in[i]|. `out` may alias `in`.
+template<typename T> void normalize(std::type_identity_t<QuaternionSoA<const T>> in, QuaternionSoA<T> out) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::normalize(Detail::QuatBatch::load<N>(in, i)));
+    });
+}
+
+/// out[i] = q[i] rotating v[i]. Quaternions must be of unit length. `out` may alias `v`.
+template<typename T> void rotate(std::type_identity_t<QuaternionSoA<const T>> q, std::type_identity_t<Vector3SoA<const T>> v, Vector3SoA<T> out) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::rotate(Detail::QuatBatch::load<N>(q, i), Detail::QuatBatch::load<N>(v, i)));
+    });
+}
+
+/// out[i] = q rotating v[i]. `q` must be of unit length. `out` may alias `v`.
+template<typename T> void rotate(Quaternion<T> const& q, std::type_identity_t<Vector3SoA<const T>> v, Vector3SoA<T> out) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::rotate(Detail::QuatBatch::broadcast<N>(q), Detail::QuatBatch::load<N>(v, i)));
+    });
+}
+
+/// out[i] = nlerp(a[i], b[i], t[i]). `out` may alias either input.
+template<typename T>
+void nlerp(
+  std::type_identity_t<QuaternionSoA<const T>> a, std::type_identity_t<QuaternionSoA<const T>> b, std::type_identity_t<std::span<const T>> t,
+  QuaternionSoA<T> out
+) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        const auto q_a = Detail::QuatBatch::load<N>(a, i);
+        const auto q_b = Detail::QuatBatch::load<N>(b, i);
+        const auto t_v = SIMD::load<N>(t.data() + i);
+
+        const auto sign = SIMD::select(Detail::QuatBatch::dot(q_a, q_b) < 0, SIMD::broadcast<N, T>(-1), SIMD::broadcast<N, T>(1));
+        const auto blended = Detail::QuatBatch::blend(q_a, q_b, 1 - t_v, t_v * sign);
+
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::normalize(blended));
+    });
+}
+
+/// out[i] = slerp(a[i], b[i], t[i]). `out` may alias either input.\n
+/// The interpolation weights need sin/acos per lane; everything else runs on full vectors.
+template<typename T>
+void slerp(
+  std::type_identity_t<QuaternionSoA<const T>> a, std::type_identity_t<QuaternionSoA<const T>> b, std::type_identity_t<std::span<const T>> t,
+  QuaternionSoA<T> out
+) {
+    Detail::QuatBatch::for_each_block<T>(out.size(), [&]<size_t N>(size_t i) {
+        const auto q_a = Detail::QuatBatch::load<N>(a, i);
+        const auto q_b = Detail::QuatBatch::load<N>(b, i);
+        const auto t_v = SIMD::load<N>(t.data() + i);
+
+        const auto raw_cos = Detail::QuatBatch::dot(q_a, q_b);
+        const auto sign = SIMD::select(raw_cos < 0, SIMD::broadcast<N, T>(-1), SIMD::broadcast<N, T>(1));
+        const auto cos_theta = raw_cos * sign;
+
+        SIMD::Vec<T, N> s_a = 1 - t_v;
+        SIMD::Vec<T, N> s_b = t_v;
+
+        for (size_t lane = 0; lane < N; lane++) {
+            if (cos_theta[lane] > static_cast<T>(0.9995))
+                continue;
+
+            const auto theta = std::acos(cos_theta[lane]);
+            const auto inv_sin_theta = 1 / std::sin(theta);
+            s_a[lane] = std::sin((1 - t_v[lane]) * theta) * inv_sin_theta;
+            s_b[lane] = std::sin(t_v[lane] * theta) * inv_sin_theta;
+        }
+
+        Detail::QuatBatch::store(out, i, Detail::QuatBatch::normalize(Detail::QuatBatch::blend(q_a, q_b, s_a, s_b * sign)));
+    });
+}
+
+}
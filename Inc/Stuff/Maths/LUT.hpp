@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Stuff/Maths/Scalar.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+
+#include <array>
+#include <span>
+
+namespace Stf {
+
+enum class LUTInterpolation {
+    Linear,
+    /// Catmull-Rom, see Stf::cubic
+    Cubic,
+};
+
+/// N uniformly spaced samples of a function over [domain_min, domain_max], evaluated with linear or cubic interpolation.
+/// Inputs outside of the domain (and NaN, which is sent to domain_min) are clamped.\n
+/// The table is meant to be built in a constant expression from a constexpr function (e.g. Stf::log, Stf::pow):
+/// the constructor also measures the largest absolute interpolation error against that function at `error_samples`
+/// points per interval so that it can be checked where the table is declared:
+/// @code
+/// constexpr Stf::LUT<float, 256, Stf::LUTInterpolation::Cubic> sin_lut([](float x) { return Stf::sin(x); }, 0.f, pi);
+/// static_assert(sin_lut.max_error() < 1e-6f);
+/// @endcode
+template<std::floating_point T, size_t N, LUTInterpolation Interpolation = LUTInterpolation::Linear> struct LUT {
+    static_assert(N >= 2);
+
+    static constexpr size_t size = N;
+    static constexpr LUTInterpolation interpolation = Interpolation;
+
+    template<typename Fn>
+    constexpr LUT(Fn&& fn, T domain_min, T domain_max, size_t error_samples = 8)
+        : m_domain_min(domain_min)
+        , m_domain_max(domain_max)
+        , m_scale(static_cast<T>(N - 1) / (domain_max - domain_min)) {
+        const auto step = (domain_max - domain_min) / static_cast<T>(N - 1);
+
+        for (auto i = 0uz; i < N; i++)
+            m_samples[i + 1] = fn(i == N - 1 ? domain_max : domain_min + static_cast<T>(i) * step);
+
+        // the outer neighbours for the cubic spline are quadratically extrapolated (linearly for N = 2), this keeps
+        // the first and last intervals about as accurate as the inner ones
+        if constexpr (N == 2) {
+            m_samples[0] = 2 * m_samples[1] - m_samples[2];
+            m_samples[N + 1] = 2 * m_samples[N] - m_samples[N - 1];
+        } else {
+            m_samples[0] = 3 * m_samples[1] - 3 * m_samples[2] + m_samples[3];
+            m_samples[N + 1] = 3 * m_samples[N] - 3 * m_samples[N - 1] + m_samples[N - 2];
+        }
+
+        for (auto i = 0uz; i < N - 1; i++) {
+            for (auto j = 1uz; j <= error_samples; j++) {
+                const auto x = domain_min + (static_cast<T>(i) + static_cast<T>(j) / static_cast<T>(error_samples + 1)) * step;
+                const auto error = Stf::abs(fn(x) - (*this)(x));
+
+                if (error > m_max_error) {
+                    m_max_error = error;
+                    m_max_error_at = x;
+                }
+            }
+        }
+    }
+
+    constexpr T domain_min() const { return m_domain_min; }
+
+    constexpr T domain_max() const { return m_domain_max; }
+
+    /// Largest absolute error seen while building the table
+    constexpr T max_error() const { return m_max_error; }
+
+    /// Where `max_error` was seen
+    constexpr T max_error_at() const { return m_max_error_at; }
+
+    constexpr std::span<const T, N> samples() const { return std::span<const T, N>(m_samples.data() + 1, N); }
+
+    constexpr T operator()(T x) const { return evaluate(x); }
+
+    /// out[i] = (*this)(in[i]), processing `out.size()` elements with gathers from the table
+    void operator()(std::span<const T> in, std::span<T> out) const {
+        constexpr size_t lanes = SIMD::native_lanes<T>;
+
+        size_t i = 0;
+        for (; i + lanes <= out.size(); i += lanes)
+            SIMD::store(out.data() + i, evaluate(SIMD::load<lanes>(in.data() + i)));
+
+        for (; i < out.size(); i++)
+            out[i] = evaluate(in[i]);
+    }
+
+private:
+    T m_domain_min;
+    T m_domain_max;
+    T m_scale;
+
+    T m_max_error = 0;
+    T m_max_error_at = 0;
+
+    /// Samples at [1, N], extrapolated neighbours at 0 and N + 1 (only read by the cubic interpolation)
+    std::array<T, N + 2> m_samples {};
+
+    template<typename I> constexpr auto fetch(I index) const {
+        if constexpr (Detail::Kernels::Traits<I>::is_vector) {
+            return SIMD::gather(m_samples.data(), index);
+        } else {
+            return m_samples[index];
+        }
+    }
+
+    /// Shared by the scalar (constexpr) and the vector paths, V is either T or a SIMD::Vec of T
+    template<typename V> constexpr V evaluate(V x) const {
+        using I = typename Detail::Kernels::Traits<V>::integer;
+        using IL = typename Detail::Kernels::Traits<V>::integer_lane;
+
+        x = x >= m_domain_min ? x : Detail::Kernels::splat<V>(m_domain_min);
+        x = x <= m_domain_max ? x : Detail::Kernels::splat<V>(m_domain_max);
+
+        const V t = (x - m_domain_min) * m_scale;
+
+        // t >= 0 so truncation is floor; the last sample is reached with interval N - 2 and a fraction of 1
+        I index = Detail::Kernels::convert<I>(t);
+        index = index < static_cast<IL>(N - 2) ? index : Detail::Kernels::splat<I>(static_cast<IL>(N - 2));
+        const V fraction = t - Detail::Kernels::convert<V>(index);
+
+        // +1 for the leading extrapolated sample
+        const auto p1 = fetch(index + 1);
+        const auto p2 = fetch(index + 2);
+
+        if constexpr (Interpolation == LUTInterpolation::Linear) {
+            return p1 + fraction * (p2 - p1);
+        } else {
+            return cubic(fraction, fetch(index), p1, p2, fetch(index + 3));
+        }
+    }
+};
+
+}
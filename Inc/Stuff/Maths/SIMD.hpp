@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <immintrin.h>
+#endif
+
+namespace Stf::SIMD {
+
+/// Register width, in bytes, of the widest vector unit enabled for the current compilation target
+inline constexpr size_t native_width =
+#if defined(__AVX512F__)
+  64;
+#elif defined(__AVX__)
+  32;
+#else
+  16;
+#endif
+
+/// Number of `T` lanes in a native-width register
+template<typename T> inline constexpr size_t native_lanes = native_width / sizeof(T) > 0 ? native_width / sizeof(T) : 1;
+
+namespace Detail {
+
+template<typename T, size_t N> struct VecType {
+    typedef T type __attribute__((vector_size(sizeof(T) * N)));
+};
+
+}
+
+/// A GCC/Clang generic vector of N elements of type T.\n
+/// Arithmetic, comparison (yielding a signed integer mask vector) and subscripting are provided by the compiler and
+/// lowered to whatever the target supports.
+template<typename T, size_t N = native_lanes<T>> using Vec = typename Detail::VecType<T, N>::type;
+
+template<typename V> using lane_type = std::remove_cvref_t<decltype(std::declval<V>()[0])>;
+
+template<typename V> inline constexpr size_t lane_count = sizeof(V) / sizeof(lane_type<V>);
+
+template<size_t N, typename T> inline Vec<T, N> load(const T* p) noexcept {
+    Vec<T, N> ret;
+    std::memcpy(&ret, p, sizeof(ret));
+    return ret;
+}
+
+template<typename T, typename V> inline void store(T* p, V v) noexcept {
+    static_assert(std::is_same_v<T, lane_type<V>>);
+    std::memcpy(p, &v, sizeof(v));
+}
+
+template<size_t N, typename T> constexpr Vec<T, N> broadcast(T v) noexcept { return Vec<T, N> {} + v; }
+
+/// Lane-wise `mask ? a : b` where mask lanes are either all-zeroes or all-ones. Also accepts scalars.
+template<typename M, typename V> constexpr V select(M mask, V a, V b) noexcept { return mask ? a : b; }
+
+template<typename To, typename V> constexpr Vec<To, lane_count<V>> convert(V v) noexcept {
+    return __builtin_convertvector(v, Vec<To, lane_count<V>>);
+}
+
+/// Lane-wise `base[index[i]]`. `index` is a vector of signed integers as wide as `T`, e.g. the type of a comparison
+/// between two `Vec<T, N>`s. Lowered to the gather instructions on AVX2/AVX-512.
+template<typename T, typename I> inline Vec<T, lane_count<I>> gather(const T* base, I index) noexcept {
+    constexpr size_t lanes = lane_count<I>;
+    static_assert(sizeof(lane_type<I>) == sizeof(T));
+
+#if defined(__AVX512F__)
+    // the masked forms with a zeroed source, the unmasked ones start from an undefined register that GCC 12 warns
+    // about (-Wuninitialized)
+    if constexpr (std::is_same_v<T, float> && lanes == 16)
+        return reinterpret_cast<Vec<T, lanes>>(_mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, reinterpret_cast<__m512i>(index), base, sizeof(T)));
+    if constexpr (std::is_same_v<T, double> && lanes == 8)
+        return reinterpret_cast<Vec<T, lanes>>(_mm512_mask_i64gather_pd(_mm512_setzero_pd(), 0xFF, reinterpret_cast<__m512i>(index), base, sizeof(T)));
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 4 && lanes == 16)
+        return reinterpret_cast<Vec<T, lanes>>(
+          _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, reinterpret_cast<__m512i>(index), base, sizeof(T))
+        );
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 8 && lanes == 8)
+        return reinterpret_cast<Vec<T, lanes>>(
+          _mm512_mask_i64gather_epi64(_mm512_setzero_si512(), 0xFF, reinterpret_cast<__m512i>(index), base, sizeof(T))
+        );
+#endif
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<T, float> && lanes == 8)
+        return reinterpret_cast<Vec<T, lanes>>(_mm256_i32gather_ps(base, reinterpret_cast<__m256i>(index), sizeof(T)));
+    if constexpr (std::is_same_v<T, float> && lanes == 4)
+        return reinterpret_cast<Vec<T, lanes>>(_mm_i32gather_ps(base, reinterpret_cast<__m128i>(index), sizeof(T)));
+    if constexpr (std::is_same_v<T, double> && lanes == 4)
+        return reinterpret_cast<Vec<T, lanes>>(_mm256_i64gather_pd(base, reinterpret_cast<__m256i>(index), sizeof(T)));
+    if constexpr (std::is_same_v<T, double> && lanes == 2)
+        return reinterpret_cast<Vec<T, lanes>>(_mm_i64gather_pd(base, reinterpret_cast<__m128i>(index), sizeof(T)));
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 4 && lanes == 8)
+        return reinterpret_cast<Vec<T, lanes>>(_mm256_i32gather_epi32(reinterpret_cast<const int*>(base), reinterpret_cast<__m256i>(index), sizeof(T)));
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 4 && lanes == 4)
+        return reinterpret_cast<Vec<T, lanes>>(_mm_i32gather_epi32(reinterpret_cast<const int*>(base), reinterpret_cast<__m128i>(index), sizeof(T)));
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 8 && lanes == 4)
+        return reinterpret_cast<Vec<T, lanes>>(
+          _mm256_i64gather_epi64(reinterpret_cast<const long long*>(base), reinterpret_cast<__m256i>(index), sizeof(T))
+        );
+    if constexpr (std::is_integral_v<T> && sizeof(T) == 8 && lanes == 2)
+        return reinterpret_cast<Vec<T, lanes>>(
+          _mm_i64gather_epi64(reinterpret_cast<const long long*>(base), reinterpret_cast<__m128i>(index), sizeof(T))
+        );
+#endif
+
+    Vec<T, lanes> ret;
+    for (size_t i = 0; i < lanes; i++)
+        ret[i] = base[index[i]];
+    return ret;
+}
+
+/// True if any lane of a comparison mask is set
+template<typename M> constexpr bool any(M mask) noexcept {
+    for (size_t i = 0; i < lane_count<M>; i++)
+        if (mask[i] != 0)
+            return true;
+    return false;
+}
+
+template<typename V> constexpr lane_type<V> reduce_add(V v) noexcept {
+    lane_type<V> ret = v[0];
+    for (size_t i = 1; i < lane_count<V>; i++)
+        ret += v[i];
+    return ret;
+}
+
+/// Lane-wise square root, lowered to the packed instruction where one exists for the vector shape
+template<typename V> inline V sqrt(V v) noexcept {
+    using T = lane_type<V>;
+    constexpr size_t lanes = lane_count<V>;
+
+#if defined(__AVX__)
+    if constexpr (std::is_same_v<T, float> && lanes == 8)
+        return reinterpret_cast<V>(_mm256_sqrt_ps(reinterpret_cast<__m256>(v)));
+    if constexpr (std::is_same_v<T, double> && lanes == 4)
+        return reinterpret_cast<V>(_mm256_sqrt_pd(reinterpret_cast<__m256d>(v)));
+#endif
+#if defined(__SSE2__)
+    if constexpr (std::is_same_v<T, float> && lanes == 4)
+        return reinterpret_cast<V>(_mm_sqrt_ps(reinterpret_cast<__m128>(v)));
+    if constexpr (std::is_same_v<T, double> && lanes == 2)
+        return reinterpret_cast<V>(_mm_sqrt_pd(reinterpret_cast<__m128d>(v)));
+#endif
+
+    for (size_t i = 0; i < lanes; i++)
+        v[i] = std::sqrt(v[i]);
+    return v;
+}
+
+}
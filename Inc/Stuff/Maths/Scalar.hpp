@@ -13,8 +13,11 @@
 
 #include "Scalar/FloatUtils.hpp"
 
-#include "Scalar/Basic.hpp"
 #include "Scalar/Classification.hpp"
+
+#include "Scalar/Basic.hpp"
+#include "Scalar/Kernels.hpp"
+
 #include "Scalar/Exponential.hpp"
 #include "Scalar/Interpolation.hpp"
 #include "Scalar/Manipulation.hpp"
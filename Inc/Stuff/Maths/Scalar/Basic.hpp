@@ -31,6 +31,16 @@ template<std::floating_point T> constexpr T abs(T v) {
     }
 }
 
+template<typename T>
+    requires std::is_arithmetic_v<T>
+constexpr T fabs(T v) {
+    if consteval {
+        return Detail::CEMaths::abs(v);
+    } else {
+        return std::abs(v);
+    }
+}
+
 template<std::floating_point T> constexpr T fmax(T x, T y) {
     if consteval {
         return Detail::CEMaths::fmax(x, y);
@@ -19,6 +19,12 @@ template<typename T> constexpr T lerp(T t, T a, T b) {
     return t * (b - a) + a;
 }
 
+/// Catmull-Rom spline through p1 (t = 0) and p2 (t = 1) with p0 and p3 as the outer neighbours.\n
+/// Only uses integer constants so that it also works lane-wise on SIMD vectors.
+template<typename T> constexpr T cubic(T t, T p0, T p1, T p2, T p3) {
+    return p1 + t * (p2 - p0 + t * (2 * p0 - 5 * p1 + 4 * p2 - p3 + t * (3 * (p1 - p2) + p3 - p0))) / 2;
+}
+
 template<std::floating_point T> constexpr T map(T v, T from_a, T from_b, T to_a, T to_b) {
     const auto t = inv_lerp(v, from_a, from_b);
     return lerp(t, to_a, to_b);
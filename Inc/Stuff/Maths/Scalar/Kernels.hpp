@@ -0,0 +1,284 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+
+#include "./FloatUtils.hpp"
+
+/// Range reduction + minimax/series polynomial kernels for sin, cos, exp and log.\n
+/// Every kernel is written once against a type `V` that is either a `float`/`double` or a GCC generic vector of them,
+/// using only arithmetic, comparisons, `?:` and bit casts. The scalar instantiations are usable in constant
+/// expressions, the vector instantiations back the span overloads in <Stuff/Maths/Transcendental.hpp>.\n
+/// Kernels assume finite, in-range arguments; callers deal with the edges (see the `*_limit` constants).
+namespace Stf::Detail::Kernels {
+
+template<typename V> struct Traits {
+    using lane = V;
+    using integer = std::conditional_t<sizeof(V) == 4, int32_t, int64_t>;
+    using integer_lane = integer;
+    static constexpr bool is_vector = false;
+};
+
+template<typename V>
+    requires requires(V v) { v[0]; }
+struct Traits<V> {
+    using lane = std::remove_cvref_t<decltype(std::declval<V>()[0])>;
+    /// GCC yields a signed integer vector of the same shape from vector comparisons
+    using integer = decltype(std::declval<V>() < std::declval<V>());
+    using integer_lane = std::conditional_t<sizeof(lane) == 4, int32_t, int64_t>;
+    static constexpr bool is_vector = true;
+};
+
+/// The same shape as `V` with double lanes
+template<typename V> struct Widened {
+    using type = double;
+};
+
+template<typename V>
+    requires Traits<V>::is_vector
+struct Widened<V> {
+    typedef double type __attribute__((vector_size(sizeof(double) * (sizeof(V) / sizeof(typename Traits<V>::lane)))));
+};
+
+template<typename To, typename From> constexpr To convert(From v) {
+    if constexpr (Traits<From>::is_vector) {
+        return __builtin_convertvector(v, To);
+    } else {
+        return static_cast<To>(v);
+    }
+}
+
+template<typename V> constexpr V splat(typename Traits<V>::lane v) {
+    if constexpr (Traits<V>::is_vector) {
+        return V {} + v;
+    } else {
+        return v;
+    }
+}
+
+template<typename V> constexpr V abs(V v) { return v < 0 ? -v : v; }
+
+/// Round to nearest (ties to even) for |v| < 2^(digits - 2) by pushing the fraction bits out of the mantissa
+template<typename V> constexpr V round_nearest(V v) {
+    using T = typename Traits<V>::lane;
+    constexpr T magic = static_cast<T>(3) * static_cast<T>(1ull << (std::numeric_limits<T>::digits - 2));
+
+    return (v + magic) - magic;
+}
+
+template<typename V, typename T, size_t N> constexpr V horner(V x, std::array<T, N> const& coefficients) {
+    V ret = splat<V>(coefficients[0]);
+    for (auto i = 1uz; i < N; i++)
+        ret = ret * x + coefficients[i];
+    return ret;
+}
+
+/// 2^n for an integer n within the normal exponent range
+template<typename V> constexpr V exp2i(typename Traits<V>::integer n) {
+    using T = typename Traits<V>::lane;
+    using IL = typename Traits<V>::integer_lane;
+    using U = FloatParts<T>;
+
+    return std::bit_cast<V>((n + static_cast<IL>(U::max_exponent >> 1)) << static_cast<IL>(U::fraction_bits));
+}
+
+template<typename T> struct Constants;
+
+template<> struct Constants<float> {
+    /// sin(r) = r + r^3 * P(r^2), cos(r) = 1 - r^2 / 2 + r^4 * Q(r^2) on [-pi/4, pi/4] (Cephes sinf/cosf)
+    static constexpr std::array<float, 3> sin_coefficients { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f };
+    static constexpr std::array<float, 3> cos_coefficients { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+    static constexpr float ln2_hi = 0.693359375f;
+    static constexpr float ln2_lo = -2.12194440e-4f;
+
+    /// exp(r) = 1 + r + r^2 * P(r) on [-ln2/2, ln2/2] (Cephes expf)
+    static constexpr std::array<float, 6> exp_coefficients {
+        1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f, 4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f,
+    };
+
+    /// Arguments past which exp saturates to +inf / 0
+    static constexpr float exp_max = 0x1.62e42ep+6f;
+    static constexpr float exp_min = -104.f;
+
+    /// log(m) = 2 atanh(s) = 2s + 2s * s^2 * P(s^2) with s = (m - 1) / (m + 1), |s| <= 3 - 2 sqrt 2
+    static constexpr std::array<float, 4> log_coefficients { 1.f / 9.f, 1.f / 7.f, 1.f / 5.f, 1.f / 3.f };
+};
+
+template<> struct Constants<double> {
+    /// Cody-Waite split of pi/2 (fdlibm), the leading parts have enough trailing zeros for j * part to be exact
+    static constexpr double pio2_1 = 1.57079632673412561417e+00;
+    static constexpr double pio2_2 = 6.07710050630396597660e-11;
+    static constexpr double pio2_3 = 2.02226624879595063154e-21;
+
+    /// Cephes sin/cos
+    static constexpr std::array<double, 6> sin_coefficients {
+        1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+        -1.98412698295895385996e-4, 8.33333333332211858878e-3,  -1.66666666666666307295e-1,
+    };
+    static constexpr std::array<double, 6> cos_coefficients {
+        -1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+        2.48015872888517045348e-5,   -1.38888888888730564116e-3, 4.16666666666665929218e-2,
+    };
+
+    static constexpr double ln2_hi = 6.93147180369123816490e-01;
+    static constexpr double ln2_lo = 1.90821492927058770002e-10;
+
+    /// Taylor series through r^13, the truncation error on [-ln2/2, ln2/2] is below 2^-57
+    static constexpr std::array<double, 12> exp_coefficients {
+        1. / 6227020800., 1. / 479001600., 1. / 39916800., 1. / 3628800., 1. / 362880., 1. / 40320.,
+        1. / 5040.,       1. / 720.,       1. / 120.,      1. / 24.,      1. / 6.,      1. / 2.,
+    };
+
+    static constexpr double exp_max = 0x1.62e42fefa39efp+9;
+    static constexpr double exp_min = -746.;
+
+    /// Minimax replacement of the atanh series (fdlibm Lg7..Lg1, halved for the 2s * s^2 * P(s^2) form)
+    static constexpr std::array<double, 7> log_coefficients {
+        1.479819860511658591e-01 / 2, 1.531383769920937332e-01 / 2, 1.818357216161805012e-01 / 2, 2.222219843214978396e-01 / 2,
+        2.857142874366239149e-01 / 2, 3.999999999940941908e-01 / 2, 6.666666666666735130e-01 / 2,
+    };
+};
+
+/// Largest |x| for which the pi/2 reduction in `sin_cos` is exact
+template<typename T> inline constexpr T sin_cos_limit = static_cast<T>(1 << 20);
+
+template<typename V> struct Reduced {
+    V r;
+    typename Traits<V>::integer quadrant;
+};
+
+/// x = quadrant * pi/2 + r with |r| <= pi/4, for |x| <= sin_cos_limit
+template<typename V> constexpr Reduced<V> reduce_pio2(V x) {
+    using T = typename Traits<V>::lane;
+    using I = typename Traits<V>::integer;
+    using C = Constants<T>;
+
+    if constexpr (std::is_same_v<T, float>) {
+        // no float split of pi/2 survives the cancellation next to multiples of pi/2, this costs a round trip instead
+        using W = typename Widened<V>::type;
+        const auto wide = reduce_pio2(convert<W>(x));
+        return { convert<V>(wide.r), convert<I>(wide.quadrant) };
+    } else {
+        const V j = round_nearest(x * static_cast<T>(2 * std::numbers::inv_pi_v<long double>));
+        return {
+            .r = ((x - j * C::pio2_1) - j * C::pio2_2) - j * C::pio2_3,
+            .quadrant = convert<I>(j),
+        };
+    }
+}
+
+template<typename V> struct SinCos {
+    V sin;
+    V cos;
+};
+
+/// |x| <= sin_cos_limit. Error: <= 2 ulp
+template<typename V> constexpr SinCos<V> sin_cos(V x) {
+    using T = typename Traits<V>::lane;
+    using C = Constants<T>;
+
+    const auto [r, q] = reduce_pio2(x);
+    const V z = r * r;
+
+    const V s = r + r * z * horner(z, C::sin_coefficients);
+    const V c = 1 - z * static_cast<T>(0.5) + z * z * horner(z, C::cos_coefficients);
+
+    // quadrant q: sin x = { s, c, -s, -c }[q], cos x = { c, -s, -c, s }[q]
+    const V sin_abs = (q & 1) != 0 ? c : s;
+    const V cos_abs = (q & 1) != 0 ? s : c;
+
+    return {
+        .sin = (q & 2) != 0 ? -sin_abs : sin_abs,
+        .cos = ((q + 1) & 2) != 0 ? -cos_abs : cos_abs,
+    };
+}
+
+/// Defined for every input, NaN included. Error: <= 1 ulp
+template<typename V> constexpr V exp(V x) {
+    using T = typename Traits<V>::lane;
+    using I = typename Traits<V>::integer;
+    using C = Constants<T>;
+
+    constexpr auto inf = std::numeric_limits<T>::infinity();
+
+    // written so that NaN lands on exp_min, it is patched back in at the end
+    V clamped = x >= C::exp_min ? x : splat<V>(C::exp_min);
+    clamped = clamped > C::exp_max ? splat<V>(C::exp_max) : clamped;
+
+    const V n = round_nearest(clamped * std::numbers::log2e_v<T>);
+    const V r = (clamped - n * C::ln2_hi) - n * C::ln2_lo;
+    const V p = 1 + r + r * r * horner(r, C::exp_coefficients);
+
+    // 2^n is applied in two halves so that results in the subnormal range are rounded once
+    const I n_i = convert<I>(n);
+    const I n_1 = n_i >> 1;
+    // saturated before the product overflows, which a constant evaluation rejects (a scalar ?: only evaluates one side)
+    const V ret = x > C::exp_max ? splat<V>(inf) : p * exp2i<V>(n_1) * exp2i<V>(n_i - n_1);
+
+    return x != x ? x : ret;
+}
+
+/// Defined for every input: NaN for x < 0, -inf for +-0. Error: <= 2 ulp
+template<typename V> constexpr V log(V x) {
+    using T = typename Traits<V>::lane;
+    using I = typename Traits<V>::integer;
+    using IL = typename Traits<V>::integer_lane;
+    using C = Constants<T>;
+    using U = FloatParts<T>;
+
+    constexpr auto fraction_bits = static_cast<IL>(U::fraction_bits);
+    constexpr auto bias = static_cast<IL>(U::max_exponent >> 1);
+    constexpr auto inf = std::numeric_limits<T>::infinity();
+
+    const auto subnormal = x < std::numeric_limits<T>::min();
+    const V scaled = subnormal ? x * static_cast<T>(1ull << fraction_bits) : x;
+
+    const I bits = std::bit_cast<I>(scaled);
+    I e = ((bits >> fraction_bits) & static_cast<IL>(U::max_exponent)) - bias;
+    e = subnormal ? e - fraction_bits : e;
+
+    // m in [sqrt(1/2), sqrt(2))
+    V m = std::bit_cast<V>((bits & static_cast<IL>(U::max_fraction)) | (bias << fraction_bits));
+    const auto high = m > std::numbers::sqrt2_v<T>;
+    m = high ? m * static_cast<T>(0.5) : m;
+    e = high ? e + 1 : e;
+
+    const V s = (m - 1) / (m + 1);
+    const V z = s * s;
+    const V two_s = s + s;
+    const V log_m = two_s + two_s * z * horner(z, C::log_coefficients);
+
+    const V e_f = convert<V>(e);
+    V ret = e_f * C::ln2_hi + (log_m + e_f * C::ln2_lo);
+
+    ret = x == inf ? x : ret;
+    ret = x == 0 ? splat<V>(-inf) : ret;
+    ret = x < 0 ? splat<V>(std::numeric_limits<T>::quiet_NaN()) : ret;
+    return x != x ? x : ret;
+}
+
+/// x^y for finite x > 0 and finite y, as exp(y log x).\n
+/// Float inputs are evaluated with the double kernels, which keeps the result within 1 ulp. For double inputs the
+/// error of log(x) is scaled by y, giving a relative error of about |y log x| * 2^-53 (up to a few hundred ulp close
+/// to the overflow threshold, 1-2 ulp for moderate results).
+template<typename V> constexpr V pow_positive(V x, V y) {
+    using T = typename Traits<V>::lane;
+
+    if constexpr (std::is_same_v<T, float>) {
+        using W = typename Widened<V>::type;
+        const W x_w = convert<W>(x);
+        const W y_w = convert<W>(y);
+        return convert<V>(exp(y_w * log(x_w)));
+    } else {
+        return exp(y * log(x));
+    }
+}
+
+}
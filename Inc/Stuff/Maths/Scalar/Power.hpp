@@ -100,6 +100,64 @@ template<std::floating_point T, std::integral U> constexpr T pow(T base, U iexp)
 
 //static_assert(pow(2.f, 10) == 1024.f);
 
+template<std::floating_point T> constexpr T pow(T base, T exponent) {
+    const auto inf = std::numeric_limits<T>::infinity();
+    // every float at or above this magnitude is an even integer: 2^digits, which is too wide for a shift with long double
+    constexpr auto even_threshold = [] {
+        T ret = 1;
+        for (auto i = 0; i < std::numeric_limits<T>::digits; i++)
+            ret *= 2;
+        return ret;
+    }();
+
+    if (base == 1 || exponent == 0)
+        return 1;
+
+    if (is_nan(base) || is_nan(exponent))
+        return std::numeric_limits<T>::quiet_NaN();
+
+    if (is_inf(exponent)) {
+        const auto magnitude = abs(base);
+        if (magnitude == 1)
+            return 1;
+        return (magnitude < 1) == (exponent < 0) ? inf : 0;
+    }
+
+    // every float at or above 2^(digits - 1) is an integer, and adding it to a smaller one leaves no fractional bits
+    constexpr auto integral_threshold = even_threshold / 2;
+
+    const auto abs_exponent = abs(exponent);
+    const bool integral = abs_exponent >= integral_threshold || (abs_exponent + integral_threshold) - integral_threshold == abs_exponent;
+    // an integer below 2^digits, which fits in 64 bits
+    const bool odd = integral && abs_exponent < even_threshold && (static_cast<uint64_t>(abs_exponent) & 1) != 0;
+
+    // small integral exponents are done by squaring so that exactly representable results come out exact
+    if (integral && abs_exponent <= 64) {
+        if constexpr (std::is_same_v<T, float>)
+            return static_cast<float>(pow(static_cast<double>(base), static_cast<int64_t>(exponent)));
+        else
+            return pow(base, static_cast<int64_t>(exponent));
+    }
+
+    if (base == 0 || is_inf(base)) {
+        if (integral && abs_exponent < static_cast<T>(1ull << 62))
+            return pow(base, static_cast<int64_t>(exponent));
+
+        // non-integral or huge (thus even) exponent: the sign of the base does not matter
+        return (base == 0) == (exponent < 0) ? inf : 0;
+    }
+
+    if (base < 0) {
+        if (!integral)
+            return std::numeric_limits<T>::quiet_NaN();
+
+        const auto magnitude = Kernels::pow_positive(-base, exponent);
+        return odd ? -magnitude : magnitude;
+    }
+
+    return Kernels::pow_positive(base, exponent);
+}
+
 }
 
 namespace Stf {
@@ -112,4 +170,12 @@ template<std::floating_point T, std::integral U> constexpr T pow(T base, U iexp)
     }
 }
 
+template<std::floating_point T> constexpr T pow(T base, T exponent) {
+    if consteval {
+        return Detail::CEMaths::pow(base, exponent);
+    } else {
+        return std::pow(base, exponent);
+    }
+}
+
 }
@@ -2,33 +2,15 @@
 
 namespace Stf::Detail::CEMaths {
 
-template<typename T> constexpr T sin(T x) {
-    const T target_delta = 0.000001f;
-    const size_t max_rounds = 50;
-
-    const T k = std::round(x * std::numbers::inv_pi_v<T> * 0.5f);
-    x -= k * 2 * std::numbers::pi_v<T>;
-    // sin(x) = sin(x - 2pi * round(x/2pi))
-
-    T ret = 0;
-    T term = x;
-
-    for (size_t k = 0; k < max_rounds; k++) {
-        if ((k % 2) != 0)
-            ret -= term;
-        else
-            ret += term;
+template<std::floating_point T> constexpr Kernels::SinCos<T> sin_cos(T x) {
+    if (is_nan(x) || is_inf(x))
+        return { std::numeric_limits<T>::quiet_NaN(), std::numeric_limits<T>::quiet_NaN() };
 
-        const T divisor = 4 * k * k + 10 * k + 6;
-        const T temp = term * (x * x / divisor);
-
-        if (is_close(temp, term, target_delta))
-            break;
-
-        term = temp;
-    }
+    // out of range arguments are reduced in extended precision first, accuracy degrades with |x| past this point
+    if (abs(x) > Kernels::sin_cos_limit<T>)
+        x = static_cast<T>(std::fmod(static_cast<long double>(x), 2 * std::numbers::pi_v<long double>));
 
-    return ret;
+    return Kernels::sin_cos(x);
 }
 
 }
@@ -37,7 +19,7 @@ namespace Stf {
 
 template<typename T> constexpr T sin(T x) {
     if consteval {
-        return Detail::CEMaths::sin(x);
+        return Detail::CEMaths::sin_cos(x).sin;
     } else {
         return std::sin(x);
     }
@@ -45,7 +27,7 @@ template<typename T> constexpr T sin(T x) {
 
 template<typename T> constexpr T cos(T x) {
     if consteval {
-        return sin(M_PI_2 + x);
+        return Detail::CEMaths::sin_cos(x).cos;
     } else {
         return std::cos(x);
     }
@@ -53,7 +35,8 @@ template<typename T> constexpr T cos(T x) {
 
 template<typename T> constexpr T tan(T x) {
     if consteval {
-        return sin(x) / cos(x);
+        const auto [sin, cos] = Detail::CEMaths::sin_cos(x);
+        return sin / cos;
     } else {
         return std::tan(x);
     };
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <Stuff/Maths/Scalar.hpp>
+#include <Stuff/Maths/SIMD.hpp>
+
+#include <cmath>
+#include <cstring>
+#include <span>
+
+/// Vectorised sin/cos/exp/log/pow over spans.\n
+/// The bulk of every span is processed in native width vectors with the polynomial kernels from
+/// <Stuff/Maths/Scalar/Kernels.hpp>, the same kernels that back the constexpr paths of Stf::sin & co. Lanes the
+/// kernels do not cover (huge trig arguments, non-positive pow bases...) are patched with the <cmath> function, so
+/// every input is handled and the stated bounds hold over the whole domain.\n
+/// All functions process `out.size()` elements; inputs must be at least as long. Outputs may alias inputs.
+namespace Stf::Detail::Transcendental {
+
+template<typename V, typename T> inline V load_partial(const T* p, size_t count) {
+    V ret {};
+    std::memcpy(&ret, p, count * sizeof(T));
+    return ret;
+}
+
+template<typename T, typename V> inline void store_partial(T* p, V v, size_t count) { std::memcpy(p, &v, count * sizeof(T)); }
+
+/// Lane count for kernels that widen float to double internally (sin/cos reduction, pow), chosen so that the widened
+/// vector is still native width. Wider generic vectors get split by the compiler, often lane by lane.
+template<typename T> inline constexpr size_t widening_lanes = std::is_same_v<T, float> ? SIMD::native_lanes<double> : SIMD::native_lanes<T>;
+
+/// out[i] = fn(in[i]) where `fn` maps a vector of `Lanes` elements to a vector of the same shape
+template<typename T, size_t Lanes = SIMD::native_lanes<T>, typename Fn> inline void unary(std::span<const T> in, std::span<T> out, Fn&& fn) {
+    using V = SIMD::Vec<T, Lanes>;
+    constexpr size_t lanes = Lanes;
+
+    size_t i = 0;
+    for (; i + lanes <= out.size(); i += lanes)
+        SIMD::store(out.data() + i, fn(SIMD::load<lanes>(in.data() + i)));
+
+    if (const auto count = out.size() - i; count != 0)
+        store_partial(out.data() + i, fn(load_partial<V>(in.data() + i, count)), count);
+}
+
+template<typename T, size_t Lanes = SIMD::native_lanes<T>, typename Fn>
+inline void binary(std::span<const T> lhs, std::span<const T> rhs, std::span<T> out, Fn&& fn) {
+    using V = SIMD::Vec<T, Lanes>;
+    constexpr size_t lanes = Lanes;
+
+    size_t i = 0;
+    for (; i + lanes <= out.size(); i += lanes)
+        SIMD::store(out.data() + i, fn(SIMD::load<lanes>(lhs.data() + i), SIMD::load<lanes>(rhs.data() + i)));
+
+    if (const auto count = out.size() - i; count != 0)
+        store_partial(out.data() + i, fn(load_partial<V>(lhs.data() + i, count), load_partial<V>(rhs.data() + i, count)), count);
+}
+
+/// Replaces lanes of `ret` where `mask` is set with `fn(lane index)`
+template<typename V, typename M, typename Fn> inline void patch(V& ret, M mask, Fn&& fn) {
+    if (!SIMD::any(mask)) [[likely]]
+        return;
+
+    for (size_t i = 0; i < SIMD::lane_count<V>; i++)
+        if (mask[i] != 0)
+            ret[i] = fn(i);
+}
+
+template<typename V> inline Kernels::SinCos<V> sin_cos(V x) {
+    auto ret = Kernels::sin_cos(x);
+
+    const auto out_of_range = Kernels::abs(x) > Kernels::sin_cos_limit<SIMD::lane_type<V>>;
+    patch(ret.sin, out_of_range, [&](size_t i) { return std::sin(x[i]); });
+    patch(ret.cos, out_of_range, [&](size_t i) { return std::cos(x[i]); });
+
+    return ret;
+}
+
+template<typename V> inline V pow(V x, V y) {
+    using T = SIMD::lane_type<V>;
+    constexpr auto inf = std::numeric_limits<T>::infinity();
+
+    const auto fast = (x > 0) & (x < inf) & (Kernels::abs(y) < inf);
+    V ret = Kernels::pow_positive(fast ? x : Kernels::splat<V>(1), fast ? y : Kernels::splat<V>(0));
+
+    patch(ret, fast == 0, [&](size_t i) { return std::pow(x[i], y[i]); });
+    return ret;
+}
+
+}
+
+namespace Stf {
+
+/// Error: <= 2 ulp
+template<std::floating_point T> void sin(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Detail::Transcendental::unary<T, Detail::Transcendental::widening_lanes<T>>(in, out, [](auto x) {
+        return Detail::Transcendental::sin_cos(x).sin;
+    });
+}
+
+/// Error: <= 2 ulp
+template<std::floating_point T> void cos(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Detail::Transcendental::unary<T, Detail::Transcendental::widening_lanes<T>>(in, out, [](auto x) {
+        return Detail::Transcendental::sin_cos(x).cos;
+    });
+}
+
+/// Computes both at the cost of one range reduction. Error: <= 2 ulp
+template<std::floating_point T> void sin_cos(std::type_identity_t<std::span<const T>> in, std::span<T> sin_out, std::span<T> cos_out) {
+    constexpr size_t lanes = Detail::Transcendental::widening_lanes<T>;
+    using V = SIMD::Vec<T, lanes>;
+
+    size_t i = 0;
+    for (; i + lanes <= sin_out.size(); i += lanes) {
+        const auto [sin, cos] = Detail::Transcendental::sin_cos(SIMD::load<lanes>(in.data() + i));
+        SIMD::store(sin_out.data() + i, sin);
+        SIMD::store(cos_out.data() + i, cos);
+    }
+
+    if (const auto count = sin_out.size() - i; count != 0) {
+        const auto [sin, cos] = Detail::Transcendental::sin_cos(Detail::Transcendental::load_partial<V>(in.data() + i, count));
+        Detail::Transcendental::store_partial(sin_out.data() + i, sin, count);
+        Detail::Transcendental::store_partial(cos_out.data() + i, cos, count);
+    }
+}
+
+/// Error: <= 1 ulp
+template<std::floating_point T> void exp(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Detail::Transcendental::unary(in, out, [](auto x) { return Detail::Kernels::exp(x); });
+}
+
+/// Error: <= 2 ulp
+template<std::floating_point T> void log(std::type_identity_t<std::span<const T>> in, std::span<T> out) {
+    Detail::Transcendental::unary(in, out, [](auto x) { return Detail::Kernels::log(x); });
+}
+
+/// out[i] = base[i] ^ exponent[i]\n
+/// Error: <= 1 ulp (float). For double about |y log x| * 2^-53 relative, see Detail::Kernels::pow_positive.
+template<std::floating_point T>
+void pow(std::type_identity_t<std::span<const T>> base, std::type_identity_t<std::span<const T>> exponent, std::span<T> out) {
+    Detail::Transcendental::binary<T, Detail::Transcendental::widening_lanes<T>>(base, exponent, out, [](auto x, auto y) {
+        return Detail::Transcendental::pow(x, y);
+    });
+}
+
+/// out[i] = base[i] ^ exponent
+template<std::floating_point T> void pow(std::type_identity_t<std::span<const T>> base, T exponent, std::span<T> out) {
+    Detail::Transcendental::unary<T, Detail::Transcendental::widening_lanes<T>>(base, out, [exponent](auto x) {
+        return Detail::Transcendental::pow(x, Detail::Kernels::splat<decltype(x)>(exponent));
+    });
+}
+
+}
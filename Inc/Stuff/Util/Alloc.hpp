@@ -1,12 +1,17 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <memory>
+#include <new>
 #include <span>
 
 namespace Stf {
 
 template<typename T> struct BumpAllocator;
 
+/// Bumps through a caller-provided buffer, see Arena for storage that grows and can be rewound.\n
+/// Not thread-safe, see SharedArena for concurrent allocations.
 template<> struct BumpAllocator<std::byte> {
     using pointer = std::byte*;
     using const_pointer = const std::byte*;
@@ -18,7 +23,6 @@ template<> struct BumpAllocator<std::byte> {
 
     std::span<std::byte> m_pool;
 
-    mutable std::mutex m_mutex {};
     size_t m_allocated = 0;
     size_t m_discarded = 0;
 
@@ -70,4 +74,27 @@ template<typename T> struct BumpAllocator {
 // template<typename T, size_t N>
 // BumpAllocator(BumpAllocatorStorage<N>& storage) -> BumpAllocator<T, N>;
 
+/// An allocator that hands out storage aligned to `Align` bytes (at least alignof(T)), suitable for aligned SIMD loads
+template<typename T, size_t Align = 64> struct AlignedAllocator {
+    static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    static constexpr size_t alignment = std::max(Align, alignof(T));
+
+    template<typename U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    constexpr AlignedAllocator() noexcept = default;
+
+    template<typename U> constexpr AlignedAllocator(AlignedAllocator<U, Align> const&) noexcept { }
+
+    [[nodiscard]] T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t { alignment })); }
+
+    void deallocate(T* p, size_t) noexcept { ::operator delete(p, std::align_val_t { alignment }); }
+
+    template<typename U> constexpr bool operator==(AlignedAllocator<U, Align> const&) const noexcept { return true; }
+};
+
 }
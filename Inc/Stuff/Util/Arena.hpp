@@ -0,0 +1,227 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+
+namespace Stf {
+
+namespace Detail {
+
+/// A block of arena storage, its bytes follow the header and start on a cache line
+struct alignas(64) ArenaChunk {
+    ArenaChunk* next;
+    size_t size;
+
+    /// Bump offset of a SharedArena
+    std::atomic_size_t used { 0 };
+
+    std::byte* begin() noexcept { return reinterpret_cast<std::byte*>(this + 1); }
+
+    std::byte* end() noexcept { return begin() + size; }
+
+    static ArenaChunk* create(size_t size, ArenaChunk* next);
+
+    /// Along with the chunks that follow
+    static void destroy_list(ArenaChunk* chunk) noexcept;
+};
+
+inline uintptr_t align_up(uintptr_t address, size_t alignment) noexcept { return (address + alignment - 1) & ~(alignment - 1); }
+
+}
+
+/// Storage for short-lived objects that are freed all at once, e.g. everything allocated while serving one request.\n
+/// Allocating bumps a pointer through a chunk, a new chunk is linked in when one runs out (each new chunk twice as
+/// large as the one before, up to `max_chunk_size`). Nothing is freed on its own, `rewind` (or an ArenaScope) frees
+/// everything allocated after a marker and `reset` everything. Both keep the chunks for the allocations that follow.\n
+/// Not thread-safe, every thread has an arena of its own in `local()`; see SharedArena for one that is shared. The
+/// destructors of the objects in an arena are never run.\n
+/// Alignments have to be powers of two.
+struct Arena {
+    static constexpr size_t default_chunk_size = 64uz * 1024;
+    static constexpr size_t max_chunk_size = 16uz * 1024 * 1024;
+
+    struct Marker {
+        Detail::ArenaChunk* chunk;
+        std::byte* ptr;
+    };
+
+    explicit Arena(size_t chunk_size = default_chunk_size) noexcept
+        : m_next_chunk_size(std::max<size_t>(chunk_size, 1)) { }
+
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    Arena(Arena const&) = delete;
+    Arena& operator=(Arena const&) = delete;
+
+    ~Arena() noexcept { release(); }
+
+    /// The arena of the calling thread
+    static Arena& local();
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        const auto address = Detail::align_up(reinterpret_cast<uintptr_t>(m_ptr), alignment);
+        const auto end = reinterpret_cast<uintptr_t>(m_end);
+        if (address > end || size > end - address || m_end == nullptr) [[unlikely]]
+            return allocate_slow(size, alignment);
+
+        m_ptr = reinterpret_cast<std::byte*>(address + size);
+        return reinterpret_cast<void*>(address);
+    }
+
+    template<typename T> [[nodiscard]] T* allocate(size_t n = 1) {
+        size_t size;
+        if (__builtin_mul_overflow(n, sizeof(T), &size)) [[unlikely]]
+            throw std::bad_alloc();
+
+        return static_cast<T*>(allocate(size, alignof(T)));
+    }
+
+    Marker mark() const noexcept { return { m_current, m_ptr }; }
+
+    /// Frees everything allocated after `marker` was taken
+    void rewind(Marker marker) noexcept {
+        m_current = marker.chunk;
+        m_ptr = marker.ptr;
+        m_end = marker.chunk == nullptr ? nullptr : marker.chunk->end();
+    }
+
+    /// Frees everything, the chunks are kept
+    void reset() noexcept { rewind({}); }
+
+    /// Frees everything and gives the chunks back
+    void release() noexcept;
+
+    /// Number of bytes in all the chunks, used or not
+    constexpr size_t reserved() const noexcept { return m_reserved; }
+
+private:
+    Detail::ArenaChunk* m_first = nullptr;
+    Detail::ArenaChunk* m_current = nullptr;
+    std::byte* m_ptr = nullptr;
+    std::byte* m_end = nullptr;
+
+    size_t m_next_chunk_size;
+    size_t m_reserved = 0;
+
+    void* allocate_slow(size_t size, size_t alignment);
+};
+
+/// Rewinds an arena to where it was on construction when it goes out of scope
+struct ArenaScope {
+    explicit ArenaScope(Arena& arena) noexcept
+        : m_arena(arena)
+        , m_marker(arena.mark()) { }
+
+    ArenaScope(ArenaScope const&) = delete;
+    ArenaScope& operator=(ArenaScope const&) = delete;
+
+    ~ArenaScope() noexcept { m_arena.rewind(m_marker); }
+
+private:
+    Arena& m_arena;
+    Arena::Marker m_marker;
+};
+
+/// An arena that threads allocate from concurrently. Allocating is an atomic fetch-add on the offset into the current
+/// chunk, only linking in a new chunk takes a lock. `reset` and `release` require that no thread is allocating.
+struct SharedArena {
+    static constexpr size_t default_chunk_size = 1024uz * 1024;
+
+    explicit SharedArena(size_t chunk_size = default_chunk_size) noexcept
+        : m_chunk_size(std::max<size_t>(chunk_size, 1)) { }
+
+    SharedArena(SharedArena const&) = delete;
+    SharedArena(SharedArena&&) = delete;
+
+    ~SharedArena() noexcept { release(); }
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        // sizes are kept to multiples of the granule so that smaller alignments never need padding
+        size_t rounded;
+        if (__builtin_add_overflow(size, granule - 1, &rounded)) [[unlikely]]
+            throw std::bad_alloc();
+        rounded = rounded / granule * granule;
+
+        size_t reserved;
+        if (__builtin_add_overflow(rounded, alignment > granule ? alignment - granule : 0, &reserved)) [[unlikely]]
+            throw std::bad_alloc();
+
+        for (;;) {
+            auto* const chunk = m_current.load(std::memory_order_acquire);
+            // more than a whole chunk is never added to its offset, so that it can not wrap around
+            if (chunk != nullptr && reserved <= chunk->size) {
+                const auto offset = chunk->used.fetch_add(reserved, std::memory_order_relaxed);
+                if (offset + reserved <= chunk->size) [[likely]]
+                    return reinterpret_cast<void*>(Detail::align_up(reinterpret_cast<uintptr_t>(chunk->begin() + offset), alignment));
+            }
+
+            grow(chunk, reserved);
+        }
+    }
+
+    template<typename T> [[nodiscard]] T* allocate(size_t n = 1) {
+        size_t size;
+        if (__builtin_mul_overflow(n, sizeof(T), &size)) [[unlikely]]
+            throw std::bad_alloc();
+
+        return static_cast<T*>(allocate(size, alignof(T)));
+    }
+
+    /// Frees everything, the chunks are kept
+    void reset() noexcept;
+
+    /// Frees everything and gives the chunks back
+    void release() noexcept;
+
+    size_t reserved() const noexcept {
+        std::unique_lock lock { m_mutex };
+        return m_reserved;
+    }
+
+private:
+    static constexpr size_t granule = alignof(std::max_align_t);
+
+    std::atomic<Detail::ArenaChunk*> m_current { nullptr };
+
+    mutable std::mutex m_mutex {};
+    Detail::ArenaChunk* m_first = nullptr;
+    size_t m_chunk_size;
+    size_t m_reserved = 0;
+
+    /// Moves on from `full` to a chunk with room for `size` bytes, unless another thread did already
+    void grow(Detail::ArenaChunk* full, size_t size);
+};
+
+/// A standard allocator over an Arena or a SharedArena, deallocations are no-ops
+template<typename T, typename A = Arena> struct ArenaAllocator {
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename U> struct rebind { using other = ArenaAllocator<U, A>; };
+
+    constexpr ArenaAllocator(A& arena) noexcept
+        : m_arena(&arena) { }
+
+    template<typename U>
+    constexpr ArenaAllocator(ArenaAllocator<U, A> const& other) noexcept
+        : m_arena(other.arena()) { }
+
+    [[nodiscard]] T* allocate(size_t n) { return m_arena->template allocate<T>(n); }
+
+    constexpr void deallocate(T*, size_t) noexcept { }
+
+    constexpr A* arena() const noexcept { return m_arena; }
+
+    template<typename U> constexpr bool operator==(ArenaAllocator<U, A> const& other) const noexcept { return m_arena == other.arena(); }
+
+private:
+    A* m_arena;
+};
+
+}
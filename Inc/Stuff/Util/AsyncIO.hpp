@@ -0,0 +1,158 @@
+#pragma once
+
+#include <Stuff/Util/Hacks/Coroutines.hpp>
+#include <Stuff/Util/Hacks/Try.hpp>
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Stf {
+
+enum class AsyncIOBackend {
+    /// Operations are submitted to the kernel in batches through an io_uring
+    IOUring,
+
+    /// Operations are blocking preads and pwrites on the threads of a ThreadPool
+    ThreadPool,
+};
+
+/// Called with the number of bytes transferred or with -errno, as a pread or a pwrite would have returned
+using AsyncIOCallback = std::function<void(int64_t result)>;
+
+struct AsyncIO;
+
+namespace Detail {
+
+struct AsyncIOEngine;
+
+struct AsyncIOOperation {
+    enum class Kind {
+        Read,
+        Write,
+        ReadFixed,
+    };
+
+    Kind kind;
+    int fildes;
+    char* data;
+    size_t length;
+    size_t offset;
+    size_t buffer_index;
+    AsyncIOCallback callback;
+};
+
+struct AsyncIOCompletion {
+    size_t slot;
+    int64_t result;
+};
+
+/// Queues its operation on suspension and is resumed from `AsyncIO::poll` with the result
+struct AsyncIOAwaitable {
+    AsyncIO& io;
+    AsyncIOOperation operation;
+    int64_t result = 0;
+
+    constexpr bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle);
+
+    constexpr int64_t await_resume() const noexcept { return result; }
+};
+
+}
+
+/// Positional reads and writes that complete asynchronously, for keeping many reads in flight where page faults on a
+/// mapping would have serialised them.\n
+/// Operations are queued, started by `submit` or `poll` with at most `queue_depth()` of them in flight, and their
+/// callbacks are run by `poll` on the thread that calls it, never concurrently. The io_uring backend is used where the
+/// kernel provides it, otherwise the operations are run on a ThreadPool.\n
+/// Buffers and file descriptors have to stay valid until the callback of their operation is run.
+struct AsyncIO {
+    explicit AsyncIO(size_t queue_depth = 64, bool prefer_io_uring = true, ThreadPool& pool = ThreadPool::global());
+
+    AsyncIO(AsyncIO const&) = delete;
+    AsyncIO(AsyncIO&&) = delete;
+
+    /// Waits for all pending operations, running their callbacks
+    ~AsyncIO() noexcept;
+
+    AsyncIOBackend backend() const noexcept;
+
+    /// The depth asked for, down to what the backend can keep in flight (32768 operations on io_uring)
+    size_t queue_depth() const noexcept { return m_slots.size(); }
+
+    /// Queued and in flight
+    size_t pending() const noexcept { return m_queued.size() + m_in_flight; }
+
+    void read(int fildes, std::span<char> buffer, size_t offset, AsyncIOCallback callback);
+
+    void write(int fildes, std::span<const char> buffer, size_t offset, AsyncIOCallback callback);
+
+    /// Registers buffers with the kernel once instead of mapping them in on every operation, see `read_fixed`.
+    /// Replaces the buffers registered before, which requires that no operation is pending.
+    tl::expected<void, std::string_view> register_buffers(std::span<const std::span<char>> buffers);
+
+    /// Reads `length` bytes into the beginning of the registered buffer at `buffer_index`
+    void read_fixed(int fildes, size_t buffer_index, size_t length, size_t offset, AsyncIOCallback callback);
+
+    /// Starts as many of the queued operations as fit in the queue, with a single syscall for all of them on io_uring
+    void submit();
+
+    /// Submits, then runs the callbacks of the completed operations after waiting for at least `min_completions` of
+    /// them (or for all of the ones in flight if there are fewer).
+    /// @return the number of callbacks that were run
+    size_t poll(size_t min_completions = 0);
+
+    /// Polls until no operation is pending, including the ones queued by the callbacks
+    void drain();
+
+    [[nodiscard]] Detail::AsyncIOAwaitable async_read(int fildes, std::span<char> buffer, size_t offset);
+
+    [[nodiscard]] Detail::AsyncIOAwaitable async_write(int fildes, std::span<const char> buffer, size_t offset);
+
+    [[nodiscard]] Detail::AsyncIOAwaitable async_read_fixed(int fildes, size_t buffer_index, size_t length, size_t offset);
+
+private:
+    friend struct Detail::AsyncIOAwaitable;
+
+    std::unique_ptr<Detail::AsyncIOEngine> m_engine;
+
+    std::vector<std::span<char>> m_buffers {};
+
+    std::deque<Detail::AsyncIOOperation> m_queued {};
+
+    /// The callbacks of the operations in flight, indexed by the slots the engine reports completions with
+    std::vector<AsyncIOCallback> m_slots;
+    std::vector<size_t> m_free_slots;
+    size_t m_in_flight = 0;
+
+    std::vector<Detail::AsyncIOCompletion> m_completions {};
+
+    void enqueue(Detail::AsyncIOOperation&& operation);
+};
+
+/// The return type of a coroutine that starts right away and that nothing awaits, e.g. one that issues AsyncIO reads.
+/// Its frame is freed when it returns.
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+
+        std::suspend_never final_suspend() noexcept { return {}; }
+
+        void return_void() noexcept { }
+
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+}
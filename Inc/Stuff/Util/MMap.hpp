@@ -2,24 +2,90 @@
 
 #include <Stuff/Util/Hacks/Try.hpp>
 
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <limits>
 #include <span>
 #include <string>
 #include <string_view>
 
 namespace Stf {
 
+/// How a mapping is going to be read, passed on to the kernel to tune its read-ahead
+enum class MMapAccess {
+    Normal,
+    Sequential,
+    Random,
+};
+
+struct MMapOptions {
+    /// Writes through a writable mapping go to the file (MAP_SHARED) instead of to private copies of the pages
+    bool shared = false;
+
+    /// Reads the whole mapping in when it is created (MAP_POPULATE) instead of faulting the pages in as they are touched
+    bool populate = false;
+
+    MMapAccess access = MMapAccess::Normal;
+
+    /// Starts reading the mapping in asynchronously (MADV_WILLNEED)
+    bool will_need = false;
+
+    /// Asks for transparent huge pages (MADV_HUGEPAGE), fewer TLB misses and page faults where the file system has them
+    bool huge_pages = false;
+};
+
+namespace Detail {
+
+/// A mapping of a part of a file, unmapped on destruction. Mappings start on a page, `data()` points at the requested
+/// offset in it.
+struct MMapRegion {
+    MMapRegion() noexcept = default;
+
+    MMapRegion(MMapRegion&& other) noexcept;
+    MMapRegion& operator=(MMapRegion&& other) noexcept;
+
+    MMapRegion(MMapRegion const&) = delete;
+    MMapRegion& operator=(MMapRegion const&) = delete;
+
+    ~MMapRegion() noexcept { unmap(); }
+
+    /// Maps `length` bytes at `offset` of the file, the region is empty if that fails
+    static MMapRegion map(int fildes, size_t offset, size_t length, bool writable, MMapOptions const& options) noexcept;
+
+    char* data() const noexcept { return m_base == nullptr ? nullptr : static_cast<char*>(m_base) + m_skip; }
+
+    size_t size() const noexcept { return m_length - m_skip; }
+
+    void unmap() noexcept;
+
+private:
+    void* m_base = nullptr;
+    size_t m_length = 0;
+    size_t m_skip = 0;
+};
+
+}
+
 struct MMapStringView {
-    MMapStringView(std::string const& filename, bool readonly)
+    MMapStringView(std::string const& filename, bool readonly, MMapOptions const& options = {})
         : m_filename(filename)
-        , m_readonly(readonly) {
+        , m_readonly(readonly)
+        , m_options(options) {
         initialize();
     }
 
+    MMapStringView(MMapStringView&& other) noexcept;
+    MMapStringView& operator=(MMapStringView&& other) noexcept;
+
+    MMapStringView(MMapStringView const&) = delete;
+    MMapStringView& operator=(MMapStringView const&) = delete;
+
     ~MMapStringView() noexcept { deinitialize(); }
 
-    char* data() noexcept { return reinterpret_cast<char*>(m_data); }
+    char* data() noexcept { return m_region.data(); }
 
-    const char* data() const noexcept { return reinterpret_cast<const char*>(m_data); }
+    const char* data() const noexcept { return m_region.data(); }
 
     constexpr size_t size() const noexcept { return m_filesize; }
 
@@ -32,14 +98,131 @@ struct MMapStringView {
 private:
     std::string m_filename;
     bool m_readonly;
+    MMapOptions m_options;
 
     size_t m_filesize = 0;
-    void* m_data = nullptr;
-    int m_fildes;
+    Detail::MMapRegion m_region {};
+    int m_fildes = -1;
 
     void initialize() noexcept;
 
     void deinitialize() noexcept;
 };
 
+/// Read-only access to a file through mappings of one fixed-size window of it at a time, for files larger than what
+/// can be mapped at once.\n
+/// Window `i` holds the bytes [i * window_size(), (i + 1) * window_size() + overlap) of the file (cut at its end), the
+/// overlap lets records that cross into the next window be read whole. While a window is in use the one after it is
+/// mapped and read in (MAP_POPULATE) on a background thread, so that a scan over the windows in order does not stall
+/// on page faults.
+struct MMapWindowedFile {
+    static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+    /// `window_size` is rounded up to a whole number of pages
+    MMapWindowedFile(std::string const& filename, size_t window_size, size_t overlap = 0, MMapOptions const& options = {});
+
+    MMapWindowedFile(MMapWindowedFile&& other) noexcept;
+    MMapWindowedFile& operator=(MMapWindowedFile&& other) noexcept;
+
+    MMapWindowedFile(MMapWindowedFile const&) = delete;
+    MMapWindowedFile& operator=(MMapWindowedFile const&) = delete;
+
+    ~MMapWindowedFile() noexcept { deinitialize(); }
+
+    bool is_open() const noexcept { return m_fildes >= 0; }
+
+    /// Size of the file in bytes
+    constexpr size_t size() const noexcept { return m_filesize; }
+
+    constexpr size_t window_size() const noexcept { return m_window_size; }
+
+    constexpr size_t window_count() const noexcept { return (m_filesize + m_window_size - 1) / m_window_size; }
+
+    /// Maps window `index` and starts prefetching the next one. The view stays valid until the next call, it is empty
+    /// if `index` is out of range or if the window could not be mapped.
+    std::span<const char> window(size_t index);
+
+private:
+    int m_fildes = -1;
+    size_t m_filesize = 0;
+    size_t m_window_size;
+    size_t m_overlap;
+    MMapOptions m_options;
+
+    Detail::MMapRegion m_current {};
+    size_t m_current_index = npos;
+
+    std::future<Detail::MMapRegion> m_next {};
+    size_t m_next_index = npos;
+
+    std::function<Detail::MMapRegion()> window_mapper(size_t index, bool populate) const;
+
+    void deinitialize() noexcept;
+};
+
+/// An append-only file written through a shared mapping of it.\n
+/// The file starts with a `header_size` byte header holding the length of the committed records, the records follow
+/// it. Appends are copies into the mapping, the file is preallocated and grows geometrically so that most appends are
+/// neither syscalls nor page cache misses. `commit()` flushes the records to the file first and only then records
+/// their length in the header, so readers (see `committed_bytes`) and the file reopened after a crash only ever see
+/// whole records. Whatever was appended after the last commit is dropped on reopening.
+struct MMapAppendFile {
+    static constexpr size_t header_size = 64;
+
+    /// Opens or creates `filename`. An existing file has to have been written by an MMapAppendFile, appends continue
+    /// after its committed records.
+    static tl::expected<MMapAppendFile, std::string_view> open(std::string const& filename, size_t initial_capacity = 1uz << 20);
+
+    MMapAppendFile(MMapAppendFile&& other) noexcept;
+    MMapAppendFile& operator=(MMapAppendFile&& other) noexcept;
+
+    MMapAppendFile(MMapAppendFile const&) = delete;
+    MMapAppendFile& operator=(MMapAppendFile const&) = delete;
+
+    /// Does not commit
+    ~MMapAppendFile() noexcept { deinitialize(); }
+
+    /// Reserves `size` bytes after the appended ones and returns their offset among the records. Offsets stay valid
+    /// for the lifetime of the file, pointers into `data()` only until the next append that grows the file.
+    tl::expected<size_t, std::string_view> allocate(size_t size);
+
+    /// Copies `bytes` after the appended ones and returns their offset
+    tl::expected<size_t, std::string_view> append(std::span<const char> bytes);
+
+    /// Makes everything appended so far durable and visible to readers
+    tl::expected<void, std::string_view> commit();
+
+    /// The records
+    char* data() noexcept { return m_base + header_size; }
+
+    const char* data() const noexcept { return m_base + header_size; }
+
+    /// Number of bytes appended, committed or not
+    constexpr size_t size() const noexcept { return m_size; }
+
+    /// Number of bytes appended as of the last commit
+    constexpr size_t committed() const noexcept { return m_committed; }
+
+    /// Number of bytes the file can hold before it has to grow
+    constexpr size_t capacity() const noexcept { return m_capacity - header_size; }
+
+    /// The committed records of a file written by an MMapAppendFile, e.g. mapped with an MMapStringView
+    static tl::expected<std::span<const char>, std::string_view> committed_bytes(std::span<const char> file);
+
+private:
+    MMapAppendFile(int fildes, char* base, size_t capacity, size_t committed) noexcept;
+
+    int m_fildes = -1;
+    char* m_base = nullptr;
+
+    /// Size of both the file and the mapping, the header included
+    size_t m_capacity = 0;
+    size_t m_size = 0;
+    size_t m_committed = 0;
+
+    tl::expected<void, std::string_view> grow(size_t min_capacity);
+
+    void deinitialize() noexcept;
+};
+
 }
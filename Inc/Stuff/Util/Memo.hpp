@@ -1,7 +1,14 @@
 #pragma once
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
 #include <list>
+#include <unordered_map>
+#include <vector>
 
+#include <Stuff/Util/Hash.hpp>
 #include <Stuff/Util/Tuple.hpp>
 
 namespace Stf::Comp {
@@ -82,4 +89,213 @@ protected:
     }
 };
 
+/// A cache of at most `capacity` values that forgets the least recently used one to make room. All of it lives in
+/// arrays that are sized on construction: the entries, linked from the most to the least recently used through their
+/// indices, and an open addressing table of entry indices next to the upper bits of their hashes.\n
+/// A lookup hashes the key once (or not at all, with a hash from `hash`) and compares keys only where those bits
+/// match. A hit makes the entry the most recently used one. Nothing is allocated after construction, unless the keys
+/// or the values do.
+template<typename Key, typename Value, typename Hash = std::hash<Key>, typename Equal = std::equal_to<Key>> struct FlatLRUCache {
+    explicit FlatLRUCache(size_t capacity, Hash hash = {}, Equal equal = {})
+        : m_hash(std::move(hash))
+        , m_equal(std::move(equal))
+        , m_capacity(std::clamp<size_t>(capacity, 1, max_capacity))
+        , m_buckets(std::bit_ceil(m_capacity * 2)) {
+        m_shift = 32 - static_cast<uint32_t>(std::countr_zero(m_buckets.size()));
+        m_entries.reserve(m_capacity);
+    }
+
+    size_t capacity() const noexcept { return m_capacity; }
+    size_t size() const noexcept { return m_entries.size(); }
+
+    uint32_t hash(Key const& key) const {
+        // fibonacci hashing, for std::hash of integers is the identity
+        return static_cast<uint32_t>((static_cast<uint64_t>(m_hash(key)) * 0x9e3779b97f4a7c15ull) >> 32);
+    }
+
+    Value* find(Key const& key) { return find(key, hash(key)); }
+
+    /// `hash` has to be `hash(key)`
+    Value* find(Key const& key, uint32_t hash) {
+        const auto bucket = find_bucket(key, hash);
+        if (bucket == npos)
+            return nullptr;
+
+        const auto index = m_buckets[bucket].entry;
+        make_newest(index);
+        return &m_entries[index].value;
+    }
+
+    Value& insert(Key key, Value value) {
+        const auto key_hash = hash(key);
+        return insert(std::move(key), std::move(value), key_hash);
+    }
+
+    /// Replaces the value if `key` is cached already, `hash` has to be `hash(key)`
+    Value& insert(Key key, Value value, uint32_t hash) {
+        if (const auto bucket = find_bucket(key, hash); bucket != npos) {
+            auto& entry = m_entries[m_buckets[bucket].entry];
+            entry.value = std::move(value);
+            make_newest(m_buckets[bucket].entry);
+            return entry.value;
+        }
+
+        uint32_t index;
+        if (m_entries.size() < m_capacity) {
+            index = static_cast<uint32_t>(m_entries.size());
+            m_entries.push_back({ std::move(key), std::move(value), hash, npos, npos });
+        } else {
+            index = m_oldest;
+            erase_bucket(bucket_of(index));
+            unlink(index);
+
+            auto& entry = m_entries[index];
+            entry.key = std::move(key);
+            entry.value = std::move(value);
+            entry.hash = hash;
+        }
+
+        auto bucket = home(hash);
+        while (m_buckets[bucket].entry != npos)
+            bucket = (bucket + 1) & mask();
+        m_buckets[bucket] = { index, hash };
+
+        link_newest(index);
+        return m_entries[index].value;
+    }
+
+    void clear() noexcept {
+        m_entries.clear();
+        std::ranges::fill(m_buckets, Bucket {});
+        m_newest = npos;
+        m_oldest = npos;
+    }
+
+private:
+    static constexpr uint32_t npos = UINT32_MAX;
+    static constexpr size_t max_capacity = 1uz << 30;
+
+    struct Entry {
+        Key key;
+        Value value;
+        uint32_t hash;
+
+        uint32_t newer;
+        uint32_t older;
+    };
+
+    struct Bucket {
+        uint32_t entry = npos;
+        uint32_t hash = 0;
+    };
+
+    [[no_unique_address]] Hash m_hash;
+    [[no_unique_address]] Equal m_equal;
+
+    size_t m_capacity;
+    uint32_t m_shift;
+
+    std::vector<Entry> m_entries {};
+    std::vector<Bucket> m_buckets;
+
+    uint32_t m_newest = npos;
+    uint32_t m_oldest = npos;
+
+    uint32_t mask() const noexcept { return static_cast<uint32_t>(m_buckets.size() - 1); }
+
+    /// The bucket a hash is probed from, its upper bits
+    uint32_t home(uint32_t hash) const noexcept { return hash >> m_shift; }
+
+    uint32_t find_bucket(Key const& key, uint32_t hash) const {
+        for (auto bucket = home(hash);; bucket = (bucket + 1) & mask()) {
+            auto const& [entry, bucket_hash] = m_buckets[bucket];
+            if (entry == npos)
+                return npos;
+            if (bucket_hash == hash && m_equal(m_entries[entry].key, key))
+                return bucket;
+        }
+    }
+
+    uint32_t bucket_of(uint32_t index) const noexcept {
+        auto bucket = home(m_entries[index].hash);
+        while (m_buckets[bucket].entry != index)
+            bucket = (bucket + 1) & mask();
+        return bucket;
+    }
+
+    /// Shifts the buckets that follow back instead of leaving a tombstone, so that probes stay short
+    void erase_bucket(uint32_t bucket) noexcept {
+        for (auto next = (bucket + 1) & mask(); m_buckets[next].entry != npos; next = (next + 1) & mask()) {
+            // one can move back if the hole is no further from it than its home
+            if (((next - home(m_buckets[next].hash)) & mask()) >= ((next - bucket) & mask())) {
+                m_buckets[bucket] = m_buckets[next];
+                bucket = next;
+            }
+        }
+
+        m_buckets[bucket] = {};
+    }
+
+    void unlink(uint32_t index) noexcept {
+        auto& entry = m_entries[index];
+        (entry.newer == npos ? m_newest : m_entries[entry.newer].older) = entry.older;
+        (entry.older == npos ? m_oldest : m_entries[entry.older].newer) = entry.newer;
+    }
+
+    void link_newest(uint32_t index) noexcept {
+        auto& entry = m_entries[index];
+        entry.newer = npos;
+        entry.older = m_newest;
+        (m_newest == npos ? m_oldest : m_entries[m_newest].newer) = index;
+        m_newest = index;
+    }
+
+    void make_newest(uint32_t index) noexcept {
+        if (index == m_newest)
+            return;
+
+        unlink(index);
+        link_newest(index);
+    }
+};
+
+/// MemoizerBase over a FlatLRUCache: the arguments are stored and hashed once, and calls that hit the cache keep the
+/// result from being forgotten
+template<typename Ret, typename... Args> struct FlatMemoizerBase {
+    FlatMemoizerBase(size_t lru_size = 512uz * 1024uz)
+        : m_cache(lru_size) { }
+
+    virtual ~FlatMemoizerBase() = default;
+
+    Ret operator()(Args... args) {
+        ++m_all_calls;
+
+        auto arg_tuple = std::make_tuple(args...);
+        const auto hash = m_cache.hash(arg_tuple);
+        if (auto* ret = m_cache.find(arg_tuple, hash); ret != nullptr) {
+            ++m_memo_calls;
+            return *ret;
+        }
+
+        // impl may call back into the memoizer, the cache is probed again to insert
+        auto ret = impl(std::move(args)...);
+        m_cache.insert(std::move(arg_tuple), ret, hash);
+        return ret;
+    }
+
+    Ret call(Args... args) { return (*this)(std::move(args)...); }
+
+    size_t all_calls() { return m_all_calls; }
+    size_t memo_calls() { return m_memo_calls; }
+
+protected:
+    virtual Ret impl(Args...) = 0;
+
+private:
+    size_t m_all_calls = 0;
+    size_t m_memo_calls = 0;
+
+    FlatLRUCache<std::tuple<Args...>, Ret> m_cache;
+};
+
 }
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <Stuff/Util/Arena.hpp>
+#include <Stuff/Util/Slab.hpp>
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory_resource>
+
+namespace Stf {
+
+/// A memory resource that knows how many bytes it holds on to, for telling how much of them is in use (see
+/// StatsResource)
+struct MeasuredResource : std::pmr::memory_resource {
+    virtual size_t reserved_bytes() const noexcept = 0;
+};
+
+/// std::pmr over an Arena: allocating bumps a pointer, deallocating does nothing. Unlike
+/// std::pmr::monotonic_buffer_resource the memory can be reused before the resource is destroyed, by rewinding to a
+/// marker (or with an ArenaScope over `arena()`) or by resetting. Not thread-safe.
+struct ArenaResource final : MeasuredResource {
+    explicit ArenaResource(size_t chunk_size = Arena::default_chunk_size) noexcept
+        : m_arena(chunk_size) { }
+
+    Arena& arena() noexcept { return m_arena; }
+
+    Arena::Marker mark() const noexcept { return m_arena.mark(); }
+
+    void rewind(Arena::Marker marker) noexcept { m_arena.rewind(marker); }
+
+    void reset() noexcept { m_arena.reset(); }
+
+    size_t reserved_bytes() const noexcept override { return m_arena.reserved(); }
+
+private:
+    Arena m_arena;
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void*, size_t, size_t) override { }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+};
+
+/// std::pmr over the slab pool (see `slab_allocate`), thread-safe. Allocations that are too large or too aligned for
+/// it go to `upstream`. Memory has to be deallocated through the SlabResource it was allocated from, which keeps count
+/// of what it holds from upstream.
+struct SlabResource final : MeasuredResource {
+    explicit SlabResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) noexcept
+        : m_upstream(upstream) { }
+
+    std::pmr::memory_resource* upstream() const noexcept { return m_upstream; }
+
+    /// Number of bytes held by the whole pool, which is shared with every other SlabResource and SlabAllocator, plus
+    /// the bytes this resource holds from upstream
+    size_t reserved_bytes() const noexcept override { return slab_reserved_bytes() + m_upstream_bytes.load(std::memory_order_relaxed); }
+
+private:
+    std::pmr::memory_resource* m_upstream;
+    std::atomic_size_t m_upstream_bytes { 0 };
+
+    static bool fits(size_t bytes, size_t alignment) noexcept { return bytes <= slab_max_size && alignment <= slab_alignment; }
+
+    void* do_allocate(size_t bytes, size_t alignment) override;
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override;
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+};
+
+struct AllocationStats {
+    /// Bucket `i` counts the allocations of [2^(i-1), 2^i) bytes, the last one all that are larger
+    static constexpr size_t histogram_size = 32;
+
+    size_t allocations = 0;
+    size_t deallocations = 0;
+
+    size_t bytes_allocated = 0;
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;
+
+    std::array<size_t, histogram_size> size_histogram {};
+
+    /// Number of bytes the upstream holds on to if it is a MeasuredResource, 0 otherwise
+    size_t reserved_bytes = 0;
+
+    /// The part of the reserved bytes that is not in use, 0 if unknown
+    double fragmentation() const noexcept {
+        return reserved_bytes == 0 || reserved_bytes < bytes_in_use ? 0. : 1. - static_cast<double>(bytes_in_use) / static_cast<double>(reserved_bytes);
+    }
+};
+
+/// Wraps a resource and counts what goes through it. The counters are relaxed atomics, so one StatsResource can be
+/// shared by threads if its upstream can.\n
+/// With `Enabled` false nothing is counted and `resource()` is the upstream itself, so that statistics can be compiled
+/// out without touching the code that uses them.
+template<bool Enabled = true> struct StatsResource;
+
+template<> struct StatsResource<false> {
+    explicit StatsResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : m_upstream(upstream) { }
+
+    std::pmr::memory_resource* resource() const noexcept { return m_upstream; }
+
+    std::pmr::memory_resource* upstream() const noexcept { return m_upstream; }
+
+    AllocationStats stats() const noexcept { return {}; }
+
+    void reset_peak() noexcept { }
+
+private:
+    std::pmr::memory_resource* m_upstream;
+};
+
+template<> struct StatsResource<true> final : std::pmr::memory_resource {
+    explicit StatsResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+        : m_upstream(upstream) { }
+
+    /// Allocating through a const StatsResource only changes its counters
+    std::pmr::memory_resource* resource() const noexcept { return const_cast<StatsResource*>(this); }
+
+    std::pmr::memory_resource* upstream() const noexcept { return m_upstream; }
+
+    AllocationStats stats() const noexcept {
+        AllocationStats ret {
+            .deallocations = m_deallocations.load(std::memory_order_relaxed),
+            .bytes_allocated = m_bytes_allocated.load(std::memory_order_relaxed),
+            .bytes_in_use = m_bytes_in_use.load(std::memory_order_relaxed),
+            .peak_bytes_in_use = m_peak_bytes_in_use.load(std::memory_order_relaxed),
+        };
+
+        // the histogram doubles as the count of allocations, one fewer atomic to bump
+        for (auto i = 0uz; i < ret.size_histogram.size(); i++) {
+            ret.size_histogram[i] = m_size_histogram[i].load(std::memory_order_relaxed);
+            ret.allocations += ret.size_histogram[i];
+        }
+
+        if (const auto* measured = dynamic_cast<const MeasuredResource*>(m_upstream); measured != nullptr)
+            ret.reserved_bytes = measured->reserved_bytes();
+
+        return ret;
+    }
+
+    /// Restarts the peak from what is in use now
+    void reset_peak() noexcept { m_peak_bytes_in_use.store(m_bytes_in_use.load(std::memory_order_relaxed), std::memory_order_relaxed); }
+
+private:
+    std::pmr::memory_resource* m_upstream;
+
+    mutable std::atomic_size_t m_deallocations { 0 };
+    mutable std::atomic_size_t m_bytes_allocated { 0 };
+    mutable std::atomic_size_t m_bytes_in_use { 0 };
+    mutable std::atomic_size_t m_peak_bytes_in_use { 0 };
+    mutable std::array<std::atomic_size_t, AllocationStats::histogram_size> m_size_histogram {};
+
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        auto* const ret = m_upstream->allocate(bytes, alignment);
+
+        m_bytes_allocated.fetch_add(bytes, std::memory_order_relaxed);
+        m_size_histogram[std::min<size_t>(std::bit_width(bytes), AllocationStats::histogram_size - 1)].fetch_add(1, std::memory_order_relaxed);
+
+        const auto in_use = m_bytes_in_use.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        for (auto peak = m_peak_bytes_in_use.load(std::memory_order_relaxed); peak < in_use;) {
+            if (m_peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed))
+                break;
+        }
+
+        return ret;
+    }
+
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        m_upstream->deallocate(ptr, bytes, alignment);
+
+        m_deallocations.fetch_add(1, std::memory_order_relaxed);
+        m_bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override { return this == &other; }
+};
+
+StatsResource() -> StatsResource<true>;
+
+StatsResource(std::pmr::memory_resource*) -> StatsResource<true>;
+
+}
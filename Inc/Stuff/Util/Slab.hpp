@@ -0,0 +1,181 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+namespace Stf {
+
+inline constexpr size_t slab_max_size = 1024;
+inline constexpr size_t slab_alignment = 16;
+
+namespace Detail::Slab {
+
+/// Multiples of 16 up to 256, then four classes per power of two
+inline constexpr std::array<size_t, 24> class_sizes {
+    16, 32, 48, 64, 80, 96, 112, 128, 144, 160, 176, 192, 208, 224, 240, 256, 320, 384, 448, 512, 640, 768, 896, 1024,
+};
+
+inline constexpr size_t class_count = class_sizes.size();
+
+/// Indexed by `(size + 15) / 16`
+inline constexpr auto class_lookup = [] {
+    std::array<uint8_t, slab_max_size / 16 + 1> ret {};
+    for (auto i = 0uz, size_class = 0uz; i < ret.size(); i++) {
+        while (class_sizes[size_class] < i * 16)
+            size_class++;
+        ret[i] = static_cast<uint8_t>(size_class);
+    }
+    return ret;
+}();
+
+constexpr size_t class_of(size_t size) noexcept { return class_lookup[(size + 15) / 16]; }
+
+/// Number of objects in a full magazine, about 16 KiB worth
+constexpr size_t magazine_capacity(size_t size_class) noexcept { return std::max<size_t>(8, 16384 / class_sizes[size_class]); }
+
+struct FreeObject {
+    FreeObject* next;
+
+    /// Chains the full magazines in the depot through their first objects, which spares the depot any allocation
+    FreeObject* next_magazine;
+};
+
+static_assert(sizeof(FreeObject) <= class_sizes[0]);
+
+struct Magazine {
+    FreeObject* head = nullptr;
+    size_t count = 0;
+};
+
+struct ThreadCache {
+    std::array<Magazine, class_count> loaded {};
+
+    /// Either full or empty
+    std::array<Magazine, class_count> spare {};
+
+    ~ThreadCache() noexcept;
+
+    void flush() noexcept;
+};
+
+inline thread_local ThreadCache thread_cache {};
+
+/// Set when the thread destroys its cache. The destructors of thread_local objects that run after it allocate from
+/// and free to the depot directly, the flag lives apart from the cache as it has to be read after the cache is gone.
+inline thread_local bool thread_cache_destroyed = false;
+
+/// Takes an object straight from the depot
+[[nodiscard]] void* allocate_from_depot(size_t size_class);
+
+/// Puts the object straight into the depot
+void deallocate_to_depot(size_t size_class, void* ptr) noexcept;
+
+/// Refills the loaded magazine of the class and takes an object from it
+[[nodiscard]] void* refill(ThreadCache& cache, size_t size_class);
+
+/// Makes room in the loaded magazine of the class and puts the object in it
+void overflow(ThreadCache& cache, size_t size_class, void* ptr) noexcept;
+
+}
+
+/// A process-wide pool for small objects that are allocated and freed in large numbers, e.g. the nodes of node-based
+/// containers.\n
+/// Objects of up to `slab_max_size` bytes are rounded up to one of a few size classes and carved out of 64 KiB slabs,
+/// the free ones are kept in intrusive lists threaded through themselves. Every thread caches two magazines (chains of
+/// free objects) per class so that most allocations and frees touch no shared state; magazines that fill up or run dry
+/// are exchanged with a global depot, which is also how objects freed by another thread than the one that allocated
+/// them find their way back. Slabs are never given back to the system.\n
+/// Objects are aligned to `slab_alignment` bytes, larger objects go to `operator new`.
+[[nodiscard]] inline void* slab_allocate(size_t size) {
+    if (size > slab_max_size) [[unlikely]]
+        return ::operator new(size);
+
+    const auto size_class = Detail::Slab::class_of(size);
+    if (Detail::Slab::thread_cache_destroyed) [[unlikely]]
+        return Detail::Slab::allocate_from_depot(size_class);
+
+    auto& cache = Detail::Slab::thread_cache;
+    auto& magazine = cache.loaded[size_class];
+
+    if (magazine.head == nullptr) [[unlikely]]
+        return Detail::Slab::refill(cache, size_class);
+
+    auto* const ret = magazine.head;
+    magazine.head = ret->next;
+    magazine.count--;
+
+    return ret;
+}
+
+/// `size` has to be the size the object was allocated with, on any thread
+inline void slab_deallocate(void* ptr, size_t size) noexcept {
+    if (ptr == nullptr)
+        return;
+
+    if (size > slab_max_size) [[unlikely]] {
+        ::operator delete(ptr, size);
+        return;
+    }
+
+    const auto size_class = Detail::Slab::class_of(size);
+    if (Detail::Slab::thread_cache_destroyed) [[unlikely]] {
+        Detail::Slab::deallocate_to_depot(size_class, ptr);
+        return;
+    }
+
+    auto& cache = Detail::Slab::thread_cache;
+    auto& magazine = cache.loaded[size_class];
+
+    if (magazine.count == Detail::Slab::magazine_capacity(size_class)) [[unlikely]] {
+        Detail::Slab::overflow(cache, size_class, ptr);
+        return;
+    }
+
+    auto* const object = static_cast<Detail::Slab::FreeObject*>(ptr);
+    object->next = magazine.head;
+    magazine.head = object;
+    magazine.count++;
+}
+
+/// Hands the objects cached by the calling thread over to the depot, as is done when the thread exits
+inline void slab_flush_thread_cache() noexcept {
+    if (!Detail::Slab::thread_cache_destroyed)
+        Detail::Slab::thread_cache.flush();
+}
+
+/// Number of bytes reserved by all slabs, which are never released
+size_t slab_reserved_bytes() noexcept;
+
+/// A standard allocator over the slab pool. Types that are more aligned than `slab_alignment` go to `operator new`.
+template<typename T> struct SlabAllocator {
+    using value_type = T;
+    using size_type = size_t;
+    using difference_type = ptrdiff_t;
+
+    template<typename U> struct rebind { using other = SlabAllocator<U>; };
+
+    constexpr SlabAllocator() noexcept = default;
+
+    template<typename U> constexpr SlabAllocator(SlabAllocator<U> const&) noexcept { }
+
+    [[nodiscard]] T* allocate(size_t n) {
+        if constexpr (alignof(T) > slab_alignment)
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t { alignof(T) }));
+        else
+            return static_cast<T*>(slab_allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if constexpr (alignof(T) > slab_alignment)
+            ::operator delete(p, n * sizeof(T), std::align_val_t { alignof(T) });
+        else
+            slab_deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U> constexpr bool operator==(SlabAllocator<U> const&) const noexcept { return true; }
+};
+
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Stf {
+
+/// A fixed-size pool of worker threads with a shared FIFO task queue.\n
+/// Threads that wait on a parallel_for help drain the queue while waiting so
+/// that nested parallel regions cannot starve the pool.
+struct ThreadPool {
+    using task_type = std::function<void()>;
+
+    explicit ThreadPool(size_t thread_count = std::max(1u, std::thread::hardware_concurrency()));
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool(ThreadPool&&) = delete;
+
+    ~ThreadPool() noexcept;
+
+    /// The process-wide pool, lazily created with one worker per hardware thread
+    static ThreadPool& global();
+
+    size_t size() const noexcept { return m_workers.size(); }
+
+    void submit(task_type task);
+
+    /// Runs at most one queued task on the calling thread.
+    /// @return whether a task was run
+    bool run_pending();
+
+    /// Splits [begin, end) into chunks of at least `grain` elements and calls `fn(chunk_begin, chunk_end)` on each
+    /// chunk. The calling thread takes part in the work. Returns when all chunks are processed.\n
+    /// If `fn` throws, the chunks that have not started yet are skipped and the first exception is rethrown on the
+    /// calling thread once every helper is done.
+    template<typename Fn> void parallel_for(size_t begin, size_t end, size_t grain, Fn&& fn) {
+        if (begin >= end)
+            return;
+
+        grain = std::max<size_t>(grain, 1);
+        const size_t chunk_count = (end - begin + grain - 1) / grain;
+
+        if (chunk_count == 1 || size() == 0) {
+            std::invoke(fn, begin, end);
+            return;
+        }
+
+        struct SharedState {
+            std::atomic_size_t next_chunk { 0 };
+            std::atomic_size_t finished_helpers { 0 };
+
+            std::mutex error_mutex {};
+            std::exception_ptr error {};
+
+            void fail(std::exception_ptr exception, size_t chunk_count) {
+                {
+                    std::unique_lock lock { error_mutex };
+                    if (!error)
+                        error = std::move(exception);
+                }
+
+                // the chunks nobody has taken yet are skipped
+                next_chunk.store(chunk_count, std::memory_order_relaxed);
+            }
+        } state {};
+
+        // the helpers refer to this frame, so it is only left once they are all done, even if `fn` throws
+        const auto work = [&] {
+            try {
+                for (;;) {
+                    const auto chunk = state.next_chunk.fetch_add(1, std::memory_order_relaxed);
+                    if (chunk >= chunk_count)
+                        break;
+
+                    const auto chunk_begin = begin + chunk * grain;
+                    const auto chunk_end = std::min(end, chunk_begin + grain);
+                    std::invoke(fn, chunk_begin, chunk_end);
+                }
+            } catch (...) { state.fail(std::current_exception(), chunk_count); }
+        };
+
+        size_t helper_count = 0;
+        try {
+            for (; helper_count < std::min(size(), chunk_count - 1); helper_count++) {
+                submit([&] {
+                    work();
+                    state.finished_helpers.fetch_add(1, std::memory_order_release);
+                });
+            }
+        } catch (...) { state.fail(std::current_exception(), chunk_count); }
+
+        work();
+
+        while (state.finished_helpers.load(std::memory_order_acquire) != helper_count) {
+            if (!run_pending())
+                std::this_thread::yield();
+        }
+
+        if (state.error)
+            std::rethrow_exception(state.error);
+    }
+
+private:
+    std::vector<std::thread> m_workers {};
+
+    std::mutex m_mutex {};
+    std::condition_variable m_cv {};
+    std::deque<task_type> m_tasks {};
+    bool m_stopping = false;
+
+    void worker_loop();
+};
+
+}
@@ -0,0 +1,110 @@
+#include <Stuff/Graphics/BufferPool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <new>
+
+namespace Stf::Gfx {
+
+BufferPool::BufferPool(size_t max_cached_bytes)
+    : m_max_cached_bytes(max_cached_bytes) { }
+
+BufferPool::~BufferPool() noexcept { trim(); }
+
+BufferPool& BufferPool::global() {
+    static BufferPool pool {};
+    return pool;
+}
+
+size_t BufferPool::size_class(size_t bytes) {
+    if (bytes <= 4 * alignment)
+        return std::max<size_t>(alignment, (bytes + alignment - 1) / alignment * alignment);
+
+    const auto step = std::bit_floor(bytes - 1) / 4;
+    return (bytes + step - 1) / step * step;
+}
+
+void* BufferPool::allocate(size_t bytes) {
+    const auto size = size_class(bytes);
+
+    {
+        std::unique_lock lock { m_mutex };
+
+        if (auto it = m_free.find(size); it != m_free.end() && !it->second.empty()) {
+            auto* const ret = it->second.back();
+            it->second.pop_back();
+
+            m_stats.hits++;
+            m_stats.cached_buffers--;
+            m_stats.cached_bytes -= size;
+
+            return ret;
+        }
+
+        m_stats.misses++;
+    }
+
+    return ::operator new(size, std::align_val_t { alignment });
+}
+
+void BufferPool::deallocate(void* p, size_t bytes) noexcept {
+    if (p == nullptr)
+        return;
+
+    const auto size = size_class(bytes);
+
+    {
+        std::unique_lock lock { m_mutex };
+
+        if (m_stats.cached_bytes + size <= m_max_cached_bytes) {
+            // a failure to grow the bucket frees the buffer instead
+            try {
+                m_free[size].push_back(p);
+
+                m_stats.recycled++;
+                m_stats.cached_buffers++;
+                m_stats.cached_bytes += size;
+
+                return;
+            } catch (...) { }
+        }
+
+        m_stats.evicted++;
+    }
+
+    free_buffer(p, size);
+}
+
+BufferPool::Stats BufferPool::stats() const {
+    std::unique_lock lock { m_mutex };
+    return m_stats;
+}
+
+void BufferPool::reset_stats() {
+    std::unique_lock lock { m_mutex };
+
+    m_stats.hits = 0;
+    m_stats.misses = 0;
+    m_stats.recycled = 0;
+    m_stats.evicted = 0;
+}
+
+void BufferPool::trim() {
+    decltype(m_free) buffers {};
+
+    {
+        std::unique_lock lock { m_mutex };
+        std::swap(buffers, m_free);
+
+        m_stats.cached_buffers = 0;
+        m_stats.cached_bytes = 0;
+    }
+
+    for (auto& [size, bucket] : buffers)
+        for (auto* const p : bucket)
+            free_buffer(p, size);
+}
+
+void BufferPool::free_buffer(void* p, size_t size_class) noexcept { ::operator delete(p, size_class, std::align_val_t { alignment }); }
+
+}
@@ -0,0 +1,128 @@
+#include <Stuff/Util/Arena.hpp>
+
+#include <utility>
+
+namespace Stf {
+
+namespace Detail {
+
+ArenaChunk* ArenaChunk::create(size_t size, ArenaChunk* next) {
+    size_t bytes;
+    if (__builtin_add_overflow(sizeof(ArenaChunk), size, &bytes))
+        throw std::bad_alloc();
+
+    auto* const storage = ::operator new(bytes, std::align_val_t { alignof(ArenaChunk) });
+    return new (storage) ArenaChunk { next, size };
+}
+
+void ArenaChunk::destroy_list(ArenaChunk* chunk) noexcept {
+    while (chunk != nullptr) {
+        auto* const next = chunk->next;
+        chunk->~ArenaChunk();
+        ::operator delete(static_cast<void*>(chunk), std::align_val_t { alignof(ArenaChunk) });
+        chunk = next;
+    }
+}
+
+}
+
+Arena::Arena(Arena&& other) noexcept
+    : m_first(std::exchange(other.m_first, nullptr))
+    , m_current(std::exchange(other.m_current, nullptr))
+    , m_ptr(std::exchange(other.m_ptr, nullptr))
+    , m_end(std::exchange(other.m_end, nullptr))
+    , m_next_chunk_size(other.m_next_chunk_size)
+    , m_reserved(std::exchange(other.m_reserved, 0)) { }
+
+Arena& Arena::operator=(Arena&& other) noexcept {
+    if (this != &other) {
+        release();
+
+        m_first = std::exchange(other.m_first, nullptr);
+        m_current = std::exchange(other.m_current, nullptr);
+        m_ptr = std::exchange(other.m_ptr, nullptr);
+        m_end = std::exchange(other.m_end, nullptr);
+        m_next_chunk_size = other.m_next_chunk_size;
+        m_reserved = std::exchange(other.m_reserved, 0);
+    }
+
+    return *this;
+}
+
+Arena& Arena::local() {
+    thread_local Arena arena {};
+    return arena;
+}
+
+void* Arena::allocate_slow(size_t size, size_t alignment) {
+    // chunks start on a cache line, only larger alignments need padding
+    size_t needed;
+    if (__builtin_add_overflow(size, alignment > alignof(Detail::ArenaChunk) ? alignment : 0, &needed))
+        throw std::bad_alloc();
+
+    // the chunks after the current one are left over from before a reset or a rewind
+    auto* next = m_current == nullptr ? m_first : m_current->next;
+    if (next == nullptr || next->size < needed) {
+        const auto chunk_size = std::max(m_next_chunk_size, needed);
+        next = Detail::ArenaChunk::create(chunk_size, next);
+        (m_current == nullptr ? m_first : m_current->next) = next;
+
+        m_reserved += chunk_size;
+        m_next_chunk_size = std::min(m_next_chunk_size * 2, std::max(max_chunk_size, m_next_chunk_size));
+    }
+
+    m_current = next;
+    m_ptr = next->begin();
+    m_end = next->end();
+
+    return allocate(size, alignment);
+}
+
+void Arena::release() noexcept {
+    Detail::ArenaChunk::destroy_list(m_first);
+
+    m_first = nullptr;
+    m_current = nullptr;
+    m_ptr = nullptr;
+    m_end = nullptr;
+    m_reserved = 0;
+}
+
+void SharedArena::grow(Detail::ArenaChunk* full, size_t size) {
+    std::unique_lock lock { m_mutex };
+    if (m_current.load(std::memory_order_relaxed) != full)
+        return;
+
+    auto* next = full == nullptr ? m_first : full->next;
+    if (next == nullptr || next->size < size) {
+        const auto chunk_size = std::max(m_chunk_size, size);
+        next = Detail::ArenaChunk::create(chunk_size, next);
+        (full == nullptr ? m_first : full->next) = next;
+
+        m_reserved += chunk_size;
+    }
+
+    next->used.store(0, std::memory_order_relaxed);
+    m_current.store(next, std::memory_order_release);
+}
+
+void SharedArena::reset() noexcept {
+    std::unique_lock lock { m_mutex };
+
+    for (auto* chunk = m_first; chunk != nullptr; chunk = chunk->next)
+        chunk->used.store(0, std::memory_order_relaxed);
+
+    m_current.store(m_first, std::memory_order_release);
+}
+
+void SharedArena::release() noexcept {
+    std::unique_lock lock { m_mutex };
+
+    m_current.store(nullptr, std::memory_order_release);
+    Detail::ArenaChunk::destroy_list(m_first);
+
+    m_first = nullptr;
+    m_reserved = 0;
+}
+
+}
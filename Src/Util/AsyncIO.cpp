@@ -0,0 +1,464 @@
+// the engines need POSIX pread, pwrite and mmap, io_uring is detected below
+#if __has_include(<unistd.h>) && __has_include(<sys/mman.h>) && __has_include(<sys/uio.h>)
+
+#include <Stuff/Util/AsyncIO.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <condition_variable>
+#include <cstring>
+#include <limits>
+#include <mutex>
+
+extern "C" {
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+}
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+extern "C" {
+#    include <linux/io_uring.h>
+#    include <sys/syscall.h>
+}
+
+#    if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(__NR_io_uring_register)
+#        define LIBSTF_HAS_IO_URING
+#    endif
+#endif
+
+namespace Stf {
+
+namespace Detail {
+
+struct AsyncIOEngine {
+    virtual ~AsyncIOEngine() = default;
+
+    virtual AsyncIOBackend backend() const noexcept = 0;
+
+    /// Number of operations that can be in flight at once
+    virtual size_t capacity() const noexcept = 0;
+
+    virtual tl::expected<void, std::string_view> register_buffers(std::span<const std::span<char>> buffers) = 0;
+
+    /// Prepares the operation, it is only guaranteed to have started after the next `flush`
+    virtual void start(size_t slot, AsyncIOOperation const& operation) = 0;
+
+    /// Starts the prepared operations, the ones that can not be started complete with an error
+    virtual void flush() = 0;
+
+    /// Appends completions to `out` after waiting for at least `min_completions` of them
+    virtual void reap(size_t min_completions, std::vector<AsyncIOCompletion>& out) = 0;
+};
+
+#ifdef LIBSTF_HAS_IO_URING
+
+/// Talks to the kernel through the raw syscalls, which spares a dependency on liburing
+struct IOUringEngine final : AsyncIOEngine {
+    /// The most entries a ring can be created with
+    static constexpr size_t max_entries = 32768;
+
+    static std::unique_ptr<IOUringEngine> create(unsigned entries) {
+        io_uring_params params {};
+        const auto fildes = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (fildes < 0)
+            return nullptr;
+
+        // IORING_OP_READ and IORING_OP_WRITE came with 5.6, this feature flag with 5.7
+        if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+            close(fildes);
+            return nullptr;
+        }
+
+        auto ret = std::unique_ptr<IOUringEngine>(new IOUringEngine(fildes));
+        if (!ret->map(params))
+            return nullptr;
+
+        return ret;
+    }
+
+    ~IOUringEngine() noexcept override {
+        if (m_sqes != nullptr)
+            munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring != nullptr && m_cq_ring != m_sq_ring)
+            munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring != nullptr)
+            munmap(m_sq_ring, m_sq_ring_size);
+
+        close(m_fildes);
+    }
+
+    AsyncIOBackend backend() const noexcept override { return AsyncIOBackend::IOUring; }
+
+    /// The completion queue is twice as large as the submission queue, so it never overflows
+    size_t capacity() const noexcept override { return m_sq_entries; }
+
+    tl::expected<void, std::string_view> register_buffers(std::span<const std::span<char>> buffers) override {
+        if (m_registered)
+            syscall(__NR_io_uring_register, m_fildes, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        m_registered = false;
+
+        if (buffers.empty())
+            return {};
+
+        std::vector<iovec> iovecs(buffers.size());
+        std::ranges::transform(buffers, iovecs.begin(), [](std::span<char> buffer) { return iovec { buffer.data(), buffer.size() }; });
+
+        // the pages are pinned, which counts against RLIMIT_MEMLOCK
+        if (syscall(__NR_io_uring_register, m_fildes, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned>(iovecs.size())) < 0)
+            return tl::unexpected { "Could not register the buffers" };
+
+        m_registered = true;
+        return {};
+    }
+
+    void start(size_t slot, AsyncIOOperation const& operation) override {
+        const auto index = m_local_tail & *m_sq_mask;
+        auto& sqe = m_sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        switch (operation.kind) {
+        case AsyncIOOperation::Kind::Read: sqe.opcode = IORING_OP_READ; break;
+        case AsyncIOOperation::Kind::Write: sqe.opcode = IORING_OP_WRITE; break;
+        case AsyncIOOperation::Kind::ReadFixed:
+            sqe.opcode = IORING_OP_READ_FIXED;
+            sqe.buf_index = static_cast<uint16_t>(operation.buffer_index);
+            break;
+        }
+
+        // longer transfers are cut short, as a pread may cut them
+        sqe.fd = operation.fildes;
+        sqe.addr = reinterpret_cast<uint64_t>(operation.data);
+        sqe.len = static_cast<uint32_t>(std::min<size_t>(operation.length, UINT_MAX));
+        sqe.off = operation.offset;
+        sqe.user_data = slot;
+
+        m_sq_array[index] = index;
+        m_local_tail++;
+    }
+
+    void flush() override {
+        if (m_local_tail == m_submitted_tail)
+            return;
+
+        std::atomic_ref(*m_sq_tail).store(m_local_tail, std::memory_order_release);
+
+        // fewer operations are in flight than the completion queue has room for, so the kernel takes all of the entries
+        // and reports failures of single operations as their completions. It only fails as a whole on a broken ring.
+        while (m_submitted_tail != m_local_tail) {
+            const auto submitted = enter(m_local_tail - m_submitted_tail, 0, 0);
+            if (submitted < 0) {
+                // the kernel only reads the queue in io_uring_enter, the entries it did not take are taken back and
+                // completed with the error
+                const auto error = -errno;
+                for (auto tail = m_submitted_tail; tail != m_local_tail; tail++)
+                    m_failed.push_back({ static_cast<size_t>(m_sqes[m_sq_array[tail & *m_sq_mask]].user_data), error });
+
+                m_local_tail = m_submitted_tail;
+                std::atomic_ref(*m_sq_tail).store(m_local_tail, std::memory_order_release);
+                return;
+            }
+
+            m_submitted_tail += static_cast<unsigned>(submitted);
+        }
+    }
+
+    void reap(size_t min_completions, std::vector<AsyncIOCompletion>& out) override {
+        out.insert(out.end(), m_failed.begin(), m_failed.end());
+        const auto failed = std::exchange(m_failed, {}).size();
+
+        for (auto reaped = failed;;) {
+            auto head = *m_cq_head;
+            const auto tail = std::atomic_ref(*m_cq_tail).load(std::memory_order_acquire);
+
+            for (; head != tail; head++, reaped++) {
+                const auto& cqe = m_cqes[head & *m_cq_mask];
+                out.push_back({ static_cast<size_t>(cqe.user_data), cqe.res });
+            }
+
+            std::atomic_ref(*m_cq_head).store(head, std::memory_order_release);
+
+            if (reaped >= min_completions)
+                return;
+
+            enter(0, static_cast<unsigned>(min_completions - reaped), IORING_ENTER_GETEVENTS);
+        }
+    }
+
+private:
+    explicit IOUringEngine(int fildes) noexcept
+        : m_fildes(fildes) { }
+
+    int m_fildes;
+    bool m_registered = false;
+    size_t m_sq_entries = 0;
+
+    /// Operations that could not be submitted, reported by the next `reap`
+    std::vector<AsyncIOCompletion> m_failed {};
+
+    void* m_sq_ring = nullptr;
+    size_t m_sq_ring_size = 0;
+    void* m_cq_ring = nullptr;
+    size_t m_cq_ring_size = 0;
+    io_uring_sqe* m_sqes = nullptr;
+    size_t m_sqes_size = 0;
+
+    unsigned* m_sq_tail;
+    unsigned* m_sq_mask;
+    unsigned* m_sq_array;
+    unsigned* m_cq_head;
+    unsigned* m_cq_tail;
+    unsigned* m_cq_mask;
+    io_uring_cqe* m_cqes;
+
+    /// Tail of the submission queue as written by `start`
+    unsigned m_local_tail = 0;
+    /// Tail of the entries the kernel took
+    unsigned m_submitted_tail = 0;
+
+    bool map(io_uring_params const& params) {
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const auto single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap)
+            m_sq_ring_size = m_cq_ring_size = std::max(m_sq_ring_size, m_cq_ring_size);
+
+        const auto map_ring = [this](size_t size, off_t offset) -> void* {
+            auto* const ret = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fildes, offset);
+            return ret == MAP_FAILED ? nullptr : ret;
+        };
+
+        if (m_sq_ring = map_ring(m_sq_ring_size, IORING_OFF_SQ_RING); m_sq_ring == nullptr)
+            return false;
+
+        if (m_cq_ring = single_mmap ? m_sq_ring : map_ring(m_cq_ring_size, IORING_OFF_CQ_RING); m_cq_ring == nullptr)
+            return false;
+
+        m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        if (m_sqes = static_cast<io_uring_sqe*>(map_ring(m_sqes_size, IORING_OFF_SQES)); m_sqes == nullptr)
+            return false;
+
+        auto* const sq = static_cast<char*>(m_sq_ring);
+        m_sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        m_sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        m_sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        auto* const cq = static_cast<char*>(m_cq_ring);
+        m_cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        m_cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        m_cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        m_local_tail = m_submitted_tail = *m_sq_tail;
+        m_sq_entries = params.sq_entries;
+
+        return true;
+    }
+
+    /// Retries on interruptions
+    long enter(unsigned to_submit, unsigned min_complete, unsigned flags) {
+        for (;;) {
+            const auto ret = syscall(__NR_io_uring_enter, m_fildes, to_submit, min_complete, flags, nullptr, 0);
+            if (ret >= 0 || (errno != EINTR && errno != EAGAIN && errno != EBUSY))
+                return ret;
+        }
+    }
+};
+
+#endif
+
+/// Blocking preads and pwrites on the workers of a pool, or on the calling thread of `start` if the pool has none
+struct ThreadPoolEngine final : AsyncIOEngine {
+    explicit ThreadPoolEngine(ThreadPool& pool) noexcept
+        : m_pool(pool) { }
+
+    AsyncIOBackend backend() const noexcept override { return AsyncIOBackend::ThreadPool; }
+
+    size_t capacity() const noexcept override { return std::numeric_limits<size_t>::max(); }
+
+    tl::expected<void, std::string_view> register_buffers(std::span<const std::span<char>> buffers) override {
+        m_buffers.assign(buffers.begin(), buffers.end());
+        return {};
+    }
+
+    void start(size_t slot, AsyncIOOperation const& operation) override {
+        auto task = [this, slot, kind = operation.kind, fildes = operation.fildes, data = operation.data, length = operation.length, offset = operation.offset,
+                     buffer = fixed_buffer(operation)] {
+            int64_t result;
+            if (kind == AsyncIOOperation::Kind::ReadFixed && (buffer.data() == nullptr || length > buffer.size()))
+                result = -EFAULT;
+            else
+                result = transfer(kind == AsyncIOOperation::Kind::Write, fildes, data, length, offset);
+
+            // notified under the lock, the engine may be gone as soon as its last completion is reaped
+            std::unique_lock lock { m_mutex };
+            m_completions.push_back({ slot, result });
+            m_cv.notify_one();
+        };
+
+        if (m_pool.size() == 0)
+            task();
+        else
+            m_pool.submit(std::move(task));
+    }
+
+    void flush() override { }
+
+    void reap(size_t min_completions, std::vector<AsyncIOCompletion>& out) override {
+        std::unique_lock lock { m_mutex };
+        m_cv.wait(lock, [&] { return m_completions.size() >= min_completions; });
+
+        out.insert(out.end(), m_completions.begin(), m_completions.end());
+        m_completions.clear();
+    }
+
+private:
+    ThreadPool& m_pool;
+    std::vector<std::span<char>> m_buffers {};
+
+    std::mutex m_mutex {};
+    std::condition_variable m_cv {};
+    std::vector<AsyncIOCompletion> m_completions {};
+
+    std::span<char> fixed_buffer(AsyncIOOperation const& operation) const noexcept {
+        if (operation.kind != AsyncIOOperation::Kind::ReadFixed || operation.buffer_index >= m_buffers.size())
+            return {};
+
+        return m_buffers[operation.buffer_index];
+    }
+
+    static int64_t transfer(bool write, int fildes, char* data, size_t length, size_t offset) noexcept {
+        for (;;) {
+            const auto ret = write ? pwrite(fildes, data, length, static_cast<off_t>(offset)) : pread(fildes, data, length, static_cast<off_t>(offset));
+            if (ret >= 0)
+                return ret;
+            if (errno != EINTR)
+                return -errno;
+        }
+    }
+};
+
+void AsyncIOAwaitable::await_suspend(std::coroutine_handle<> handle) {
+    operation.callback = [this, handle](int64_t res) {
+        result = res;
+        handle.resume();
+    };
+
+    io.enqueue(std::move(operation));
+}
+
+}
+
+AsyncIO::AsyncIO(size_t queue_depth, bool prefer_io_uring, ThreadPool& pool) {
+    queue_depth = std::max<size_t>(queue_depth, 1);
+
+#ifdef LIBSTF_HAS_IO_URING
+    if (prefer_io_uring)
+        m_engine = Detail::IOUringEngine::create(static_cast<unsigned>(std::min(queue_depth, Detail::IOUringEngine::max_entries)));
+#else
+    std::ignore = prefer_io_uring;
+#endif
+
+    if (!m_engine)
+        m_engine = std::make_unique<Detail::ThreadPoolEngine>(pool);
+
+    m_slots.resize(std::min(queue_depth, m_engine->capacity()));
+    m_free_slots.reserve(m_slots.size());
+    for (auto i = m_slots.size(); i != 0; i--)
+        m_free_slots.push_back(i - 1);
+}
+
+AsyncIO::~AsyncIO() noexcept { drain(); }
+
+AsyncIOBackend AsyncIO::backend() const noexcept { return m_engine->backend(); }
+
+void AsyncIO::enqueue(Detail::AsyncIOOperation&& operation) { m_queued.emplace_back(std::move(operation)); }
+
+void AsyncIO::read(int fildes, std::span<char> buffer, size_t offset, AsyncIOCallback callback) {
+    enqueue({ Detail::AsyncIOOperation::Kind::Read, fildes, buffer.data(), buffer.size(), offset, 0, std::move(callback) });
+}
+
+void AsyncIO::write(int fildes, std::span<const char> buffer, size_t offset, AsyncIOCallback callback) {
+    enqueue({ Detail::AsyncIOOperation::Kind::Write, fildes, const_cast<char*>(buffer.data()), buffer.size(), offset, 0, std::move(callback) });
+}
+
+tl::expected<void, std::string_view> AsyncIO::register_buffers(std::span<const std::span<char>> buffers) {
+    if (pending() != 0)
+        return tl::unexpected { "Buffers can not be registered while operations are pending" };
+
+    m_buffers.clear();
+    TRYX(m_engine->register_buffers(buffers));
+    m_buffers.assign(buffers.begin(), buffers.end());
+
+    return {};
+}
+
+void AsyncIO::read_fixed(int fildes, size_t buffer_index, size_t length, size_t offset, AsyncIOCallback callback) {
+    // an unknown buffer fails the operation with -EFAULT
+    auto* const data = buffer_index < m_buffers.size() ? m_buffers[buffer_index].data() : nullptr;
+    enqueue({ Detail::AsyncIOOperation::Kind::ReadFixed, fildes, data, length, offset, buffer_index, std::move(callback) });
+}
+
+void AsyncIO::submit() {
+    while (!m_queued.empty() && !m_free_slots.empty()) {
+        auto operation = std::move(m_queued.front());
+        m_queued.pop_front();
+
+        const auto slot = m_free_slots.back();
+        m_free_slots.pop_back();
+
+        m_slots[slot] = std::move(operation.callback);
+        m_in_flight++;
+        m_engine->start(slot, operation);
+    }
+
+    m_engine->flush();
+}
+
+size_t AsyncIO::poll(size_t min_completions) {
+    submit();
+
+    // callbacks may poll in turn, they get a buffer of their own
+    auto completions = std::exchange(m_completions, {});
+    m_engine->reap(std::min(min_completions, m_in_flight), completions);
+
+    for (const auto [slot, result] : completions) {
+        auto callback = std::exchange(m_slots[slot], nullptr);
+        m_free_slots.push_back(slot);
+        m_in_flight--;
+
+        if (callback)
+            callback(result);
+    }
+
+    const auto ret = completions.size();
+    completions.clear();
+    m_completions = std::move(completions);
+
+    return ret;
+}
+
+void AsyncIO::drain() {
+    while (pending() != 0)
+        poll(1);
+}
+
+Detail::AsyncIOAwaitable AsyncIO::async_read(int fildes, std::span<char> buffer, size_t offset) {
+    return { *this, { Detail::AsyncIOOperation::Kind::Read, fildes, buffer.data(), buffer.size(), offset, 0, nullptr } };
+}
+
+Detail::AsyncIOAwaitable AsyncIO::async_write(int fildes, std::span<const char> buffer, size_t offset) {
+    return { *this, { Detail::AsyncIOOperation::Kind::Write, fildes, const_cast<char*>(buffer.data()), buffer.size(), offset, 0, nullptr } };
+}
+
+Detail::AsyncIOAwaitable AsyncIO::async_read_fixed(int fildes, size_t buffer_index, size_t length, size_t offset) {
+    auto* const data = buffer_index < m_buffers.size() ? m_buffers[buffer_index].data() : nullptr;
+    return { *this, { Detail::AsyncIOOperation::Kind::ReadFixed, fildes, data, length, offset, buffer_index, nullptr } };
+}
+
+}
+
+#endif
@@ -5,6 +5,12 @@
 
 #include <Stuff/Util/Scope.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <utility>
+
 extern "C" {
 #include <fcntl.h>
 #include <sys/mman.h>
@@ -14,15 +20,108 @@ extern "C" {
 
 namespace Stf {
 
+namespace Detail {
+
+MMapRegion::MMapRegion(MMapRegion&& other) noexcept
+    : m_base(std::exchange(other.m_base, nullptr))
+    , m_length(std::exchange(other.m_length, 0))
+    , m_skip(std::exchange(other.m_skip, 0)) { }
+
+MMapRegion& MMapRegion::operator=(MMapRegion&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_base = std::exchange(other.m_base, nullptr);
+        m_length = std::exchange(other.m_length, 0);
+        m_skip = std::exchange(other.m_skip, 0);
+    }
+
+    return *this;
+}
+
+MMapRegion MMapRegion::map(int fildes, size_t offset, size_t length, bool writable, MMapOptions const& options) noexcept {
+    MMapRegion ret {};
+    if (length == 0)
+        return ret;
+
+    // mappings start on a page boundary
+    static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto skip = offset % page_size;
+
+    const auto prot = PROT_READ | (writable ? PROT_WRITE : 0);
+    const auto flags = (options.shared ? MAP_SHARED : MAP_PRIVATE) | (options.populate ? MAP_POPULATE : 0);
+
+    auto* const base = mmap(nullptr, length + skip, prot, flags, fildes, static_cast<off_t>(offset - skip));
+    if (base == MAP_FAILED)
+        return ret;
+
+    ret.m_base = base;
+    ret.m_length = length + skip;
+    ret.m_skip = skip;
+
+    // the hints are only hints, a kernel that does not know one still maps the file
+    switch (options.access) {
+    case MMapAccess::Normal: break;
+    case MMapAccess::Sequential: madvise(base, ret.m_length, MADV_SEQUENTIAL); break;
+    case MMapAccess::Random: madvise(base, ret.m_length, MADV_RANDOM); break;
+    }
+
+    if (options.will_need)
+        madvise(base, ret.m_length, MADV_WILLNEED);
+
+#ifdef MADV_HUGEPAGE
+    if (options.huge_pages)
+        madvise(base, ret.m_length, MADV_HUGEPAGE);
+#endif
+
+    return ret;
+}
+
+void MMapRegion::unmap() noexcept {
+    if (m_base == nullptr)
+        return;
+
+    munmap(m_base, m_length);
+    m_base = nullptr;
+    m_length = 0;
+    m_skip = 0;
+}
+
+}
+
+MMapStringView::MMapStringView(MMapStringView&& other) noexcept
+    : m_filename(std::move(other.m_filename))
+    , m_readonly(other.m_readonly)
+    , m_options(other.m_options)
+    , m_filesize(std::exchange(other.m_filesize, 0))
+    , m_region(std::move(other.m_region))
+    , m_fildes(std::exchange(other.m_fildes, -1)) { }
+
+MMapStringView& MMapStringView::operator=(MMapStringView&& other) noexcept {
+    if (this != &other) {
+        deinitialize();
+
+        m_filename = std::move(other.m_filename);
+        m_readonly = other.m_readonly;
+        m_options = other.m_options;
+        m_filesize = std::exchange(other.m_filesize, 0);
+        m_region = std::move(other.m_region);
+        m_fildes = std::exchange(other.m_fildes, -1);
+    }
+
+    return *this;
+}
+
 void MMapStringView::initialize() noexcept {
     m_fildes = open(m_filename.c_str(), m_readonly ? O_RDONLY : O_RDWR);
     if (m_fildes < 0) {
+        m_fildes = -1;
         return;
     }
 
-    Stf::ScopeGuard open_guard(Stf::GuardType::ScopeExit, [this] {
+    Stf::ScopeExit open_guard([this] {
         close(m_fildes);
         m_fildes = -1;
+        m_filesize = 0;
     });
 
     struct stat stats{};
@@ -30,12 +129,12 @@ void MMapStringView::initialize() noexcept {
         return;
     }
 
-    m_filesize = stats.st_size;
-    m_data = mmap(nullptr, m_filesize, PROT_READ | (m_readonly ? 0 : PROT_WRITE), MAP_PRIVATE, m_fildes, 0);
-    if (m_data == MAP_FAILED) {
+    m_region = Detail::MMapRegion::map(m_fildes, 0, static_cast<size_t>(stats.st_size), !m_readonly, m_options);
+    if (m_region.data() == nullptr) {
         return;
     }
 
+    m_filesize = m_region.size();
     open_guard.release();
 }
 
@@ -43,8 +142,325 @@ void MMapStringView::deinitialize() noexcept {
     if (m_fildes == -1)
         return;
 
-    munmap(m_data, m_filesize);
+    m_region.unmap();
+    close(m_fildes);
+    m_fildes = -1;
+    m_filesize = 0;
+}
+
+MMapWindowedFile::MMapWindowedFile(std::string const& filename, size_t window_size, size_t overlap, MMapOptions const& options)
+    : m_overlap(overlap)
+    , m_options(options) {
+    const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    m_window_size = std::max<size_t>(1, (window_size + page_size - 1) / page_size) * page_size;
+
+    // windows are only ever read
+    m_options.shared = false;
+
+    m_fildes = open(filename.c_str(), O_RDONLY);
+    if (m_fildes < 0) {
+        m_fildes = -1;
+        return;
+    }
+
+    struct stat stats{};
+    if (fstat(m_fildes, &stats) < 0) {
+        close(m_fildes);
+        m_fildes = -1;
+        return;
+    }
+
+    m_filesize = static_cast<size_t>(stats.st_size);
+}
+
+MMapWindowedFile::MMapWindowedFile(MMapWindowedFile&& other) noexcept
+    : m_fildes(std::exchange(other.m_fildes, -1))
+    , m_filesize(std::exchange(other.m_filesize, 0))
+    , m_window_size(other.m_window_size)
+    , m_overlap(other.m_overlap)
+    , m_options(other.m_options)
+    , m_current(std::move(other.m_current))
+    , m_current_index(std::exchange(other.m_current_index, npos))
+    , m_next(std::move(other.m_next))
+    , m_next_index(std::exchange(other.m_next_index, npos)) { }
+
+MMapWindowedFile& MMapWindowedFile::operator=(MMapWindowedFile&& other) noexcept {
+    if (this != &other) {
+        deinitialize();
+
+        m_fildes = std::exchange(other.m_fildes, -1);
+        m_filesize = std::exchange(other.m_filesize, 0);
+        m_window_size = other.m_window_size;
+        m_overlap = other.m_overlap;
+        m_options = other.m_options;
+        m_current = std::move(other.m_current);
+        m_current_index = std::exchange(other.m_current_index, npos);
+        m_next = std::move(other.m_next);
+        m_next_index = std::exchange(other.m_next_index, npos);
+    }
+
+    return *this;
+}
+
+std::function<Detail::MMapRegion()> MMapWindowedFile::window_mapper(size_t index, bool populate) const {
+    const auto offset = index * m_window_size;
+    const auto length = std::min(m_filesize - offset, m_window_size + m_overlap);
+
+    auto options = m_options;
+    options.populate |= populate;
+
+    // by value, prefetches keep going while the file is moved
+    return [fildes = m_fildes, offset, length, options] { return Detail::MMapRegion::map(fildes, offset, length, false, options); };
+}
+
+std::span<const char> MMapWindowedFile::window(size_t index) {
+    if (!is_open() || index >= window_count())
+        return {};
+
+    if (index != m_current_index) {
+        // unmapped before the next one is mapped, only two windows are ever mapped at a time
+        m_current.unmap();
+        m_current_index = npos;
+
+        if (m_next.valid()) {
+            auto next = m_next.get();
+            if (m_next_index == index)
+                m_current = std::move(next);
+            m_next_index = npos;
+        }
+
+        if (m_current.data() == nullptr)
+            m_current = window_mapper(index, false)();
+
+        if (m_current.data() == nullptr)
+            return {};
+
+        m_current_index = index;
+
+        if (index + 1 < window_count()) {
+            m_next_index = index + 1;
+            m_next = std::async(std::launch::async, window_mapper(index + 1, true));
+        }
+    }
+
+    return { m_current.data(), m_current.size() };
+}
+
+void MMapWindowedFile::deinitialize() noexcept {
+    if (m_next.valid())
+        m_next.wait();
+
+    m_next = {};
+    m_next_index = npos;
+    m_current.unmap();
+    m_current_index = npos;
+
+    if (m_fildes == -1)
+        return;
+
+    close(m_fildes);
+    m_fildes = -1;
+    m_filesize = 0;
+}
+
+namespace Detail {
+
+static constexpr uint64_t append_file_magic = 0x31444E5050414653; // "SFAPPND1"
+
+static constexpr size_t append_file_committed_offset = sizeof(uint64_t);
+
+static size_t round_to_pages(size_t size) {
+    static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return (size + page_size - 1) / page_size * page_size;
+}
+
+static uint64_t read_committed(const char* header) {
+    uint64_t committed;
+    std::memcpy(&committed, header + append_file_committed_offset, sizeof(committed));
+    return committed;
+}
+
+/// Makes the creation of `filename` durable
+static bool sync_directory_of(std::string const& filename) {
+    const auto parent = std::filesystem::path(filename).parent_path();
+    const auto fildes = ::open(parent.empty() ? "." : parent.c_str(), O_RDONLY | O_DIRECTORY);
+    if (fildes < 0)
+        return false;
+
+    const auto synced = fsync(fildes) == 0;
+    close(fildes);
+    return synced;
+}
+
+}
+
+tl::expected<MMapAppendFile, std::string_view> MMapAppendFile::open(std::string const& filename, size_t initial_capacity) {
+    const auto fildes = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fildes < 0)
+        return tl::unexpected { "Could not open the file" };
+
+    Stf::ScopeExit open_guard([fildes] { close(fildes); });
+
+    struct stat stats{};
+    if (fstat(fildes, &stats) < 0)
+        return tl::unexpected { "Could not stat the file" };
+
+    const auto filesize = static_cast<size_t>(stats.st_size);
+    uint64_t committed = 0;
+
+    if (filesize != 0) {
+        char header[header_size];
+        if (filesize < header_size || pread(fildes, header, header_size, 0) != static_cast<ssize_t>(header_size))
+            return tl::unexpected { "Not an append file" };
+
+        uint64_t magic;
+        std::memcpy(&magic, header, sizeof(magic));
+        committed = Detail::read_committed(header);
+
+        if (magic != Detail::append_file_magic)
+            return tl::unexpected { "Not an append file" };
+        if (committed > filesize - header_size)
+            return tl::unexpected { "The committed length is past the end of the file" };
+    }
+
+    if (filesize == 0) {
+        // written and synced before the file is used at all, so that a file that was never committed reopens empty
+        char header[header_size] {};
+        std::memcpy(header, &Detail::append_file_magic, sizeof(Detail::append_file_magic));
+        if (pwrite(fildes, header, header_size, 0) != static_cast<ssize_t>(header_size) || fsync(fildes) != 0)
+            return tl::unexpected { "Could not write the header" };
+        if (!Detail::sync_directory_of(filename))
+            return tl::unexpected { "Could not sync the directory" };
+    }
+
+    const auto capacity = std::max(filesize, Detail::round_to_pages(header_size + initial_capacity));
+    if (capacity != filesize && posix_fallocate(fildes, static_cast<off_t>(filesize), static_cast<off_t>(capacity - filesize)) != 0)
+        return tl::unexpected { "Could not allocate the file" };
+
+    auto* const base = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fildes, 0);
+    if (base == MAP_FAILED)
+        return tl::unexpected { "Could not map the file" };
+
+    open_guard.release();
+    return MMapAppendFile(fildes, static_cast<char*>(base), capacity, committed);
+}
+
+MMapAppendFile::MMapAppendFile(int fildes, char* base, size_t capacity, size_t committed) noexcept
+    : m_fildes(fildes)
+    , m_base(base)
+    , m_capacity(capacity)
+    , m_size(committed)
+    , m_committed(committed) { }
+
+MMapAppendFile::MMapAppendFile(MMapAppendFile&& other) noexcept
+    : m_fildes(std::exchange(other.m_fildes, -1))
+    , m_base(std::exchange(other.m_base, nullptr))
+    , m_capacity(std::exchange(other.m_capacity, 0))
+    , m_size(std::exchange(other.m_size, 0))
+    , m_committed(std::exchange(other.m_committed, 0)) { }
+
+MMapAppendFile& MMapAppendFile::operator=(MMapAppendFile&& other) noexcept {
+    if (this != &other) {
+        deinitialize();
+
+        m_fildes = std::exchange(other.m_fildes, -1);
+        m_base = std::exchange(other.m_base, nullptr);
+        m_capacity = std::exchange(other.m_capacity, 0);
+        m_size = std::exchange(other.m_size, 0);
+        m_committed = std::exchange(other.m_committed, 0);
+    }
+
+    return *this;
+}
+
+tl::expected<void, std::string_view> MMapAppendFile::grow(size_t min_capacity) {
+    const auto capacity = std::max(m_capacity * 2, Detail::round_to_pages(min_capacity));
+
+    // allocated up front so that running out of space is an error here and not a SIGBUS on a later write
+    if (posix_fallocate(m_fildes, static_cast<off_t>(m_capacity), static_cast<off_t>(capacity - m_capacity)) != 0)
+        return tl::unexpected { "Could not grow the file" };
+
+#ifdef __linux__
+    auto* const base = mremap(m_base, m_capacity, capacity, MREMAP_MAYMOVE);
+    if (base == MAP_FAILED)
+        return tl::unexpected { "Could not remap the file" };
+#else
+    auto* const base = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fildes, 0);
+    if (base == MAP_FAILED)
+        return tl::unexpected { "Could not remap the file" };
+
+    munmap(m_base, m_capacity);
+#endif
+
+    m_base = static_cast<char*>(base);
+    m_capacity = capacity;
+
+    return {};
+}
+
+tl::expected<size_t, std::string_view> MMapAppendFile::allocate(size_t size) {
+    if (m_base == nullptr)
+        return tl::unexpected { "The file is not open" };
+
+    if (header_size + m_size + size > m_capacity)
+        TRYX(grow(header_size + m_size + size));
+
+    return std::exchange(m_size, m_size + size);
+}
+
+tl::expected<size_t, std::string_view> MMapAppendFile::append(std::span<const char> bytes) {
+    const auto offset = TRYX(allocate(bytes.size()));
+    std::memcpy(data() + offset, bytes.data(), bytes.size());
+    return offset;
+}
+
+tl::expected<void, std::string_view> MMapAppendFile::commit() {
+    if (m_base == nullptr)
+        return tl::unexpected { "The file is not open" };
+
+    // the records go first, a crash between the two syncs leaves the previous commit in the header
+    static const auto page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const auto begin = (header_size + m_committed) / page_size * page_size;
+    const auto end = header_size + m_size;
+    if (end != begin && msync(m_base + begin, end - begin, MS_SYNC) != 0)
+        return tl::unexpected { "Could not sync the records" };
+
+    // a single aligned store, concurrent readers of the mapping see either the old or the new length
+    std::atomic_ref(*reinterpret_cast<uint64_t*>(m_base + Detail::append_file_committed_offset)).store(m_size, std::memory_order_release);
+    if (msync(m_base, page_size, MS_SYNC) != 0)
+        return tl::unexpected { "Could not sync the header" };
+
+    m_committed = m_size;
+    return {};
+}
+
+tl::expected<std::span<const char>, std::string_view> MMapAppendFile::committed_bytes(std::span<const char> file) {
+    if (file.size() < header_size)
+        return tl::unexpected { "Not an append file" };
+
+    uint64_t magic;
+    std::memcpy(&magic, file.data(), sizeof(magic));
+    if (magic != Detail::append_file_magic)
+        return tl::unexpected { "Not an append file" };
+
+    const auto committed = Detail::read_committed(file.data());
+    if (committed > file.size() - header_size)
+        return tl::unexpected { "The committed length is past the end of the file" };
+
+    return file.subspan(header_size, committed);
+}
+
+void MMapAppendFile::deinitialize() noexcept {
+    if (m_fildes == -1)
+        return;
+
+    munmap(m_base, m_capacity);
     close(m_fildes);
+    m_fildes = -1;
+    m_base = nullptr;
+    m_capacity = 0;
+    m_size = 0;
+    m_committed = 0;
 }
 
 }
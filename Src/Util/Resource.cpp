@@ -0,0 +1,28 @@
+#include <Stuff/Util/Resource.hpp>
+
+namespace Stf {
+
+void* ArenaResource::do_allocate(size_t bytes, size_t alignment) { return m_arena.allocate(bytes, alignment); }
+
+void* SlabResource::do_allocate(size_t bytes, size_t alignment) {
+    if (!fits(bytes, alignment)) {
+        // counted once upstream has not thrown
+        void* const ret = m_upstream->allocate(bytes, alignment);
+        m_upstream_bytes.fetch_add(bytes, std::memory_order_relaxed);
+        return ret;
+    }
+
+    return slab_allocate(bytes);
+}
+
+void SlabResource::do_deallocate(void* ptr, size_t bytes, size_t alignment) {
+    if (!fits(bytes, alignment)) {
+        m_upstream_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        m_upstream->deallocate(ptr, bytes, alignment);
+        return;
+    }
+
+    slab_deallocate(ptr, bytes);
+}
+
+}
@@ -0,0 +1,178 @@
+#include <Stuff/Util/Slab.hpp>
+
+#include <Stuff/Util/SpinLock.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+namespace Stf::Detail::Slab {
+
+static constexpr size_t slab_size = 64uz * 1024;
+
+struct Depot {
+    SpinMutex mutex {};
+
+    /// Full magazines, chained through `FreeObject::next_magazine`
+    FreeObject* full = nullptr;
+
+    /// The objects of the magazines that were handed over partly filled, gathered until they fill one
+    Magazine partial {};
+
+    /// The part of the newest slab that is not carved up yet
+    std::byte* cursor = nullptr;
+    std::byte* end = nullptr;
+};
+
+static std::atomic_size_t s_reserved { 0 };
+
+/// Never destroyed, threads return their magazines while the process exits
+static std::array<Depot, class_count>& depots() {
+    static auto* const ret = new std::array<Depot, class_count> {};
+    return *ret;
+}
+
+/// Fills a magazine with objects that were never handed out, the lock of the depot has to be held
+static Magazine carve(Depot& depot, size_t size_class) {
+    const auto object_size = class_sizes[size_class];
+    Magazine ret {};
+
+    for (auto i = 0uz; i < magazine_capacity(size_class); i++) {
+        // the tail of a slab that is too short for another object is left unused
+        if (static_cast<size_t>(depot.end - depot.cursor) < object_size) {
+            depot.cursor = static_cast<std::byte*>(::operator new(slab_size));
+            depot.end = depot.cursor + slab_size;
+            s_reserved.fetch_add(slab_size, std::memory_order_relaxed);
+        }
+
+        auto* const object = reinterpret_cast<FreeObject*>(depot.cursor);
+        depot.cursor += object_size;
+
+        object->next = ret.head;
+        ret.head = object;
+        ret.count++;
+    }
+
+    return ret;
+}
+
+/// The partial magazine if there is one, so that it does not linger, else a full one, else a new one. Leaves the
+/// depot without a partial magazine. The lock of the depot has to be held.
+static Magazine take(Depot& depot, size_t size_class) {
+    if (depot.partial.count != 0)
+        return std::exchange(depot.partial, {});
+
+    if (depot.full == nullptr)
+        return carve(depot, size_class);
+
+    auto* const head = std::exchange(depot.full, depot.full->next_magazine);
+    return { head, magazine_capacity(size_class) };
+}
+
+/// The lock of the depot has to be held
+static void give_back(Depot& depot, size_t size_class, Magazine magazine) noexcept {
+    const auto capacity = magazine_capacity(size_class);
+
+    // the objects go over one by one, which only happens when a thread flushes its cache
+    while (magazine.count != capacity && magazine.count != 0) {
+        auto* const object = magazine.head;
+        magazine.head = object->next;
+        magazine.count--;
+
+        object->next = depot.partial.head;
+        depot.partial.head = object;
+        if (++depot.partial.count == capacity)
+            give_back(depot, size_class, std::exchange(depot.partial, {}));
+    }
+
+    if (magazine.count == capacity) {
+        magazine.head->next_magazine = depot.full;
+        depot.full = magazine.head;
+    }
+}
+
+void* refill(ThreadCache& cache, size_t size_class) {
+    auto& loaded = cache.loaded[size_class];
+    auto& spare = cache.spare[size_class];
+
+    if (spare.count != 0) {
+        std::swap(loaded, spare);
+    } else {
+        auto& depot = depots()[size_class];
+        std::unique_lock lock { depot.mutex };
+        loaded = take(depot, size_class);
+    }
+
+    auto* const ret = loaded.head;
+    loaded.head = ret->next;
+    loaded.count--;
+
+    return ret;
+}
+
+void overflow(ThreadCache& cache, size_t size_class, void* ptr) noexcept {
+    auto& loaded = cache.loaded[size_class];
+    auto& spare = cache.spare[size_class];
+
+    if (spare.count != 0) {
+        auto& depot = depots()[size_class];
+        std::unique_lock lock { depot.mutex };
+        give_back(depot, size_class, spare);
+    }
+
+    spare = std::exchange(loaded, {});
+
+    auto* const object = static_cast<FreeObject*>(ptr);
+    object->next = nullptr;
+    loaded = { object, 1 };
+}
+
+void* allocate_from_depot(size_t size_class) {
+    auto& depot = depots()[size_class];
+    std::unique_lock lock { depot.mutex };
+
+    // the rest goes back as the partial magazine that `take` left room for
+    auto magazine = take(depot, size_class);
+    auto* const ret = magazine.head;
+    magazine.head = ret->next;
+    magazine.count--;
+    depot.partial = magazine;
+
+    return ret;
+}
+
+void deallocate_to_depot(size_t size_class, void* ptr) noexcept {
+    auto* const object = static_cast<FreeObject*>(ptr);
+    object->next = nullptr;
+
+    auto& depot = depots()[size_class];
+    std::unique_lock lock { depot.mutex };
+    give_back(depot, size_class, { object, 1 });
+}
+
+void ThreadCache::flush() noexcept {
+    for (auto size_class = 0uz; size_class < class_count; size_class++) {
+        auto& depot = depots()[size_class];
+
+        for (auto* const magazine : { &loaded[size_class], &spare[size_class] }) {
+            if (magazine->count == 0)
+                continue;
+
+            std::unique_lock lock { depot.mutex };
+            give_back(depot, size_class, std::exchange(*magazine, {}));
+        }
+    }
+}
+
+ThreadCache::~ThreadCache() noexcept {
+    flush();
+    thread_cache_destroyed = true;
+}
+
+}
+
+namespace Stf {
+
+size_t slab_reserved_bytes() noexcept { return Detail::Slab::s_reserved.load(std::memory_order_relaxed); }
+
+}
@@ -0,0 +1,73 @@
+#include <Stuff/Util/ThreadPool.hpp>
+
+namespace Stf {
+
+ThreadPool::ThreadPool(size_t thread_count) {
+    m_workers.reserve(thread_count);
+
+    for (size_t i = 0; i < thread_count; i++)
+        m_workers.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool() noexcept {
+    {
+        std::unique_lock lock { m_mutex };
+        m_stopping = true;
+    }
+
+    m_cv.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+ThreadPool& ThreadPool::global() {
+    static ThreadPool pool {};
+    return pool;
+}
+
+void ThreadPool::submit(task_type task) {
+    {
+        std::unique_lock lock { m_mutex };
+        m_tasks.emplace_back(std::move(task));
+    }
+
+    m_cv.notify_one();
+}
+
+bool ThreadPool::run_pending() {
+    task_type task;
+
+    {
+        std::unique_lock lock { m_mutex };
+        if (m_tasks.empty())
+            return false;
+
+        task = std::move(m_tasks.front());
+        m_tasks.pop_front();
+    }
+
+    std::invoke(task);
+    return true;
+}
+
+void ThreadPool::worker_loop() {
+    for (;;) {
+        task_type task;
+
+        {
+            std::unique_lock lock { m_mutex };
+            m_cv.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+
+            if (m_tasks.empty())
+                return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+
+        std::invoke(task);
+    }
+}
+
+}
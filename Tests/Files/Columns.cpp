@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <Stuff/Files/Columns.hpp>
+
+using namespace Stf::FFormat;
+
+static std::vector<uint8_t> random_bytes(size_t count, uint32_t seed = 1234) {
+    std::mt19937 engine { seed };
+    std::vector<uint8_t> ret(count);
+    for (auto& byte : ret)
+        byte = static_cast<uint8_t>(engine());
+    return ret;
+}
+
+TEST(Columns, Decode) {
+    const auto group = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc") << name_field(primitive_field<Primitive::U16BE>(), "length")
+                                     << name_field(primitive_field<Primitive::U16BE>(), "id") << name_field(primitive_field<Primitive::U32BE>(), "order");
+    using group_type = decltype(group);
+    static_assert(group_type::encoded_size == 12);
+
+    // record counts that end before, at and past a register of records and a parallel range
+    for (const auto count : { 0uz, 1uz, 15uz, 16uz, 17uz, 12345uz }) {
+        const auto data = random_bytes(count * group_type::encoded_size);
+
+        const auto columns = decode_columns(group, data);
+        ASSERT_TRUE(columns) << columns.error();
+
+        const auto& [crc, length, id, order] = *columns;
+        ASSERT_EQ(crc.size(), count);
+
+        const auto* it = data.data();
+        for (auto i = 0uz; i < count; i++) {
+            group_type::representation_type record {};
+            it = *group.decode(it, data.data() + data.size(), record);
+            ASSERT_EQ(record, std::tuple(crc[i], length[i], id[i], order[i])) << i;
+        }
+    }
+}
+
+TEST(Columns, Layouts) {
+    // odd strides, 8 byte and little endian primitives, floats and an array
+    const auto group = group_field() << primitive_field<Primitive::F64BE>() << primitive_field<Primitive::U8>() << primitive_field<Primitive::I32LE>()
+                                     << primitive_field<Primitive::F32BE>() << make_array_field<3>(primitive_field<Primitive::U16BE>())
+                                     << primitive_field<Primitive::U64LE>();
+    using group_type = decltype(group);
+    static_assert(group_type::encoded_size == 31);
+
+    const auto data = random_bytes(1000 * group_type::encoded_size);
+    const auto columns = decode_columns(group, data);
+    ASSERT_TRUE(columns) << columns.error();
+
+    const auto* it = data.data();
+    for (auto i = 0uz; i < 1000; i++) {
+        group_type::representation_type record {};
+        it = *group.decode(it, data.data() + data.size(), record);
+
+        // bitwise, random doubles may be NaNs
+        ASSERT_EQ(std::bit_cast<uint64_t>(std::get<0>(record)), std::bit_cast<uint64_t>(std::get<0>(*columns)[i]));
+        ASSERT_EQ(std::get<1>(record), std::get<1>(*columns)[i]);
+        ASSERT_EQ(std::get<2>(record), std::get<2>(*columns)[i]);
+        ASSERT_EQ(std::bit_cast<uint32_t>(std::get<3>(record)), std::bit_cast<uint32_t>(std::get<3>(*columns)[i]));
+        ASSERT_EQ(std::get<4>(record), std::get<4>(*columns)[i]);
+        ASSERT_EQ(std::get<5>(record), std::get<5>(*columns)[i]);
+    }
+
+    // the 8 byte stride gathers
+    const auto pairs = group_field() << primitive_field<Primitive::U32BE>() << primitive_field<Primitive::U32LE>();
+    const auto pair_data = random_bytes(333 * 8);
+    const auto pair_columns = decode_columns(pairs, pair_data);
+    ASSERT_TRUE(pair_columns);
+    for (auto i = 0uz; i < 333; i++) {
+        ASSERT_EQ(std::get<0>(*pair_columns)[i], Stf::reverse_bytes(*reinterpret_cast<const uint32_t*>(pair_data.data() + i * 8)));
+        ASSERT_EQ(std::get<1>(*pair_columns)[i], *reinterpret_cast<const uint32_t*>(pair_data.data() + i * 8 + 4));
+    }
+}
+
+TEST(Columns, Projection) {
+    const auto group = name_field(
+      group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc") << name_field(primitive_field<Primitive::U16BE>(), "length")
+                    << name_field(primitive_field<Primitive::U16BE>(), "id") << name_field(primitive_field<Primitive::U32BE>(), "order"),
+      "group"
+    );
+
+    static_assert(std::is_same_v<columns_t<decltype(group), 3, 1>, std::tuple<std::vector<uint32_t>, std::vector<uint16_t>>>);
+
+    const auto data = random_bytes(100 * 12);
+    const auto columns = decode_columns<3, 1>(group, data);
+    ASSERT_TRUE(columns) << columns.error();
+
+    const auto all = decode_columns(group, data);
+    ASSERT_EQ(std::get<0>(*columns), std::get<3>(*all));
+    ASSERT_EQ(std::get<1>(*columns), std::get<1>(*all));
+
+    ASSERT_EQ(decode_columns<0>(group, std::span(data).first(1199)).error(), "Data is not a whole number of records");
+
+    // existing columns are resized and reused
+    columns_t<decltype(group), 3, 1> reused { std::vector<uint32_t>(1000, 7), {} };
+    const auto* storage = std::get<0>(reused).data();
+    ASSERT_TRUE((decode_columns_into<3, 1>(group, data, reused)));
+    ASSERT_EQ(reused, *columns);
+    ASSERT_EQ(std::get<0>(reused).data(), storage);
+}
+
+TEST(Columns, Mapped) {
+    const auto group = group_field() << primitive_field<Primitive::U16LE>() << primitive_field<Primitive::F32BE>();
+    const auto data = random_bytes(4321 * 6);
+
+    const auto filename = (std::filesystem::temp_directory_path() / "libstuff_columns_mapped.bin").string();
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ASSERT_TRUE(ofs);
+        ofs.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    const auto columns = [&] {
+        const Stf::MMapStringView file(filename, true);
+        return decode_columns<0>(group, file);
+    }();
+    std::filesystem::remove(filename);
+
+    ASSERT_TRUE(columns) << columns.error();
+    ASSERT_EQ(std::get<0>(*columns), std::get<0>(*decode_columns(group, data)));
+}
@@ -0,0 +1,313 @@
+#include <gtest/gtest.h>
+
+#include <list>
+#include <random>
+
+#include <Stuff/Files/Format.hpp>
+
+using namespace Stf::FFormat;
+
+static std::vector<uint8_t> random_bytes(size_t count, uint32_t seed = 1234) {
+    std::mt19937 engine { seed };
+    std::vector<uint8_t> ret(count);
+    for (auto& byte : ret)
+        byte = static_cast<uint8_t>(engine());
+    return ret;
+}
+
+/// Decodes from a pointer range (the contiguous path) and from a list (the iterator path), checks that both agree and
+/// consume the same amount
+template<typename E> static typename E::representation_type decode_both(E const& expression, std::vector<uint8_t> const& data) {
+    typename E::representation_type contiguous {};
+    const auto contiguous_res = expression.decode(data.data(), data.data() + data.size(), contiguous);
+    EXPECT_TRUE(contiguous_res);
+    EXPECT_EQ(*contiguous_res - data.data(), static_cast<ptrdiff_t>(E::encoded_size));
+
+    const std::list<uint8_t> list(data.begin(), data.end());
+    typename E::representation_type stepped {};
+    const auto stepped_res = expression.decode(list.begin(), list.end(), stepped);
+    EXPECT_TRUE(stepped_res);
+    EXPECT_EQ(std::distance(list.begin(), *stepped_res), static_cast<ptrdiff_t>(E::encoded_size));
+
+    EXPECT_TRUE(contiguous == stepped);
+    return contiguous;
+}
+
+TEST(FFormat, Primitives) {
+    const std::vector<uint8_t> data { 0x81, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10 };
+
+    ASSERT_EQ(decode_both(primitive_field<Primitive::U8>(), data), 0x81);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::I8>(), data), -127);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::U16BE>(), data), 0x8102);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::U16LE>(), data), 0x0281);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::I16BE>(), data), static_cast<int16_t>(0x8102));
+    ASSERT_EQ(decode_both(primitive_field<Primitive::U32BE>(), data), 0x81020304u);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::I32LE>(), data), 0x04030281);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::U64LE>(), data), 0x0807060504030281ull);
+    ASSERT_EQ(decode_both(primitive_field<Primitive::I64BE>(), data), static_cast<int64_t>(0x8102030405060708ull));
+    ASSERT_TRUE(decode_both(primitive_field<Primitive::U128BE>(), data) == (__uint128_t(0x8102030405060708ull) << 64 | 0x090A0B0C0D0E0F10ull));
+
+    static_assert(std::is_signed_v<primitive_respresentation_t<Primitive::I32BE>>);
+    static_assert(std::is_unsigned_v<primitive_respresentation_t<Primitive::U32LE>>);
+
+    const std::vector<uint8_t> one { 0x3F, 0x80, 0x00, 0x00 };
+    ASSERT_EQ(decode_both(primitive_field<Primitive::F32BE>(), one), 1.f);
+
+    // still usable in constant expressions
+    constexpr auto constant = [] {
+        constexpr std::array<uint8_t, 2> bytes { 0x12, 0x34 };
+        uint16_t out = 0;
+        primitive_field<Primitive::U16BE>().decode(bytes.begin(), bytes.end(), out);
+        return out;
+    }();
+    static_assert(constant == 0x1234);
+}
+
+template<Primitive P, size_t Len> static void check_array() {
+    using T = primitive_respresentation_t<P>;
+    constexpr auto expression = make_array_field<Len>(primitive_field<P>());
+
+    const auto data = random_bytes(Len * sizeof(T));
+    const auto decoded = decode_both(expression, data);
+
+    for (auto i = 0uz; i < Len; i++) {
+        T expected {};
+        primitive_field<P>().decode(data.begin() + i * sizeof(T), data.end(), expected);
+        ASSERT_EQ(std::memcmp(&decoded[i], &expected, sizeof(T)), 0) << i;
+    }
+}
+
+TEST(FFormat, Arrays) {
+    // lengths that end before, at and past a register
+    check_array<Primitive::U8, 37>();
+    check_array<Primitive::U16BE, 3>();
+    check_array<Primitive::U16BE, 37>();
+    check_array<Primitive::U16LE, 37>();
+    check_array<Primitive::I32BE, 16>();
+    check_array<Primitive::U32BE, 101>();
+    check_array<Primitive::F32BE, 64>();
+    check_array<Primitive::U64BE, 9>();
+    check_array<Primitive::F64BE, 33>();
+    check_array<Primitive::F64LE, 33>();
+    check_array<Primitive::I128BE, 7>();
+
+    // arrays of groups go member by member
+    constexpr auto pairs = make_array_field<5>(group_field() << primitive_field<Primitive::U16BE>() << primitive_field<Primitive::U8>());
+    static_assert(decltype(pairs)::encoded_size == 15);
+
+    const auto data = random_bytes(15);
+    const auto decoded = decode_both(pairs, data);
+    ASSERT_EQ(std::get<0>(decoded[4]), data[12] << 8 | data[13]);
+    ASSERT_EQ(std::get<1>(decoded[4]), data[14]);
+}
+
+TEST(FFormat, Groups) {
+    const auto group = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc") << name_field(primitive_field<Primitive::U16BE>(), "length")
+                                     << name_field(primitive_field<Primitive::U16BE>(), "id")
+                                     << name_field(make_array_field<3>(primitive_field<Primitive::I16LE>()), "samples")
+                                     << name_field(primitive_field<Primitive::F64BE>(), "time");
+
+    using group_type = decltype(group);
+    static_assert(group_type::encoded_size == 4 + 2 + 2 + 6 + 8);
+    static_assert(group_type::offsets == std::array<size_t, 5> { 0, 4, 6, 8, 14 });
+    static_assert(decltype(group_field())::encoded_size == 0);
+
+    const auto data = random_bytes(group_type::encoded_size);
+    const auto decoded = decode_both(group, data);
+    ASSERT_EQ(std::get<1>(decoded), data[4] << 8 | data[5]);
+    ASSERT_EQ(std::get<3>(decoded)[2], static_cast<int16_t>(data[13] << 8 | data[12]));
+
+    // a single check for the whole group, nothing is written on failure
+    for (auto size = 0uz; size < group_type::encoded_size; size++) {
+        group_type::representation_type out {};
+        ASSERT_FALSE(group.decode(data.data(), data.data() + size, out)) << size;
+        ASSERT_TRUE(out == group_type::representation_type {});
+
+        const std::list<uint8_t> list(data.begin(), data.begin() + static_cast<ptrdiff_t>(size));
+        ASSERT_FALSE(group.decode(list.begin(), list.end(), out)) << size;
+    }
+}
+
+/// Encodes into a buffer (the contiguous path) and through a back inserter (the iterator path), both have to write
+/// `expected`
+template<typename E> static void check_encode(E const& expression, typename E::representation_type const& value, std::vector<uint8_t> const& expected) {
+    std::vector<uint8_t> contiguous(E::encoded_size + 1, 0xAA);
+    const auto end = expression.encode(contiguous.data(), value);
+    ASSERT_EQ(end - contiguous.data(), static_cast<ptrdiff_t>(E::encoded_size));
+    ASSERT_EQ(contiguous.back(), 0xAA);
+    contiguous.pop_back();
+    ASSERT_EQ(contiguous, expected);
+
+    std::vector<uint8_t> stepped {};
+    expression.encode(back_inserter(stepped), value);
+    ASSERT_EQ(stepped, expected);
+}
+
+TEST(FFormat, Encode) {
+    check_encode(primitive_field<Primitive::U16BE>(), 0x1234, { 0x12, 0x34 });
+    check_encode(primitive_field<Primitive::I32LE>(), -2, { 0xFE, 0xFF, 0xFF, 0xFF });
+    check_encode(primitive_field<Primitive::F32BE>(), 1.f, { 0x3F, 0x80, 0x00, 0x00 });
+    check_encode(primitive_field<Primitive::U64BE>(), 0x0102030405060708ull, { 1, 2, 3, 4, 5, 6, 7, 8 });
+
+    // whatever is decoded encodes back to the same bytes
+    const auto group = group_field() << name_field(primitive_field<Primitive::U32BE>(), "crc") << name_field(primitive_field<Primitive::U16LE>(), "length")
+                                     << name_field(make_array_field<37>(primitive_field<Primitive::U32BE>()), "samples")
+                                     << name_field(make_array_field<3>(group_field() << primitive_field<Primitive::F64BE>() << primitive_field<Primitive::I8>()), "pairs")
+                                     << name_field(make_array_field<19>(primitive_field<Primitive::U8>()), "tail");
+
+    using group_type = decltype(group);
+
+    const auto data = random_bytes(group_type::encoded_size);
+    group_type::representation_type value {};
+    ASSERT_TRUE(group.decode(data.data(), data.data() + data.size(), value));
+    check_encode(group, value, data);
+
+    // still usable in constant expressions
+    constexpr auto constant = [] {
+        std::array<uint8_t, 6> bytes {};
+        (group_field() << primitive_field<Primitive::U16BE>() << primitive_field<Primitive::U32LE>()).encode(bytes.begin(), { 0x1234, 0x05060708 });
+        return bytes;
+    }();
+    static_assert(constant == std::array<uint8_t, 6> { 0x12, 0x34, 0x08, 0x07, 0x06, 0x05 });
+}
+
+TEST(FFormat, Blobs) {
+    const auto blob = blob_field<Primitive::U16BE>();
+    static_assert(decltype(blob)::encoded_size == dynamic_size);
+
+    const std::vector<uint8_t> data { 0, 3, 'a', 'b', 'c', 'd' };
+    std::span<const uint8_t> view {};
+    const auto res = blob.decode(data.data(), data.data() + data.size(), view);
+    ASSERT_TRUE(res);
+    ASSERT_EQ(*res, data.data() + 5);
+
+    // a view into the source, not a copy
+    ASSERT_EQ(view.data(), data.data() + 2);
+    ASSERT_EQ(view.size(), 3);
+    ASSERT_EQ(encoded_size_of(blob, view), 5);
+
+    ASSERT_FALSE(blob.decode(data.data(), data.data() + 4, view));
+    ASSERT_FALSE(blob.decode(data.data(), data.data() + 1, view));
+
+    std::vector<uint8_t> encoded(5);
+    ASSERT_EQ(blob.encode(encoded.data(), view), encoded.data() + 5);
+    ASSERT_TRUE(std::ranges::equal(encoded, std::span(data).first(5)));
+
+    std::vector<uint8_t> stepped {};
+    blob.encode(back_inserter(stepped), std::vector<uint8_t> { 1, 2 });
+    ASSERT_EQ(stepped, (std::vector<uint8_t> { 0, 2, 1, 2 }));
+}
+
+TEST(FFormat, CountedArrays) {
+    const auto array = counted_array_field<Primitive::U8>(group_field() << primitive_field<Primitive::U16BE>() << primitive_field<Primitive::I8>());
+
+    const std::vector<uint8_t> data { 3, 0x12, 0x34, 0xFF, 0x56, 0x78, 1, 0x9A, 0xBC, 2, 0xAA };
+    typename decltype(array)::representation_type view {};
+    ASSERT_EQ(*array.decode(data.data(), data.data() + data.size(), view), data.data() + 10);
+
+    ASSERT_EQ(view.size(), 3);
+    ASSERT_EQ(view.encoded().data(), data.data() + 1);
+    ASSERT_EQ(view[1], std::tuple(0x5678, 1));
+
+    using element = std::tuple<uint16_t, int8_t>;
+    const std::vector<element> expected { { 0x1234, -1 }, { 0x5678, 1 }, { 0x9ABC, 2 } };
+    ASSERT_TRUE(std::ranges::equal(view, expected));
+
+    // all of the elements are checked for up front
+    for (auto size = 0uz; size < 10; size++)
+        ASSERT_FALSE(array.decode(data.data(), data.data() + size, view)) << size;
+
+    // from a view the bytes are copied, from anything else the elements are encoded
+    std::vector<uint8_t> encoded(10);
+    ASSERT_EQ(array.encode(encoded.data(), view), encoded.data() + 10);
+    ASSERT_TRUE(std::ranges::equal(encoded, std::span(data).first(10)));
+
+    std::vector<uint8_t> stepped {};
+    array.encode(back_inserter(stepped), expected);
+    ASSERT_TRUE(std::ranges::equal(stepped, std::span(data).first(10)));
+
+    const auto floats = counted_array_field<Primitive::U32LE>(primitive_field<Primitive::F32BE>());
+    std::vector<uint8_t> float_data {};
+    floats.encode(back_inserter(float_data), std::vector { 1.f, 2.f });
+    ASSERT_EQ(float_data, (std::vector<uint8_t> { 2, 0, 0, 0, 0x3F, 0x80, 0, 0, 0x40, 0, 0, 0 }));
+}
+
+TEST(FFormat, TaggedUnions) {
+    const auto message = tagged_union_field<Primitive::U8>(
+      union_case<1>(primitive_field<Primitive::U32BE>()), union_case<7>(blob_field<Primitive::U8>()),
+      union_case<9>(group_field() << primitive_field<Primitive::U8>() << primitive_field<Primitive::U8>())
+    );
+
+    using message_type = decltype(message)::representation_type;
+
+    const std::vector<uint8_t> data { 7, 2, 'h', 'i', 1, 0, 0, 1, 0, 9, 4, 5, 3 };
+    const auto* it = data.data();
+    const auto* end = data.data() + data.size();
+
+    message_type value {};
+    it = *message.decode(it, end, value);
+    ASSERT_EQ(value.index(), 1);
+    ASSERT_TRUE(std::ranges::equal(std::get<1>(value), std::string_view("hi")));
+    ASSERT_EQ(encoded_size_of(message, value), 4);
+
+    it = *message.decode(it, end, value);
+    ASSERT_EQ(std::get<0>(value), 256);
+
+    it = *message.decode(it, end, value);
+    ASSERT_EQ(std::get<2>(value), std::tuple(4, 5));
+
+    // unknown tag
+    ASSERT_FALSE(message.decode(it, end, value));
+
+    std::vector<uint8_t> encoded {};
+    message.encode(back_inserter(encoded), message_type { std::in_place_index<0>, 0x01020304 });
+    message.encode(back_inserter(encoded), message_type { std::in_place_index<2>, std::tuple(6, 7) });
+    ASSERT_EQ(encoded, (std::vector<uint8_t> { 1, 1, 2, 3, 4, 9, 6, 7 }));
+
+    // fixed-size alternatives decode from any iterator
+    const auto fixed = tagged_union_field<Primitive::U16LE>(union_case<1>(primitive_field<Primitive::U8>()), union_case<2>(primitive_field<Primitive::U16BE>()));
+    const std::list<uint8_t> list { 2, 0, 0xAB, 0xCD };
+    decltype(fixed)::representation_type fixed_value {};
+    ASSERT_EQ(*fixed.decode(list.begin(), list.end(), fixed_value), list.end());
+    ASSERT_EQ(std::get<1>(fixed_value), 0xABCD);
+}
+
+TEST(FFormat, DynamicGroups) {
+    const auto fixed = group_field() << primitive_field<Primitive::U32BE>() << make_array_field<4>(primitive_field<Primitive::U16LE>());
+    const auto record = group_field() << name_field(fixed, "header") << name_field(blob_field<Primitive::U32LE>(), "payload")
+                                      << name_field(counted_array_field<Primitive::U16BE>(primitive_field<Primitive::F64LE>()), "samples")
+                                      << name_field(primitive_field<Primitive::U8>(), "trailer");
+
+    // fixed-size groups keep their static size, anything with a variable member does not
+    static_assert(decltype(fixed)::encoded_size == 12);
+    static_assert(decltype(record)::encoded_size == dynamic_size);
+    static_assert(decltype(make_array_field<2>(blob_field<Primitive::U8>()))::encoded_size == dynamic_size);
+
+    const auto payload = random_bytes(1000);
+    const std::vector<double> samples { 1., 2., 3. };
+
+    decltype(fixed)::representation_type header { 0xDEADBEEF, { 1, 2, 3, 4 } };
+    std::vector<uint8_t> encoded {};
+    auto out = back_inserter(encoded);
+    out = fixed.encode(out, header);
+    out = blob_field<Primitive::U32LE>().encode(out, payload);
+    out = counted_array_field<Primitive::U16BE>(primitive_field<Primitive::F64LE>()).encode(out, samples);
+    out = primitive_field<Primitive::U8>().encode(out, 42);
+    ASSERT_EQ(encoded.size(), 12 + 4 + 1000 + 2 + 24 + 1);
+
+    decltype(record)::representation_type value {};
+    ASSERT_EQ(*record.decode(encoded.data(), encoded.data() + encoded.size(), value), encoded.data() + encoded.size());
+    ASSERT_EQ(std::get<0>(value), header);
+    ASSERT_TRUE(std::ranges::equal(std::get<1>(value), payload));
+    ASSERT_TRUE(std::ranges::equal(std::get<2>(value), samples));
+    ASSERT_EQ(std::get<3>(value), 42);
+    ASSERT_EQ(encoded_size_of(record, value), encoded.size());
+
+    // the views encode back to the same bytes
+    std::vector<uint8_t> re_encoded(encoded_size_of(record, value));
+    ASSERT_EQ(record.encode(re_encoded.data(), value), re_encoded.data() + re_encoded.size());
+    ASSERT_EQ(re_encoded, encoded);
+
+    for (const auto size : { 0uz, 11uz, 12uz, 15uz, 1015uz, 1016uz, 1018uz, 1041uz, 1042uz })
+        ASSERT_FALSE(record.decode(encoded.data(), encoded.data() + size, value)) << size;
+}
@@ -0,0 +1,225 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include <Stuff/Graphics/BufferPool.hpp>
+#include <Stuff/Graphics/Image.hpp>
+
+using namespace Stf::Gfx;
+
+using PooledImage = Image<PooledAllocator<uint8_t>>;
+
+TEST(BufferPool, SizeClasses) {
+    ASSERT_EQ(BufferPool::size_class(0), 64);
+    ASSERT_EQ(BufferPool::size_class(1), 64);
+    ASSERT_EQ(BufferPool::size_class(65), 128);
+    ASSERT_EQ(BufferPool::size_class(256), 256);
+    ASSERT_EQ(BufferPool::size_class(257), 320);
+    ASSERT_EQ(BufferPool::size_class(1024), 1024);
+    ASSERT_EQ(BufferPool::size_class(1025), 1280);
+
+    // 1080p RGBA
+    ASSERT_EQ(BufferPool::size_class(1920 * 1080 * 4), 8388608);
+
+    for (auto bytes = 1uz; bytes < 1 << 20; bytes = bytes * 5 / 4 + 1) {
+        const auto size = BufferPool::size_class(bytes);
+        ASSERT_GE(size, bytes);
+        ASSERT_LE(size, std::max<size_t>(256, bytes + bytes / 4));
+        ASSERT_EQ(size % BufferPool::alignment, 0);
+        ASSERT_EQ(BufferPool::size_class(size), size);
+    }
+}
+
+TEST(BufferPool, Recycling) {
+    BufferPool pool {};
+
+    auto* const a = pool.allocate(1000);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(a) % BufferPool::alignment, 0);
+    pool.deallocate(a, 1000);
+
+    // same size class
+    auto* const b = pool.allocate(1020);
+    ASSERT_EQ(a, b);
+
+    auto* const c = pool.allocate(1000);
+    ASSERT_NE(b, c);
+
+    pool.deallocate(b, 1020);
+    pool.deallocate(c, 1000);
+
+    auto stats = pool.stats();
+    ASSERT_EQ(stats.hits, 1);
+    ASSERT_EQ(stats.misses, 2);
+    ASSERT_EQ(stats.recycled, 3);
+    ASSERT_EQ(stats.evicted, 0);
+    ASSERT_EQ(stats.cached_buffers, 2);
+    ASSERT_EQ(stats.cached_bytes, 2 * BufferPool::size_class(1000));
+    ASSERT_NEAR(stats.hit_rate(), 1. / 3., 1e-9);
+
+    pool.reset_stats();
+    stats = pool.stats();
+    ASSERT_EQ(stats.hits + stats.misses + stats.recycled + stats.evicted, 0);
+    ASSERT_EQ(stats.cached_buffers, 2);
+
+    pool.trim();
+    stats = pool.stats();
+    ASSERT_EQ(stats.cached_buffers, 0);
+    ASSERT_EQ(stats.cached_bytes, 0);
+
+    pool.deallocate(nullptr, 1000);
+}
+
+TEST(BufferPool, Eviction) {
+    BufferPool pool { 4096 };
+
+    std::vector<void*> buffers {};
+    for (auto i = 0uz; i < 6; i++)
+        buffers.push_back(pool.allocate(1024));
+    for (auto* const p : buffers)
+        pool.deallocate(p, 1024);
+
+    const auto stats = pool.stats();
+    ASSERT_EQ(stats.recycled, 4);
+    ASSERT_EQ(stats.evicted, 2);
+    ASSERT_EQ(stats.cached_bytes, 4096);
+
+    // larger than the whole cache
+    pool.deallocate(pool.allocate(8192), 8192);
+    ASSERT_EQ(pool.stats().evicted, 3);
+}
+
+TEST(BufferPool, Threads) {
+    BufferPool pool {};
+
+    std::vector<std::thread> threads {};
+    for (auto t = 0uz; t < 4; t++) {
+        threads.emplace_back([&pool, t] {
+            for (auto i = 0uz; i < 1000; i++) {
+                const auto bytes = 64 * (1 + (i + t) % 7);
+                auto* const p = static_cast<uint8_t*>(pool.allocate(bytes));
+                std::fill_n(p, bytes, static_cast<uint8_t>(t));
+                pool.deallocate(p, bytes);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto stats = pool.stats();
+    ASSERT_EQ(stats.hits + stats.misses, 4000);
+    ASSERT_EQ(stats.recycled, 4000);
+    ASSERT_LE(stats.cached_buffers, 4 * 7);
+}
+
+TEST(BufferPool, Image) {
+    BufferPool pool {};
+    const PooledAllocator<uint8_t> alloc { pool };
+
+    // a pipeline creating a frame of the same size over and over
+    for (auto i = 0uz; i < 10; i++) {
+        PooledImage frame(1920, 1080, Colors::black, alloc);
+        ASSERT_EQ(&frame.get_allocator().pool(), &pool);
+        ASSERT_EQ(frame.get_pixel(1919, 1079), Colors::black);
+    }
+
+    const auto stats = pool.stats();
+    ASSERT_EQ(stats.misses, 1);
+    ASSERT_EQ(stats.hits, 9);
+
+    // copies keep the allocator
+    PooledImage a(16, 16, Colors::black, alloc);
+    const auto b = a;
+    ASSERT_EQ(&b.get_allocator().pool(), &pool);
+
+    // creating an image of the same size keeps the buffer
+    const auto* const data = a.data();
+    a.create(8, 32);
+    ASSERT_EQ(a.data(), data);
+    a.resize(32, 8);
+    ASSERT_EQ(a.data(), data);
+}
+
+TEST(BufferPool, Assignment) {
+    Image<> a(4, 4, Color { 1, 2, 3, 4 });
+    Image<> b(8, 8, Colors::black);
+
+    // copies reuse the destination buffer when the sizes match
+    Image<> c(4, 4);
+    const auto* const c_data = c.data();
+    c = a;
+    ASSERT_EQ(c.data(), c_data);
+    ASSERT_TRUE(std::ranges::equal(a, c));
+
+    c = c;
+    ASSERT_EQ(c.get_pixel(3, 3), (Color { 1, 2, 3, 4 }));
+
+    // moves take the buffer and free the old one
+    const auto* const b_data = b.data();
+    c = std::move(b);
+    ASSERT_EQ(c.data(), b_data);
+    ASSERT_EQ(c.dimensions(), (Stf::Vector<size_t, 2> { 8, 8 }));
+    ASSERT_EQ(b.data(), nullptr);
+    ASSERT_EQ(b.size(), 0);
+
+    Image<> d(std::move(c));
+    ASSERT_EQ(d.data(), b_data);
+    ASSERT_EQ(c.data(), nullptr);
+
+    // a move between pools copies
+    BufferPool pool_a {};
+    BufferPool pool_b {};
+    PooledImage e(4, 4, Color { 5, 6, 7, 8 }, PooledAllocator<uint8_t> { pool_a });
+    PooledImage f(std::move(e), PooledAllocator<uint8_t> { pool_b });
+    ASSERT_EQ(&f.get_allocator().pool(), &pool_b);
+    ASSERT_EQ(f.get_pixel(0, 0), (Color { 5, 6, 7, 8 }));
+    ASSERT_EQ(e.data(), nullptr);
+    ASSERT_EQ(pool_a.stats().recycled, 1);
+}
+
+TEST(BufferPool, SharedImage) {
+    SharedImage<> a { Image<>(4, 4, Color { 1, 2, 3, 4 }) };
+    ASSERT_TRUE(a.unique());
+
+    auto b = a;
+    ASSERT_EQ(a.use_count(), 2);
+    ASSERT_EQ(a->data(), b->data());
+
+    // the writer gets its own copy, the other one keeps the original
+    const auto* const data = a->data();
+    b.write().set_pixel(0, Colors::black);
+    ASSERT_TRUE(a.unique());
+    ASSERT_TRUE(b.unique());
+    ASSERT_EQ(a->data(), data);
+    ASSERT_NE(b->data(), data);
+    ASSERT_EQ(a->get_pixel(0), (Color { 1, 2, 3, 4 }));
+    ASSERT_EQ(b->get_pixel(0), Colors::black);
+    ASSERT_EQ(b->get_pixel(1), (Color { 1, 2, 3, 4 }));
+
+    // unique images are written in place
+    b.write().set_pixel(1, Colors::black);
+    ASSERT_EQ((*b).get_pixel(1), Colors::black);
+
+    // the clone and the control block come from the pool of the image
+    BufferPool pool {};
+    SharedImage<PooledAllocator<uint8_t>> c { PooledImage(64, 64, Colors::black, PooledAllocator<uint8_t> { pool }) };
+    const auto d = c;
+    c.write();
+    ASSERT_EQ(&c->get_allocator().pool(), &pool);
+    ASSERT_EQ(pool.stats().misses, 4);
+
+    // copies handed to other threads
+    std::vector<std::thread> threads {};
+    std::atomic_size_t matching = 0;
+    for (auto t = 0uz; t < 4; t++) {
+        threads.emplace_back([copy = a, &matching]() mutable {
+            if (copy->get_pixel(5) == Color { 1, 2, 3, 4 })
+                matching++;
+            copy.write().set_pixel(5, Colors::black);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    ASSERT_EQ(matching, 4);
+    ASSERT_EQ(a->get_pixel(5), (Color { 1, 2, 3, 4 }));
+}
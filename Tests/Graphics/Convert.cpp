@@ -0,0 +1,181 @@
+#include <gtest/gtest.h>
+
+#include <bit>
+#include <cmath>
+
+#include <Stuff/Graphics/Convert.hpp>
+
+#include "./Random.hpp"
+
+using namespace Stf::Gfx;
+
+template<ColorFormat Format, ColorSpace Space> using TestImage = NewImage<Format, Space>;
+
+template<typename T> static constexpr double channel_max = std::is_floating_point_v<T> ? 1. : static_cast<double>(std::numeric_limits<T>::max());
+
+static double clamp_unit(double v) { return std::clamp(v, 0., 1.); }
+
+static double to_linear(double v) { return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4); }
+
+static double from_linear(double v) { return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1. / 2.4) - 0.055; }
+
+/// Per pixel reference in double precision
+template<ColorFormat SrcFormat, ColorSpace SrcSpace, ColorFormat DstFormat, ColorSpace DstSpace>
+static void check_pair(TestImage<SrcFormat, SrcSpace> const& src, Stf::ThreadPool& pool) {
+    using S = typename TestImage<SrcFormat, SrcSpace>::channel_type;
+    using T = typename TestImage<DstFormat, DstSpace>::channel_type;
+    constexpr auto src_layout = Detail::Convert::layout_of(SrcFormat);
+    constexpr auto dst_layout = Detail::Convert::layout_of(DstFormat);
+
+    const auto dst = convert<DstFormat, DstSpace>(src, pool);
+    ASSERT_EQ(dst.dimensions(), src.dimensions());
+
+    // the float pipeline keeps ~1e-6 of the unit range
+    const auto tolerance = std::is_floating_point_v<T> ? 4e-6 : std::max(1., channel_max<T> * 4e-6);
+
+    for (auto i = 0uz; i < src.pixel_count(); i++) {
+        for (auto c = 0uz; c < 4; c++) {
+            if (dst_layout[c] < 0)
+                continue;
+
+            double v = src_layout[c] < 0 ? 1. : static_cast<double>(src[i][src_layout[c]]) / channel_max<S>;
+
+            if (c < 3 && SrcSpace == ColorSpace::SRGB && DstSpace == ColorSpace::Linear)
+                v = to_linear(clamp_unit(v));
+            else if (c < 3 && SrcSpace == ColorSpace::Linear && DstSpace == ColorSpace::SRGB)
+                v = from_linear(clamp_unit(v));
+
+            if constexpr (!std::is_floating_point_v<T>)
+                v = std::round(clamp_unit(v) * channel_max<T>);
+
+            const auto got = static_cast<double>(dst[i][dst_layout[c]]);
+            ASSERT_LE(std::abs(got - v), tolerance) << "pixel " << i << " channel " << c << ": " << got << " vs " << v << " for "
+                                                    << static_cast<int>(SrcFormat) << "/" << static_cast<int>(SrcSpace) << " -> "
+                                                    << static_cast<int>(DstFormat) << "/" << static_cast<int>(DstSpace);
+        }
+    }
+}
+
+/// Random channels, seeded by the format, with the extremes of every channel in the first two pixels
+template<ColorFormat Format, ColorSpace Space> static TestImage<Format, Space> random_test_image(Stf::Vector<size_t, 2> dimensions) {
+    using T = typename TestImage<Format, Space>::channel_type;
+
+    auto ret = random_image<TestImage<Format, Space>>(dimensions, static_cast<uint32_t>(Format) * 31 + static_cast<uint32_t>(Space));
+    ret[0].fill(T(0));
+    ret[1].fill(static_cast<T>(channel_max<T>));
+
+    return ret;
+}
+
+template<ColorFormat... Formats> struct FormatList {
+    template<typename Fn> static void for_each(Fn&& fn) { (fn.template operator()<Formats>(), ...); }
+};
+
+using AllFormats = FormatList<
+  ColorFormat::RGB8u, ColorFormat::RGBA8u, ColorFormat::BGRA8u, ColorFormat::RGB16u, ColorFormat::RGBA16u, ColorFormat::RGB32u,
+  ColorFormat::RGBA32u, ColorFormat::RGB32f, ColorFormat::RGBA32f>;
+
+/// One channel type of each kind, the transfer paths only depend on the channel types
+using SomeFormats = FormatList<ColorFormat::BGRA8u, ColorFormat::RGB16u, ColorFormat::RGBA32f>;
+
+template<ColorSpace SrcSpace, ColorSpace DstSpace, typename SrcFormats, typename DstFormats> static void check_pairs() {
+    Stf::ThreadPool pool(2);
+
+    SrcFormats::for_each([&]<ColorFormat SrcFormat>() {
+        // not a multiple of any vector or block width
+        const auto src = random_test_image<SrcFormat, SrcSpace>({ 67, 5 });
+        DstFormats::for_each([&]<ColorFormat DstFormat>() { check_pair<SrcFormat, SrcSpace, DstFormat, DstSpace>(src, pool); });
+    });
+}
+
+TEST(Convert, SameSpace) { check_pairs<ColorSpace::SRGB, ColorSpace::SRGB, AllFormats, AllFormats>(); }
+
+TEST(Convert, ToLinear) {
+    check_pairs<ColorSpace::SRGB, ColorSpace::Linear, AllFormats, SomeFormats>();
+    check_pairs<ColorSpace::SRGB, ColorSpace::Linear, SomeFormats, AllFormats>();
+}
+
+TEST(Convert, FromLinear) {
+    check_pairs<ColorSpace::Linear, ColorSpace::SRGB, AllFormats, SomeFormats>();
+    check_pairs<ColorSpace::Linear, ColorSpace::SRGB, SomeFormats, AllFormats>();
+}
+
+TEST(Convert, Quantizer) {
+    constexpr auto lanes = Stf::SIMD::native_lanes<float>;
+
+    // a stride through every float in [0, 1]
+    for (auto bits = 0u; bits <= std::bit_cast<uint32_t>(1.f); bits += 97 * lanes) {
+        Stf::SIMD::Vec<float, lanes> vs;
+        for (auto j = 0uz; j < lanes; j++)
+            vs[j] = std::min(1.f, std::bit_cast<float>(static_cast<uint32_t>(bits + j)));
+
+        const auto from_linear_codes = SRGB::from_linear_u8<>(vs);
+        const auto to_linear_codes = SRGB::to_linear_u8<>(vs);
+
+        for (auto j = 0uz; j < lanes; j++) {
+            const auto v = vs[j];
+            ASSERT_EQ(from_linear_codes[j], SRGB::from_linear_u8<>(v));
+            ASSERT_EQ(to_linear_codes[j], SRGB::to_linear_u8<>(v));
+
+            // the thresholds are floats, values right next to them may go either way
+            const auto srgb = 255. * from_linear(v);
+            if (std::abs(srgb - std::floor(srgb) - 0.5) > 1e-4) {
+                ASSERT_EQ(SRGB::from_linear_u8<>(v), std::round(srgb)) << v;
+            }
+
+            const auto linear = 255. * to_linear(v);
+            if (std::abs(linear - std::floor(linear) - 0.5) > 1e-4) {
+                ASSERT_EQ(SRGB::to_linear_u8<>(v), std::round(linear)) << v;
+            }
+        }
+    }
+}
+
+TEST(Convert, RoundTrip) {
+    // every 8 bit code survives BGRA8 sRGB -> RGBA32f linear -> BGRA8 sRGB
+    TestImage<ColorFormat::BGRA8u, ColorSpace::SRGB> src {};
+    src.create({ 256, 1 });
+    for (auto i = 0uz; i < 256; i++)
+        src[i] = { static_cast<uint8_t>(i), static_cast<uint8_t>(255 - i), static_cast<uint8_t>(i * 7), static_cast<uint8_t>(i) };
+
+    const auto linear = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(src);
+    const auto back = convert<ColorFormat::BGRA8u, ColorSpace::SRGB>(linear);
+
+    ASSERT_TRUE(std::ranges::equal(src.pixels(), back.pixels()));
+}
+
+TEST(Convert, Clamp) {
+    TestImage<ColorFormat::RGBA32f, ColorSpace::Linear> src {};
+    src.create({ 1, 1 });
+    src[0] = { -1.f, 2.f, std::numeric_limits<float>::quiet_NaN(), 0.5f };
+
+    const auto dst = convert<ColorFormat::RGBA8u, ColorSpace::Linear>(src);
+    ASSERT_EQ(dst[0], (std::array<uint8_t, 4> { 0, 255, 0, 128 }));
+
+    const auto srgb = convert<ColorFormat::RGBA16u, ColorSpace::SRGB>(src);
+    ASSERT_EQ(srgb[0][0], 0);
+    ASSERT_EQ(srgb[0][1], 65535);
+}
+
+TEST(Convert, Parallel) {
+    const auto src = random_test_image<ColorFormat::BGRA8u, ColorSpace::SRGB>({ 1000, 300 });
+
+    Stf::ThreadPool serial(0);
+    Stf::ThreadPool pool(3);
+
+    const auto a = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(src, serial);
+    const auto b = convert<ColorFormat::RGBA32f, ColorSpace::Linear>(src, pool);
+    ASSERT_TRUE(std::ranges::equal(a.pixels(), b.pixels()));
+}
+
+TEST(Convert, Errors) {
+    TestImage<ColorFormat::RGBA8u, ColorSpace::SRGB> src {};
+    src.create({ 4, 4 });
+
+    TestImage<ColorFormat::RGBA32f, ColorSpace::Linear> dst {};
+    dst.create({ 4, 3 });
+    ASSERT_EQ(convert(src, dst).error(), "Image dimensions do not match");
+
+    auto view = TestImage<ColorFormat::RGBA8u, ColorSpace::Linear>::view(src.pixels(), src.dimensions());
+    ASSERT_EQ(convert(src, view).error(), "Can not convert in place");
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <cmath>
+
+#include <Stuff/Graphics/Expression.hpp>
+
+#include "./Random.hpp"
+
+using namespace Stf::Gfx;
+
+using ByteImage = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+using FloatImage = NewImage<ColorFormat::RGBA32f, ColorSpace::Linear>;
+
+static double srgb_to_linear(double v) { return v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4); }
+static double linear_to_srgb(double v) { return v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1. / 2.4) - 0.055; }
+
+/// The compositor chain from the header, in doubles one pixel at a time
+static std::array<double, 4> composite(std::array<uint8_t, 4> fg, std::array<uint8_t, 4> bg) {
+    std::array<double, 4> f {};
+    std::array<double, 4> b {};
+    for (auto c = 0uz; c < 4; c++) {
+        f[c] = fg[c] / 255.;
+        b[c] = bg[c] / 255.;
+        if (c < 3) {
+            f[c] = srgb_to_linear(f[c]);
+            b[c] = srgb_to_linear(b[c]);
+        }
+    }
+
+    for (auto c = 0uz; c < 3; c++)
+        f[c] *= f[3];
+
+    std::array<double, 4> ret {};
+    for (auto c = 0uz; c < 4; c++)
+        ret[c] = f[c] + b[c] * (1. - f[3]);
+    for (auto c = 0uz; c < 3; c++)
+        ret[c] = linear_to_srgb(std::clamp(ret[c], 0., 1.));
+
+    return ret;
+}
+
+template<typename Layout> static void check_composite(Stf::Vector<size_t, 2> dimensions) {
+    using Image = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB, ColorTraits<ColorFormat::RGBA8u, ColorSpace::SRGB>, std::allocator<std::array<uint8_t, 4>>, Layout>;
+
+    const auto fg = relayout<Layout>(random_image<ByteImage>(dimensions, 1));
+    const auto bg = relayout<Layout>(random_image<ByteImage>(dimensions, 2));
+
+    Image dst {};
+    dst.create(dimensions);
+    ASSERT_TRUE(assign(dst, to_srgb(over(premultiply(to_linear(expression(fg))), to_linear(expression(bg))))));
+
+    for (auto y = 0uz; y < dimensions[1]; y++)
+        for (auto x = 0uz; x < dimensions[0]; x++) {
+            const auto expected = composite(fg[{ x, y }], bg[{ x, y }]);
+            for (auto c = 0uz; c < 4; c++)
+                ASSERT_NEAR((dst[{ x, y }][c]), expected[c] * 255., 0.5 + 1e-3) << x << ", " << y;
+        }
+}
+
+TEST(Expression, Composite) {
+    // runs that end before, at and past a block
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 1, 1 }, { 37, 5 }, { 256, 3 }, { 300, 7 } }) {
+        check_composite<Layouts::Linear>(dimensions);
+        check_composite<Layouts::Tiled<8>>(dimensions);
+        check_composite<Layouts::Morton>(dimensions);
+    }
+}
+
+TEST(Expression, Arithmetic) {
+    const auto a = random_image<FloatImage>({ 45, 6 }, 1);
+    const auto b = random_image<FloatImage>({ 45, 6 }, 2);
+
+    FloatImage dst {};
+    dst.create(a.dimensions());
+    ASSERT_TRUE(assign(dst, (expression(a) + expression(b)) * 0.5f - expression(b) / 4.f + std::array { 1.f, 2.f, 3.f, 4.f }));
+
+    for (auto i = 0uz; i < a.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_NEAR(dst[i][c], (a[i][c] + b[i][c]) * 0.5f - b[i][c] / 4.f + static_cast<float>(c + 1), 1e-6);
+
+    ASSERT_TRUE(assign(dst, 1.f - expression(a) * expression(b)));
+    for (auto i = 0uz; i < a.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_NEAR(dst[i][c], 1.f - a[i][c] * b[i][c], 1e-6);
+
+    ASSERT_TRUE(assign(dst, 2.f / (expression(a) + 1.f)));
+    for (auto i = 0uz; i < a.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_NEAR(dst[i][c], 2.f / (a[i][c] + 1.f), 1e-6);
+}
+
+TEST(Expression, Operations) {
+    const auto src = random_image<FloatImage>({ 70, 3 });
+
+    FloatImage dst {};
+    dst.create(src.dimensions());
+
+    ASSERT_TRUE(assign(dst, unpremultiply(premultiply(expression(src)))));
+    for (auto i = 0uz; i < src.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_NEAR(dst[i][c], src[i][c], 1e-5);
+
+    ASSERT_TRUE(assign(dst, gamma(expression(src) - 0.25f, 2.2f)));
+    for (auto i = 0uz; i < src.pixel_count(); i++) {
+        for (auto c = 0uz; c < 3; c++)
+            ASSERT_NEAR(dst[i][c], std::pow(std::max(src[i][c] - 0.25f, 0.f), 2.2f), 1e-6);
+        ASSERT_FLOAT_EQ(dst[i][3], src[i][3] - 0.25f);
+    }
+
+    ASSERT_TRUE(assign(dst, clamp(expression(src) * 3.f - 1.f)));
+    for (auto i = 0uz; i < src.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_FLOAT_EQ(dst[i][c], std::clamp(src[i][c] * 3.f - 1.f, 0.f, 1.f));
+
+    // fully transparent pixels
+    FloatImage clear {};
+    clear.create({ 3, 1 });
+    clear.fill({ 0.5f, 0.5f, 0.5f, 0.f });
+    ASSERT_TRUE(assign(clear, unpremultiply(expression(clear))));
+    for (const auto pixel : clear.pixels())
+        ASSERT_EQ(pixel, (std::array { 0.f, 0.f, 0.f, 0.f }));
+}
+
+TEST(Expression, Custom) {
+    const auto a = random_image<FloatImage>({ 53, 4 }, 1);
+    const auto b = random_image<FloatImage>({ 53, 4 }, 2);
+
+    // the width is not a multiple of the vector width, the tails go through the scalar instantiations
+    FloatImage dst {};
+    dst.create(a.dimensions());
+    ASSERT_TRUE(assign(dst, map(expression(a), [](auto p) {
+                           std::swap(p[0], p[2]);
+                           p[3] = 1 - p[3];
+                           return p;
+                       })));
+
+    for (auto i = 0uz; i < a.pixel_count(); i++)
+        ASSERT_EQ(dst[i], (std::array { a[i][2], a[i][1], a[i][0], 1 - a[i][3] }));
+
+    ASSERT_TRUE(assign(dst, zip(expression(a), expression(b), [](auto p, auto q) {
+                           for (auto c = 0uz; c < 4; c++)
+                               p[c] = Stf::SIMD::select(p[c] < q[c], p[c], q[c]);
+                           return p;
+                       })));
+
+    for (auto i = 0uz; i < a.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_EQ(dst[i][c], std::min(a[i][c], b[i][c]));
+}
+
+TEST(Expression, Formats) {
+    // missing alpha reads as opaque, integer outputs are clamped and rounded
+    NewImage<ColorFormat::RGB16u, ColorSpace::SRGB> rgb {};
+    rgb.create({ 2, 1 });
+    rgb[0] = { 0, 32768, 65535 };
+    rgb[1] = { 65535, 0, 1 };
+
+    NewImage<ColorFormat::BGRA8u, ColorSpace::SRGB> bgra {};
+    bgra.create({ 2, 1 });
+    ASSERT_TRUE(assign(bgra, expression(rgb) * std::array { 1.f, 1.f, 2.f, 0.5f }));
+    ASSERT_EQ(bgra[0], (std::array<uint8_t, 4> { 255, 128, 0, 128 }));
+    ASSERT_EQ(bgra[1], (std::array<uint8_t, 4> { 0, 0, 255, 128 }));
+
+    // legacy images on both sides
+    Image<> legacy(5, 3, Color { 10, 20, 30, 255 });
+    Image<> out(5, 3);
+    ASSERT_TRUE(assign(out, expression(legacy) + constant({ 1.f / 255.f, 0.f, 0.f, 0.f })));
+    ASSERT_EQ(out.get_pixel(4, 2), (Color { 11, 20, 30, 255 }));
+
+    const auto converted = evaluate<ColorFormat::RGBA32f, ColorSpace::Linear>(expression(legacy));
+    ASSERT_TRUE(converted);
+    ASSERT_FLOAT_EQ((*converted)[0][1], 20.f / 255.f);
+}
+
+TEST(Expression, InPlace) {
+    auto image = random_image<ByteImage>({ 300, 20 });
+    const auto copy = relayout<Layouts::Linear>(image);
+
+    ASSERT_TRUE(assign(image, expression(image) * 0.5f + expression(copy) * 0.5f));
+    ASSERT_TRUE(std::ranges::equal(image.pixels(), copy.pixels()));
+
+    ASSERT_TRUE(assign(image, 1.f - expression(image)));
+    for (auto i = 0uz; i < image.pixel_count(); i++)
+        for (auto c = 0uz; c < 4; c++)
+            ASSERT_EQ(image[i][c], 255 - copy[i][c]);
+}
+
+TEST(Expression, Parallel) {
+    const auto fg = random_image<ByteImage>({ 999, 201 }, 1);
+    const auto bg = random_image<ByteImage>({ 999, 201 }, 2);
+    const auto e = to_srgb(over(premultiply(to_linear(expression(fg))), to_linear(expression(bg))));
+
+    Stf::ThreadPool serial(0);
+    Stf::ThreadPool pool(3);
+
+    const auto a = evaluate<ColorFormat::RGBA8u, ColorSpace::SRGB>(e, serial);
+    const auto b = evaluate<ColorFormat::RGBA8u, ColorSpace::SRGB>(e, pool);
+    ASSERT_TRUE(a && b);
+    ASSERT_TRUE(std::ranges::equal(a->pixels(), b->pixels()));
+}
+
+TEST(Expression, Errors) {
+    const auto a = random_image<FloatImage>({ 4, 4 });
+    const auto b = random_image<FloatImage>({ 4, 3 });
+
+    FloatImage dst {};
+    dst.create({ 4, 4 });
+    ASSERT_EQ(assign(dst, expression(a) + expression(b)).error(), "Image dimensions do not match");
+    ASSERT_EQ(assign(dst, expression(b)).error(), "Image dimensions do not match");
+    ASSERT_EQ((evaluate<ColorFormat::RGBA32f, ColorSpace::Linear>(expression(a) * expression(b)).error()), "Image dimensions do not match");
+    ASSERT_EQ((evaluate<ColorFormat::RGBA32f, ColorSpace::Linear>(constant({})).error()), "Expression has no dimensions");
+
+    // constants fit any image
+    ASSERT_TRUE(assign(dst, constant({ 1.f, 0.f, 0.f, 1.f })));
+    ASSERT_EQ((dst[{ 3, 3 }]), (std::array { 1.f, 0.f, 0.f, 1.f }));
+
+    FloatImage empty {};
+    ASSERT_TRUE(assign(empty, constant({})));
+}
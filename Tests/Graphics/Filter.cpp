@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include <Stuff/Graphics/Filter.hpp>
+
+#include "./Random.hpp"
+
+using namespace Stf::Gfx;
+
+using FloatImage = NewImage<ColorFormat::RGBA32f, ColorSpace::Linear>;
+using ByteImage = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+
+/// The weight of every source pixel along one axis, straight from the definition of the filters in double precision
+template<typename Filter> static std::vector<double> reference_weights(size_t src_size, size_t dst_size, size_t i, Filter const& filter) {
+    const auto scale = static_cast<double>(src_size) / static_cast<double>(dst_size);
+    std::vector<double> ret(src_size);
+
+    // a generous range of source pixels, the ones past the edges go to the edge pixels
+    const auto reach = static_cast<ptrdiff_t>(std::ceil(8. * std::max(scale, 1.))) + 8;
+    const auto center = static_cast<ptrdiff_t>(static_cast<double>(i) * scale);
+    for (auto j = center - reach; j <= center + reach; j++) {
+        const auto x = static_cast<double>(j);
+
+        double w;
+        if constexpr (std::is_same_v<Filter, Filters::Area>)
+            w = std::max(0., std::min(x + 1., (static_cast<double>(i) + 1.) * scale) - std::max(x, static_cast<double>(i) * scale));
+        else
+            w = filter((x - ((static_cast<double>(i) + 0.5) * scale - 0.5)) / std::max(scale, 1.));
+
+        ret[std::clamp<ptrdiff_t>(j, 0, static_cast<ptrdiff_t>(src_size) - 1)] += w;
+    }
+
+    const auto sum = std::accumulate(ret.begin(), ret.end(), 0.);
+    for (auto& w : ret)
+        w /= sum;
+
+    return ret;
+}
+
+template<typename Image, typename Filter> static void check_resample(Image const& src, Stf::Vector<size_t, 2> dimensions, Filter const& filter) {
+    constexpr auto channels = Image::traits::channel_count;
+
+    const auto dst = resize(src, dimensions, filter);
+    ASSERT_EQ(dst.dimensions(), dimensions);
+
+    const auto [src_width, src_height] = src.dimensions();
+    for (auto y = 0uz; y < dimensions[1]; y++) {
+        const auto wy = reference_weights(src_height, dimensions[1], y, filter);
+        for (auto x = 0uz; x < dimensions[0]; x++) {
+            const auto wx = reference_weights(src_width, dimensions[0], x, filter);
+
+            std::array<double, channels> expected {};
+            for (auto sy = 0uz; sy < src_height; sy++) {
+                if (wy[sy] == 0.)
+                    continue;
+                for (auto sx = 0uz; sx < src_width; sx++)
+                    for (auto c = 0uz; c < channels; c++)
+                        expected[c] += wy[sy] * wx[sx] * src[{ sx, sy }][c];
+            }
+
+            for (auto c = 0uz; c < channels; c++)
+                ASSERT_NEAR((dst[{ x, y }][c]), expected[c], 2e-5) << x << ", " << y << " from " << src_width << "x" << src_height;
+        }
+    }
+}
+
+template<typename Filter> static void check_filter(Filter const& filter) {
+    const auto src = random_image<FloatImage>({ 23, 17 });
+
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 23, 17 }, { 11, 8 }, { 5, 3 }, { 40, 30 }, { 1, 1 }, { 23, 1 }, { 7, 17 } })
+        check_resample(src, dimensions, filter);
+}
+
+TEST(Filter, Area) {
+    check_filter(Filters::Area {});
+
+    // a 2x downsample is the average of 2x2 blocks
+    const auto src = random_image<FloatImage>({ 8, 6 });
+    const auto dst = resize(src, { 4, 3 }, Filters::Area {});
+    for (auto y = 0uz; y < 3; y++)
+        for (auto x = 0uz; x < 4; x++)
+            for (auto c = 0uz; c < 4; c++) {
+                const auto expected = (src[{ 2 * x, 2 * y }][c] + src[{ 2 * x + 1, 2 * y }][c] + src[{ 2 * x, 2 * y + 1 }][c] + src[{ 2 * x + 1, 2 * y + 1 }][c]) / 4;
+                ASSERT_NEAR((dst[{ x, y }][c]), expected, 1e-6);
+            }
+}
+
+TEST(Filter, Triangle) { check_filter(Filters::Triangle {}); }
+
+TEST(Filter, Lanczos) {
+    check_filter(Filters::Lanczos {});
+    check_filter(Filters::Lanczos { 2 });
+}
+
+TEST(Filter, Convolve) {
+    const auto src = random_image<FloatImage>({ 31, 9 });
+    check_resample(src, src.dimensions(), Filters::Box { 1 });
+    check_resample(src, src.dimensions(), Filters::Box { 3 });
+    check_resample(src, src.dimensions(), Filters::Gaussian { 1.5 });
+
+    // vectors of channels that split pixels
+    const auto rgb = random_image<NewImage<ColorFormat::RGB32f, ColorSpace::Linear>>({ 45, 7 });
+    check_resample(rgb, rgb.dimensions(), Filters::Box { 2 });
+    check_resample(rgb, rgb.dimensions(), Filters::Gaussian { 0.7 });
+    check_resample(rgb, { 20, 7 }, Filters::Lanczos {});
+
+    // a radius of 1 is the average of the 3x3 neighbourhood in the interior
+    FloatImage dst {};
+    dst.create(src.dimensions());
+    ASSERT_TRUE(convolve(src, dst, Filters::Box { 1 }));
+    for (auto c = 0uz; c < 4; c++) {
+        float expected = 0;
+        for (auto y = 3uz; y < 6; y++)
+            for (auto x = 9uz; x < 12; x++)
+                expected += src[{ x, y }][c];
+        ASSERT_NEAR((dst[{ 10, 4 }][c]), expected / 9, 1e-6);
+    }
+
+    // a Gaussian of no width is the identity
+    for (const auto sigma : { 0., -1. }) {
+        ASSERT_TRUE(convolve(src, dst, Filters::Gaussian { sigma }));
+        ASSERT_TRUE(std::ranges::equal(dst.pixels(), src.pixels()));
+    }
+
+    // and resizes to the nearest pixels
+    const auto nearest = resize(src, { 15, 4 }, Filters::Gaussian { 0. });
+    for (auto y = 0uz; y < 4; y++)
+        for (auto x = 0uz; x < 15; x++) {
+            const auto sx = static_cast<size_t>((static_cast<double>(x) + 0.5) * 31. / 15.);
+            const auto sy = static_cast<size_t>((static_cast<double>(y) + 0.5) * 9. / 4.);
+            ASSERT_EQ((nearest[{ x, y }]), (src[{ sx, sy }])) << x << ", " << y;
+        }
+}
+
+TEST(Filter, Integers) {
+    // same size triangle filtering is the identity
+    const auto src = random_image<ByteImage>({ 67, 13 });
+    const auto same = resize(src, src.dimensions(), Filters::Triangle {});
+    ASSERT_TRUE(std::ranges::equal(same.pixels(), src.pixels()));
+
+    // constants stay constant, the weights sum to 1 and Lanczos overshoots are clamped
+    ByteImage flat {};
+    flat.create({ 50, 40 });
+    flat.fill({ 0, 255, 128, 7 });
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 13, 7 }, { 111, 97 } }) {
+        const auto lanczos = resize(flat, dimensions, Filters::Lanczos {});
+        ASSERT_TRUE(std::ranges::all_of(lanczos.pixels(), [](auto p) { return p == std::array<uint8_t, 4> { 0, 255, 128, 7 }; }));
+    }
+
+    // the ringing around an edge goes past both ends of the range
+    ByteImage edge {};
+    FloatImage float_edge {};
+    edge.create({ 8, 1 });
+    float_edge.create({ 8, 1 });
+    for (auto x = 0uz; x < 8; x++) {
+        edge[x].fill(x < 4 ? 0 : 255);
+        float_edge[x].fill(x < 4 ? 0.f : 255.f);
+    }
+
+    const auto sharp = resize(edge, { 24, 1 }, Filters::Lanczos {});
+    const auto float_sharp = resize(float_edge, { 24, 1 }, Filters::Lanczos {});
+    ASSERT_LT(std::ranges::min(float_sharp.pixels())[0], 0.f);
+    ASSERT_GT(std::ranges::max(float_sharp.pixels())[0], 255.f);
+    for (auto x = 0uz; x < 24; x++)
+        ASSERT_EQ(sharp[x][0], std::round(std::clamp(float_sharp[x][0], 0.f, 255.f))) << x;
+
+    // 16 bit channels round to the nearest
+    NewImage<ColorFormat::RGB16u, ColorSpace::SRGB> wide {};
+    wide.create({ 2, 1 });
+    wide[0] = { 0, 1, 65535 };
+    wide[1] = { 1, 2, 65534 };
+    const auto average = resize(wide, { 1, 1 }, Filters::Area {});
+    ASSERT_EQ(average[0], (std::array<uint16_t, 3> { 1, 2, 65535 }));
+}
+
+TEST(Filter, Parallel) {
+    const auto src = random_image<ByteImage>({ 700, 500 });
+
+    Stf::ThreadPool serial(0);
+    Stf::ThreadPool pool(3);
+
+    const auto a = resize(src, { 301, 777 }, Filters::Lanczos {}, serial);
+    const auto b = resize(src, { 301, 777 }, Filters::Lanczos {}, pool);
+    ASSERT_TRUE(std::ranges::equal(a.pixels(), b.pixels()));
+}
+
+TEST(Filter, Mipmaps) {
+    const auto src = random_image<FloatImage>({ 37, 10 });
+    const auto levels = mipmaps(src);
+
+    const std::vector<Stf::Vector<size_t, 2>> expected_dimensions { { 18, 5 }, { 9, 2 }, { 4, 1 }, { 2, 1 }, { 1, 1 } };
+    ASSERT_EQ(levels.size(), expected_dimensions.size());
+    for (auto i = 0uz; i < levels.size(); i++)
+        ASSERT_EQ(levels[i].dimensions(), expected_dimensions[i]);
+
+    // area filtering keeps the average of power of two images
+    const auto square = random_image<FloatImage>({ 16, 16 });
+    const auto square_levels = mipmaps(square);
+    ASSERT_EQ(square_levels.size(), 4);
+    for (auto c = 0uz; c < 4; c++) {
+        double sum = 0.;
+        for (const auto pixel : square.pixels())
+            sum += pixel[c];
+        ASSERT_NEAR(square_levels.back()[0][c], sum / 256., 1e-5);
+    }
+
+    ASSERT_TRUE(mipmaps(FloatImage {}).empty());
+}
+
+TEST(Filter, Errors) {
+    FloatImage src {};
+    src.create({ 4, 4 });
+
+    FloatImage dst {};
+    dst.create({ 4, 3 });
+    ASSERT_EQ(convolve(src, dst, Filters::Box {}).error(), "Image dimensions do not match");
+
+    auto view = FloatImage::view(src.pixels(), src.dimensions());
+    ASSERT_EQ(resample(src, view).error(), "Can not filter in place");
+
+    ASSERT_EQ(resample(FloatImage {}, dst).error(), "Can not resample an empty image");
+
+    FloatImage empty {};
+    ASSERT_TRUE(resample(src, empty));
+}
@@ -2,10 +2,15 @@
 
 #include <Stuff/Util/Hacks/Try.hpp>
 
+#include <filesystem>
 #include <fstream>
+#include <list>
+#include <random>
 
 #include <Stuff/Files/Format.hpp>
 #include <Stuff/Graphics/Image.hpp>
+#include <Stuff/Graphics/Image/Mapped.hpp>
+#include <Stuff/Graphics/Image/QoIStriped.hpp>
 #include <Stuff/Maths/Check/CRC.hpp>
 
 TEST(Image, Idk) {
@@ -119,3 +124,271 @@ TEST(Image, QoI) {
         .redecode_data = "Tests/Graphics/dice_re.data",
     }.run();
 }
+
+TEST(Image, QoIFastPath) {
+    // every block type, runs of all lengths and a run that ends on the last pixel
+    Stf::Gfx::Image image(97, 61);
+    std::mt19937 engine { 1234 };
+    std::uniform_int_distribution<int> dist { 0, 255 };
+
+    Stf::Gfx::Color color { 0, 0, 0, 255 };
+    for (size_t i = 0; i < image.pixel_count();) {
+        const auto run = std::min<size_t>(dist(engine) % 8 == 0 ? dist(engine) : 1, image.pixel_count() - i);
+        for (size_t j = 0; j < run; j++)
+            image.set_pixel(i++, color);
+
+        switch (dist(engine) % 4) {
+        case 0: color[0] += dist(engine) % 3 - 1; break;
+        case 1: color[1] += dist(engine) % 40 - 20; break;
+        case 2: color = { static_cast<uint8_t>(dist(engine)), static_cast<uint8_t>(dist(engine)), color[2], color[3] }; break;
+        case 3: color[3] = dist(engine) % 2 == 0 ? 255 : dist(engine); break;
+        }
+    }
+
+    std::vector<uint8_t> encoded {};
+    ASSERT_TRUE(Stf::Gfx::Formats::QoI::encode(back_inserter(encoded), image));
+
+    const std::list<uint8_t> encoded_list(encoded.begin(), encoded.end());
+
+    auto contiguous = Stf::Gfx::Formats::QoI::decode(encoded.begin(), encoded.end());
+    auto generic = Stf::Gfx::Formats::QoI::decode(encoded_list.begin(), encoded_list.end());
+    ASSERT_TRUE(contiguous);
+    ASSERT_TRUE(generic);
+    ASSERT_TRUE(std::ranges::equal(*contiguous, image));
+    ASSERT_TRUE(std::ranges::equal(*generic, image));
+
+    // truncated streams fail in both paths
+    for (size_t size = 14; size < encoded.size(); size += 97) {
+        ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode(encoded.begin(), encoded.begin() + size));
+        ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode(encoded_list.begin(), std::next(encoded_list.begin(), size)));
+    }
+
+    // 64 pixels: the first run goes through the unchecked path and the second one overflows in the checked one
+    std::vector<uint8_t> overflowing { 'q', 'o', 'i', 'f', 0, 0, 0, 8, 0, 0, 0, 8, 4, 0, 0xFD, 0xFD, 0, 0, 0, 0, 0, 0, 0, 1 };
+    const auto res = Stf::Gfx::Formats::QoI::decode(overflowing.begin(), overflowing.end());
+    ASSERT_FALSE(res);
+    ASSERT_EQ(res.error(), "Overflow while reading QoI blocks");
+}
+
+TEST(Image, QoIStriped) {
+    std::ifstream ifs("Tests/Graphics/Images/dice.qoi", std::ios::binary);
+    ASSERT_TRUE(ifs);
+    const std::vector<uint8_t> plain(std::istreambuf_iterator<char> { ifs }, std::istreambuf_iterator<char>());
+
+    const auto res_image = Stf::Gfx::Formats::QoI::decode(plain.begin(), plain.end());
+    ASSERT_TRUE(res_image);
+    const auto& image = *res_image;
+
+    Stf::ThreadPool serial(0);
+    Stf::ThreadPool pool(3);
+
+    for (const size_t stripe_height : { 1uz, 7uz, Stf::Gfx::Formats::QoI::default_stripe_height, 600uz, 1000uz }) {
+        std::vector<uint8_t> striped {};
+        ASSERT_TRUE(Stf::Gfx::Formats::QoI::encode_striped(back_inserter(striped), image, stripe_height, pool));
+
+        // the output does not depend on the thread count
+        std::vector<uint8_t> striped_serial {};
+        ASSERT_TRUE(Stf::Gfx::Formats::QoI::encode_striped(back_inserter(striped_serial), image, stripe_height, serial));
+        ASSERT_EQ(striped, striped_serial);
+
+        const auto decoded = Stf::Gfx::Formats::QoI::decode_striped(striped, pool);
+        ASSERT_TRUE(decoded) << decoded.error();
+        ASSERT_TRUE(std::ranges::equal(*decoded, image)) << stripe_height;
+
+        // a single stripe holds exactly the plain QoI chunks
+        if (stripe_height >= image.dimensions()[1]) {
+            ASSERT_EQ(striped.size(), plain.size() + 4 + 8);
+        }
+    }
+
+    std::vector<uint8_t> striped {};
+    ASSERT_TRUE(Stf::Gfx::Formats::QoI::encode_striped(back_inserter(striped), image, 64, pool));
+
+    // plain and striped decoders reject each other's files
+    ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode(striped.begin(), striped.end()));
+    ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode_striped(plain, pool));
+
+    for (size_t size = 0; size < striped.size(); size += 997)
+        ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode_striped(std::span(striped).first(size), pool));
+
+    // swap the sizes of the first two stripes
+    auto corrupted = striped;
+    const auto first_size = Stf::Gfx::Detail::Image::QoI::from_big_endian<uint64_t>(corrupted.data() + 18);
+    const auto second_size = Stf::Gfx::Detail::Image::QoI::from_big_endian<uint64_t>(corrupted.data() + 26) - first_size;
+    std::ranges::copy(Stf::Gfx::Detail::Image::QoI::to_big_endian<uint64_t>(second_size), corrupted.begin() + 18);
+    ASSERT_FALSE(Stf::Gfx::Formats::QoI::decode_striped(corrupted, pool));
+}
+
+TEST(Image, QoIStream) {
+    std::ifstream ifs("Tests/Graphics/Images/dice.qoi", std::ios::binary);
+    ASSERT_TRUE(ifs);
+    const std::vector<uint8_t> plain(std::istreambuf_iterator<char> { ifs }, std::istreambuf_iterator<char>());
+
+    const auto res_image = Stf::Gfx::Formats::QoI::decode(plain.begin(), plain.end());
+    ASSERT_TRUE(res_image);
+    const auto& image = *res_image;
+    const auto [width, height] = image.dimensions();
+
+    std::mt19937 engine { 1234 };
+
+    // max_chunk: largest input chunk, out_size: output buffer size, one row and a few awkward sizes
+    for (const auto& [max_chunk, out_size] : std::initializer_list<std::pair<size_t, size_t>> { { 1, 7 }, { 5, width * 4 }, { 4096, width * 4 }, { 333, 4 * 61 + 3 } }) {
+        std::uniform_int_distribution<size_t> dist { 0, max_chunk };
+
+        Stf::Gfx::Formats::QoI::StreamDecoder decoder {};
+        std::vector<uint8_t> out(out_size);
+        std::vector<uint8_t> decoded {};
+
+        for (size_t in_pos = 0; !decoder.finished();) {
+            const auto chunk = std::min(dist(engine), plain.size() - in_pos);
+            const auto progress = decoder.decode(std::span(plain).subspan(in_pos, chunk), out);
+            ASSERT_TRUE(progress) << progress.error();
+            ASSERT_LE(progress->consumed, chunk);
+            ASSERT_EQ(progress->produced % 4, 0);
+
+            in_pos += progress->consumed;
+            decoded.insert(decoded.end(), out.begin(), out.begin() + progress->produced);
+
+            // not consuming anything with room left means the input was exhausted
+            if (progress->consumed == 0 && progress->produced == 0) {
+                ASSERT_TRUE(chunk == 0 || decoder.finished()) << in_pos;
+            }
+        }
+
+        ASSERT_TRUE(decoder.header());
+        ASSERT_EQ(decoder.header()->dims[0], width);
+        ASSERT_TRUE(std::ranges::equal(decoded, image)) << max_chunk << " " << out_size;
+    }
+
+    for (const auto& [max_in_pixels, max_out] : std::initializer_list<std::pair<size_t, size_t>> { { 1, 1 }, { 17, 5 }, { 1000, 4096 }, { 3, 64 } }) {
+        std::uniform_int_distribution<size_t> in_dist { 0, max_in_pixels * 4 };
+        std::uniform_int_distribution<size_t> out_dist { 0, max_out };
+
+        Stf::Gfx::Formats::QoI::StreamEncoder encoder { *Stf::Gfx::Detail::Image::QoI::Header::from_image(image) };
+        std::vector<uint8_t> out(max_out);
+        std::vector<uint8_t> encoded {};
+
+        const std::span<const uint8_t> pixels(image.data(), image.size());
+        for (size_t in_pos = 0; !encoder.finished();) {
+            const auto chunk = std::min(in_dist(engine), pixels.size() - in_pos);
+            const auto progress = encoder.encode(pixels.subspan(in_pos, chunk), std::span(out).first(out_dist(engine)));
+            ASSERT_EQ(progress.consumed % 4, 0);
+
+            in_pos += progress.consumed;
+            encoded.insert(encoded.end(), out.begin(), out.begin() + progress.produced);
+        }
+
+        ASSERT_EQ(encoded, plain) << max_in_pixels << " " << max_out;
+
+        // nothing is taken past the last pixel
+        const auto after = encoder.encode(pixels.first(4), out);
+        ASSERT_EQ(after.consumed, 0);
+        ASSERT_EQ(after.produced, 0);
+    }
+}
+
+TEST(Image, QoIStreamErrors) {
+    const auto decode_all = [](std::vector<uint8_t> const& data) -> tl::expected<void, std::string_view> {
+        Stf::Gfx::Formats::QoI::StreamDecoder decoder {};
+        std::array<uint8_t, 64> out;
+
+        for (size_t in_pos = 0; in_pos != data.size();) {
+            const auto progress = TRYX(decoder.decode(std::span(data).subspan(in_pos), out));
+            if (progress.consumed == 0 && progress.produced == 0)
+                break;
+            in_pos += progress.consumed;
+        }
+
+        if (!decoder.finished())
+            return tl::unexpected { "Not finished" };
+
+        return {};
+    };
+
+    // 2x1, one RGB chunk and a run of one
+    std::vector<uint8_t> valid { 'q', 'o', 'i', 'f', 0, 0, 0, 2, 0, 0, 0, 1, 4, 0, 0xFE, 1, 2, 3, 0xC0, 0, 0, 0, 0, 0, 0, 0, 1 };
+    ASSERT_TRUE(decode_all(valid));
+
+    auto bad_magic = valid;
+    bad_magic[3] = 'g';
+    ASSERT_EQ(decode_all(bad_magic).error(), "Bad header magic");
+
+    auto bad_end = valid;
+    bad_end.back() = 2;
+    ASSERT_EQ(decode_all(bad_end).error(), "Bad ending bytes");
+
+    auto overflow = valid;
+    overflow[18] = 0xC1;
+    ASSERT_EQ(decode_all(overflow).error(), "Overflow while reading QoI blocks");
+
+    auto truncated = valid;
+    truncated.resize(16);
+    ASSERT_EQ(decode_all(truncated).error(), "Not finished");
+}
+
+TEST(Image, QoIMapped) {
+    const auto image = Stf::Gfx::Formats::QoI::load("Tests/Graphics/Images/dice.qoi");
+    ASSERT_TRUE(image) << image.error();
+    ASSERT_EQ(image_checksum(*image), 0xA53F2646ul);
+
+    ASSERT_EQ(Stf::Gfx::Formats::QoI::load("Tests/Graphics/Images/does_not_exist.qoi").error(), "Could not map the file");
+}
+
+TEST(Image, RawMapped) {
+    using namespace Stf::Gfx;
+    using image_type = NewImage<ColorFormat::RGBA32f, ColorSpace::Linear>;
+
+    image_type image {};
+    image.create({ 37, 23 });
+    for (auto i = 0uz; i < image.pixel_count(); i++)
+        image[i] = { static_cast<float>(i), static_cast<float>(i % 37) / 37.f, -1.f, 0.5f };
+
+    std::vector<uint8_t> encoded {};
+    Formats::Raw::encode(back_inserter(encoded), image);
+    ASSERT_EQ(encoded.size(), Formats::Raw::alignment + image.size());
+
+    const auto filename = (std::filesystem::temp_directory_path() / "libstuff_raw_mapped.raw").string();
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ASSERT_TRUE(ofs);
+        std::ranges::copy(encoded, std::ostreambuf_iterator<char>(ofs));
+    }
+
+    {
+        const auto mapped = MappedImage<ColorFormat::RGBA32f, ColorSpace::Linear>::open(filename);
+        ASSERT_TRUE(mapped) << mapped.error();
+        ASSERT_FALSE(mapped->image().owning());
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(mapped->image().data()) % Formats::Raw::alignment, 0);
+        ASSERT_EQ(mapped->image().dimensions(), image.dimensions());
+        ASSERT_TRUE(std::ranges::equal(mapped->image().pixels(), image.pixels()));
+
+        const auto loaded = Formats::Raw::load<ColorFormat::RGBA32f, ColorSpace::Linear>(filename);
+        ASSERT_TRUE(loaded) << loaded.error();
+        ASSERT_TRUE(loaded->owning());
+        ASSERT_TRUE(std::ranges::equal(loaded->pixels(), image.pixels()));
+
+        const auto mismatched = MappedImage<ColorFormat::RGBA8u, ColorSpace::Linear>::open(filename);
+        ASSERT_EQ(mismatched.error(), "Image metadata does not match header metadata");
+    }
+
+    std::filesystem::remove(filename);
+
+    // views share the pixels and moves hand them over
+    auto view = image_type::view(image.pixels(), image.dimensions());
+    view[{ 1, 1 }] = { 1.f, 2.f, 3.f, 4.f };
+    ASSERT_EQ(image[image.coords_to_index({ 1, 1 })], (std::array { 1.f, 2.f, 3.f, 4.f }));
+
+    auto moved = std::move(image);
+    ASSERT_EQ(image.data(), nullptr);
+    ASSERT_TRUE(moved.owning());
+    ASSERT_EQ(moved.data(), view.data());
+
+    const auto truncated = std::span(encoded).first(encoded.size() - 1);
+    ASSERT_EQ(
+      (Formats::Raw::decode<ColorFormat::RGBA32f, ColorSpace::Linear>(truncated).error()), "Insufficient data (while reading the pixels)"
+    );
+
+    auto misaligned = encoded;
+    misaligned[32] = 48;
+    ASSERT_EQ((Formats::Raw::decode<ColorFormat::RGBA32f, ColorSpace::Linear>(misaligned).error()), "Bad pixel offset");
+}
@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include <Stuff/Graphics/Tiles.hpp>
+
+using namespace Stf::Gfx;
+
+using TestTraits = ColorTraits<ColorFormat::RGBA8u, ColorSpace::SRGB>;
+
+template<typename Layout>
+using TestImage = NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB, TestTraits, std::allocator<TestTraits::color_type>, Layout>;
+
+static std::array<uint8_t, 4> color_at(size_t x, size_t y) {
+    return { static_cast<uint8_t>(x), static_cast<uint8_t>(x >> 8), static_cast<uint8_t>(y), static_cast<uint8_t>(y >> 8) };
+}
+
+/// Every pixel has its own index within the storage
+template<typename Layout> static void check_bijective(Stf::Vector<size_t, 2> dimensions) {
+    const Layout layout(dimensions);
+    ASSERT_GE(layout.storage_count(), dimensions[0] * dimensions[1]);
+
+    std::vector<bool> seen(layout.storage_count());
+    for (auto y = 0uz; y < dimensions[1]; y++) {
+        for (auto x = 0uz; x < dimensions[0]; x++) {
+            const auto index = layout({ x, y });
+            ASSERT_LT(index, layout.storage_count()) << x << ", " << y;
+            ASSERT_FALSE(seen[index]) << x << ", " << y;
+            seen[index] = true;
+
+            // the runs the layout promises are contiguous
+            if (x % Layout::contiguous_run != 0) {
+                ASSERT_EQ(index, layout({ x - 1, y }) + 1);
+            }
+        }
+    }
+}
+
+template<typename Layout> static void check_layout() {
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 1, 1 }, { 67, 5 }, { 5, 67 }, { 64, 64 }, { 100, 37 }, { 1, 130 } })
+        check_bijective<Layout>(dimensions);
+
+    check_bijective<Layout>({ 0, 0 });
+    check_bijective<Layout>({ 3, 0 });
+}
+
+TEST(Layout, Linear) { check_layout<Layouts::Linear>(); }
+
+TEST(Layout, Tiled) {
+    check_layout<Layouts::Tiled<8>>();
+    check_layout<Layouts::Tiled<4, 16>>();
+
+    const Layouts::Tiled<8> layout({ 20, 20 });
+    ASSERT_EQ(layout.storage_count(), 24 * 24);
+    ASSERT_EQ(layout({ 7, 0 }), 7);
+    ASSERT_EQ(layout({ 0, 1 }), 8);
+    ASSERT_EQ(layout({ 8, 0 }), 64);
+    ASSERT_EQ(layout({ 0, 8 }), 3 * 64);
+}
+
+TEST(Layout, Morton) {
+    check_layout<Layouts::Morton>();
+
+    const Layouts::Morton square({ 8, 8 });
+    ASSERT_EQ(square.storage_count(), 64);
+    ASSERT_EQ(square({ 1, 0 }), 1);
+    ASSERT_EQ(square({ 0, 1 }), 2);
+    ASSERT_EQ(square({ 2, 0 }), 4);
+    ASSERT_EQ(square({ 7, 7 }), 63);
+    ASSERT_EQ(square({ 5, 3 }), 0b011011);
+
+    // the 4x4 blocks of a wide image follow each other
+    const Layouts::Morton wide({ 16, 3 });
+    ASSERT_EQ(wide.storage_count(), 64);
+    ASSERT_EQ(wide({ 3, 3 }), 15);
+    ASSERT_EQ(wide({ 4, 0 }), 16);
+    ASSERT_EQ(wide({ 12, 1 }), 50);
+
+    for (auto v = 0u; v < 1u << 16; v += 7)
+        ASSERT_EQ(Layouts::Detail::spread_bits(v), [v] {
+            uint64_t ret = 0;
+            for (auto bit = 0u; bit < 32; bit++)
+                ret |= static_cast<uint64_t>((v >> bit) & 1) << (2 * bit);
+            return ret;
+        }());
+}
+
+TEST(Layout, Tiles) {
+    const TileGrid grid({ 67, 5 }, { 16, 4 });
+    ASSERT_EQ(grid.size(), 10);
+    ASSERT_EQ(grid[4].origin, (Stf::Vector<size_t, 2> { 64, 0 }));
+    ASSERT_EQ(grid[4].extent, (Stf::Vector<size_t, 2> { 3, 4 }));
+    ASSERT_EQ(grid[9].extent, (Stf::Vector<size_t, 2> { 3, 1 }));
+
+    // every pixel is in exactly one tile
+    std::vector<std::atomic_int> hits(67 * 5);
+    Stf::ThreadPool pool(3);
+    for_each_tile(grid, pool, [&](Tile tile) {
+        for (auto y = tile.origin[1]; y < tile.origin[1] + tile.extent[1]; y++)
+            for (auto x = tile.origin[0]; x < tile.origin[0] + tile.extent[0]; x++)
+                hits[x + y * 67]++;
+    });
+    ASSERT_TRUE(std::ranges::all_of(hits, [](auto const& v) { return v == 1; }));
+
+    size_t count = 0;
+    for (const auto tile : grid)
+        count += tile.extent[0] * tile.extent[1];
+    ASSERT_EQ(count, 67 * 5);
+}
+
+template<typename SrcLayout, typename DstLayout> static void check_relayout(Stf::ThreadPool& pool) {
+    TestImage<SrcLayout> src {};
+    src.create({ 131, 70 });
+    for (auto y = 0uz; y < 70; y++)
+        for (auto x = 0uz; x < 131; x++)
+            src[{ x, y }] = color_at(x, y);
+
+    const auto dst = relayout<DstLayout>(src, pool);
+    ASSERT_EQ(dst.dimensions(), src.dimensions());
+    for (auto y = 0uz; y < 70; y++)
+        for (auto x = 0uz; x < 131; x++)
+            ASSERT_EQ((dst[{ x, y }]), color_at(x, y)) << x << ", " << y;
+}
+
+TEST(Layout, Relayout) {
+    Stf::ThreadPool pool(2);
+
+    check_relayout<Layouts::Linear, Layouts::Tiled<8>>(pool);
+    check_relayout<Layouts::Tiled<8>, Layouts::Linear>(pool);
+    check_relayout<Layouts::Linear, Layouts::Morton>(pool);
+    check_relayout<Layouts::Morton, Layouts::Linear>(pool);
+    check_relayout<Layouts::Tiled<64>, Layouts::Morton>(pool);
+    check_relayout<Layouts::Tiled<4, 16>, Layouts::Tiled<16, 4>>(pool);
+    check_relayout<Layouts::Morton, Layouts::Morton>(pool);
+
+    TestImage<Layouts::Linear> src {};
+    src.create({ 4, 4 });
+
+    TestImage<Layouts::Morton> dst {};
+    dst.create({ 4, 3 });
+    ASSERT_EQ(relayout(src, dst, pool).error(), "Image dimensions do not match");
+
+    auto view = TestImage<Layouts::Linear>::view(src.pixels(), src.dimensions());
+    ASSERT_EQ(relayout(src, view, pool).error(), "Can not convert in place");
+}
+
+TEST(Layout, Image) {
+    TestImage<Layouts::Tiled<8>> image {};
+    image.create({ 20, 3 });
+    ASSERT_EQ(image.pixel_count(), 60);
+    ASSERT_EQ(image.storage_count(), 3 * 64);
+    ASSERT_EQ(image.pixels().size(), image.storage_count());
+    ASSERT_EQ(image.size(), image.storage_count() * 4);
+
+    image.fill({ 1, 2, 3, 4 });
+    image[{ 9, 2 }] = { 5, 6, 7, 8 };
+    ASSERT_EQ(image[64 + 2 * 8 + 1], (std::array<uint8_t, 4> { 5, 6, 7, 8 }));
+
+    auto moved = std::move(image);
+    ASSERT_EQ(image.storage_count(), 0);
+    ASSERT_EQ((moved[{ 9, 2 }]), (std::array<uint8_t, 4> { 5, 6, 7, 8 }));
+    ASSERT_EQ(moved.tiles().size(), 3);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include <Stuff/Graphics/Image/Mapped.hpp>
+#include <Stuff/Graphics/Image/PNM.hpp>
+
+#include "./Random.hpp"
+
+using namespace Stf::Gfx;
+
+static std::vector<uint8_t> bytes_of(std::string_view header, std::initializer_list<uint8_t> samples) {
+    std::vector<uint8_t> ret(header.begin(), header.end());
+    ret.insert(ret.end(), samples);
+    return ret;
+}
+
+template<ColorFormat Format> static void check_round_trip(Stf::Vector<size_t, 2> dimensions, std::string_view magic) {
+    using Image = NewImage<Format, ColorSpace::SRGB>;
+    const auto image = random_image<Image>(dimensions);
+
+    std::vector<uint8_t> encoded {};
+    Formats::PNM::encode(back_inserter(encoded), image);
+    ASSERT_TRUE(std::ranges::equal(std::span(encoded).first(2), magic));
+
+    const auto decoded = Formats::PNM::decode<Format, ColorSpace::SRGB>(encoded);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ASSERT_EQ(decoded->dimensions(), dimensions);
+    ASSERT_TRUE(std::ranges::equal(decoded->pixels(), image.pixels()));
+}
+
+TEST(PNM, RoundTrip) {
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 1, 1 }, { 5, 3 }, { 37, 5 }, { 300, 7 } }) {
+        check_round_trip<ColorFormat::RGB8u>(dimensions, "P6");
+        check_round_trip<ColorFormat::RGBA8u>(dimensions, "P7");
+        check_round_trip<ColorFormat::BGRA8u>(dimensions, "P7");
+        check_round_trip<ColorFormat::RGB16u>(dimensions, "P6");
+        check_round_trip<ColorFormat::RGBA16u>(dimensions, "P7");
+    }
+
+    NewImage<ColorFormat::RGBA16u, ColorSpace::Linear> image {};
+    image.create({ 2, 1 });
+    image[0] = { 0x0102, 0x0304, 0x0506, 0x0708 };
+    image[1] = { 0xFFFF, 0, 1, 256 };
+
+    std::vector<uint8_t> encoded {};
+    Formats::PNM::encode(back_inserter(encoded), image);
+
+    const std::string_view header = "P7\nWIDTH 2\nHEIGHT 1\nDEPTH 4\nMAXVAL 65535\nTUPLTYPE RGB_ALPHA\nENDHDR\n";
+    ASSERT_EQ(encoded, bytes_of(header, { 1, 2, 3, 4, 5, 6, 7, 8, 0xFF, 0xFF, 0, 0, 0, 1, 1, 0 }));
+}
+
+TEST(PNM, Files) {
+    // comments anywhere between the numbers
+    const auto ppm = bytes_of("P6 # comment\n2 1\n#another\n255\n", { 1, 2, 3, 4, 5, 6 });
+
+    const auto bgra = Formats::PNM::decode<ColorFormat::BGRA8u, ColorSpace::SRGB>(ppm);
+    ASSERT_TRUE(bgra) << bgra.error();
+    ASSERT_EQ((*bgra)[0], (std::array<uint8_t, 4> { 3, 2, 1, 255 }));
+    ASSERT_EQ((*bgra)[1], (std::array<uint8_t, 4> { 6, 5, 4, 255 }));
+
+    // 8 bit samples into 16 bit channels are rescaled
+    const auto wide = Formats::PNM::decode<ColorFormat::RGB16u, ColorSpace::SRGB>(ppm);
+    ASSERT_TRUE(wide) << wide.error();
+    ASSERT_EQ((*wide)[1], (std::array<uint16_t, 3> { 4 * 257, 5 * 257, 6 * 257 }));
+
+    // 10 bit grayscale
+    const auto pgm = bytes_of("P5\n3 1\n1023\n", { 0, 0, 0x02, 0x00, 0x03, 0xFF });
+    const auto gray = Formats::PNM::decode<ColorFormat::RGBA8u, ColorSpace::Linear>(pgm);
+    ASSERT_TRUE(gray) << gray.error();
+    ASSERT_EQ((*gray)[0], (std::array<uint8_t, 4> { 0, 0, 0, 255 }));
+    ASSERT_EQ((*gray)[1], (std::array<uint8_t, 4> { 128, 128, 128, 255 }));
+    ASSERT_EQ((*gray)[2], (std::array<uint8_t, 4> { 255, 255, 255, 255 }));
+
+    // gray and alpha, into a format without alpha
+    const auto pam = bytes_of("P7\nWIDTH 2\nHEIGHT 1\nDEPTH 2\nMAXVAL 255\nTUPLTYPE GRAYSCALE_ALPHA\nENDHDR\n", { 10, 20, 30, 40 });
+    const auto rgb = Formats::PNM::decode<ColorFormat::RGB8u, ColorSpace::SRGB>(pam);
+    ASSERT_TRUE(rgb) << rgb.error();
+    ASSERT_EQ((*rgb)[0], (std::array<uint8_t, 3> { 10, 10, 10 }));
+    ASSERT_EQ((*rgb)[1], (std::array<uint8_t, 3> { 30, 30, 30 }));
+
+    const auto header = Formats::PNM::Header::from_bytes(pam);
+    ASSERT_TRUE(header);
+    ASSERT_EQ(header->kind, Formats::PNM::Kind::PAM);
+    ASSERT_EQ(header->depth, 2);
+    ASSERT_EQ(header->data_offset, pam.size() - 4);
+}
+
+TEST(PNM, Errors) {
+    const auto decode = [](std::vector<uint8_t> const& data) { return Formats::PNM::decode<ColorFormat::RGB8u, ColorSpace::SRGB>(data); };
+
+    ASSERT_EQ(decode(bytes_of("P3\n1 1\n255\n", { 1, 2, 3 })).error(), "Bad header magic");
+    ASSERT_EQ(decode(bytes_of("P6\n1 1\n255", {})).error(), "Insufficient data (while reading the header)");
+    ASSERT_EQ(decode(bytes_of("P6\n1 x\n255\n", { 1, 2, 3 })).error(), "Bad header number");
+    ASSERT_EQ(decode(bytes_of("P6\n0 1\n255\n", {})).error(), "Bad header dimensions");
+    ASSERT_EQ(decode(bytes_of("P6\n1 1\n65536\n", { 1, 2, 3 })).error(), "Bad maximum value");
+    ASSERT_EQ(decode(bytes_of("P6\n1 1\n99999999999\n", { 1, 2, 3 })).error(), "Bad header number");
+    ASSERT_EQ(decode(bytes_of("P6\n2 1\n255\n", { 1, 2, 3 })).error(), "Insufficient data (while reading the pixels)");
+    ASSERT_EQ(decode(bytes_of("P6\n1 1\n65535\n", { 1, 2, 3 })).error(), "Insufficient data (while reading the pixels)");
+    ASSERT_EQ(decode(bytes_of("P7\nWIDTH 1\nHEIGHT 1\nDEPTH 5\nMAXVAL 255\nENDHDR\n", { 1, 2, 3, 4, 5 })).error(), "Unsupported depth, only 1 to 4 channels are supported");
+    ASSERT_EQ(decode(bytes_of("P7\nWIDTH 1\nHEIGHT 1\nDEPTHS 3\n", {})).error(), "Bad header keyword");
+    ASSERT_EQ(decode(bytes_of("P7\nWIDTH 1\nHEIGHT 1\nDEPTH 3\nMAXVAL 255\n", {})).error(), "Insufficient data (while reading the header)");
+}
+
+TEST(PNM, Mapped) {
+    const auto image = random_image<NewImage<ColorFormat::RGB16u, ColorSpace::SRGB>>({ 123, 45 });
+
+    const auto filename = (std::filesystem::temp_directory_path() / "libstuff_pnm_mapped.ppm").string();
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ASSERT_TRUE(ofs);
+        Formats::PNM::encode(std::ostreambuf_iterator<char>(ofs), image);
+    }
+
+    const auto loaded = Formats::PNM::load<ColorFormat::RGB16u, ColorSpace::SRGB>(filename);
+    std::filesystem::remove(filename);
+
+    ASSERT_TRUE(loaded) << loaded.error();
+    ASSERT_TRUE(std::ranges::equal(loaded->pixels(), image.pixels()));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Stuff/Graphics/Image.hpp>
+
+#include <limits>
+#include <random>
+#include <type_traits>
+
+/// An image of uniformly distributed channels: in [0, 1) for floating point ones, over the whole range for integers
+template<typename Image> Image random_image(Stf::Vector<size_t, 2> dimensions, uint32_t seed = 1234) {
+    using T = typename Image::channel_type;
+
+    std::mt19937 engine { seed };
+
+    Image ret {};
+    ret.create(dimensions);
+    for (auto& pixel : ret.pixels()) {
+        for (auto& channel : pixel) {
+            if constexpr (std::is_floating_point_v<T>) {
+                channel = std::uniform_real_distribution<T>(0, 1)(engine);
+            } else {
+                // there are no distributions of char sized types
+                using U = std::common_type_t<T, unsigned>;
+                channel = static_cast<T>(std::uniform_int_distribution<U>(0, std::numeric_limits<T>::max())(engine));
+            }
+        }
+    }
+
+    return ret;
+}
@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+#include <Stuff/Graphics/Image/Mapped.hpp>
+#include <Stuff/Graphics/Image/TGA.hpp>
+
+using namespace Stf::Gfx;
+
+/// Random pixels with runs of identical ones mixed in
+template<typename Image> static Image runny_image(Stf::Vector<size_t, 2> dimensions, uint32_t seed = 1234) {
+    std::mt19937 engine { seed };
+
+    Image ret {};
+    ret.create(dimensions);
+
+    typename Image::color_type color {};
+    for (auto& pixel : ret.pixels()) {
+        if (engine() % 4 != 0)
+            for (auto& channel : color)
+                channel = static_cast<uint8_t>(engine());
+        pixel = color;
+    }
+
+    return ret;
+}
+
+template<ColorFormat Format> static void check_round_trip(Stf::Vector<size_t, 2> dimensions, bool rle) {
+    using Image = NewImage<Format, ColorSpace::SRGB>;
+    const auto image = runny_image<Image>(dimensions);
+
+    std::vector<uint8_t> encoded {};
+    ASSERT_TRUE(Formats::TGA::encode(back_inserter(encoded), image, rle));
+    if (!rle) {
+        ASSERT_EQ(encoded.size(), 18 + image.size());
+    }
+
+    const auto decoded = Formats::TGA::decode<Format, ColorSpace::SRGB>(encoded);
+    ASSERT_TRUE(decoded) << decoded.error();
+    ASSERT_EQ(decoded->dimensions(), dimensions);
+    ASSERT_TRUE(std::ranges::equal(decoded->pixels(), image.pixels()));
+
+    // into a format with the channels in another order
+    const auto swizzled = Formats::TGA::decode<ColorFormat::RGBA8u, ColorSpace::SRGB>(encoded);
+    ASSERT_TRUE(swizzled) << swizzled.error();
+    for (auto i = 0uz; i < image.pixel_count(); i++) {
+        const auto expected = Format == ColorFormat::BGRA8u ? std::array { image[i][2], image[i][1], image[i][0], image[i][3] }
+                            : Format == ColorFormat::RGB8u  ? std::array<uint8_t, 4> { image[i][0], image[i][1], image[i][2], 255 }
+                                                            : std::array { image[i][0], image[i][1], image[i][2], image[i][3] };
+        ASSERT_EQ((*swizzled)[i], expected) << i;
+    }
+}
+
+TEST(TGA, RoundTrip) {
+    // rows shorter than, as long as and longer than a shuffle and a packet
+    for (const auto dimensions : { Stf::Vector<size_t, 2> { 1, 1 }, { 5, 3 }, { 16, 2 }, { 37, 5 }, { 300, 7 } }) {
+        for (const auto rle : { false, true }) {
+            check_round_trip<ColorFormat::RGBA8u>(dimensions, rle);
+            check_round_trip<ColorFormat::BGRA8u>(dimensions, rle);
+            check_round_trip<ColorFormat::RGB8u>(dimensions, rle);
+        }
+    }
+
+    // runs are packed
+    NewImage<ColorFormat::RGB8u, ColorSpace::SRGB> flat {};
+    flat.create({ 1000, 10 });
+    flat.fill({ 1, 2, 3 });
+
+    std::vector<uint8_t> encoded {};
+    ASSERT_TRUE(Formats::TGA::encode(back_inserter(encoded), flat, true));
+    ASSERT_EQ(encoded.size(), 18 + 10 * 8 * 4);
+}
+
+TEST(TGA, Files) {
+    // 2x2, bottom to top, with an image ID and a color map to skip
+    // clang-format off
+    const std::vector<uint8_t> bgr {
+        3, 1, 2, 0, 0, 2, 0, 24, 0, 0, 0, 0, 2, 0, 2, 0, 24, 0,
+        'i', 'd', '!',
+        0xAA, 0xAA, 0xAA, 0xBB, 0xBB, 0xBB,
+        1, 2, 3, 4, 5, 6,
+        7, 8, 9, 10, 11, 12,
+    };
+    // clang-format on
+
+    const auto image = Formats::TGA::decode<ColorFormat::BGRA8u, ColorSpace::SRGB>(bgr);
+    ASSERT_TRUE(image) << image.error();
+    ASSERT_EQ((*image)[0], (std::array<uint8_t, 4> { 7, 8, 9, 255 }));
+    ASSERT_EQ((*image)[1], (std::array<uint8_t, 4> { 10, 11, 12, 255 }));
+    ASSERT_EQ((*image)[2], (std::array<uint8_t, 4> { 1, 2, 3, 255 }));
+    ASSERT_EQ((*image)[3], (std::array<uint8_t, 4> { 4, 5, 6, 255 }));
+
+    // 3x2 RLE grayscale, top to bottom, with packets crossing the row
+    // clang-format off
+    const std::vector<uint8_t> gray {
+        0, 0, 11, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 2, 0, 8, 0x20,
+        0x83, 50,
+        0x01, 60, 70,
+    };
+    // clang-format on
+
+    const auto gray_image = Formats::TGA::decode<ColorFormat::RGB8u, ColorSpace::Linear>(gray);
+    ASSERT_TRUE(gray_image) << gray_image.error();
+    for (auto i = 0uz; i < 4; i++)
+        ASSERT_EQ((*gray_image)[i], (std::array<uint8_t, 3> { 50, 50, 50 }));
+    ASSERT_EQ((*gray_image)[4], (std::array<uint8_t, 3> { 60, 60, 60 }));
+    ASSERT_EQ((*gray_image)[5], (std::array<uint8_t, 3> { 70, 70, 70 }));
+}
+
+TEST(TGA, Errors) {
+    NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB> image {};
+    image.create({ 4, 4 });
+    image.fill({ 1, 2, 3, 4 });
+
+    std::vector<uint8_t> valid {};
+    ASSERT_TRUE(Formats::TGA::encode(back_inserter(valid), image, true));
+
+    const auto decode = [](std::span<const uint8_t> data) { return Formats::TGA::decode<ColorFormat::RGBA8u, ColorSpace::SRGB>(data); };
+
+    ASSERT_TRUE(decode(valid));
+    ASSERT_EQ(decode(std::span(valid).first(10)).error(), "Insufficient data (while reading the header)");
+    ASSERT_EQ(decode(std::span(valid).first(valid.size() - 1)).error(), "Insufficient data (while reading RLE packets)");
+
+    auto bad = valid;
+    bad[2] = 1;
+    ASSERT_EQ(decode(bad).error(), "Unsupported image type, only true color and grayscale images are supported");
+
+    bad = valid;
+    bad[16] = 16;
+    ASSERT_EQ(decode(bad).error(), "Unsupported pixel depth");
+
+    bad = valid;
+    bad[17] |= 0x10;
+    ASSERT_EQ(decode(bad).error(), "Unsupported pixel order (right to left)");
+
+    bad = valid;
+    bad[0] = 255;
+    ASSERT_EQ(decode(bad).error(), "Insufficient data (while reading the image ID and the color map)");
+
+    std::vector<uint8_t> uncompressed {};
+    ASSERT_TRUE(Formats::TGA::encode(back_inserter(uncompressed), image));
+    ASSERT_EQ(decode(std::span(uncompressed).first(uncompressed.size() - 1)).error(), "Insufficient data (while reading the pixels)");
+
+    NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB> wide {};
+    wide.create({ 65536, 1 });
+    ASSERT_EQ(Formats::TGA::encode(back_inserter(uncompressed), wide).error(), "Image is too large, TGA dimensions are at most 65535");
+}
+
+TEST(TGA, Mapped) {
+    const auto image = runny_image<NewImage<ColorFormat::RGBA8u, ColorSpace::SRGB>>({ 123, 45 });
+
+    const auto filename = (std::filesystem::temp_directory_path() / "libstuff_tga_mapped.tga").string();
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        ASSERT_TRUE(ofs);
+        ASSERT_TRUE(Formats::TGA::encode(std::ostreambuf_iterator<char>(ofs), image, true));
+    }
+
+    const auto loaded = Formats::TGA::load<ColorFormat::RGBA8u, ColorSpace::SRGB>(filename);
+    std::filesystem::remove(filename);
+
+    ASSERT_TRUE(loaded) << loaded.error();
+    ASSERT_TRUE(std::ranges::equal(loaded->pixels(), image.pixels()));
+
+    ASSERT_EQ((Formats::TGA::load<ColorFormat::RGBA8u, ColorSpace::SRGB>(filename).error()), "Could not map the file");
+}
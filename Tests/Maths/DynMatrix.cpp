@@ -0,0 +1,164 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include <Stuff/Maths/BLAS/Dynamic.hpp>
+
+template<typename T> static Stf::DynMatrix<T> random_matrix(size_t rows, size_t cols, std::mt19937_64& gen) {
+    std::uniform_real_distribution<T> dist(-1, 1);
+
+    Stf::DynMatrix<T> ret(rows, cols);
+    for (auto i = 0uz; i < rows; i++)
+        for (auto j = 0uz; j < cols; j++)
+            ret.at(i, j) = dist(gen);
+
+    return ret;
+}
+
+template<typename T> static Stf::DynMatrix<T> naive_product(Stf::DynMatrix<T> const& a, Stf::DynMatrix<T> const& b) {
+    Stf::DynMatrix<T> ret(a.rows(), b.cols());
+
+    for (auto i = 0uz; i < a.rows(); i++)
+        for (auto j = 0uz; j < b.cols(); j++) {
+            double sum = 0;
+            for (auto k = 0uz; k < a.cols(); k++)
+                sum += static_cast<double>(a.at(i, k)) * b.at(k, j);
+            ret.at(i, j) = static_cast<T>(sum);
+        }
+
+    return ret;
+}
+
+TEST(DynMatrix, StaticInterop) {
+    const auto mat = Stf::Matrix<float, 2, 3> { 1, 2, 3, 4, 5, 6 };
+    const Stf::DynMatrix<float> dyn(mat);
+
+    ASSERT_EQ(dyn.rows(), 2);
+    ASSERT_EQ(dyn.cols(), 3);
+    ASSERT_EQ(dyn.at(1, 0), 4.f);
+
+    const Stf::DynMatrix<float> dyn_t(Stf::transpose(mat));
+    ASSERT_EQ(dyn_t.rows(), 3);
+    ASSERT_EQ(dyn_t.at(2, 1), 6.f);
+
+    const auto back = dyn.to_static<2, 3>();
+    for (auto i = 0uz; i < 6; i++)
+        ASSERT_EQ(back.data[i], mat.data[i]);
+
+    const Stf::DynVector<float> vec(Stf::vector<float>(1, 1, 1));
+    const auto prod = dyn * vec;
+    ASSERT_EQ(prod.size(), 2);
+    ASSERT_FLOAT_EQ(prod[0], 6.f);
+    ASSERT_FLOAT_EQ(prod[1], 15.f);
+}
+
+TEST(DynMatrix, GEMM) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    Stf::ThreadPool pool(3);
+
+    const std::array<std::array<size_t, 3>, 6> shapes { {
+      { 1, 1, 1 },
+      { 7, 5, 3 },
+      { 31, 17, 29 },
+      { 64, 64, 64 },
+      { 130, 70, 300 },
+      { 257, 129, 513 },
+    } };
+
+    for (auto [m, k, n] : shapes) {
+        const auto a = random_matrix<float>(m, k, gen);
+        const auto b = random_matrix<float>(k, n, gen);
+        auto c = random_matrix<float>(m, n, gen);
+        const auto c_prev = c;
+
+        ASSERT_TRUE(Stf::gemm(2.f, a, b, 0.5f, c, pool));
+
+        const auto expected = naive_product(a, b);
+        for (auto i = 0uz; i < m; i++)
+            for (auto j = 0uz; j < n; j++)
+                ASSERT_NEAR(c.at(i, j), 2.f * expected.at(i, j) + 0.5f * c_prev.at(i, j), 1e-3f * k);
+    }
+
+    const auto a = random_matrix<double>(45, 33, gen);
+    const auto b = random_matrix<double>(33, 21, gen);
+    const auto c = a * b;
+    const auto expected = naive_product(a, b);
+    for (auto i = 0uz; i < c.rows(); i++)
+        for (auto j = 0uz; j < c.cols(); j++)
+            ASSERT_NEAR(c.at(i, j), expected.at(i, j), 1e-12);
+}
+
+TEST(DynMatrix, GEMV) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+
+    const auto a = random_matrix<double>(67, 131, gen);
+    const auto x_mat = random_matrix<double>(131, 1, gen);
+    const Stf::DynVector<double> x(std::span<const double>(x_mat.data(), 131));
+    Stf::DynVector<double> y(67, 1.);
+
+    ASSERT_TRUE(Stf::gemv(1., a, x, -1., y));
+
+    const auto expected = naive_product(a, x_mat);
+    for (auto i = 0uz; i < 67; i++)
+        ASSERT_NEAR(y[i], expected.at(i, 0) - 1., 1e-12);
+}
+
+TEST(DynMatrix, MismatchedShapes) {
+    const Stf::DynMatrix<float> a(4, 3, 1.f);
+    const Stf::DynMatrix<float> b(2, 5, 1.f);
+    Stf::DynMatrix<float> c(4, 5, 7.f);
+
+    ASSERT_FALSE(Stf::gemm(1.f, a, b, 0.f, c));
+    ASSERT_EQ(c.at(3, 4), 7.f);
+
+    const Stf::DynMatrix<float> b_ok(3, 5, 1.f);
+    Stf::DynMatrix<float> c_wrong(5, 4);
+    ASSERT_FALSE(Stf::gemm(1.f, a, b_ok, 0.f, c_wrong));
+    ASSERT_TRUE(Stf::gemm(1.f, a, b_ok, 0.f, c));
+    ASSERT_EQ(c.at(3, 4), 3.f);
+
+    const Stf::DynVector<float> x(2, 1.f);
+    Stf::DynVector<float> y(4);
+    ASSERT_FALSE(Stf::gemv(1.f, a, x, 0.f, y));
+
+    const Stf::DynVector<float> x_ok(3, 1.f);
+    Stf::DynVector<float> y_wrong(3);
+    ASSERT_FALSE(Stf::gemv(1.f, a, x_ok, 0.f, y_wrong));
+    ASSERT_TRUE(Stf::gemv(1.f, a, x_ok, 0.f, y));
+    ASSERT_EQ(y[3], 3.f);
+}
+
+TEST(DynMatrix, Solvers) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    const size_t n = 96;
+
+    const auto a = random_matrix<double>(n, n, gen);
+    auto spd = a * a.transposed();
+    for (auto i = 0uz; i < n; i++)
+        spd.at(i, i) += 1.;
+
+    Stf::DynVector<double> b(n);
+    for (auto i = 0uz; i < n; i++)
+        b[i] = static_cast<double>(i) - 48.;
+
+    const auto lu = Stf::lu_decompose(a);
+    ASSERT_TRUE(lu);
+    const auto x_lu = lu->solve(b);
+    const auto b_lu = a * x_lu;
+    for (auto i = 0uz; i < n; i++)
+        ASSERT_NEAR(b_lu[i], b[i], 1e-8);
+
+    const auto chol = Stf::cholesky_decompose(spd);
+    ASSERT_TRUE(chol);
+    const auto x_chol = chol->solve(b);
+    const auto b_chol = spd * x_chol;
+    for (auto i = 0uz; i < n; i++)
+        ASSERT_NEAR(b_chol[i], b[i], 1e-8);
+
+    const auto det = Stf::lu_decompose(Stf::DynMatrix<double>(Stf::Matrix<double, 2, 2> { 4, 3, 6, 3 }));
+    ASSERT_TRUE(det);
+    ASSERT_NEAR(det->determinant(), -6., 1e-12);
+
+    ASSERT_FALSE(Stf::lu_decompose(Stf::DynMatrix<double>(3, 3, 1.)));
+    ASSERT_FALSE(Stf::cholesky_decompose(Stf::DynMatrix<double>(Stf::Matrix<double, 2, 2> { 1, 2, 2, 1 })));
+}
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <Stuff/Graphics/SRGB.hpp>
+#include <Stuff/IO/NTC.hpp>
+#include <Stuff/Maths/LUT.hpp>
+
+static constexpr Stf::LUT<float, 256, Stf::LUTInterpolation::Linear> sin_linear([](float x) { return Stf::sin(x); }, 0.f, 3.14159265f);
+static constexpr Stf::LUT<float, 256, Stf::LUTInterpolation::Cubic> sin_cubic([](float x) { return Stf::sin(x); }, 0.f, 3.14159265f);
+static constexpr Stf::LUT<double, 64, Stf::LUTInterpolation::Cubic> log_cubic([](double x) { return Stf::log(x); }, 1., 2.);
+
+TEST(LUT, Error) {
+    static_assert(sin_linear.max_error() < 2e-5f);
+    static_assert(sin_cubic.max_error() < 5e-7f);
+    static_assert(log_cubic.max_error() < 1e-6);
+
+    // the measured error is a lower bound, check it against a denser sampling
+    for (auto i = 0; i <= 100'000; i++) {
+        const auto x = static_cast<float>(i) * 3.14159265f / 100'000.f;
+        ASSERT_LE(std::abs(sin_cubic(x) - std::sin(x)), sin_cubic.max_error() * 1.5f) << x;
+        ASSERT_LE(std::abs(sin_linear(x) - std::sin(x)), sin_linear.max_error() * 1.5f) << x;
+    }
+
+    // both interpolations go through the samples
+    for (auto i = 0uz; i < sin_cubic.size; i++) {
+        const auto x = static_cast<float>(i) * 3.14159265f / 255.f;
+        ASSERT_NEAR(sin_cubic(x), sin_cubic.samples()[i], 5e-7f);
+        ASSERT_NEAR(sin_linear(x), sin_linear.samples()[i], 5e-7f);
+        ASSERT_NEAR(sin_cubic.samples()[i], std::sin(x), 5e-7f);
+    }
+}
+
+TEST(LUT, Clamp) {
+    static_assert(sin_cubic(-1.f) == sin_cubic(0.f));
+    static_assert(sin_cubic(100.f) == sin_cubic(3.14159265f));
+
+    ASSERT_EQ(sin_linear(std::numeric_limits<float>::quiet_NaN()), sin_linear(0.f));
+    ASSERT_EQ(sin_linear(std::numeric_limits<float>::infinity()), sin_linear(3.14159265f));
+}
+
+template<typename Table> static void test_span(const Table& table, double lo, double hi) {
+    using T = std::remove_cvref_t<decltype(table.samples()[0])>;
+
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    std::uniform_real_distribution<double> dist(lo, hi);
+
+    // not a multiple of any vector width
+    std::vector<T> in(10'007);
+    std::vector<T> out(in.size());
+    for (auto& v : in)
+        v = static_cast<T>(dist(gen));
+
+    // the vector path may contract to FMAs where the scalar one does not
+    table(in, out);
+    for (auto i = 0uz; i < in.size(); i++)
+        ASSERT_NEAR(out[i], table(in[i]), std::numeric_limits<T>::epsilon() * 4) << in[i];
+}
+
+TEST(LUT, Span) {
+    test_span(sin_linear, -1., 4.);
+    test_span(sin_cubic, -1., 4.);
+    test_span(log_cubic, 0.5, 2.5);
+}
+
+TEST(LUT, SRGB) {
+    using namespace Stf::Gfx;
+
+    constexpr auto& to_linear = SRGB::to_linear_lut<>;
+    constexpr auto& from_linear = SRGB::from_linear_lut<>;
+    static_assert(to_linear.max_error() < 2e-6f);
+    static_assert(from_linear.max_error() < 2e-4f);
+
+    static_assert(SRGB::u8_to_linear<>[0] == 0.f);
+    static_assert(SRGB::u8_to_linear<>[255] == 1.f);
+
+    for (auto i = 0; i < 256; i++) {
+        const auto v = static_cast<float>(i) / 255.f;
+        ASSERT_NEAR(SRGB::u8_to_linear<>[i], SRGB::to_linear(v), 1e-6f);
+        ASSERT_NEAR(to_linear(v), SRGB::to_linear(v), 2e-6f);
+
+        // every 8 bit code survives the round trip through the tables
+        ASSERT_EQ(static_cast<int>(std::round(from_linear(to_linear(v)) * 255.f)), i);
+    }
+}
+
+TEST(LUT, NTC) {
+    using namespace Stf::NTC;
+
+    static constexpr auto lut = divider_lut(Nominal::R10K, 10'000.f);
+    static_assert(lut.max_error() < 0.05f);
+
+    for (auto i = 1; i < 4095; i++) {
+        const auto ratio = static_cast<float>(i) / 4095.f;
+        if (ratio < lut.domain_min() || ratio > lut.domain_max())
+            continue;
+
+        const auto [r_1, r_2] = solve_voltage_divider(10'000.f, 1.f, ratio);
+        ASSERT_NEAR(lut(ratio), calculate_ntc(Nominal::R10K, r_2), lut.max_error() * 1.5f) << ratio;
+    }
+
+    // 25°C at the midpoint
+    ASSERT_NEAR(lut(.5f), 298.15f, 0.01f);
+}
@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <numbers>
+#include <random>
+#include <vector>
+
+#include <Stuff/Maths/BLAS/MatVec.hpp>
+#include <Stuff/Maths/BLAS/QuatBatch.hpp>
+
+using Quat = Stf::Quaternion<float>;
+
+static Quat random_unit_quaternion(std::mt19937_64& gen) {
+    std::normal_distribution<float> dist {};
+    return Quat { dist(gen), dist(gen), dist(gen), dist(gen) }.normalized();
+}
+
+static void assert_vector_near(Stf::Vector<float, 3> lhs, Stf::Vector<float, 3> rhs, float error = 1e-5f) {
+    for (auto i = 0uz; i < 3; i++)
+        ASSERT_NEAR(lhs[i], rhs[i], error);
+}
+
+static void assert_rotation_near(Quat lhs, Quat rhs, float error = 1e-5f) {
+    if (lhs.dot(rhs) < 0)
+        rhs = { -rhs.x, -rhs.y, -rhs.z, -rhs.w };
+
+    ASSERT_NEAR(lhs.x, rhs.x, error);
+    ASSERT_NEAR(lhs.y, rhs.y, error);
+    ASSERT_NEAR(lhs.z, rhs.z, error);
+    ASSERT_NEAR(lhs.w, rhs.w, error);
+}
+
+TEST(Quaternion, Scalar) {
+    const auto pi = std::numbers::pi_v<float>;
+
+    const auto about_z = Quat::from_axis_angle(Stf::vector<float>(0, 0, 1), pi / 2);
+    assert_vector_near(about_z.rotate(Stf::vector<float>(1, 0, 0)), Stf::vector<float>(0, 1, 0));
+
+    const auto about_y = Quat::from_axis_angle(Stf::vector<float>(0, 1, 0), pi / 2);
+    assert_vector_near(about_y.rotate(Stf::vector<float>(1, 0, 0)), Stf::vector<float>(0, 0, -1));
+
+    const auto axis = Stf::normalized(Stf::vector<float>(1, 2, 3));
+    const auto q = Quat::from_axis_angle(axis, 0.7f);
+    assert_vector_near(q.rotate(axis), axis);
+
+    const auto v = Stf::vector<float>(-0.5f, 2.f, 1.25f);
+    const auto composed = (about_z * about_y).rotate(v);
+    assert_vector_near(composed, about_z.rotate(about_y.rotate(v)));
+    assert_vector_near(q.conjugate().rotate(q.rotate(v)), v);
+}
+
+TEST(Quaternion, Matrix) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+
+    for (auto i = 0uz; i < 64; i++) {
+        const auto q = random_unit_quaternion(gen);
+        const auto v = Stf::vector<float>(0.3f, -1.f, 2.f);
+
+        const auto mat = q.to_matrix3();
+        assert_vector_near(Stf::vector(mat * v), q.rotate(v));
+
+        assert_rotation_near(Quat::from_matrix(mat), q);
+        assert_rotation_near(Quat::from_matrix(q.to_matrix4()), q);
+    }
+
+    const auto from_euler = Quat::from_matrix(Stf::Matrix<float, 3, 3>::rotation(0.f, 0.f, 0.f));
+    assert_rotation_near(from_euler, Quat::identity());
+}
+
+TEST(Quaternion, Batch) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    std::uniform_real_distribution<float> dist_t(0.f, 1.f);
+
+    const size_t n = 67;
+
+    std::vector<float> a[4], b[4], out[4], vec[3], vec_out[3], t(n);
+    for (auto& v : a)
+        v.resize(n);
+    for (auto& v : b)
+        v.resize(n);
+    for (auto& v : out)
+        v.resize(n);
+    for (auto& v : vec)
+        v.resize(n);
+    for (auto& v : vec_out)
+        v.resize(n);
+
+    for (auto i = 0uz; i < n; i++) {
+        const auto q_a = random_unit_quaternion(gen);
+        const auto q_b = random_unit_quaternion(gen);
+        a[0][i] = q_a.x, a[1][i] = q_a.y, a[2][i] = q_a.z, a[3][i] = q_a.w;
+        b[0][i] = q_b.x, b[1][i] = q_b.y, b[2][i] = q_b.z, b[3][i] = q_b.w;
+        vec[0][i] = dist_t(gen), vec[1][i] = -dist_t(gen), vec[2][i] = 2 * dist_t(gen);
+        t[i] = dist_t(gen);
+    }
+
+    const Stf::QuaternionSoA<float> soa_a { a[0], a[1], a[2], a[3] };
+    const Stf::QuaternionSoA<float> soa_b { b[0], b[1], b[2], b[3] };
+    const Stf::QuaternionSoA<float> soa_out { out[0], out[1], out[2], out[3] };
+    const Stf::Vector3SoA<float> soa_vec { vec[0], vec[1], vec[2] };
+    const Stf::Vector3SoA<float> soa_vec_out { vec_out[0], vec_out[1], vec_out[2] };
+
+    Stf::multiply(soa_a, soa_b, soa_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_rotation_near(soa_out[i], soa_a[i] * soa_b[i]);
+
+    Stf::multiply(soa_a[0], soa_b, soa_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_rotation_near(soa_out[i], soa_a[0] * soa_b[i]);
+
+    Stf::rotate(soa_a, soa_vec, soa_vec_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_vector_near(soa_vec_out[i], soa_a[i].rotate(soa_vec[i]));
+
+    Stf::rotate(soa_b[3], soa_vec, soa_vec_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_vector_near(soa_vec_out[i], soa_b[3].rotate(soa_vec[i]));
+
+    Stf::nlerp(soa_a, soa_b, t, soa_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_rotation_near(soa_out[i], Stf::nlerp(soa_a[i], soa_b[i], t[i]));
+
+    Stf::slerp(soa_a, soa_b, t, soa_out);
+    for (auto i = 0uz; i < n; i++)
+        assert_rotation_near(soa_out[i], Stf::slerp(soa_a[i], soa_b[i], t[i]));
+
+    for (auto i = 0uz; i < n; i++)
+        out[0][i] *= 3.f, out[1][i] *= 3.f, out[2][i] *= 3.f, out[3][i] *= 3.f;
+    Stf::normalize(soa_out, soa_out);
+    for (auto i = 0uz; i < n; i++)
+        ASSERT_NEAR(soa_out[i].norm(), 1.f, 1e-6f);
+}
@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+#include <Stuff/Maths/Transcendental.hpp>
+
+template<std::floating_point T> static int64_t ulp_distance(T lhs, T rhs) {
+    using I = std::conditional_t<sizeof(T) == 4, int32_t, int64_t>;
+
+    if (lhs != lhs && rhs != rhs)
+        return 0;
+    if (lhs == rhs)
+        return 0;
+
+    const auto to_ordered = [](T v) -> int64_t {
+        const auto i = std::bit_cast<I>(v);
+        return i < 0 ? std::numeric_limits<I>::min() - i : i;
+    };
+
+    return std::abs(to_ordered(lhs) - to_ordered(rhs));
+}
+
+/// Runs `fn` over n random inputs in [lo, hi) (or [2^lo, 2^hi) if `log_scale`) and returns the worst error against
+/// the long double <cmath> reference. n is deliberately not a multiple of any vector width.
+template<std::floating_point T, typename Fn, typename Ref>
+static int64_t max_ulp_error(double lo, double hi, Fn&& fn, Ref&& reference, bool log_scale = false) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    std::uniform_real_distribution<double> dist(lo, hi);
+
+    const size_t n = 40'003;
+    std::vector<T> in(n);
+    std::vector<T> out(n);
+    for (auto& v : in)
+        v = static_cast<T>(log_scale ? std::exp2(dist(gen)) : dist(gen));
+
+    fn(std::span<const T>(in), std::span<T>(out));
+
+    int64_t worst = 0;
+    for (auto i = 0uz; i < n; i++)
+        worst = std::max(worst, ulp_distance(out[i], static_cast<T>(reference(static_cast<long double>(in[i])))));
+
+    return worst;
+}
+
+template<std::floating_point T> static void test_unary() {
+    const auto sin = [](auto in, auto out) { Stf::sin<T>(in, out); };
+    const auto cos = [](auto in, auto out) { Stf::cos<T>(in, out); };
+    const auto exp = [](auto in, auto out) { Stf::exp<T>(in, out); };
+    const auto log = [](auto in, auto out) { Stf::log<T>(in, out); };
+
+    const auto ref_sin = [](long double x) { return std::sin(x); };
+    const auto ref_cos = [](long double x) { return std::cos(x); };
+    const auto ref_exp = [](long double x) { return std::exp(x); };
+    const auto ref_log = [](long double x) { return std::log(x); };
+
+    ASSERT_LE(max_ulp_error<T>(-10, 10, sin, ref_sin), 2);
+    ASSERT_LE(max_ulp_error<T>(-1e5, 1e5, sin, ref_sin), 2);
+    ASSERT_LE(max_ulp_error<T>(-10, 10, cos, ref_cos), 2);
+    ASSERT_LE(max_ulp_error<T>(-1e7, 1e7, cos, ref_cos), 2); // partially through the fallback
+
+    ASSERT_LE(max_ulp_error<T>(-1, 1, exp, ref_exp), 1);
+    ASSERT_LE(max_ulp_error<T>(-80, 80, exp, ref_exp), 1);
+
+    ASSERT_LE(max_ulp_error<T>(0.5, 2, log, ref_log), 2);
+    ASSERT_LE(max_ulp_error<T>(-140, 120, log, ref_log, true), 2);
+}
+
+TEST(Transcendental, Float) { test_unary<float>(); }
+
+TEST(Transcendental, Double) { test_unary<double>(); }
+
+TEST(Transcendental, Pow) {
+    std::mt19937_64 gen(0xDEADBEEFCAFEBABE);
+    std::uniform_real_distribution<float> dist_base(-6.f, 6.f);
+    std::uniform_real_distribution<float> dist_exponent(-20.f, 20.f);
+
+    const size_t n = 10'001;
+    std::vector<float> base(n);
+    std::vector<float> exponent(n);
+    std::vector<float> out(n);
+    for (auto i = 0uz; i < n; i++) {
+        base[i] = std::exp2(dist_base(gen));
+        exponent[i] = dist_exponent(gen);
+    }
+
+    // lanes that go through the <cmath> fallback
+    base[0] = -2.f, exponent[0] = 3.f;
+    base[1] = 0.f, exponent[1] = -1.f;
+    base[2] = -8.f, exponent[2] = 1.f / 3.f;
+    base[3] = std::numeric_limits<float>::infinity(), exponent[3] = 0.5f;
+
+    Stf::pow<float>(base, exponent, out);
+    for (auto i = 0uz; i < n; i++)
+        ASSERT_LE(ulp_distance(out[i], std::pow(base[i], exponent[i])), 1) << base[i] << " ^ " << exponent[i];
+
+    Stf::pow<float>(base, 2.5f, out);
+    for (auto i = 0uz; i < n; i++)
+        ASSERT_LE(ulp_distance(out[i], std::pow(base[i], 2.5f)), 1) << base[i] << " ^ 2.5";
+}
+
+TEST(Transcendental, Special) {
+    const auto inf = std::numeric_limits<float>::infinity();
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    const auto denorm_min = std::numeric_limits<float>::denorm_min();
+
+    const std::vector<float> in { 0.f, -0.f, inf, -inf, nan, -1.f, denorm_min, 1e-40f, 100.f, -110.f };
+    std::vector<float> out(in.size());
+
+    Stf::log<float>(in, out);
+    for (auto i = 0uz; i < in.size(); i++)
+        ASSERT_EQ(ulp_distance(out[i], std::log(in[i])), 0) << "log " << in[i];
+
+    Stf::exp<float>(in, out);
+    for (auto i = 0uz; i < in.size(); i++)
+        ASSERT_LE(ulp_distance(out[i], std::exp(in[i])), 1) << "exp " << in[i];
+
+    Stf::sin<float>(in, out);
+    for (auto i = 0uz; i < in.size(); i++)
+        ASSERT_LE(ulp_distance(out[i], std::sin(in[i])), 1) << "sin " << in[i];
+
+    std::vector<float> sin_out(in.size());
+    std::vector<float> cos_out(in.size());
+    Stf::sin_cos<float>(in, sin_out, cos_out);
+    for (auto i = 0uz; i < in.size(); i++) {
+        ASSERT_EQ(ulp_distance(sin_out[i], out[i]), 0);
+        ASSERT_LE(ulp_distance(cos_out[i], std::cos(in[i])), 1) << "cos " << in[i];
+    }
+}
+
+TEST(Transcendental, Constexpr) {
+    static_assert(Stf::sin(0.5f) > 0.4794255f && Stf::sin(0.5f) < 0.4794256f);
+    static_assert(Stf::cos(3.) > -0.9899925 && Stf::cos(3.) < -0.9899924);
+    static_assert(Stf::exp(1.) > 2.7182818284 && Stf::exp(1.) < 2.7182818285);
+    static_assert(Stf::log(10.f) > 2.3025849f && Stf::log(10.f) < 2.3025853f);
+    static_assert(Stf::pow(2.f, .5f) > 1.4142134f && Stf::pow(2.f, .5f) < 1.4142137f);
+    static_assert(Stf::pow(-2., 3.) == -8.);
+    static_assert(Stf::pow(0.f, -.5f) == std::numeric_limits<float>::infinity());
+    static_assert(Stf::pow(-1., 0x1p53 - 1) == -1.);
+    static_assert(Stf::pow(-1., 0x1p53) == 1.);
+    static_assert(Stf::pow(-1.f, 4194305.f) == -1.f);
+    static_assert(Stf::pow(-2.f, 4194305.f) == -std::numeric_limits<float>::infinity());
+    static_assert(Stf::pow(-1.f, 8388610.f) == 1.f);
+
+    constexpr auto sin_large = Stf::sin(1e6f);
+    ASSERT_LE(ulp_distance(sin_large, std::sin(1e6f)), 2);
+
+    constexpr auto pow_frac = Stf::pow(3.7, -2.25);
+    ASSERT_LE(ulp_distance(pow_frac, std::pow(3.7, -2.25)), 2);
+}
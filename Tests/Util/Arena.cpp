@@ -0,0 +1,191 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/Arena.hpp>
+
+#include <map>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+bool is_aligned(const void* ptr, size_t alignment) { return reinterpret_cast<uintptr_t>(ptr) % alignment == 0; }
+
+/// Allocates and fills blocks of all sizes and alignments, returns them as (pointer, size, fill)
+std::vector<std::tuple<uint8_t*, size_t, uint8_t>> fill_blocks(auto& arena, size_t count, uint8_t seed) {
+    std::vector<std::tuple<uint8_t*, size_t, uint8_t>> ret {};
+
+    for (auto i = 0uz; i < count; i++) {
+        const auto size = (i * 37) % 1000;
+        const auto alignment = 1uz << (i % 9);
+        auto* const ptr = static_cast<uint8_t*>(arena.allocate(size, alignment));
+        EXPECT_TRUE(is_aligned(ptr, alignment));
+
+        const auto fill = static_cast<uint8_t>(seed + i);
+        std::fill_n(ptr, size, fill);
+        ret.emplace_back(ptr, size, fill);
+    }
+
+    return ret;
+}
+
+bool blocks_intact(std::vector<std::tuple<uint8_t*, size_t, uint8_t>> const& blocks) {
+    return std::ranges::all_of(blocks, [](auto const& block) {
+        const auto [ptr, size, fill] = block;
+        return std::all_of(ptr, ptr + size, [fill](uint8_t v) { return v == fill; });
+    });
+}
+
+}
+
+TEST(Arena, Allocate) {
+    Stf::Arena arena(4096);
+    ASSERT_EQ(arena.reserved(), 0);
+
+    const auto blocks = fill_blocks(arena, 1000, 0);
+    ASSERT_TRUE(blocks_intact(blocks));
+    ASSERT_GE(arena.reserved(), 1000 * 500);
+
+    // larger than any chunk so far
+    auto* const large = arena.allocate<uint64_t>(1 << 20);
+    ASSERT_TRUE(is_aligned(large, alignof(uint64_t)));
+    std::fill_n(large, 1 << 20, 0x0123456789ABCDEF);
+    ASSERT_TRUE(blocks_intact(blocks));
+
+    auto* const over_aligned = arena.allocate(10, 4096);
+    ASSERT_TRUE(is_aligned(over_aligned, 4096));
+
+    // sizes that overflow on the way to a chunk, the arena is left as it was
+    const auto reserved = arena.reserved();
+    ASSERT_THROW(std::ignore = arena.allocate(SIZE_MAX - 10), std::bad_alloc);
+    ASSERT_THROW(std::ignore = arena.allocate(SIZE_MAX - 100, 4096), std::bad_alloc);
+    ASSERT_THROW(std::ignore = arena.allocate<uint64_t>(SIZE_MAX / 4), std::bad_alloc);
+    ASSERT_EQ(arena.reserved(), reserved);
+
+    Stf::Arena moved(std::move(arena));
+    ASSERT_EQ(arena.reserved(), 0);
+    ASSERT_TRUE(blocks_intact(blocks));
+    ASSERT_NE(moved.allocate(1), nullptr);
+}
+
+TEST(Arena, Reset) {
+    Stf::Arena arena(4096);
+
+    const auto first = fill_blocks(arena, 1000, 0);
+    const auto reserved = arena.reserved();
+
+    // the same allocations land in the same places, in the chunks that were kept
+    arena.reset();
+    const auto second = fill_blocks(arena, 1000, 1);
+    ASSERT_EQ(arena.reserved(), reserved);
+    for (auto i = 0uz; i < first.size(); i++)
+        ASSERT_EQ(std::get<0>(first[i]), std::get<0>(second[i]));
+    ASSERT_TRUE(blocks_intact(second));
+
+    arena.release();
+    ASSERT_EQ(arena.reserved(), 0);
+    ASSERT_NE(arena.allocate(1), nullptr);
+}
+
+TEST(Arena, Scopes) {
+    Stf::Arena arena(4096);
+
+    const auto outer = fill_blocks(arena, 10, 0);
+    const auto marker = arena.mark();
+    void* inner_first;
+
+    {
+        Stf::ArenaScope scope(arena);
+        inner_first = arena.allocate(100);
+        fill_blocks(arena, 1000, 1);
+
+        {
+            Stf::ArenaScope nested(arena);
+            fill_blocks(arena, 1000, 2);
+        }
+    }
+
+    ASSERT_TRUE(blocks_intact(outer));
+    ASSERT_EQ(arena.mark().chunk, marker.chunk);
+    ASSERT_EQ(arena.mark().ptr, marker.ptr);
+
+    // rewound, and growing back to the same size takes no new chunks
+    const auto reserved = arena.reserved();
+    ASSERT_EQ(arena.allocate(100), inner_first);
+    fill_blocks(arena, 1000, 3);
+    ASSERT_EQ(arena.reserved(), reserved);
+    ASSERT_TRUE(blocks_intact(outer));
+}
+
+TEST(Arena, Local) {
+    auto& arena = Stf::Arena::local();
+    ASSERT_EQ(&arena, &Stf::Arena::local());
+
+    Stf::Arena* other = nullptr;
+    std::thread([&] { other = &Stf::Arena::local(); }).join();
+    ASSERT_NE(other, &arena);
+
+    Stf::ArenaScope scope(arena);
+    ASSERT_NE(arena.allocate(64), nullptr);
+}
+
+TEST(Arena, Shared) {
+    Stf::SharedArena arena(64 * 1024);
+    auto first_reserved = 0uz;
+
+    for (auto round = 0; round < 3; round++) {
+        std::vector<std::vector<std::tuple<uint8_t*, size_t, uint8_t>>> blocks(4);
+        std::vector<std::thread> threads {};
+        for (auto i = 0uz; i < blocks.size(); i++)
+            threads.emplace_back([&, i] { blocks[i] = fill_blocks(arena, 5000, static_cast<uint8_t>(i * 64)); });
+        for (auto& thread : threads)
+            thread.join();
+
+        for (auto const& thread_blocks : blocks)
+            ASSERT_TRUE(blocks_intact(thread_blocks));
+
+        // the chunks are reused, the threads may only interleave differently and waste different amounts at their ends
+        if (round == 0)
+            first_reserved = arena.reserved();
+        else
+            ASSERT_LE(arena.reserved(), first_reserved * 2);
+
+        arena.reset();
+    }
+
+    ASSERT_THROW(std::ignore = arena.allocate(SIZE_MAX - 5), std::bad_alloc);
+    ASSERT_THROW(std::ignore = arena.allocate(SIZE_MAX - 100, 4096), std::bad_alloc);
+    ASSERT_THROW(std::ignore = arena.allocate<uint64_t>(SIZE_MAX / 4), std::bad_alloc);
+
+    arena.release();
+    ASSERT_EQ(arena.reserved(), 0);
+    ASSERT_NE(arena.allocate<uint64_t>(3), nullptr);
+}
+
+TEST(Arena, Allocator) {
+    Stf::Arena arena {};
+
+    {
+        Stf::ArenaScope scope(arena);
+
+        std::vector<int, Stf::ArenaAllocator<int>> vec(arena);
+        for (auto i = 0; i < 10000; i++)
+            vec.push_back(i);
+        for (auto i = 0; i < 10000; i++)
+            ASSERT_EQ(vec[static_cast<size_t>(i)], i);
+
+        std::map<int, int, std::less<>, Stf::ArenaAllocator<std::pair<const int, int>>> map(arena);
+        for (auto i = 0; i < 1000; i++)
+            map[i * 7 % 1000] = i;
+        ASSERT_EQ(map.size(), 1000);
+        ASSERT_EQ(map.begin()->first, 0);
+    }
+
+    Stf::SharedArena shared {};
+    std::vector<double, Stf::ArenaAllocator<double, Stf::SharedArena>> vec(shared);
+    vec.assign(1000, 1.5);
+    ASSERT_TRUE((vec.get_allocator() == Stf::ArenaAllocator<int, Stf::SharedArena>(shared)));
+
+    Stf::SharedArena other {};
+    ASSERT_FALSE((vec.get_allocator() == Stf::ArenaAllocator<double, Stf::SharedArena>(other)));
+}
@@ -0,0 +1,210 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/AsyncIO.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <random>
+
+extern "C" {
+#include <fcntl.h>
+#include <unistd.h>
+}
+
+namespace {
+
+/// A file of `size` bytes in the temporary directory opened for reading and writing, removed on destruction
+struct TemporaryFile {
+    explicit TemporaryFile(std::string_view name, size_t size)
+        : filename((std::filesystem::temp_directory_path() / name).string())
+        , contents(size) {
+        std::mt19937 engine { 1234 };
+        std::ranges::generate(contents, [&] { return static_cast<char>(engine()); });
+
+        std::ofstream(filename, std::ios::binary).write(contents.data(), static_cast<std::streamsize>(contents.size()));
+        fildes = open(filename.c_str(), O_RDWR);
+    }
+
+    ~TemporaryFile() {
+        close(fildes);
+        std::filesystem::remove(filename);
+    }
+
+    std::string filename;
+    std::vector<char> contents;
+    int fildes;
+};
+
+/// Every backend, and the pool one with and without workers
+template<typename Fn> void for_each_backend(Fn&& fn) {
+    Stf::ThreadPool inline_pool { 0 };
+    Stf::ThreadPool pool { 3 };
+
+    for (auto* const p : { &inline_pool, &pool }) {
+        Stf::AsyncIO io(8, false, *p);
+        ASSERT_EQ(io.backend(), Stf::AsyncIOBackend::ThreadPool);
+        fn(io);
+    }
+
+    // not every kernel, or every sandbox, lets processes have an io_uring
+    Stf::AsyncIO io(8, true, pool);
+    if (io.backend() == Stf::AsyncIOBackend::IOUring)
+        fn(io);
+}
+
+}
+
+TEST(AsyncIO, Read) {
+    const TemporaryFile file("libstuff_async_io_read.bin", 1 << 20);
+
+    for_each_backend([&](Stf::AsyncIO& io) {
+        std::mt19937 engine { 1234 };
+        std::vector<std::vector<char>> buffers(200);
+        auto completed = 0uz;
+
+        for (auto& buffer : buffers) {
+            const auto offset = engine() % file.contents.size();
+            buffer.resize(1 + engine() % 10000);
+
+            io.read(file.fildes, buffer, offset, [&, offset](int64_t result) {
+                const auto expected = std::min(buffer.size(), file.contents.size() - offset);
+                ASSERT_EQ(result, expected);
+                ASSERT_TRUE(std::ranges::equal(std::span(buffer).first(expected), std::span(file.contents).subspan(offset, expected)));
+                completed++;
+            });
+        }
+
+        ASSERT_EQ(io.pending(), buffers.size());
+        io.drain();
+        ASSERT_EQ(io.pending(), 0);
+        ASSERT_EQ(completed, buffers.size());
+
+        // failures are reported through the callbacks
+        char byte;
+        int64_t result = 0;
+        io.read(-1, std::span(&byte, 1), 0, [&](int64_t res) { result = res; });
+        ASSERT_EQ(io.poll(1), 1);
+        ASSERT_EQ(result, -EBADF);
+    });
+}
+
+TEST(AsyncIO, QueueDepth) {
+    ASSERT_EQ(Stf::AsyncIO(0, false).queue_depth(), 1);
+    ASSERT_EQ(Stf::AsyncIO(100000, false).queue_depth(), 100000);
+
+    // no more operations in flight than the ring has entries
+    Stf::AsyncIO io(100000, true);
+    if (io.backend() == Stf::AsyncIOBackend::IOUring) {
+        ASSERT_LE(io.queue_depth(), 32768);
+    }
+}
+
+TEST(AsyncIO, Write) {
+    const TemporaryFile file("libstuff_async_io_write.bin", 64 * 1024);
+
+    for_each_backend([&](Stf::AsyncIO& io) {
+        std::vector<char> block(4096);
+        std::iota(block.begin(), block.end(), static_cast<char>(io.queue_depth()));
+
+        auto expected = file.contents;
+        auto completed = 0uz;
+        for (auto offset = 0uz; offset < expected.size(); offset += 2 * block.size()) {
+            std::ranges::copy(block, expected.begin() + static_cast<ptrdiff_t>(offset));
+            io.write(file.fildes, block, offset, [&](int64_t result) {
+                ASSERT_EQ(result, block.size());
+                completed++;
+            });
+        }
+
+        // callbacks that queue more operations
+        std::vector<char> read_back(expected.size());
+        io.drain();
+        ASSERT_EQ(completed, expected.size() / block.size() / 2);
+
+        io.read(file.fildes, std::span(read_back).first(1), 0, [&](int64_t) {
+            io.read(file.fildes, std::span(read_back).subspan(1), 1, [&](int64_t result) { ASSERT_EQ(result, read_back.size() - 1); });
+        });
+        io.drain();
+        ASSERT_EQ(read_back, expected);
+
+        // restored for the next backend
+        ASSERT_EQ(pwrite(file.fildes, file.contents.data(), file.contents.size(), 0), static_cast<ssize_t>(file.contents.size()));
+    });
+}
+
+TEST(AsyncIO, ReadFixed) {
+    const TemporaryFile file("libstuff_async_io_read_fixed.bin", 1 << 20);
+
+    for_each_backend([&](Stf::AsyncIO& io) {
+        std::vector<std::vector<char>> storage(4, std::vector<char>(16384));
+        std::vector<std::span<char>> buffers(storage.begin(), storage.end());
+        ASSERT_TRUE(io.register_buffers(buffers));
+
+        for (auto round = 0uz; round < 8; round++) {
+            for (auto i = 0uz; i < buffers.size(); i++) {
+                const auto offset = (round * buffers.size() + i) * 10007;
+                io.read_fixed(file.fildes, i, 16384, offset, [&, i, offset](int64_t result) {
+                    ASSERT_EQ(result, 16384);
+                    ASSERT_TRUE(std::ranges::equal(buffers[i], std::span(file.contents).subspan(offset, 16384)));
+                });
+            }
+            io.drain();
+        }
+
+        int64_t result = 0;
+        io.read_fixed(file.fildes, buffers.size(), 16, 0, [&](int64_t res) { result = res; });
+        io.read(file.fildes, buffers[0], 0, nullptr);
+        ASSERT_FALSE(io.register_buffers({}));
+        io.drain();
+        ASSERT_LT(result, 0);
+
+        ASSERT_TRUE(io.register_buffers({}));
+    });
+}
+
+static Stf::DetachedTask checksum(Stf::AsyncIO& io, int fildes, size_t size, uint64_t& out, bool& done) {
+    std::vector<char> buffer(3000);
+    uint64_t sum = 0;
+
+    for (auto offset = 0uz; offset < size; offset += buffer.size()) {
+        const auto result = co_await io.async_read(fildes, buffer, offset);
+        if (result <= 0)
+            break;
+
+        sum = std::accumulate(buffer.begin(), buffer.begin() + result, sum, [](uint64_t acc, char c) { return acc * 31 + static_cast<uint8_t>(c); });
+    }
+
+    out = sum;
+    done = true;
+}
+
+TEST(AsyncIO, Coroutines) {
+    const TemporaryFile file("libstuff_async_io_coroutines.bin", 100000);
+    const auto expected = std::accumulate(file.contents.begin(), file.contents.end(), uint64_t {}, [](uint64_t acc, char c) { return acc * 31 + static_cast<uint8_t>(c); });
+
+    for_each_backend([&](Stf::AsyncIO& io) {
+        // more of them than fit in the queue
+        std::array<uint64_t, 20> sums {};
+        std::array<bool, 20> done {};
+        for (auto i = 0uz; i < sums.size(); i++)
+            checksum(io, file.fildes, file.contents.size(), sums[i], done[i]);
+
+        ASSERT_EQ(std::ranges::count(done, true), 0);
+        io.drain();
+        ASSERT_EQ(std::ranges::count(done, true), done.size());
+        ASSERT_EQ(std::ranges::count(sums, expected), sums.size());
+
+        std::vector<char> block { 'a', 'b', 'c' };
+        std::vector<char> read_back(3);
+        [](Stf::AsyncIO& io, int fildes, std::span<const char> in, std::span<char> out) -> Stf::DetachedTask {
+            co_await io.async_write(fildes, in, 10);
+            co_await io.async_read(fildes, out, 10);
+            co_await io.async_write(fildes, std::span(out).first(0), 10);
+        }(io, file.fildes, block, read_back);
+        io.drain();
+        ASSERT_EQ(read_back, block);
+
+        ASSERT_EQ(pwrite(file.fildes, file.contents.data() + 10, 3, 10), 3);
+    });
+}
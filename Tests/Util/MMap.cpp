@@ -0,0 +1,229 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/MMap.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+/// A file of `size` bytes counting up from 0 in the temporary directory, removed on destruction
+struct TemporaryFile {
+    explicit TemporaryFile(std::string_view name, size_t size)
+        : filename((std::filesystem::temp_directory_path() / name).string())
+        , contents(size) {
+        std::iota(contents.begin(), contents.end(), 0);
+        write();
+    }
+
+    ~TemporaryFile() { std::filesystem::remove(filename); }
+
+    void write() const {
+        std::ofstream ofs(filename, std::ios::binary | std::ios::trunc);
+        ofs.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+    }
+
+    std::vector<char> read() const {
+        std::ifstream ifs(filename, std::ios::binary);
+        return { std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>() };
+    }
+
+    std::string filename;
+    std::vector<char> contents;
+};
+
+TEST(MMap, Options) {
+    const TemporaryFile file("libstuff_mmap_options.bin", 100000);
+
+    for (const auto access : { Stf::MMapAccess::Normal, Stf::MMapAccess::Sequential, Stf::MMapAccess::Random }) {
+        const Stf::MMapOptions options { .populate = true, .access = access, .will_need = true, .huge_pages = true };
+        const Stf::MMapStringView view(file.filename, true, options);
+
+        ASSERT_NE(view.data(), nullptr);
+        ASSERT_EQ(view.size(), file.contents.size());
+        ASSERT_TRUE(std::ranges::equal(std::span<const char>(view), file.contents));
+    }
+
+    const Stf::MMapStringView missing("/nonexistent/libstuff_mmap", true);
+    ASSERT_EQ(missing.data(), nullptr);
+    ASSERT_EQ(missing.size(), 0);
+}
+
+TEST(MMap, Writable) {
+    const TemporaryFile file("libstuff_mmap_writable.bin", 5000);
+
+    // private mappings keep their writes to themselves
+    {
+        Stf::MMapStringView view(file.filename, false);
+        ASSERT_NE(view.data(), nullptr);
+        view.data()[10] = 'x';
+        ASSERT_EQ(view.data()[10], 'x');
+    }
+    ASSERT_EQ(file.read(), file.contents);
+
+    {
+        Stf::MMapStringView view(file.filename, false, { .shared = true });
+        ASSERT_NE(view.data(), nullptr);
+        view.data()[10] = 'x';
+        view.data()[4999] = 'y';
+    }
+
+    auto expected = file.contents;
+    expected[10] = 'x';
+    expected[4999] = 'y';
+    ASSERT_EQ(file.read(), expected);
+}
+
+TEST(MMap, Move) {
+    const TemporaryFile file("libstuff_mmap_move.bin", 5000);
+
+    Stf::MMapStringView view(file.filename, true);
+    const auto* data = view.data();
+
+    Stf::MMapStringView moved(std::move(view));
+    ASSERT_EQ(moved.data(), data);
+    ASSERT_EQ(moved.size(), 5000);
+    ASSERT_EQ(view.data(), nullptr);
+    ASSERT_EQ(view.size(), 0);
+
+    Stf::MMapStringView other("/nonexistent/libstuff_mmap", true);
+    other = std::move(moved);
+    ASSERT_EQ(other.data(), data);
+    ASSERT_TRUE(std::ranges::equal(std::span<const char>(other), file.contents));
+
+    std::vector<Stf::MMapStringView> views {};
+    for (auto i = 0uz; i < 10; i++)
+        views.emplace_back(file.filename, true);
+    for (auto const& v : views)
+        ASSERT_TRUE(std::ranges::equal(std::span<const char>(v), file.contents));
+}
+
+TEST(MMap, Windows) {
+    const TemporaryFile file("libstuff_mmap_windows.bin", 3 * 8192 + 1234);
+
+    Stf::MMapWindowedFile windows(file.filename, 8000, 100, { .access = Stf::MMapAccess::Sequential });
+    ASSERT_TRUE(windows.is_open());
+    ASSERT_EQ(windows.size(), file.contents.size());
+    ASSERT_EQ(windows.window_size() % 4096, 0);
+    ASSERT_GE(windows.window_size(), 8000);
+
+    const auto expected = [&](size_t index) {
+        const auto begin = index * windows.window_size();
+        const auto end = std::min(file.contents.size(), begin + windows.window_size() + 100);
+        return std::span(file.contents).subspan(begin, end - begin);
+    };
+
+    // in order, with the next window prefetched
+    for (auto i = 0uz; i < windows.window_count(); i++) {
+        const auto window = windows.window(i);
+        ASSERT_TRUE(std::ranges::equal(window, expected(i))) << i;
+        ASSERT_TRUE(std::ranges::equal(windows.window(i), window)) << i;
+    }
+
+    // and out of order
+    for (const auto i : { 2uz, 0uz, 0uz, 3uz, 1uz })
+        ASSERT_TRUE(std::ranges::equal(windows.window(i), expected(i))) << i;
+
+    ASSERT_TRUE(windows.window(windows.window_count()).empty());
+
+    auto moved = std::move(windows);
+    ASSERT_FALSE(windows.is_open());
+    ASSERT_TRUE(windows.window(0).empty());
+    ASSERT_TRUE(std::ranges::equal(moved.window(2), expected(2)));
+
+    Stf::MMapWindowedFile missing("/nonexistent/libstuff_mmap", 4096);
+    ASSERT_FALSE(missing.is_open());
+    ASSERT_TRUE(missing.window(0).empty());
+}
+
+TEST(MMap, Append) {
+    const auto filename = (std::filesystem::temp_directory_path() / "libstuff_mmap_append.bin").string();
+    std::filesystem::remove(filename);
+
+    std::vector<char> expected {};
+    const auto committed_bytes = [&] {
+        const Stf::MMapStringView view(filename, true);
+        const auto bytes = Stf::MMapAppendFile::committed_bytes(view);
+        return bytes ? std::vector<char>(bytes->begin(), bytes->end()) : std::vector<char> {};
+    };
+
+    {
+        auto file = Stf::MMapAppendFile::open(filename, 100);
+        ASSERT_TRUE(file) << file.error();
+        ASSERT_EQ(file->size(), 0);
+        ASSERT_GE(file->capacity(), 100);
+
+        // records of all sizes, growing the file a few times over
+        for (auto i = 0uz; i < 2000; i++) {
+            std::vector<char> record(i % 37 + 1, static_cast<char>(i));
+            const auto offset = file->append(record);
+            ASSERT_TRUE(offset);
+            ASSERT_EQ(*offset, expected.size());
+            expected.insert(expected.end(), record.begin(), record.end());
+        }
+
+        ASSERT_GE(file->capacity(), expected.size());
+        ASSERT_TRUE(std::ranges::equal(std::span<const char>(file->data(), file->size()), expected));
+
+        // readers see nothing of the uncommitted records
+        ASSERT_TRUE(committed_bytes().empty());
+        ASSERT_TRUE(file->commit());
+        ASSERT_EQ(file->committed(), expected.size());
+        ASSERT_EQ(committed_bytes(), expected);
+
+        // written in place
+        const auto offset = file->allocate(3);
+        ASSERT_TRUE(offset);
+        std::memcpy(file->data() + *offset, "abc", 3);
+        ASSERT_TRUE(file->commit());
+        expected.insert(expected.end(), { 'a', 'b', 'c' });
+        ASSERT_EQ(committed_bytes(), expected);
+
+        // dropped as if the process had died before committing
+        ASSERT_TRUE(file->append(std::span<const char>("lost", 4)));
+    }
+
+    ASSERT_EQ(committed_bytes(), expected);
+
+    {
+        auto file = Stf::MMapAppendFile::open(filename);
+        ASSERT_TRUE(file) << file.error();
+        ASSERT_EQ(file->size(), expected.size());
+        ASSERT_EQ(file->committed(), expected.size());
+
+        auto moved = std::move(*file);
+        ASSERT_FALSE(file->append(std::span<const char>("x", 1)));
+        ASSERT_EQ(moved.append(std::span<const char>("kept", 4)), expected.size());
+        ASSERT_TRUE(moved.commit());
+        expected.insert(expected.end(), { 'k', 'e', 'p', 't' });
+    }
+
+    ASSERT_EQ(committed_bytes(), expected);
+    std::filesystem::remove(filename);
+
+    // never committed
+    {
+        auto file = Stf::MMapAppendFile::open(filename);
+        ASSERT_TRUE(file) << file.error();
+        ASSERT_TRUE(file->append(std::span<const char>("lost", 4)));
+    }
+
+    {
+        auto file = Stf::MMapAppendFile::open(filename);
+        ASSERT_TRUE(file) << file.error();
+        ASSERT_EQ(file->size(), 0);
+        ASSERT_EQ(file->committed(), 0);
+    }
+
+    const Stf::MMapStringView uncommitted(filename, true);
+    const auto uncommitted_bytes = Stf::MMapAppendFile::committed_bytes(uncommitted);
+    ASSERT_TRUE(uncommitted_bytes) << uncommitted_bytes.error();
+    ASSERT_TRUE(uncommitted_bytes->empty());
+    std::filesystem::remove(filename);
+
+    const TemporaryFile other("libstuff_mmap_not_append.bin", 5000);
+    ASSERT_FALSE(Stf::MMapAppendFile::open(other.filename));
+    ASSERT_FALSE(Stf::MMapAppendFile::committed_bytes(other.contents));
+    ASSERT_FALSE(Stf::MMapAppendFile::open("/nonexistent/libstuff_mmap"));
+}
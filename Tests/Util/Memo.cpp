@@ -0,0 +1,99 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/Memo.hpp>
+
+#include <list>
+#include <random>
+#include <string>
+
+TEST(Memo, FlatLRUCache) {
+    Stf::Comp::FlatLRUCache<int, std::string> cache(3);
+    ASSERT_EQ(cache.capacity(), 3);
+
+    cache.insert(1, "one");
+    cache.insert(2, "two");
+    cache.insert(3, "three");
+    ASSERT_EQ(cache.size(), 3);
+
+    // a hit makes 1 the most recent, so 2 is the one forgotten
+    ASSERT_EQ(*cache.find(1), "one");
+    cache.insert(4, "four");
+    ASSERT_EQ(cache.size(), 3);
+    ASSERT_EQ(cache.find(2), nullptr);
+    ASSERT_EQ(*cache.find(1), "one");
+    ASSERT_EQ(*cache.find(3), "three");
+    ASSERT_EQ(*cache.find(4), "four");
+
+    // inserting a cached key replaces its value and makes it the most recent
+    cache.insert(1, "uno");
+    cache.insert(5, "five");
+    ASSERT_EQ(cache.find(3), nullptr);
+    ASSERT_EQ(*cache.find(1), "uno");
+
+    cache.clear();
+    ASSERT_EQ(cache.size(), 0);
+    ASSERT_EQ(cache.find(1), nullptr);
+    cache.insert(1, "one");
+    ASSERT_EQ(*cache.find(1), "one");
+}
+
+TEST(Memo, FlatLRUCacheReference) {
+    // against a std::list, with keys that collide in the table
+    static constexpr auto capacity = 64uz;
+    Stf::Comp::FlatLRUCache<uint32_t, uint32_t> cache(capacity);
+    std::list<std::pair<uint32_t, uint32_t>> reference {};
+
+    std::mt19937 engine { 1234 };
+    for (auto i = 0u; i < 100000; i++) {
+        const auto key = static_cast<uint32_t>(engine() % 256) << 24;
+        auto it = std::ranges::find(reference, key, &std::pair<uint32_t, uint32_t>::first);
+
+        if (engine() % 2 == 0) {
+            auto* const value = cache.find(key);
+            ASSERT_EQ(value != nullptr, it != reference.end());
+            if (value != nullptr) {
+                ASSERT_EQ(*value, it->second);
+                reference.splice(reference.begin(), reference, it);
+            }
+            continue;
+        }
+
+        cache.insert(key, i);
+        if (it != reference.end()) {
+            it->second = i;
+            reference.splice(reference.begin(), reference, it);
+        } else {
+            if (reference.size() == capacity)
+                reference.pop_back();
+            reference.emplace_front(key, i);
+        }
+        ASSERT_EQ(cache.size(), reference.size());
+    }
+
+    for (auto const& [key, value] : reference)
+        ASSERT_EQ(*cache.find(key), value);
+}
+
+namespace {
+
+struct Fibonacci : Stf::Comp::FlatMemoizerBase<uint64_t, uint64_t> {
+    using FlatMemoizerBase::FlatMemoizerBase;
+
+protected:
+    uint64_t impl(uint64_t n) override { return n < 2 ? n : call(n - 1) + call(n - 2); }
+};
+
+}
+
+TEST(Memo, FlatMemoizer) {
+    Fibonacci fibonacci(16);
+    ASSERT_EQ(fibonacci(90), 2880067194370816120ull);
+    ASSERT_EQ(fibonacci.all_calls(), 90 * 2 - 1);
+    ASSERT_EQ(fibonacci.memo_calls(), 88);
+
+    // only the most recent 16 are kept
+    ASSERT_EQ(fibonacci(85), 259695496911122585ull);
+    ASSERT_EQ(fibonacci.memo_calls(), 89);
+    ASSERT_EQ(fibonacci(10), 55);
+    ASSERT_GT(fibonacci.all_calls(), fibonacci.memo_calls() + 90);
+}
@@ -0,0 +1,158 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/Resource.hpp>
+
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+TEST(Resource, Arena) {
+    Stf::ArenaResource resource(4096);
+
+    std::pmr::vector<std::pmr::string> strings(&resource);
+    for (auto i = 0; i < 1000; i++)
+        strings.emplace_back(std::string(static_cast<size_t>(i % 100), 'x'));
+    ASSERT_EQ(std::string_view(strings[999]), std::string(99, 'x'));
+    ASSERT_EQ(strings[999].get_allocator().resource(), &resource);
+    ASSERT_GE(resource.reserved_bytes(), 1000 * 50);
+
+    // rewound, the same allocation lands in the same place
+    const auto marker = resource.mark();
+    auto* const first = resource.allocate(100, 8);
+    resource.rewind(marker);
+    ASSERT_EQ(resource.allocate(100, 8), first);
+
+    const auto before = resource.mark();
+    {
+        Stf::ArenaScope scope(resource.arena());
+        std::pmr::vector<int> scratch(100000, 1, &resource);
+        ASSERT_EQ(scratch.back(), 1);
+    }
+    ASSERT_EQ(resource.mark().chunk, before.chunk);
+    ASSERT_EQ(resource.mark().ptr, before.ptr);
+
+    ASSERT_TRUE(resource.is_equal(resource));
+    Stf::ArenaResource other {};
+    ASSERT_FALSE(resource.is_equal(other));
+}
+
+TEST(Resource, Slab) {
+    Stf::StatsResource upstream {};
+    Stf::SlabResource resource(&upstream);
+
+    {
+        std::pmr::list<std::pmr::string> list(&resource);
+        for (auto i = 0; i < 1000; i++)
+            list.emplace_back(std::string(static_cast<size_t>(i % 40), 'y'));
+        ASSERT_EQ(std::string_view(list.back()), std::string(39, 'y'));
+
+        std::pmr::unordered_map<int, int> map(&resource);
+        for (auto i = 0; i < 1000; i++)
+            map[i] = i;
+        ASSERT_EQ(map.at(500), 500);
+
+        ASSERT_GE(resource.reserved_bytes(), 2000 * 16);
+    }
+
+    // the pool keeps its slabs
+    const auto reserved = resource.reserved_bytes();
+    ASSERT_EQ(reserved, Stf::slab_reserved_bytes());
+
+    // too large and too aligned for the pool
+    const auto upstream_allocations = upstream.stats().allocations;
+    auto* const large = resource.allocate(4000, 8);
+    auto* const aligned = resource.allocate(64, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned) % 64, 0);
+    ASSERT_EQ(upstream.stats().allocations, upstream_allocations + 2);
+    ASSERT_EQ(resource.reserved_bytes(), reserved + 4064);
+    ASSERT_EQ(upstream.stats().bytes_in_use, 4064);
+    resource.deallocate(large, 4000, 8);
+    resource.deallocate(aligned, 64, 64);
+    ASSERT_EQ(upstream.stats().bytes_in_use, 0);
+
+    // nothing is counted when upstream throws
+    Stf::SlabResource failing(std::pmr::null_memory_resource());
+    ASSERT_THROW(std::ignore = failing.allocate(4000, 8), std::bad_alloc);
+    ASSERT_EQ(failing.reserved_bytes(), Stf::slab_reserved_bytes());
+
+    // each resource counts what it holds from upstream, memory goes back through the one it came from
+    Stf::SlabResource other(&upstream);
+    ASSERT_TRUE(resource.is_equal(resource));
+    ASSERT_FALSE(resource.is_equal(other));
+
+    std::vector<std::thread> threads {};
+    for (auto t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            std::pmr::vector<std::pmr::vector<int>> vectors(&resource);
+            for (auto i = 0; i < 1000; i++)
+                vectors.emplace_back(static_cast<size_t>(i % 64), i);
+            for (auto i = 0; i < 1000; i++)
+                EXPECT_TRUE(std::ranges::all_of(vectors[static_cast<size_t>(i)], [i](int v) { return v == i; }));
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    ASSERT_EQ(resource.reserved_bytes(), Stf::slab_reserved_bytes());
+}
+
+TEST(Resource, Stats) {
+    Stf::ArenaResource arena(4096);
+    Stf::StatsResource stats(&arena);
+
+    auto* const a = stats.resource()->allocate(10, 8);
+    auto* const b = stats.resource()->allocate(100, 8);
+    auto* const c = stats.resource()->allocate(1000, 8);
+    stats.resource()->deallocate(b, 100, 8);
+    ASSERT_EQ(std::as_const(stats).resource(), &stats);
+
+    auto snapshot = stats.stats();
+    ASSERT_EQ(snapshot.allocations, 3);
+    ASSERT_EQ(snapshot.deallocations, 1);
+    ASSERT_EQ(snapshot.bytes_allocated, 1110);
+    ASSERT_EQ(snapshot.bytes_in_use, 1010);
+    ASSERT_EQ(snapshot.peak_bytes_in_use, 1110);
+    ASSERT_EQ(snapshot.size_histogram[4], 1); // [8, 16)
+    ASSERT_EQ(snapshot.size_histogram[7], 1); // [64, 128)
+    ASSERT_EQ(snapshot.size_histogram[10], 1); // [512, 1024)
+    ASSERT_EQ(snapshot.reserved_bytes, arena.reserved_bytes());
+    ASSERT_GT(snapshot.fragmentation(), 0.);
+    ASSERT_LT(snapshot.fragmentation(), 1.);
+
+    stats.reset_peak();
+    ASSERT_EQ(stats.stats().peak_bytes_in_use, 1010);
+    stats.resource()->deallocate(a, 10, 8);
+    stats.resource()->deallocate(c, 1000, 8);
+    ASSERT_EQ(stats.stats().bytes_in_use, 0);
+    ASSERT_EQ(stats.stats().peak_bytes_in_use, 1010);
+
+    // counted from any number of threads
+    Stf::SlabResource slab {};
+    Stf::StatsResource shared(&slab);
+    std::vector<std::thread> threads {};
+    for (auto t = 0; t < 4; t++) {
+        threads.emplace_back([&] {
+            std::pmr::list<int> list(shared.resource());
+            for (auto i = 0; i < 1000; i++)
+                list.push_back(i);
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    ASSERT_EQ(shared.stats().allocations, 4000);
+    ASSERT_EQ(shared.stats().deallocations, 4000);
+    ASSERT_EQ(shared.stats().bytes_in_use, 0);
+    ASSERT_EQ(shared.stats().reserved_bytes, Stf::slab_reserved_bytes());
+    ASSERT_EQ(shared.stats().fragmentation(), 1.);
+
+    // and nothing is counted with the statistics disabled
+    Stf::StatsResource<false> disabled(&arena);
+    ASSERT_EQ(disabled.resource(), &arena);
+    std::pmr::vector<int> vec(100, disabled.resource());
+    ASSERT_EQ(disabled.stats().allocations, 0);
+}
@@ -0,0 +1,168 @@
+#include "gtest/gtest.h"
+
+#include <Stuff/Util/Slab.hpp>
+
+#include <list>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Block {
+    uint8_t* ptr;
+    size_t size;
+    uint8_t fill;
+};
+
+Block allocate_block(size_t size, uint8_t fill) {
+    auto* const ptr = static_cast<uint8_t*>(Stf::slab_allocate(size));
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % Stf::slab_alignment, 0);
+    std::fill_n(ptr, size, fill);
+    return { ptr, size, fill };
+}
+
+bool intact(Block const& block) {
+    return std::all_of(block.ptr, block.ptr + block.size, [&](uint8_t v) { return v == block.fill; });
+}
+
+}
+
+TEST(Slab, Classes) {
+    for (auto size = 0uz; size <= Stf::slab_max_size; size++) {
+        const auto size_class = Stf::Detail::Slab::class_of(size);
+        ASSERT_GE(Stf::Detail::Slab::class_sizes[size_class], size) << size;
+        if (size_class != 0) {
+            ASSERT_LT(Stf::Detail::Slab::class_sizes[size_class - 1], size) << size;
+        }
+    }
+}
+
+TEST(Slab, Allocate) {
+    std::mt19937 engine { 1234 };
+    std::vector<Block> blocks {};
+
+    // mixed sizes, freed in random order and reused, with some of them past the largest class
+    for (auto round = 0uz; round < 20; round++) {
+        for (auto i = 0uz; i < 2000; i++)
+            blocks.push_back(allocate_block(engine() % 1100, static_cast<uint8_t>(engine())));
+
+        std::ranges::shuffle(blocks, engine);
+        for (auto i = 0uz; i < 1500; i++) {
+            ASSERT_TRUE(intact(blocks.back()));
+            Stf::slab_deallocate(blocks.back().ptr, blocks.back().size);
+            blocks.pop_back();
+        }
+    }
+
+    for (auto const& block : blocks) {
+        ASSERT_TRUE(intact(block));
+        Stf::slab_deallocate(block.ptr, block.size);
+    }
+
+    // the most recently freed object of a class is the next one handed out
+    auto* const a = Stf::slab_allocate(40);
+    Stf::slab_deallocate(a, 40);
+    ASSERT_EQ(Stf::slab_allocate(33), a);
+    Stf::slab_deallocate(a, 48);
+
+    Stf::slab_deallocate(nullptr, 16);
+
+    ASSERT_GE(Stf::slab_reserved_bytes(), 2000uz * 16);
+}
+
+TEST(Slab, CrossThread) {
+    // allocated on one thread and freed on another, through the depot and back
+    for (auto round = 0uz; round < 10; round++) {
+        std::vector<Block> blocks {};
+        std::thread([&] {
+            for (auto i = 0uz; i < 5000; i++)
+                blocks.push_back(allocate_block(16 + i % 200, static_cast<uint8_t>(i + round)));
+        }).join();
+
+        std::thread([&] {
+            for (auto const& block : blocks) {
+                ASSERT_TRUE(intact(block));
+                Stf::slab_deallocate(block.ptr, block.size);
+            }
+        }).join();
+    }
+
+    std::vector<std::thread> threads {};
+    for (auto t = 0uz; t < 4; t++) {
+        threads.emplace_back([t] {
+            std::vector<Block> blocks {};
+            for (auto i = 0uz; i < 20000; i++) {
+                blocks.push_back(allocate_block(8 + (i * 7) % 500, static_cast<uint8_t>(t * 50 + i)));
+                if (i % 3 == 0) {
+                    EXPECT_TRUE(intact(blocks.front()));
+                    Stf::slab_deallocate(blocks.front().ptr, blocks.front().size);
+                    blocks.erase(blocks.begin());
+                }
+            }
+
+            for (auto const& block : blocks) {
+                EXPECT_TRUE(intact(block));
+                Stf::slab_deallocate(block.ptr, block.size);
+            }
+
+            Stf::slab_flush_thread_cache();
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+TEST(Slab, LateFree) {
+    // the destructor of a thread_local that outlives the thread cache
+    struct Late {
+        void* ptr = nullptr;
+
+        ~Late() {
+            auto* const other = Stf::slab_allocate(1000);
+            Stf::slab_deallocate(other, 1000);
+            Stf::slab_deallocate(ptr, 1000);
+        }
+    };
+
+    void* ptr = nullptr;
+    std::thread([&] {
+        thread_local Late late {};
+        late.ptr = ptr = Stf::slab_allocate(1000);
+    }).join();
+
+    // back in the depot, in the first magazine a new thread gets
+    std::vector<void*> magazine(Stf::Detail::Slab::magazine_capacity(Stf::Detail::Slab::class_of(1000)));
+    std::thread([&] {
+        for (auto& object : magazine)
+            object = Stf::slab_allocate(1000);
+        for (auto* const object : magazine)
+            Stf::slab_deallocate(object, 1000);
+    }).join();
+    ASSERT_NE(std::ranges::find(magazine, ptr), magazine.end());
+}
+
+TEST(Slab, Allocator) {
+    std::list<std::string, Stf::SlabAllocator<std::string>> list {};
+    for (auto i = 0; i < 1000; i++)
+        list.push_back(std::string(static_cast<size_t>(i % 50), 'a'));
+    ASSERT_EQ(list.size(), 1000);
+    ASSERT_EQ(list.back(), std::string(49, 'a'));
+
+    std::unordered_map<int, std::string, std::hash<int>, std::equal_to<>, Stf::SlabAllocator<std::pair<const int, std::string>>> map {};
+    for (auto i = 0; i < 10000; i++)
+        map[i] = std::to_string(i);
+    for (auto i = 0; i < 10000; i += 2)
+        map.erase(i);
+    ASSERT_EQ(map.size(), 5000);
+    ASSERT_EQ(map.at(4321), "4321");
+
+    struct alignas(64) Aligned {
+        float v[16];
+    };
+    std::vector<Aligned, Stf::SlabAllocator<Aligned>> aligned(3);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(aligned.data()) % 64, 0);
+}
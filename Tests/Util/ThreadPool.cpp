@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <Stuff/Util/ThreadPool.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST(ThreadPool, ParallelFor) {
+    Stf::ThreadPool pool(3);
+
+    std::vector<int> values(10000, 0);
+    pool.parallel_for(0, values.size(), 64, [&](size_t begin, size_t end) {
+        for (auto i = begin; i < end; i++)
+            values[i]++;
+    });
+
+    for (auto v : values)
+        ASSERT_EQ(v, 1);
+}
+
+TEST(ThreadPool, ParallelForThrows) {
+    Stf::ThreadPool pool(3);
+
+    for (auto round = 0; round < 50; round++) {
+        std::atomic_size_t processed { 0 };
+
+        // the throwing chunk lands on the caller or on a worker depending on the round
+        const auto throwing_chunk = static_cast<size_t>(round % 8);
+        EXPECT_THROW(
+          pool.parallel_for(0, 8 * 16, 16,
+                            [&](size_t begin, size_t end) {
+                                if (begin / 16 == throwing_chunk)
+                                    throw std::runtime_error("chunk failed");
+                                processed.fetch_add(end - begin);
+                            }),
+          std::runtime_error);
+
+        ASSERT_LE(processed.load(), 7 * 16);
+    }
+
+    // and the pool is still usable afterwards
+    std::atomic_size_t sum { 0 };
+    pool.parallel_for(0, 1000, 10, [&](size_t begin, size_t end) { sum.fetch_add(end - begin); });
+    ASSERT_EQ(sum.load(), 1000);
+}